@@ -1,11 +1,57 @@
+#define _POSIX_C_SOURCE 200809L // Required for clock_gettime and nanosleep under -std=c11; must precede every #include
 #define RAYMATH_STATIC_INLINE // THIS MUST BE THE FIRST THING RELATED TO RAYMATH
 #include <raylib.h>
 #include <raymath.h>          // raymath.h must be included AFTER raylib.h
+#include <rlgl.h>             // Required for the batched particle quads
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
 #include <math.h>
 #include <float.h>            // Required for FLT_MAX
+#include <stddef.h>           // Required for size_t
+#include <string.h>           // Required for memcpy (world snapshots)
+#include <pthread.h>          // Required for the batch runner thread pool
+#include <stdatomic.h>        // Required for the batch runner work counter
+#include <stdint.h>           // Required for fixed-size network fields
+#include <stdarg.h>           // Required for the metrics text formatter
+#ifndef _WIN32
+#include <unistd.h>           // Required for sysconf (CPU count)
+#include <fcntl.h>            // Required for non-blocking sockets
+#include <sys/socket.h>       // Required for the UDP server and clients
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/time.h>         // Required for the metrics endpoint's request timeout
+#define NET_SUPPORTED         // Dedicated server and network clients use BSD sockets
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0        // Platforms without it
+#endif
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>      // Required for the config file watcher
+#include <poll.h>
+#endif
+
+// Simulation state is per thread, so the batch runner can step independent worlds in parallel
+#define WORLD_LOCAL _Thread_local
+
+// Forces a kernel to be inlined into each caller, so every instance is specialised for its arguments
+#if defined(__GNUC__) || defined(__clang__)
+#define SIM_KERNEL static inline __attribute__((always_inline))
+#else
+#define SIM_KERNEL static inline
+#endif
+
+// Missile guidance processes MISSILE_LANES missiles per arithmetic operation. GCC and Clang get a
+// native vector type; other compilers fall back to one lane and run the same kernel source.
+#if defined(__GNUC__) || defined(__clang__)
+#define MISSILE_LANES 4
+typedef float MissileLane __attribute__((vector_size(MISSILE_LANES * sizeof(float))));
+typedef int MissileMask __attribute__((vector_size(MISSILE_LANES * sizeof(int)))); // Comparison results, all bits set for true
+#else
+#define MISSILE_LANES 1
+typedef float MissileLane;
+typedef int MissileMask;
+#endif
 
 #define MAX_ENTITIES 20 // UPDATED: Renamed from MAX_ENEMIES to reflect all combat entities, increased to 20
 #define MAX_CRATES 20
@@ -17,8 +63,9 @@
 #define ENTITY_BULLET_SPEED 15.0f
 #define ENTITY_SHOOTING_RANGE 10.0f
 #define ENTITY_FIRE_RATE 2.0f
+#define ENTITY_CHASE_SPEED 3.0f // Force with which combat entities chase their target
 
-#define MAX_BOMBS 10
+#define MAX_BOMBS 64 // Jet bombs falling or exploding at once, shared by the whole fleet
 #define BOMB_RADIUS 1.0f // Size of the bomb sphere
 #define BOMB_FALL_SPEED 20.0f // Initial downward speed
 #define BOMB_EXPLOSION_RADIUS 20.0f // Area of effect for bomb damage
@@ -42,12 +89,173 @@
 #define TANK_SCALE_FACTOR 3.0f // Make tank 3 times bigger
 
 // Missile specific defines
-#define MAX_MISSILES 5 // Max missiles the jet can fire at once
+#define MAX_MISSILES 4096 // Missiles in flight at once (multiple of MISSILE_LANES)
 #define MISSILE_SPEED 40.0f // Speed of the missile
 #define MISSILE_RADIUS 0.5f // Size of the missile sphere
 #define MISSILE_DAMAGE 100.0f // Damage missile deals to tank
+#define MISSILE_NAVIGATION_GAIN 4.0f // Proportional navigation constant N
+#define MISSILE_TURN_RATE 3.0f // Largest heading change in radians per second
+#define MISSILE_PURSUIT_GAIN 2.0f // Pull towards the line of sight, turns missiles launched facing away
 #define JET_MISSILE_FIRE_RATE 3.0f // How often jet can fire a missile
 #define JET_MISSILE_LOCK_ON_RANGE 70.0f // Distance jet can lock onto a tank
+#define JET_MISSILE_SALVO 1.0f // Missiles launched per shot
+#define JET_MISSILE_SALVO_SPREAD 0.35f // Launch cone of a salvo (tangent of the half angle)
+#define MAX_AIRCRAFT 256 // Aircraft in the air at once; aircraft 0 is the orbiting jet
+#define AIRCRAFT_MAX_WAYPOINTS 8 // Control points of one patrol loop
+#define AIRCRAFT_MIN_WAYPOINTS 4
+#define AIRCRAFT_PATROL_EXTENT 45 // Waypoints fall within +-this many units of the origin on X and Z
+#define AIRCRAFT_HEIGHT_SPREAD 10 // Patrol loops fly up to this far above or below jetFlightHeight
+#define AIRCRAFT_LOCK_CELL_SIZE 32.0f // Tank grid cell for lock-on queries, about half the lock-on range
+#define AIRCRAFT_LOCK_GRID_DIM 16 // Cells per side of the lock-on grid (the cells repeat every 512 units)
+#define MISSILE_BENCH_COUNT 4096 // Default missiles in flight for --bench-missiles
+#define MISSILE_BENCH_TICKS 600 // Guidance sub-steps timed per benchmark run
+
+// Hit-scan player fire
+#define HITSCAN_RANGE 100.0f // Longest hit-scan shot
+#define HITSCAN_TERRAIN_STEP 1.0f // Step of the shot's march over the heightmap
+#define HITSCAN_MAX_BOXES (MAX_ENTITIES + MAX_TANKS + MAX_CRATES) // Boxes in the world's BVH
+#define BVH_LEAF_SIZE 2 // Most boxes per BVH leaf
+#define BVH_STACK_SIZE 64 // Traversal stack; median splits keep the depth at log2 of the box count
+#define BVH_REBUILD_GROWTH 2.0f // Rebuild instead of refitting once the root has grown this much since the build
+#define HITSCAN_BENCH_BOXES 4096 // Default box count for --bench-hitscan
+#define HITSCAN_BENCH_RAYS 1000000 // Rays cast through the BVH per benchmark run
+#define HITSCAN_BENCH_BASELINE_RAYS 20000 // Rays for the brute-force baseline
+
+// Particle effects (render side only, never part of the simulation)
+#define MAX_PARTICLES 8192 // Live particles per emitter type (multiple of MISSILE_LANES, one rlgl batch)
+#define PARTICLE_FRAME_BUDGET 1024 // Particles all effects may spawn between two particle updates
+#define PARTICLE_LOD_NEAR 20.0f // Effects closer to the camera than this spawn every particle
+#define PARTICLE_LOD_FAR 120.0f // Effects farther than this spawn none
+#define PARTICLE_LOD_MIN_DETAIL 0.2f // Fraction of its particles an effect spawns just inside PARTICLE_LOD_FAR
+#define PARTICLE_BENCH_FRAMES 2000 // Updates timed per --bench-particles run
+#define EFFECT_MAX_BURSTS 3 // Emitter types one effect can spawn into
+
+// Lit instanced rendering
+#define LIT_MAX_GROUPS 8 // Merged meshes a model keeps: one per material, more when a material passes 65535 vertices
+#define LIT_MAX_DRAWS 32 // Instanced draws per frame, across all batches and groups
+#define LIT_SPHERE_DETAIL 12 // Rings and slices of the shared unit sphere
+
+// Oriented box collision
+#define OBB_EDGE_AXIS_BIAS 1.05f // Edge-edge axes must overlap this factor less than a face axis to give the contact normal
+#define OBB_PARALLEL_EPSILON 1.0e-6f // Rotation slack against near-parallel edges, whose edge-edge axis is skipped
+#define OBB_STACKED_NORMAL_Y 0.7f // Contacts with a steeper normal stack one crate on the other instead of pushing sideways
+
+// Explosion resolution specific defines
+#define MAX_PENDING_EXPLOSIONS 32 // Detonations queued per frame before a forced flush
+#define EXPLOSION_LETHAL_DAMAGE 1.0e9f // Bombs destroy combat entities outright
+#define BOMB_TANK_DAMAGE 50.0f // Bombs do significant damage to tanks
+#define TANK_BOMB_TANK_DAMAGE 50.0f // Self-damage for tanks caught in a tank bomb
+#define BROADPHASE_CELL_SIZE 8.0f // Edge length of a broadphase grid cell
+#define BROADPHASE_GRID_DIM 32 // Cells per side (the cells repeat every 256 units)
+
+// Heightmap terrain and world streaming
+#define WORLD_CHUNKS 512 // Chunks per side of the map (32768 x 32768 units around the origin)
+#define TERRAIN_TILE_CELLS 16 // Cells per side of one tile (a tile is 17x17 samples, borders shared with neighbours)
+#define TERRAIN_CELL_SIZE 2.0f // World units per cell
+#define TERRAIN_HEIGHT_SCALE 12.0f // Largest height away from the arena
+#define TERRAIN_FEATURE_SIZE 128.0f // Wavelength of the broadest noise octave
+#define TERRAIN_OCTAVES 4
+#define TERRAIN_SEED 0x7E44A1Du
+#define TERRAIN_ARENA_RADIUS 40.0f // Hills are damped inside this radius so the battle area stays playable
+#define TERRAIN_ARENA_BLEND 100.0f // Distance at which the hills reach full height
+#define TERRAIN_ARENA_FLATNESS 0.15f // Fraction of the hill height left at the arena centre
+#define TERRAIN_CHUNK_TILES 2 // Tiles per side of one chunk, the unit of streaming and drawing (64 x 64 units)
+#define TERRAIN_DRAW_DISTANCE 224.0f // Chunks farther than this from the camera are not drawn (within the stream window)
+#define STREAM_WINDOW_CHUNKS 8 // Chunks per side kept resident around a streaming focus (power of two)
+#define STREAM_SYNC_LOADS 4 // Chunks generated per update by a streamer without a loader thread
+#define STREAM_LOADER_QUEUE 64 // Chunk load requests in flight to a loader thread
+#define STREAM_LOADER_POLL_SECONDS 0.002 // Loader thread sleep when it has no requests
+#define STREAM_PROPS_PER_CHUNK 12 // Most static rocks scattered on one chunk
+#define STREAM_MESH_BUILDS_PER_FRAME 4 // Chunk meshes rebuilt per drawn frame
+#define MAX_FROZEN_CRATES 64 // Crates stored for chunks outside the player's window (more stay simulated)
+
+// Flow field pathfinding
+#define FLOWFIELD_DIM 100 // Cells per side, a 100x100 field centred on the simulation window
+#define FLOWFIELD_CELL_SIZE 1.0f // World units per flow field cell
+#define FLOWFIELD_BLOCKED 255 // Entry cost marking an impassable cell (resting crates)
+#define FLOWFIELD_TANK_COST 8 // Tanks are passable but expensive, so agents route around them
+#define FLOWFIELD_STRAIGHT_STEP 10 // Integration cost of an orthogonal step through a cost-1 cell
+#define FLOWFIELD_DIAGONAL_STEP 14 // Integration cost of a diagonal step (~10 * sqrt(2))
+#define FLOWFIELD_BUCKETS 128 // Dial queue buckets, must exceed the largest step cost (14 * tank cost)
+#define FLOWFIELD_UNREACHED 0xFFFF // Integration value of cells no seed can reach
+#define FLOWFIELD_NO_DIRECTION 8 // Direction index for seed cells and dead ends
+#define FLOWFIELD_BENCH_AGENTS 4096 // Default agent count for --bench-flowfield
+#define FLOWFIELD_BENCH_TICKS 600 // Simulated ticks per benchmark run
+#define FLOWFIELD_BENCH_BASELINE_TICKS 20 // Ticks for the O(N^2) direct steering baseline
+
+// AI scheduling
+#define AI_AGENTS_PER_TICK 8 // Entities/tanks whose target is re-evaluated each tick (0 = no count limit)
+#define AI_BUDGET_MICROSECONDS 0.0 // Wall-clock cap on re-evaluation per tick (0 = off; non-zero is not deterministic)
+#define AI_ENTITY_TARGET_RANGE 25.0f // Combat entity target acquisition range
+#define AI_TANK_TARGET_RANGE (35.0f * TANK_SCALE_FACTOR) // Tanks have a longer target range, scaled
+#define TANK_UPDATE_RATE 20.0f // Tank AI, collision and weapon ticks per second; positions extrapolate in between
+#define MISSILE_UPDATE_RATE 120.0f // Missile guidance sub-steps per second
+#define RATE_CLASS_MAX_STEPS 8 // Sub-steps one class may run in a frame; time beyond that is dropped
+#define TIMER_TICK_RATE 60.0f // Timer wheel ticks per second, one per fixed simulation step
+#define TIMER_WHEEL_SLOT_BITS 6 // 64 slots per wheel level
+#define TIMER_WHEEL_LEVELS 3 // Three levels reach 64^3 ticks (~73 minutes) ahead
+#define MAX_TIMERS 1024 // Pending cooldown and delayed events per world (two per aircraft at most)
+#define TANK_BROADPHASE_CELL_SIZE 16.0f // Tank bucket cell, about one (scaled) tank footprint
+#define TANK_BROADPHASE_GRID_DIM 16 // Cells per side of the tank buckets (the cells repeat every 256 units)
+
+// Generational handles
+#define MAX_HANDLE_SLOTS 256 // Largest pool that hands out handles (the aircraft fleet)
+
+// Headless batch runner
+#define BATCH_TICK_SECONDS (1.0f / 60.0f) // Fixed simulation tick of headless worlds
+#define BATCH_DEFAULT_MATCHES 1000
+#define BATCH_DEFAULT_STEP_CAP (60 * 60 * 3) // Three simulated minutes per match
+#define BATCH_DEFAULT_CSV_PATH "batch_results.csv"
+#define BATCH_MAX_THREADS 64
+#define BATCH_MAX_PARAM_VALUES 8 // Values per swept parameter
+#define BATCH_BOT_FIRE_RANGE 40.0f // Bot player shoots at hostiles closer than this
+#define BATCH_BOT_ENGAGE_RANGE 15.0f // Bot player walks towards hostiles farther than this
+#define CONFIG_BENCH_MATCHES 20 // Default match count for --bench-config
+#define CONFIG_BENCH_STEPS 1800 // Step cap per benchmark match (30 simulated seconds)
+#define DIVERGENCE_DEFAULT_MATCHES 8 // Matches per variant for --check-divergence
+#define DIVERGENCE_DEFAULT_STEPS 1800 // Tick cap per --check-divergence match
+
+// Networking (dedicated server and clients)
+#define NET_DEFAULT_PORT 27960
+#define NET_PROTOCOL_MAGIC 0x4E574642u // "BFWN" in little-endian byte order
+#define NET_TICK_RATE 60 // Server simulation ticks per second
+#define NET_SNAPSHOT_INTERVAL 2 // Server ticks per snapshot (30 snapshots per second)
+#define NET_SNAPSHOT_HISTORY 32 // Ticks of snapshots kept on both ends as delta baselines (~0.5 s)
+#define NET_MAX_CLIENTS 256
+#define NET_MAX_PACKET 4096 // Largest datagram either side sends
+#define NET_POSITION_SCALE 64.0f // Quantisation steps per world unit (int16 offsets reach +-512 units from their chunk)
+#define NET_INTERP_TICKS 6 // Clients render this many ticks (100 ms) behind the newest snapshot
+#define NET_SNAP_DISTANCE 4.0f // Moves longer than this between snapshots snap instead of interpolating
+#define NET_CLIENT_TIMEOUT 3.0 // Seconds of silence before the server drops a client
+#define NET_BOT_DEFAULT_SECONDS 30.0
+#define NET_CLIENT_HISTORY (NET_SNAPSHOT_HISTORY / NET_SNAPSHOT_INTERVAL) // States the server keeps of what it sent each client
+#define NET_RELEVANCE_NEAR 15.0f // Interest tiers, distance from a client's view: near updates every snapshot
+#define NET_RELEVANCE_MID 30.0f // Mid tier updates every NET_MID_PERIOD snapshots; bullets and missiles end here
+#define NET_RELEVANCE_FAR 60.0f // Far tier updates every NET_FAR_PERIOD snapshots; beyond it only tanks are sent
+#define NET_MID_PERIOD 2
+#define NET_FAR_PERIOD 4
+#define NET_BEHIND_COSINE -0.25f // Elements past the near tier this far behind the view drop one tier
+#define NET_BENCH_CLIENTS 256 // Default simulated clients for --bench-net
+#define NET_BENCH_SECONDS 5.0 // Length of each --bench-net pass
+#define NET_BENCH_PORT 27970 // --bench-net passes use this port and the next
+#define NET_MAX_MISSILES 24 // Missiles replicated per snapshot; the rest of a large salvo is not sent
+#define NET_MAX_AIRCRAFT 32 // Aircraft replicated per snapshot; a larger raid sends its first ones
+#define PIPELINE_SIM_RATE 60 // Fixed steps per second of the pipelined simulation thread
+#define PIPELINE_FRAME_SLOTS 4 // Render frames in flight between the simulation and render threads
+#define PIPELINE_INPUT_SLOTS 64 // Input messages from the render thread to the simulation
+#define PIPELINE_SOUND_SLOTS 256 // Sound events from the simulation to the audio thread
+#define PIPELINE_EFFECT_SLOTS 512 // Particle effect events from the simulation to the render thread
+#define PIPELINE_AUDIO_POLL_SECONDS 0.001 // Audio thread sleep when its ring is empty
+#define CONFIG_WATCH_POLL_SECONDS 0.25 // Config watcher wake-up period: shutdown checks, and the file's modification time without inotify
+
+// Telemetry (soak run counters and metrics export)
+#define TELEMETRY_FLUSH_EVENTS 60 // Steps or frames a thread counts privately before adding into the shared totals
+#define TELEMETRY_HISTOGRAM_BUCKETS 10 // Finite duration buckets per histogram; +Inf comes on top
+#define TELEMETRY_EXPORT_SECONDS 5.0 // Default interval between --metrics-file writes
+#define TELEMETRY_POLL_SECONDS 0.05 // Exporter thread wake-up period, bounds the scrape latency
+#define TELEMETRY_TEXT_CAPACITY 16384 // Largest exposition text the exporter renders
+#define TELEMETRY_REQUEST_TIMEOUT 1.0 // Seconds a scrape connection may take to send its request, and to read the reply
+#define TELEMETRY_DEFAULT_PORT 9464 // --scrape-metrics port when none is given
 
 // Define paths for your sound files
 #define SOUND_BULLET_PATH "resources/sounds/bullet_shot.wav"
@@ -60,6 +268,18 @@
 #define SOUND_MISSILE_LAUNCH_PATH "resources/sounds/missile_launch.wav" // New sound
 #define SOUND_MISSILE_IMPACT_PATH "resources/sounds/missile_impact.wav" // New sound (can reuse explosion)
 
+// Frame arena specific defines
+#define FRAME_ARENA_SIZE (1024 * 1024) // Scratch memory available to a single frame
+#define FRAME_ARENA_ALIGNMENT 16 // Keeps arena arrays SIMD friendly
+
+// World snapshot specific defines
+#define SNAPSHOT_MAGIC 0x53534642u // "BFSS" in little-endian file order
+#define SNAPSHOT_VERSION 10 // Bump whenever WorldSnapshot layout changes
+#define SNAPSHOT_QUICKSAVE_PATH "quicksave.bfs"
+#define REWIND_HISTORY_FRAMES 30 // Frames of delta history kept for rewinds (~500 ms at 60 FPS)
+#define REWIND_STEP_FRAMES 18 // Frames rewound per key press (~300 ms at 60 FPS)
+#define SNAPSHOT_MIN_ZERO_RUN 4 // Unchanged bytes needed before the delta encoder starts a new run
+
 
 // Entity Types
 typedef enum {
@@ -67,65 +287,225 @@ typedef enum {
     ENTITY_FRIENDLY
 } EntityType;
 
+// Generational reference into a packed pool. It survives swap-removes, and once the element dies it
+// goes stale instead of silently pointing at whatever reuses the slot.
+typedef struct {
+    int slot;                // -1 for the null handle
+    unsigned int generation; // Must match the slot's current generation to resolve
+} Handle;
+
+#define NULL_HANDLE ((Handle){ -1, 0 })
+
+// Target cached by the AI scheduler between re-evaluations
+typedef enum {
+    AI_TARGET_NONE,
+    AI_TARGET_PLAYER,
+    AI_TARGET_ENTITY,
+    AI_TARGET_TANK
+} AiTargetKind;
+
+typedef struct {
+    AiTargetKind kind;
+    Handle handle; // Combat entity or tank handle, null for the player
+} AiTarget;
+
 // --- Entity Structs ---
+// Pools are packed: live elements occupy [0, count) and a death swaps the last element into the
+// freed slot, so loops never test an "active" flag. Per-tick (hot) fields live in the main struct,
+// rarely touched (cold) fields in a parallel array indexed the same way.
 typedef struct {
     Vector3 position;
-    bool active;
     Vector3 velocity;
     float mass;
 } Bullet;
 
 typedef struct {
     Vector3 position;
-    bool active;
     Vector3 velocity;
     float mass;
-    float explosionTimer;
+    uint32_t explosionStartTick; // Timer ticks the explosion started and ends on
+    uint32_t explosionEndTick;
     bool exploded;
     float radius; // For different bomb sizes
     float explosion_radius;
     float explosion_duration;
+    Handle handle; // Lets the explosion-end timer find the bomb after swap-removes
 } ProjectileBomb;
 
 typedef struct {
     Vector3 position;
     Vector3 velocity;
-    float mass;
-    bool active;
     float health;
-    float shootTimer;
-    EntityType type; // Type of entity (enemy or friendly)
+    AiTarget target;
 } CombatEntity;
 
+typedef struct {
+    float mass;
+    bool gunReady; // Set by the timer wheel when the fire cooldown ends
+    EntityType type; // Type of entity (enemy or friendly)
+    Handle handle;   // Own handle, used to repoint the handle table when the entity moves slot
+} CombatEntityCold;
+
 typedef struct {
     Vector3 position;
     Vector3 velocity;
-    float mass;
-    bool active;
-    Color color;
     Quaternion rotation;
     Vector3 angularVelocity;
     bool isPhysicsActive; // Flag to control physics for crates
 } Crate;
 
+typedef struct {
+    float mass;
+    Color color;
+    Handle handle;
+} CrateCold;
+
 typedef struct {
     Vector3 position;
     Vector3 velocity;
     float health;
-    bool active;
-    float bulletShootTimer;
-    float bombDropTimer;
-    float yawRotation; // For tank orientation
+    AiTarget target;
 } Vehicle; // To represent the tank
 
+typedef struct {
+    bool gunReady;  // Set by the timer wheel when the fire cooldown ends
+    bool bombReady; // Same for the bomb drop cooldown
+    float yawRotation; // For tank orientation
+    Handle handle;
+} VehicleCold;
+
+typedef enum {
+    AIRCRAFT_PATH_ORBIT,    // Circle of jetRadius around jetCenterPoint at jetFlightHeight
+    AIRCRAFT_PATH_WAYPOINTS // Closed Catmull-Rom loop through the cold waypoints
+} AircraftPath;
+
+// Position and heading are advanced once per tick by the flight step; bombing, lock-on, missile
+// launches and rendering all read them from here instead of re-evaluating the path.
 typedef struct {
     Vector3 position;
-    bool active;
-    Vector3 velocity;
-    int targetTankIndex; // Index of the tank it's tracking
-    float speed;
-    float damage;
-} Missile; // New: Missile struct
+    Vector3 forward;     // Unit direction of travel
+    float yawRotation;
+    float pathParameter; // Orbit angle in radians, or segments travelled along the waypoint loop
+} Aircraft;
+
+typedef struct {
+    AircraftPath path;
+    int waypointCount;
+    Vector3 waypoints[AIRCRAFT_MAX_WAYPOINTS]; // Y is the flight height at that point
+    bool bombReady;      // Set by the timer wheel when the bomb drop cooldown ends
+    bool missileReady;   // Same for the missile launch cooldown
+    Handle lockedTarget; // Tank this aircraft is locked onto (null if none)
+    Handle handle;
+} AircraftCold;
+
+// Missiles are kept as parallel arrays so the guidance kernel loads MISSILE_LANES neighbours per
+// operation. Nothing refers to a missile from outside, so the pool hands out no handles.
+typedef struct {
+    float positionX[MAX_MISSILES];
+    float positionY[MAX_MISSILES];
+    float positionZ[MAX_MISSILES];
+    float velocityX[MAX_MISSILES];
+    float velocityY[MAX_MISSILES];
+    float velocityZ[MAX_MISSILES];
+    float speed[MAX_MISSILES];
+    Handle targetTank[MAX_MISSILES]; // Tank it's tracking, stale once that tank is destroyed
+    float damage[MAX_MISSILES];
+} MissilePool;
+
+// --- Frame Arena ---
+// Linear allocator for per-frame transient data (pair lists, hit lists, draw buffers).
+// Everything allocated from it is released at once when the frame loop resets it.
+typedef struct {
+    unsigned char *base;
+    size_t capacity;
+    size_t offset;
+    size_t lastFrameBytes; // Bytes used by the previous frame
+    size_t peakFrameBytes; // Highest per-frame usage seen so far
+} FrameArena;
+
+// Each world thread gets its own arena; the base is bound on first reset since the address of a
+// thread-local is not a constant initializer
+WORLD_LOCAL unsigned char frameArenaMemory[FRAME_ARENA_SIZE];
+WORLD_LOCAL FrameArena frameArena = { NULL, FRAME_ARENA_SIZE, 0, 0, 0 };
+
+#ifdef FRAME_ARENA_DEBUG
+// Debug builds (-DFRAME_ARENA_DEBUG) trap general-heap allocations made during the simulation step
+WORLD_LOCAL bool frameStepActive = false;
+
+void *GuardedMalloc(size_t size, const char *file, int line) {
+    if (frameStepActive) TraceLog(LOG_FATAL, "FRAME ARENA: malloc(%zu) inside simulation step at %s:%d", size, file, line);
+    return (malloc)(size);
+}
+
+void *GuardedCalloc(size_t count, size_t size, const char *file, int line) {
+    if (frameStepActive) TraceLog(LOG_FATAL, "FRAME ARENA: calloc(%zu, %zu) inside simulation step at %s:%d", count, size, file, line);
+    return (calloc)(count, size);
+}
+
+void *GuardedRealloc(void *ptr, size_t size, const char *file, int line) {
+    if (frameStepActive) TraceLog(LOG_FATAL, "FRAME ARENA: realloc(%zu) inside simulation step at %s:%d", size, file, line);
+    return (realloc)(ptr, size);
+}
+
+void *GuardedMemAlloc(unsigned int size, const char *file, int line) {
+    if (frameStepActive) TraceLog(LOG_FATAL, "FRAME ARENA: MemAlloc(%u) inside simulation step at %s:%d", size, file, line);
+    return (MemAlloc)(size);
+}
+
+#define malloc(size) GuardedMalloc((size), __FILE__, __LINE__)
+#define calloc(count, size) GuardedCalloc((count), (size), __FILE__, __LINE__)
+#define realloc(ptr, size) GuardedRealloc((ptr), (size), __FILE__, __LINE__)
+#define MemAlloc(size) GuardedMemAlloc((size), __FILE__, __LINE__)
+#define BEGIN_SIMULATION_STEP() (frameStepActive = true)
+#define END_SIMULATION_STEP() (frameStepActive = false)
+#else
+#define BEGIN_SIMULATION_STEP() ((void)0)
+#define END_SIMULATION_STEP() ((void)0)
+#endif
+
+// Returns aligned scratch memory valid until the next ResetFrameArena(), or NULL when the arena is full
+void *ArenaAlloc(FrameArena *arena, size_t size) {
+    size_t start = (arena->offset + (FRAME_ARENA_ALIGNMENT - 1)) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+    if (start + size > arena->capacity) {
+#ifdef FRAME_ARENA_DEBUG
+        TraceLog(LOG_FATAL, "FRAME ARENA: out of memory (requested %zu, used %zu of %zu bytes)", size, arena->offset, arena->capacity);
+#else
+        TraceLog(LOG_WARNING, "FRAME ARENA: out of memory (requested %zu, used %zu of %zu bytes)", size, arena->offset, arena->capacity);
+#endif
+        return NULL;
+    }
+    arena->offset = start + size;
+    return arena->base + start;
+}
+
+#define ARENA_ALLOC_ARRAY(arena, type, count) ((type *)ArenaAlloc((arena), sizeof(type) * (size_t)(count)))
+
+// Called once at the top of the frame loop: releases everything allocated during the previous frame
+void ResetFrameArena(FrameArena *arena) {
+    if (arena->base == NULL) arena->base = frameArenaMemory;
+    arena->lastFrameBytes = arena->offset;
+    if (arena->offset > arena->peakFrameBytes) {
+        arena->peakFrameBytes = arena->offset;
+#ifdef FRAME_ARENA_DEBUG
+        TraceLog(LOG_INFO, "FRAME ARENA: new per-frame peak of %zu bytes (capacity %zu)", arena->peakFrameBytes, arena->capacity);
+#endif
+    }
+    arena->offset = 0;
+}
+
+// --- Timing ---
+// Monotonic, so budgets, benchmarks and pacing loops survive clock changes, and available without a window (unlike GetTime())
+double WallClockSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void SleepSeconds(double seconds) {
+    if (seconds <= 0.0) return;
+    struct timespec duration = { (time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1.0e9) };
+    nanosleep(&duration, NULL);
+}
 
 // --- Global Models and Arrays ---
 Model entityModel;
@@ -135,1417 +515,8439 @@ Model bombModel;
 Model tankModel;
 Model missileModel; // New: For the missile
 
-Bullet playerBullets[MAX_PLAYER_BULLETS];
-Bullet entityBullets[MAX_ENTITY_BULLETS];
-Bullet tankBullets[MAX_TANK_BULLETS];
-CombatEntity combatEntities[MAX_ENTITIES];
-Crate crates[MAX_CRATES];
-ProjectileBomb bombs[MAX_BOMBS];
-ProjectileBomb tankBombs[MAX_TANK_BOMBS];
-Vehicle tanks[MAX_TANKS];
-Missile missiles[MAX_MISSILES]; // New: Array of missiles
+WORLD_LOCAL Bullet playerBullets[MAX_PLAYER_BULLETS];
+WORLD_LOCAL Bullet entityBullets[MAX_ENTITY_BULLETS];
+WORLD_LOCAL Bullet tankBullets[MAX_TANK_BULLETS];
+WORLD_LOCAL CombatEntity combatEntities[MAX_ENTITIES];
+WORLD_LOCAL CombatEntityCold combatEntitiesCold[MAX_ENTITIES];
+WORLD_LOCAL Crate crates[MAX_CRATES];
+WORLD_LOCAL CrateCold cratesCold[MAX_CRATES];
+WORLD_LOCAL ProjectileBomb bombs[MAX_BOMBS];
+WORLD_LOCAL ProjectileBomb tankBombs[MAX_TANK_BOMBS];
+WORLD_LOCAL Vehicle tanks[MAX_TANKS];
+WORLD_LOCAL VehicleCold tanksCold[MAX_TANKS];
+WORLD_LOCAL MissilePool missiles;
+WORLD_LOCAL Aircraft aircraft[MAX_AIRCRAFT];
+WORLD_LOCAL AircraftCold aircraftCold[MAX_AIRCRAFT];
+
+// Live element counts of the packed pools above
+WORLD_LOCAL int playerBulletCount = 0;
+WORLD_LOCAL int entityBulletCount = 0;
+WORLD_LOCAL int tankBulletCount = 0;
+WORLD_LOCAL int combatEntityCount = 0;
+WORLD_LOCAL int crateCount = 0;
+WORLD_LOCAL int bombCount = 0;
+WORLD_LOCAL int tankBombCount = 0;
+WORLD_LOCAL int tankCount = 0;
+WORLD_LOCAL int missileCount = 0;
+WORLD_LOCAL int aircraftCount = 0;
 
 // --- Global Game Variables ---
-Camera camera = { 0 };
-float playerHealth = 100.0f;
-bool onGround = true;
-float jumpVelocity = 0.0f;
-float playerBulletTimer = 0.0f;
-float playerBulletFireRate = 0.05f;
-float walkSpeed = 5.0f;
-float runSpeed = 12.5f;
-float gravity = 20.0f;
-float jumpStrength = 10.0f;
-float playerHeight = 2.0f;
-float playerRadius = 0.5f;
-
-bool gameOver = false;
-int activeEnemiesCount = 0;
-int activeFriendliesCount = 0;
-int activeTanksCount = 0;
+WORLD_LOCAL Camera camera = { 0 };
+WORLD_LOCAL float playerHealth = 100.0f;
+WORLD_LOCAL bool onGround = true;
+WORLD_LOCAL float jumpVelocity = 0.0f;
+WORLD_LOCAL bool playerGunReady = false;
+
+WORLD_LOCAL bool gameOver = false;
+WORLD_LOCAL int activeEnemiesCount = 0;
+WORLD_LOCAL int activeFriendliesCount = 0;
 
 // Jet specific variables
-float jetAngle = 0.0f;
-float jetRadius = 50.0f; // UPDATED: Jet flies around the whole 100x100 ground
-float jetFlightHeight = 30.0f;
-float jetSpeed = 0.5f;
-float jetDropBombTimer = 0.0f;
-float jetBombDropRate = 5.0f;
 Vector3 jetCenterPoint = {0.0f, 0.0f, 0.0f}; // Remains centered on the ground
-float jetMissileTimer = 0.0f; // New: Timer for jet missile firing
-int jetLockedTargetIndex = -1; // New: Index of the tank the jet is currently targeting (-1 if none)
-
-// --- Sounds ---
-Sound bulletShotSound;
-Sound crateHitSound;
-Sound entityShotSound;
-Sound bombDropSound;
-Sound explosionSound;
-Sound tankShotSound;
-Sound tankBombSound;
-Sound missileLaunchSound;
-Sound missileImpactSound;
 
-// --- Custom Collision Functions ---
-bool CheckCollisionPointBox3D(Vector3 point, Vector3 boxMin, Vector3 boxMax) {
-    return (point.x >= boxMin.x && point.x <= boxMax.x &&
-            point.y >= boxMin.y && point.y <= boxMax.y &&
-            point.z >= boxMin.z && point.z <= boxMax.z);
+// --- Game Config ---
+// Every tuning value the simulation reads at runtime. Pool capacities and model geometry stay
+// #defines because they size arrays and meshes. Each world owns a copy, so the batch runner can
+// sweep any field, and a config file can override the defaults ("key = value" lines).
+typedef struct {
+    // Player
+    float walkSpeed;
+    float runSpeed;
+    float gravity;
+    float jumpStrength;
+    float playerHeight;
+    float playerRadius;
+    float playerFireRate;        // Seconds between player shots
+    float playerHitScan;         // Non-zero resolves player shots instantly by ray cast instead of firing bullets
+    float bulletSpeed;
+    float bulletMass;
+    // Combat entities
+    float entityBulletSpeed;
+    float entityShootingRange;
+    float entityFireRate;
+    float entityChaseSpeed;
+    // Jet bombs
+    float bombFallSpeed;
+    float bombExplosionRadius;
+    float bombExplosionDuration;
+    // Tanks
+    float tankBulletSpeed;
+    float tankFireRate;
+    float tankBombDropRate;
+    float tankBombFallSpeed;
+    float tankBombExplosionRadius;
+    float tankBombExplosionDuration;
+    // Jet
+    float jetRadius;             // Radius of the jet's orbit around jetCenterPoint
+    float jetFlightHeight;
+    float jetSpeed;              // Orbit angular speed (radians per second)
+    float jetBombDropRate;
+    float missileSpeed;
+    float missileDamage;
+    float jetMissileFireRate;
+    float jetMissileLockOnRange;
+    float jetMissileSalvo;       // Missiles per launch
+    float aircraftCount;         // Fleet size: the jet plus aircraft patrolling random waypoint loops
+    float missileNavigationGain;
+    float missileTurnRate;       // Radians per second
+} GameConfig;
+
+// Thread-local storage needs a constant initializer, so both the defaults and every world start from this
+#define DEFAULT_GAME_CONFIG { \
+    .walkSpeed = 5.0f,                                                  \
+    .runSpeed = 12.5f,                                                  \
+    .gravity = 20.0f,                                                   \
+    .jumpStrength = 10.0f,                                              \
+    .playerHeight = 2.0f,                                               \
+    .playerRadius = 0.5f,                                               \
+    .playerFireRate = 0.05f,                                            \
+    .playerHitScan = 0.0f,                                              \
+    .bulletSpeed = BULLET_SPEED,                                        \
+    .bulletMass = BULLET_MASS,                                          \
+    .entityBulletSpeed = ENTITY_BULLET_SPEED,                           \
+    .entityShootingRange = ENTITY_SHOOTING_RANGE,                       \
+    .entityFireRate = ENTITY_FIRE_RATE,                                 \
+    .entityChaseSpeed = ENTITY_CHASE_SPEED,                             \
+    .bombFallSpeed = BOMB_FALL_SPEED,                                   \
+    .bombExplosionRadius = BOMB_EXPLOSION_RADIUS,                       \
+    .bombExplosionDuration = BOMB_EXPLOSION_DURATION,                   \
+    .tankBulletSpeed = TANK_BULLET_SPEED,                               \
+    .tankFireRate = TANK_FIRE_RATE,                                     \
+    .tankBombDropRate = TANK_BOMB_DROP_RATE,                            \
+    .tankBombFallSpeed = TANK_BOMB_FALL_SPEED,                          \
+    .tankBombExplosionRadius = TANK_BOMB_EXPLOSION_RADIUS,              \
+    .tankBombExplosionDuration = TANK_BOMB_EXPLOSION_DURATION,          \
+    .jetRadius = 50.0f, /* Jet flies around the whole 100x100 ground */ \
+    .jetFlightHeight = 30.0f,                                           \
+    .jetSpeed = 0.5f,                                                   \
+    .jetBombDropRate = 5.0f,                                            \
+    .missileSpeed = MISSILE_SPEED,                                      \
+    .missileDamage = MISSILE_DAMAGE,                                    \
+    .jetMissileFireRate = JET_MISSILE_FIRE_RATE,                        \
+    .jetMissileLockOnRange = JET_MISSILE_LOCK_ON_RANGE,                 \
+    .jetMissileSalvo = JET_MISSILE_SALVO,                               \
+    .aircraftCount = 1.0f,                                              \
+    .missileNavigationGain = MISSILE_NAVIGATION_GAIN,                   \
+    .missileTurnRate = MISSILE_TURN_RATE                                \
 }
 
-bool CheckCollisionBoxes3D(Vector3 box1Min, Vector3 box1Max, Vector3 box2Min, Vector3 box2Max) {
-    return (box1Min.x <= box2Max.x && box1Max.x >= box2Min.x &&
-            box1Min.y <= box2Max.y && box1Max.y >= box2Min.y &&
-            box1Min.z <= box2Max.z && box1Max.z >= box2Min.z);
-}
+const GameConfig defaultConfig = DEFAULT_GAME_CONFIG;
+WORLD_LOCAL GameConfig config = DEFAULT_GAME_CONFIG;
 
-// --- Game Initialization/Reset Function ---
-void ResetGame() {
-    // Reset player
-    playerHealth = 100.0f;
-    // UPDATED: Player position to one side of the 100x100 ground
-    camera.position = (Vector3){ 0.0f, 1.0f, -45.0f };
-    camera.target = (Vector3){ 0.0f, 1.0f, -44.0f }; // Look slightly forward
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    jumpVelocity = 0.0f;
-    onGround = true;
-    gameOver = false;
-    DisableCursor();
+// Config file keys (also the names accepted by the batch runner's --param)
+typedef struct {
+    const char *name;
+    size_t offset;
+} GameConfigField;
+
+const GameConfigField gameConfigFields[] = {
+    { "walk_speed", offsetof(GameConfig, walkSpeed) },
+    { "run_speed", offsetof(GameConfig, runSpeed) },
+    { "gravity", offsetof(GameConfig, gravity) },
+    { "jump_strength", offsetof(GameConfig, jumpStrength) },
+    { "player_height", offsetof(GameConfig, playerHeight) },
+    { "player_radius", offsetof(GameConfig, playerRadius) },
+    { "player_fire_rate", offsetof(GameConfig, playerFireRate) },
+    { "player_hit_scan", offsetof(GameConfig, playerHitScan) },
+    { "bullet_speed", offsetof(GameConfig, bulletSpeed) },
+    { "bullet_mass", offsetof(GameConfig, bulletMass) },
+    { "entity_bullet_speed", offsetof(GameConfig, entityBulletSpeed) },
+    { "entity_shooting_range", offsetof(GameConfig, entityShootingRange) },
+    { "entity_fire_rate", offsetof(GameConfig, entityFireRate) },
+    { "entity_chase_speed", offsetof(GameConfig, entityChaseSpeed) },
+    { "bomb_fall_speed", offsetof(GameConfig, bombFallSpeed) },
+    { "bomb_explosion_radius", offsetof(GameConfig, bombExplosionRadius) },
+    { "bomb_explosion_duration", offsetof(GameConfig, bombExplosionDuration) },
+    { "tank_bullet_speed", offsetof(GameConfig, tankBulletSpeed) },
+    { "tank_fire_rate", offsetof(GameConfig, tankFireRate) },
+    { "tank_bomb_drop_rate", offsetof(GameConfig, tankBombDropRate) },
+    { "tank_bomb_fall_speed", offsetof(GameConfig, tankBombFallSpeed) },
+    { "tank_bomb_explosion_radius", offsetof(GameConfig, tankBombExplosionRadius) },
+    { "tank_bomb_explosion_duration", offsetof(GameConfig, tankBombExplosionDuration) },
+    { "jet_radius", offsetof(GameConfig, jetRadius) },
+    { "jet_flight_height", offsetof(GameConfig, jetFlightHeight) },
+    { "jet_speed", offsetof(GameConfig, jetSpeed) },
+    { "jet_bomb_drop_rate", offsetof(GameConfig, jetBombDropRate) },
+    { "missile_speed", offsetof(GameConfig, missileSpeed) },
+    { "missile_damage", offsetof(GameConfig, missileDamage) },
+    { "jet_missile_fire_rate", offsetof(GameConfig, jetMissileFireRate) },
+    { "jet_missile_lock_on_range", offsetof(GameConfig, jetMissileLockOnRange) },
+    { "jet_missile_salvo", offsetof(GameConfig, jetMissileSalvo) },
+    { "aircraft_count", offsetof(GameConfig, aircraftCount) },
+    { "missile_navigation_gain", offsetof(GameConfig, missileNavigationGain) },
+    { "missile_turn_rate", offsetof(GameConfig, missileTurnRate) },
+};
+
+#define GAME_CONFIG_FIELD_COUNT ((int)(sizeof(gameConfigFields) / sizeof(gameConfigFields[0])))
+_Static_assert(sizeof(gameConfigFields) / sizeof(gameConfigFields[0]) * sizeof(float) == sizeof(GameConfig), "every GameConfig field needs a config file key");
+
+float *GameConfigValue(GameConfig *cfg, int field) {
+    return (float *)((unsigned char *)cfg + gameConfigFields[field].offset);
+}
 
-    // Reset player bullets
-    for (int i = 0; i < MAX_PLAYER_BULLETS; i++) {
-        playerBullets[i].active = false;
-    }
-    // Reset entity bullets
-    for (int i = 0; i < MAX_ENTITY_BULLETS; i++) {
-        entityBullets[i].active = false;
-    }
-    // Reset regular bombs
-    for (int i = 0; i < MAX_BOMBS; i++) {
-        bombs[i].active = false;
-        bombs[i].exploded = false;
-        bombs[i].explosionTimer = 0.0f;
-    }
-    // Reset tank bullets
-    for (int i = 0; i < MAX_TANK_BULLETS; i++) {
-        tankBullets[i].active = false;
-    }
-    // Reset tank bombs
-    for (int i = 0; i < MAX_TANK_BOMBS; i++) {
-        tankBombs[i].active = false;
-        tankBombs[i].exploded = false;
-        tankBombs[i].explosionTimer = 0.0f;
+int FindGameConfigField(const char *name, size_t nameLength) {
+    for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+        if (strlen(gameConfigFields[f].name) == nameLength && strncmp(name, gameConfigFields[f].name, nameLength) == 0) return f;
     }
-    // Reset missiles
-    for (int i = 0; i < MAX_MISSILES; i++) {
-        missiles[i].active = false;
-        missiles[i].targetTankIndex = -1; // No target
-    }
-
-
-    // Reset combat entities (enemies and friendly forces)
-    activeEnemiesCount = 0;
-    activeFriendliesCount = 0;
-    for (int i = 0; i < MAX_ENTITIES; i++) { // Loop up to new MAX_ENTITIES
-        combatEntities[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        combatEntities[i].mass = 1.0f;
-        combatEntities[i].active = true;
-        combatEntities[i].health = 100.0f;
-        combatEntities[i].shootTimer = 0.0f;
+    return -1;
+}
 
-        // Assign type and spawn position:
-        if (rand() % 10 < 6) { // 6 out of 10 chance for enemy
-            combatEntities[i].type = ENTITY_ENEMY;
-            // UPDATED: Enemies spawn on the positive Z side of the 100x100 ground, spread out
-            combatEntities[i].position = (Vector3){ (float)(rand() % 90 - 45), 1.0f, (float)(rand() % 40 + 10) }; // Z from 10 to 49
-            activeEnemiesCount++;
-        } else {
-            combatEntities[i].type = ENTITY_FRIENDLY;
-            // UPDATED: Friendlies spawn on the negative Z side of the 100x100 ground, spread out
-            combatEntities[i].position = (Vector3){ (float)(rand() % 90 - 45), 1.0f, (float)(rand() % 40 - 50) }; // Z from -50 to -11
-            activeFriendliesCount++;
+// Applies "key = value" lines from fileName on top of *cfg. Blank lines and '#' comments are
+// skipped; unknown keys and malformed lines are reported and ignored.
+bool LoadGameConfig(const char *fileName, GameConfig *cfg) {
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "CONFIG: could not open %s", fileName);
+        return false;
+    }
+    char line[256];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char *cursor = line;
+        while (*cursor == ' ' || *cursor == '\t') cursor++;
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\r' || *cursor == '\0') continue;
+
+        size_t keyLength = strcspn(cursor, " \t=");
+        char *equals = strchr(cursor, '=');
+        int field = FindGameConfigField(cursor, keyLength);
+        char *end = NULL;
+        float value = (equals != NULL) ? strtof(equals + 1, &end) : 0.0f;
+        if (field == -1 || equals == NULL || end == equals + 1) {
+            TraceLog(LOG_WARNING, "CONFIG: %s:%d: ignoring '%.*s'", fileName, lineNumber, (int)strcspn(cursor, "\r\n"), cursor);
+            continue;
         }
+        *GameConfigValue(cfg, field) = value;
     }
+    fclose(file);
+    TraceLog(LOG_INFO, "CONFIG: loaded %s", fileName);
+    return true;
+}
 
-    // Reset crates (5 green, 5 yellow, 10 blue stacked)
-    float crateSize = 1.0f;
-    float halfCrate = crateSize / 2.0f;
-
-    for (int i = 0; i < 10; i++) {
-        crates[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        crates[i].mass = 2.0f;
-        crates[i].active = true;
-        crates[i].color = (i < 5) ? GREEN : YELLOW;
-        crates[i].rotation = QuaternionIdentity();
-        crates[i].angularVelocity = Vector3Zero();
-        crates[i].isPhysicsActive = true;
+// Per-world random stream (rand() is shared between threads and not reproducible per match)
+WORLD_LOCAL unsigned int worldRandomState = 1;
+
+// Seeds are hashed first so that consecutive match seeds give unrelated streams
+void SeedWorldRandom(unsigned int seed) {
+    seed ^= seed >> 16;
+    seed *= 0x7FEB352Du;
+    seed ^= seed >> 15;
+    seed *= 0x846CA68Bu;
+    seed ^= seed >> 16;
+    worldRandomState = (seed != 0) ? seed : 1;
+}
 
-        bool placed = false;
-        int attempts = 0;
-        while (!placed && attempts < 50) {
-            // UPDATED: Random crate positions to cover 100x100 ground
-            Vector3 potentialPos = (Vector3){ (float)(rand() % 90 - 45), halfCrate, (float)(rand() % 90 - 45) };
-            bool overlap = false;
+// xorshift32, returning the same 0..32767 range as rand() on common platforms
+int WorldRand(void) {
+    unsigned int x = worldRandomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worldRandomState = x;
+    return (int)((x >> 16) & 0x7FFF);
+}
 
-            for (int j = 0; j < i; j++) {
-                if (crates[j].active) {
-                    Vector3 box1Min = { potentialPos.x - halfCrate, potentialPos.y - halfCrate, potentialPos.z - halfCrate };
-                    Vector3 box1Max = { potentialPos.x + halfCrate, potentialPos.y + halfCrate, potentialPos.z + halfCrate };
-                    Vector3 box2Min = { crates[j].position.x - halfCrate, crates[j].position.y - halfCrate, crates[j].position.z - halfCrate };
-                    Vector3 box2Max = { crates[j].position.x + halfCrate, crates[j].position.y + halfCrate, crates[j].position.z + halfCrate };
-
-                    if (CheckCollisionBoxes3D(box1Min, box1Max, box2Min, box2Max)) {
-                        overlap = true;
-                        break;
-                    }
-                }
-            }
-            Vector3 playerInitialMin = { camera.position.x - playerRadius, camera.position.y - (playerHeight / 2.0f), camera.position.z - playerRadius };
-            Vector3 playerInitialMax = { camera.position.x + playerRadius, camera.position.y + (playerHeight / 2.0f), camera.position.z + playerRadius };
-            Vector3 potentialCrateMin = { potentialPos.x - halfCrate, potentialPos.y - halfCrate, potentialPos.z - halfCrate };
-            Vector3 potentialCrateMax = { potentialPos.x + halfCrate, potentialPos.y + halfCrate, potentialPos.z + halfCrate };
-            if (CheckCollisionBoxes3D(playerInitialMin, playerInitialMax, potentialCrateMin, potentialCrateMax)) {
-                overlap = true;
-            }
+// --- SPSC Rings ---
+// Lock-free single-producer/single-consumer ring of fixed-size slots, used to hand data between
+// the threads of the pipelined game. The producer owns head and the consumer owns tail; each side
+// reads the other's index with acquire and publishes its own with release, so neither ever blocks.
+// Slots are filled and read in place: BeginWrite/CommitWrite on one side, Peek/Release on the other.
+typedef struct {
+    unsigned char *slots;
+    size_t slotSize;
+    uint32_t capacity;                // Power of two
+    _Alignas(64) atomic_uint head;    // Slots ever written (producer)
+    _Alignas(64) atomic_uint tail;    // Slots ever released (consumer)
+} SpscRing;
+
+bool InitSpscRing(SpscRing *ring, size_t slotSize, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    ring->slots = calloc(capacity, slotSize);
+    ring->slotSize = slotSize;
+    ring->capacity = capacity;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ring->slots != NULL;
+}
 
-            if (!overlap) {
-                crates[i].position = potentialPos;
-                placed = true;
-            }
-            attempts++;
-        }
-        if (!placed) {
-            crates[i].position = (Vector3){ (float)(rand() % 90 - 45), halfCrate, (float)(rand() % 90 - 45) }; // Fallback to new wider random range
-            TraceLog(LOG_WARNING, "Failed to place crate %d without overlap after %d attempts. Placed randomly.", i, attempts);
-        }
-    }
-    // New blue stacked crates
-    // UPDATED: Stacked crates moved to a corner within the new 100x100 bounds
-    Vector3 resetStackBasePosition = { -40.0f, 0.5f, -40.0f };
-    for (int i = 0; i < 10; i++) {
-        crates[10 + i].position = (Vector3){ resetStackBasePosition.x, resetStackBasePosition.y + i * 1.0f, resetStackBasePosition.z };
-        crates[10 + i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        crates[10 + i].mass = 2.0f;
-        crates[10 + i].active = true;
-        crates[10 + i].color = BLUE;
-        crates[10 + i].rotation = QuaternionIdentity();
-        crates[10 + i].angularVelocity = Vector3Zero();
-        crates[10 + i].isPhysicsActive = false;
-    }
+void FreeSpscRing(SpscRing *ring) {
+    free(ring->slots);
+    ring->slots = NULL;
+}
 
-    // Initialize the tanks
-    activeTanksCount = 0;
-    // UPDATED: Tank spawn positions to the positive Z side of the 100x100 ground, for 6 tanks
-    Vector3 tankSpawnPositions[MAX_TANKS] = {
-        { 40.0f, 1.0f, 40.0f },
-        { -40.0f, 1.0f, 40.0f },
-        { 0.0f, 1.0f, 45.0f },
-        { 30.0f, 1.0f, 35.0f }, // New tank 4
-        { -30.0f, 1.0f, 35.0f },// New tank 5
-        { 15.0f, 1.0f, 42.0f }  // New tank 6
-    };
+// Producer: next free slot, or NULL when the consumer has fallen a full ring behind
+void *SpscRingBeginWrite(SpscRing *ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) == ring->capacity) return NULL;
+    return ring->slots + (size_t)(head & (ring->capacity - 1)) * ring->slotSize;
+}
 
-    for (int i = 0; i < MAX_TANKS; i++) { // Loop up to new MAX_TANKS
-        tanks[i].position = tankSpawnPositions[i];
-        tanks[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
-        tanks[i].health = 200.0f; // Tank has more health
-        tanks[i].active = true;
-        tanks[i].bulletShootTimer = 0.0f;
-        tanks[i].bombDropTimer = 0.0f;
-        tanks[i].yawRotation = 0.0f;
-        activeTanksCount++;
-    }
+void SpscRingCommitWrite(SpscRing *ring) {
+    atomic_store_explicit(&ring->head, atomic_load_explicit(&ring->head, memory_order_relaxed) + 1, memory_order_release);
+}
 
-    // Reset jet missile state
-    jetMissileTimer = 0.0f;
-    jetLockedTargetIndex = -1;
+// Consumer: oldest unread slot, or NULL when empty
+const void *SpscRingPeek(SpscRing *ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (atomic_load_explicit(&ring->head, memory_order_acquire) == tail) return NULL;
+    return ring->slots + (size_t)(tail & (ring->capacity - 1)) * ring->slotSize;
 }
 
-int main(void) {
-    // Initialization
-    InitWindow(800, 600, "Battle Force");
-    SetTargetFPS(60);
+void SpscRingRelease(SpscRing *ring) {
+    atomic_store_explicit(&ring->tail, atomic_load_explicit(&ring->tail, memory_order_relaxed) + 1, memory_order_release);
+}
 
-    InitAudioDevice();
+// Unread slots. Exact on either end's own thread, a snapshot anywhere else.
+uint32_t SpscRingDepth(SpscRing *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire) - atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
 
-    // Load sounds
-    bulletShotSound = LoadSound(SOUND_BULLET_PATH);
-    crateHitSound = LoadSound(SOUND_CRATE_HIT_PATH);
-    entityShotSound = LoadSound(SOUND_ENTITY_SHOT_PATH);
-    bombDropSound = LoadSound(SOUND_BOMB_DROP_PATH);
-    explosionSound = LoadSound(SOUND_EXPLOSION_PATH);
-    tankShotSound = LoadSound(SOUND_TANK_SHOT_PATH);
-    tankBombSound = LoadSound(SOUND_TANK_BOMB_PATH);
-    missileLaunchSound = LoadSound(SOUND_MISSILE_LAUNCH_PATH);
-    missileImpactSound = LoadSound(SOUND_MISSILE_IMPACT_PATH);
+bool SpscRingPush(SpscRing *ring, const void *item) {
+    void *slot = SpscRingBeginWrite(ring);
+    if (slot == NULL) return false;
+    memcpy(slot, item, ring->slotSize);
+    SpscRingCommitWrite(ring);
+    return true;
+}
 
-    SetSoundVolume(bulletShotSound, 0.5f);
-    SetSoundVolume(entityShotSound, 0.3f);
-    SetSoundVolume(bombDropSound, 0.8f);
-    SetSoundVolume(explosionSound, 1.0f);
-    SetSoundVolume(tankShotSound, 0.6f);
-    SetSoundVolume(tankBombSound, 0.9f);
-    SetSoundVolume(missileLaunchSound, 0.7f);
-    SetSoundVolume(missileImpactSound, 1.0f);
+bool SpscRingPop(SpscRing *ring, void *item) {
+    const void *slot = SpscRingPeek(ring);
+    if (slot == NULL) return false;
+    memcpy(item, slot, ring->slotSize);
+    SpscRingRelease(ring);
+    return true;
+}
 
-    // Initialize camera properties
-    camera.fovy = 90.0f;
-    camera.projection = CAMERA_PERSPECTIVE;
+// --- Telemetry ---
+// Counters, pool gauges and duration histograms for soak runs. Every thread counts into its own
+// WORLD_LOCAL block with plain increments and adds it into the shared atomic totals every
+// TELEMETRY_FLUSH_EVENTS steps or frames, so the hot paths never touch a shared cache line. The
+// exporter (Telemetry Export below) only ever reads the totals.
+typedef enum {
+    TELEMETRY_STEPS,
+    TELEMETRY_FRAMES_DRAWN,
+    TELEMETRY_CONTACT_PAIRS_TESTED,
+    TELEMETRY_CONTACT_PAIRS_HIT,
+    TELEMETRY_SOUNDS_STARTED,
+    TELEMETRY_SOUNDS_DROPPED,
+    TELEMETRY_PARTICLES_SPAWNED,
+    TELEMETRY_PARTICLES_CULLED,
+    TELEMETRY_RENDER_DRAWS,
+    TELEMETRY_RENDER_STATE_CHANGES,
+    TELEMETRY_CONFIG_RELOADS,
+    TELEMETRY_NET_CLAMPED_COORDINATES,
+    TELEMETRY_TIMER_OVERFLOWS,
+    TELEMETRY_COUNTER_COUNT
+} TelemetryCounter;
 
-    // Load models once at initialization
-    entityModel = LoadModelFromMesh(GenMeshCube(1.0f, 2.0f, 1.0f));
-    crateModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
-    jetModel = LoadModel("resources/models/Jet.glb");
-    bombModel = LoadModelFromMesh(GenMeshSphere(BOMB_RADIUS, 16, 16));
-    tankModel = LoadModel("resources/models/Tank.glb");
-    missileModel = LoadModelFromMesh(GenMeshCylinder(MISSILE_RADIUS, MISSILE_RADIUS * 3.0f, 16)); // Simple cylinder for missile
+typedef enum {
+    TELEMETRY_POOL_COMBAT_ENTITIES,
+    TELEMETRY_POOL_CRATES,
+    TELEMETRY_POOL_TANKS,
+    TELEMETRY_POOL_PLAYER_BULLETS,
+    TELEMETRY_POOL_ENTITY_BULLETS,
+    TELEMETRY_POOL_TANK_BULLETS,
+    TELEMETRY_POOL_BOMBS,
+    TELEMETRY_POOL_TANK_BOMBS,
+    TELEMETRY_POOL_MISSILES,
+    TELEMETRY_POOL_AIRCRAFT,
+    TELEMETRY_POOL_COUNT
+} TelemetryPool;
 
+typedef enum {
+    TELEMETRY_STEP_SECONDS,
+    TELEMETRY_DRAW_SECONDS,
+    TELEMETRY_HISTOGRAM_COUNT
+} TelemetryHistogram;
 
-    srand(time(NULL));
+typedef struct {
+    const char *name; // Exported as battleforce_<name>
+    const char *help;
+} TelemetryMetricInfo;
+
+const TelemetryMetricInfo telemetryCounterInfo[TELEMETRY_COUNTER_COUNT] = {
+    { "simulation_steps_total", "Simulation steps taken" },
+    { "frames_drawn_total", "Worlds drawn by DrawWorld" },
+    { "contact_pairs_tested_total", "Oriented box pairs run through the separating axis test" },
+    { "contact_pairs_hit_total", "Oriented box pairs found touching" },
+    { "sounds_started_total", "Sound voices started" },
+    { "sounds_dropped_total", "Sound events lost to a full audio ring" },
+    { "particles_spawned_total", "Particles spawned by effects" },
+    { "particles_culled_total", "Particles dropped by the per-frame budget or a full pool" },
+    { "render_draws_total", "Instanced draw calls issued for entities, projectiles, aircraft and tanks" },
+    { "render_state_changes_total", "Shader, texture and vertex array binds made for those draws" },
+    { "config_reloads_total", "Edited config files adopted by a running simulation" },
+    { "net_clamped_coordinates_total", "Replicated coordinates outside the int16 range, sent clamped" },
+    { "timer_overflows_total", "Cooldowns and explosions run at once because every timer event was pending" },
+};
+
+const char *telemetryPoolNames[TELEMETRY_POOL_COUNT] = {
+    "combat_entities", "crates", "tanks", "player_bullets", "entity_bullets", "tank_bullets", "bombs", "tank_bombs", "missiles", "aircraft"
+};
+
+const TelemetryMetricInfo telemetryHistogramInfo[TELEMETRY_HISTOGRAM_COUNT] = {
+    { "step_seconds", "Wall time of one simulation step" },
+    { "draw_seconds", "Wall time of one DrawWorld call (command submission, not GPU time)" },
+};
+
+// Upper bounds of the finite buckets, in seconds
+const double telemetryBucketBounds[TELEMETRY_HISTOGRAM_BUCKETS] = { 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1 };
+
+// Process-wide totals. Live gauges move by deltas, so they always hold the sum of the populations
+// the publishing worlds last reported.
+typedef struct {
+    atomic_ullong counters[TELEMETRY_COUNTER_COUNT];
+    atomic_ullong spawnFailures[TELEMETRY_POOL_COUNT];
+    atomic_llong live[TELEMETRY_POOL_COUNT];
+    atomic_int worlds; // Worlds currently publishing pool gauges
+    atomic_ullong buckets[TELEMETRY_HISTOGRAM_COUNT][TELEMETRY_HISTOGRAM_BUCKETS + 1]; // Per bucket, not cumulative; the last is +Inf
+    atomic_ullong sumNanos[TELEMETRY_HISTOGRAM_COUNT];
+} TelemetryTotals;
 
-    ResetGame();
+TelemetryTotals telemetryTotals;
 
-    // Declare these variables ONCE at the top of main to ensure they are always in scope
-    float jetYawRotation = 0.0f;
+// What this thread counted since its last flush
+typedef struct {
+    unsigned long long counters[TELEMETRY_COUNTER_COUNT];
+    unsigned long long spawnFailures[TELEMETRY_POOL_COUNT];
+    unsigned long long buckets[TELEMETRY_HISTOGRAM_COUNT][TELEMETRY_HISTOGRAM_BUCKETS + 1];
+    double sums[TELEMETRY_HISTOGRAM_COUNT];
+    int publishedLive[TELEMETRY_POOL_COUNT]; // This world's share of the live gauges
+    bool publishing;
+    int pendingEvents;
+} TelemetryLocal;
+
+WORLD_LOCAL TelemetryLocal telemetryLocal = { 0 };
+
+void CountTelemetry(TelemetryCounter counter, unsigned long long amount) {
+    telemetryLocal.counters[counter] += amount;
+}
 
-    // Main game loop
-    while (!WindowShouldClose()) {
+// A spawn refused because its pool was full
+void CountSpawnFailure(TelemetryPool pool) {
+    telemetryLocal.spawnFailures[pool]++;
+}
 
-        float deltaTime = GetFrameTime();
+void ObserveTelemetry(TelemetryHistogram histogram, double seconds) {
+    int bucket = 0;
+    while (bucket < TELEMETRY_HISTOGRAM_BUCKETS && seconds > telemetryBucketBounds[bucket]) bucket++;
+    telemetryLocal.buckets[histogram][bucket]++;
+    telemetryLocal.sums[histogram] += seconds;
+}
 
-        if (!gameOver) {
-            // Update camera rotation using Raylib's FPS mode
-            UpdateCamera(&camera, CAMERA_FIRST_PERSON);
+// Adds everything counted since the last flush into the shared totals
+void FlushTelemetry(void) {
+    TelemetryLocal *local = &telemetryLocal;
+    for (int c = 0; c < TELEMETRY_COUNTER_COUNT; c++) {
+        if (local->counters[c] == 0) continue;
+        atomic_fetch_add_explicit(&telemetryTotals.counters[c], local->counters[c], memory_order_relaxed);
+        local->counters[c] = 0;
+    }
+    for (int p = 0; p < TELEMETRY_POOL_COUNT; p++) {
+        if (local->spawnFailures[p] == 0) continue;
+        atomic_fetch_add_explicit(&telemetryTotals.spawnFailures[p], local->spawnFailures[p], memory_order_relaxed);
+        local->spawnFailures[p] = 0;
+    }
+    for (int h = 0; h < TELEMETRY_HISTOGRAM_COUNT; h++) {
+        for (int b = 0; b <= TELEMETRY_HISTOGRAM_BUCKETS; b++) {
+            if (local->buckets[h][b] == 0) continue;
+            atomic_fetch_add_explicit(&telemetryTotals.buckets[h][b], local->buckets[h][b], memory_order_relaxed);
+            local->buckets[h][b] = 0;
+        }
+        if (local->sums[h] > 0.0) {
+            atomic_fetch_add_explicit(&telemetryTotals.sumNanos[h], (unsigned long long)(local->sums[h] * 1.0e9 + 0.5), memory_order_relaxed);
+            local->sums[h] = 0.0;
+        }
+    }
+    local->pendingEvents = 0;
+}
 
-            // Player movement
-            Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
-            Vector3 right = Vector3CrossProduct(forward, camera.up);
-            right.y = 0;
-            right = Vector3Normalize(right);
-
-            Vector3 move = { 0.0f, 0.0f, 0.0f };
-            float currentSpeed = IsKeyDown(KEY_LEFT_SHIFT) ? runSpeed : walkSpeed;
-            if (IsKeyDown(KEY_W)) move = Vector3Add(move, Vector3Scale(forward, currentSpeed * deltaTime));
-            if (IsKeyDown(KEY_S)) move = Vector3Add(move, Vector3Scale(forward, -currentSpeed * deltaTime));
-            if (IsKeyDown(KEY_D)) move = Vector3Add(move, Vector3Scale(right, currentSpeed * deltaTime));
-            if (IsKeyDown(KEY_A)) move = Vector3Add(move, Vector3Scale(right, -currentSpeed * deltaTime));
-
-            Vector3 prevCameraPosition = camera.position;
-            camera.position = Vector3Add(camera.position, move);
-            Vector3 lookDirection = Vector3Normalize(Vector3Subtract(camera.target, prevCameraPosition));
-            camera.target = Vector3Add(camera.position, lookDirection);
-
-            // Jump mechanics
-            if (IsKeyPressed(KEY_SPACE) && onGround) {
-                jumpVelocity = jumpStrength;
-                onGround = false;
-            }
-
-            // Apply gravity and update vertical position
-            jumpVelocity -= gravity * deltaTime;
-            float newY = camera.position.y + jumpVelocity * deltaTime;
-            float playerFeetY = newY - (playerHeight / 2.0f);
-            onGround = false;
-
-            // Player-crate vertical collision (standing on top)
-            for (int i = 0; i < MAX_CRATES; i++) {
-                if (crates[i].active) {
-                    float crateTopY = crates[i].position.y + 0.5f;
-                    bool horizontalOverlap = (camera.position.x + playerRadius > crates[i].position.x - 0.5f &&
-                                              camera.position.x - playerRadius < crates[i].position.x + 0.5f &&
-                                              camera.position.z + playerRadius > crates[i].position.z - 0.5f &&
-                                              camera.position.z - playerRadius < crates[i].position.z + 0.5f);
-
-                    if (horizontalOverlap && jumpVelocity <= 0 && playerFeetY <= crateTopY && (prevCameraPosition.y - (playerHeight / 2.0f)) >= crateTopY) {
-                        newY = crateTopY + (playerHeight / 2.0f);
-                        jumpVelocity = 0.0f;
-                        onGround = true;
-                        // If player lands on a blue crate, activate its physics
-                        if (crates[i].color.r == BLUE.r && crates[i].color.g == BLUE.g && crates[i].color.b == BLUE.b) {
-                             crates[i].isPhysicsActive = true;
-                        }
-                        break;
-                    }
-                }
-            }
+// Moves this world's pool populations into the live gauges, or takes them out again with live false
+void PublishPoolGauges(bool live) {
+    int counts[TELEMETRY_POOL_COUNT] = { combatEntityCount, crateCount, tankCount, playerBulletCount, entityBulletCount, tankBulletCount,
+                                         bombCount, tankBombCount, missileCount, aircraftCount };
+    if (live != telemetryLocal.publishing) atomic_fetch_add_explicit(&telemetryTotals.worlds, live ? 1 : -1, memory_order_relaxed);
+    telemetryLocal.publishing = live;
+    for (int p = 0; p < TELEMETRY_POOL_COUNT; p++) {
+        int target = live ? counts[p] : 0;
+        if (target == telemetryLocal.publishedLive[p]) continue;
+        atomic_fetch_add_explicit(&telemetryTotals.live[p], target - telemetryLocal.publishedLive[p], memory_order_relaxed);
+        telemetryLocal.publishedLive[p] = target;
+    }
+}
 
-            // Ground check
-            if (!onGround && newY <= 1.0f) {
-                newY = 1.0f;
-                jumpVelocity = 0.0f;
-                onGround = true;
-            }
-            camera.position.y = newY;
-            camera.target = Vector3Add(camera.position, lookDirection);
-
-            Vector3 playerMin = { camera.position.x - playerRadius, camera.position.y - (playerHeight / 2.0f), camera.position.z - playerRadius };
-            Vector3 playerMax = { camera.position.x + playerRadius, camera.position.y + (playerHeight / 2.0f), camera.position.z + playerRadius };
-
-            // Update combat entities (chase target and shoot)
-            float chaseSpeed = 3.0f;
-            for (int i = 0; i < MAX_ENTITIES; i++) {
-                if (combatEntities[i].active) {
-                    Vector3 targetPosition = Vector3Zero();
-                    bool hasTarget = false;
-
-                    // Determine target based on entity type
-                    if (combatEntities[i].type == ENTITY_ENEMY) {
-                        // Enemies prioritize player
-                        if (Vector3Distance(combatEntities[i].position, camera.position) < 25.0f) { // Range for player targeting
-                            targetPosition = camera.position;
-                            hasTarget = true;
-                        } else { // Then look for friendly forces
-                            for (int j = 0; j < MAX_ENTITIES; j++) {
-                                if (combatEntities[j].active && combatEntities[j].type == ENTITY_FRIENDLY) {
-                                    if (Vector3Distance(combatEntities[i].position, combatEntities[j].position) < 25.0f) {
-                                        targetPosition = combatEntities[j].position;
-                                        hasTarget = true;
-                                        break;
-                                    }
-                                }
-                            }
-                            // Also target tanks if they are enemies
-                            if (!hasTarget) {
-                                for (int j = 0; j < MAX_TANKS; j++) {
-                                    if (tanks[j].active) { // Tanks are always considered enemies for combat entities
-                                        if (Vector3Distance(combatEntities[i].position, tanks[j].position) < 25.0f) {
-                                            targetPosition = tanks[j].position;
-                                            hasTarget = true;
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    } else { // ENTITY_FRIENDLY
-                        // Friendly forces target enemies
-                        for (int j = 0; j < MAX_ENTITIES; j++) {
-                            if (combatEntities[j].active && combatEntities[j].type == ENTITY_ENEMY) {
-                                if (Vector3Distance(combatEntities[i].position, combatEntities[j].position) < 25.0f) {
-                                    targetPosition = combatEntities[j].position;
-                                    hasTarget = true;
-                                    break;
-                                }
-                            }
-                        }
-                        // Also target tanks if they are enemies
-                        if (!hasTarget) {
-                            for (int j = 0; j < MAX_TANKS; j++) {
-                                if (tanks[j].active) { // Tanks are always considered enemies for friendly entities
-                                    if (Vector3Distance(combatEntities[i].position, tanks[j].position) < 25.0f) {
-                                        targetPosition = tanks[j].position;
-                                        hasTarget = true;
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    if (hasTarget) {
-                        Vector3 directionToTarget = Vector3Normalize(Vector3Subtract(targetPosition, combatEntities[i].position));
-                        Vector3 force = Vector3Scale(directionToTarget, chaseSpeed);
-                        combatEntities[i].velocity = Vector3Add(combatEntities[i].velocity, Vector3Scale(force, deltaTime / combatEntities[i].mass));
-
-                        // Shooting logic
-                        float distanceToTarget = Vector3Distance(combatEntities[i].position, targetPosition);
-                        combatEntities[i].shootTimer += deltaTime;
-
-                        if (distanceToTarget <= ENTITY_SHOOTING_RANGE && combatEntities[i].shootTimer >= ENTITY_FIRE_RATE) {
-                            for (int k = 0; k < MAX_ENTITY_BULLETS; k++) {
-                                if (!entityBullets[k].active) {
-                                    entityBullets[k].position = combatEntities[i].position;
-                                    // Aim slightly higher for player, or at center for other entities
-                                    Vector3 aimTarget = Vector3Equals(targetPosition, camera.position) ? (Vector3){targetPosition.x, targetPosition.y + 0.5f, targetPosition.z} : targetPosition;
-                                    Vector3 bulletDirection = Vector3Normalize(Vector3Subtract(aimTarget, combatEntities[i].position));
-                                    entityBullets[k].velocity = Vector3Scale(bulletDirection, ENTITY_BULLET_SPEED);
-                                    entityBullets[k].active = true;
-                                    entityBullets[k].mass = BULLET_MASS;
-                                    combatEntities[i].shootTimer = 0.0f;
-                                    PlaySound(entityShotSound);
-                                    break;
-                                }
-                            }
-                        }
-                    } else {
-                        // If no target, gradually slow down
-                        combatEntities[i].velocity = Vector3Scale(combatEntities[i].velocity, 0.95f);
-                    }
-
-                    combatEntities[i].position = Vector3Add(combatEntities[i].position, Vector3Scale(combatEntities[i].velocity, deltaTime));
-                    if (combatEntities[i].position.y <= 1.0f) {
-                        combatEntities[i].position.y = 1.0f;
-                        combatEntities[i].velocity.y = 0.0f;
-                    }
-                }
-            }
+// Called by a thread that is done stepping or drawing, so nothing it counted is left behind
+void FinishTelemetry(void) {
+    PublishPoolGauges(false);
+    FlushTelemetry();
+}
 
-            // Update crates
-            for (int i = 0; i < MAX_CRATES; i++) {
-                if (crates[i].active) {
-                    // Only apply physics if isPhysicsActive is true
-                    if (crates[i].isPhysicsActive) {
-                        crates[i].velocity.y -= gravity * deltaTime;
-                        crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.95f);
-
-                        float angle = Vector3Length(crates[i].angularVelocity) * deltaTime;
-                        Vector3 axis = Vector3Normalize(crates[i].angularVelocity);
-                        if (Vector3LengthSqr(crates[i].angularVelocity) > 0.0001f) {
-                            Quaternion frameRotation = QuaternionFromAxisAngle(axis, angle);
-                            crates[i].rotation = QuaternionMultiply(crates[i].rotation, frameRotation);
-                            crates[i].rotation = QuaternionNormalize(crates[i].rotation);
-                        }
-
-                        Vector3 predictedPosition = Vector3Add(crates[i].position, Vector3Scale(crates[i].velocity, deltaTime));
-                        if (predictedPosition.y - 0.5f <= 0.0f) {
-                            if (crates[i].position.y - 0.5f > 0.0f) { // Only bounce if not already on ground
-                                crates[i].velocity.y *= -0.5f; // Simple bounce
-                                crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.5f); // Dampen angular velocity
-                            } else {
-                                crates[i].velocity.y = 0.0f; // Stop vertical movement
-                                crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.5f); // Dampen angular velocity
-                            }
-                            crates[i].position.y = 0.5f; // Snap to ground
-                        } else {
-                            crates[i].position.y = predictedPosition.y;
-                        }
-                        crates[i].position.x = predictedPosition.x;
-                        crates[i].position.z = predictedPosition.z;
-                        crates[i].velocity = Vector3Scale(crates[i].velocity, 0.9f); // Linear damping
-                    } else {
-                        // If physics is NOT active, ensure it stays completely still
-                        crates[i].velocity = Vector3Zero();
-                        crates[i].angularVelocity = Vector3Zero();
-                        crates[i].rotation = QuaternionIdentity();
-                    }
-                }
-            }
+void RecordSimulationStep(double seconds) {
+    CountTelemetry(TELEMETRY_STEPS, 1);
+    ObserveTelemetry(TELEMETRY_STEP_SECONDS, seconds);
+    if (++telemetryLocal.pendingEvents >= TELEMETRY_FLUSH_EVENTS) {
+        PublishPoolGauges(true);
+        FlushTelemetry();
+    }
+}
 
-            // CombatEntity-CombatEntity collisions
-            for (int i = 0; i < MAX_ENTITIES; i++) {
-                if (combatEntities[i].active) {
-                    for (int j = i + 1; j < MAX_ENTITIES; j++) {
-                        if (combatEntities[j].active) {
-                            Vector3 box1Min = { combatEntities[i].position.x - 0.5f, combatEntities[i].position.y - 1.0f, combatEntities[i].position.z - 0.5f };
-                            Vector3 box1Max = { combatEntities[i].position.x + 0.5f, combatEntities[i].position.y + 1.0f, combatEntities[i].position.z + 0.5f };
-                            Vector3 box2Min = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
-                            Vector3 box2Max = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
-                            if (CheckCollisionBoxes3D(box1Min, box1Max, box2Min, box2Max)) {
-                                combatEntities[i].velocity = Vector3Scale(combatEntities[i].velocity, -0.5f);
-                                combatEntities[j].velocity = Vector3Scale(combatEntities[j].velocity, -0.5f);
-                            }
-                        }
-                    }
-                }
-            }
+// The pipelined render thread draws a copy of the simulation's world, so drawing never publishes
+// pool gauges of its own
+void RecordDrawFrame(double seconds) {
+    CountTelemetry(TELEMETRY_FRAMES_DRAWN, 1);
+    ObserveTelemetry(TELEMETRY_DRAW_SECONDS, seconds);
+    if (++telemetryLocal.pendingEvents >= TELEMETRY_FLUSH_EVENTS) FlushTelemetry();
+}
 
-            // Player-crate horizontal collisions
-            for (int i = 0; i < MAX_CRATES; i++) {
-                if (crates[i].active) {
-                    Vector3 crateMin = { crates[i].position.x - 0.5f, crates[i].position.y - 0.5f, crates[i].position.z - 0.5f };
-                    Vector3 crateMax = { crates[i].position.x + 0.5f, crates[i].position.y + 0.5f, crates[i].position.z + 0.5f };
-                    if (CheckCollisionBoxes3D(playerMin, playerMax, crateMin, crateMax)) {
-                        Vector3 pushDir = Vector3Normalize(move);
-                        bool isStandingOnThisCrate = onGround && (fabsf(camera.position.y - (playerHeight / 2.0f) - (crates[i].position.y + 0.5f)) < 0.1f);
-
-                        if (!isStandingOnThisCrate) {
-                            crates[i].velocity = Vector3Add(crates[i].velocity, Vector3Scale(pushDir, currentSpeed / crates[i].mass));
-                            if (!crates[i].isPhysicsActive) {
-                                crates[i].isPhysicsActive = true;
-                            }
-                        }
-                    }
-                }
-            }
+// --- Config Hot Reload ---
+// The interactive game and the server watch their --config file and parse it again on a
+// background thread whenever it is saved. Each parsed config goes into a fresh heap block whose
+// pointer is swapped into pending. At the start of a tick the simulation exchanges pending for
+// NULL and copies the values into its own config, so the kernel keeps reading plain floats and a
+// tick without a reload costs one relaxed load. The pointer changes hands with the block, so
+// neither side ever frees memory the other can still read. On Linux the watcher sleeps in
+// inotify on the file's directory, because editors often save by renaming a temporary file over
+// the original. Elsewhere it polls the modification time.
+typedef struct {
+    char fileName[256];
+    GameConfig base;               // Defaults and command line; the file is applied on top of these
+    GameConfig current;            // Last config published, for the change log (watcher thread only)
+    _Atomic(GameConfig *) pending; // Parsed but not yet adopted by the simulation
+    atomic_bool quit;
+    pthread_t thread;
+    bool running;
+} ConfigWatcher;
+
+ConfigWatcher configWatcher = { 0 };
+
+// Parses the file on top of the base config and publishes it when any value changed. A config the
+// simulation has not adopted yet is replaced, since only the newest one matters.
+void ReloadWatchedConfig(ConfigWatcher *watcher) {
+    GameConfig *next = malloc(sizeof(GameConfig));
+    if (next == NULL) return;
+    *next = watcher->base;
+    if (!LoadGameConfig(watcher->fileName, next)) { // Mid-save or deleted: keep the last good config
+        free(next);
+        return;
+    }
+    int changed = 0;
+    for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+        float before = *GameConfigValue(&watcher->current, f), after = *GameConfigValue(next, f);
+        if (before == after) continue;
+        TraceLog(LOG_INFO, "CONFIG: %s %g -> %g", gameConfigFields[f].name, before, after);
+        changed++;
+    }
+    if (changed == 0) {
+        free(next);
+        return;
+    }
+    watcher->current = *next;
+    free(atomic_exchange_explicit(&watcher->pending, next, memory_order_acq_rel));
+}
 
-            // Crate-crate collisions (horizontal only)
-            for (int i = 0; i < MAX_CRATES; i++) {
-                if (crates[i].active) {
-                    for (int j = i + 1; j < MAX_CRATES; j++) {
-                        if (crates[j].active) {
-                            Vector3 box1Min = { crates[i].position.x - 0.5f, crates[i].position.y - 0.5f, crates[i].position.z - 0.5f };
-                            Vector3 box1Max = { crates[i].position.x + 0.5f, crates[i].position.y + 0.5f, crates[i].position.z + 0.5f };
-                            Vector3 box2Min = { crates[j].position.x - 0.5f, crates[j].position.y - 0.5f, crates[j].position.z - 0.5f };
-                            Vector3 box2Max = { crates[j].position.x + 0.5f, crates[j].position.y + 0.5f, crates[j].position.z + 0.5f };
-                            if (CheckCollisionBoxes3D(box1Min, box1Max, box2Min, box2Max)) {
-                                crates[i].isPhysicsActive = true;
-                                crates[j].isPhysicsActive = true;
-
-                                Vector3 collisionNormal = Vector3Normalize(Vector3Subtract(crates[i].position, crates[j].position));
-                                if (fabsf(collisionNormal.y) < 0.9f && Vector3LengthSqr(collisionNormal) > 0.001f) {
-                                    collisionNormal.y = 0;
-                                    collisionNormal = Vector3Normalize(collisionNormal);
-                                    crates[i].velocity = Vector3Add(crates[i].velocity, Vector3Scale(collisionNormal, 0.5f));
-                                    crates[j].velocity = Vector3Subtract(crates[j].velocity, Vector3Scale(collisionNormal, 0.5f));
-                                }
-
-                                if (crates[i].position.y > crates[j].position.y && crates[i].velocity.y < 0) {
-                                    float overlap = (crates[i].position.y - 0.5f) - (crates[j].position.y + 0.5f);
-                                    if (overlap < 0) {
-                                        crates[i].position.y -= overlap;
-                                        crates[i].velocity.y *= -0.5f;
-                                        crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.5f);
-                                    }
-                                } else if (crates[j].position.y > crates[i].position.y && crates[j].velocity.y < 0) {
-                                    float overlap = (crates[j].position.y - 0.5f) - (crates[i].position.y + 0.5f);
-                                    if (overlap < 0) {
-                                        crates[j].position.y -= overlap;
-                                        crates[j].velocity.y *= -0.5f;
-                                        crates[j].angularVelocity = Vector3Scale(crates[j].angularVelocity, 0.5f);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+// Blocks for up to CONFIG_WATCH_POLL_SECONDS; true when the watched file may have changed
+bool WaitForConfigChange(ConfigWatcher *watcher, int notify, long *modified) {
+#ifdef __linux__
+    if (notify >= 0) {
+        struct pollfd waiter = { notify, POLLIN, 0 };
+        if (poll(&waiter, 1, (int)(CONFIG_WATCH_POLL_SECONDS * 1000.0)) <= 0) return false;
+        const char *slash = strrchr(watcher->fileName, '/');
+        const char *baseName = (slash != NULL) ? slash + 1 : watcher->fileName;
+        bool changed = false;
+        char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t length;
+        while ((length = read(notify, events, sizeof(events))) > 0) {
+            for (char *cursor = events; cursor < events + length;) {
+                const struct inotify_event *event = (const struct inotify_event *)cursor;
+                if (event->len > 0 && strcmp(event->name, baseName) == 0) changed = true;
+                cursor += sizeof(struct inotify_event) + event->len;
             }
+        }
+        return changed;
+    }
+#endif
+    SleepSeconds(CONFIG_WATCH_POLL_SECONDS);
+    long now = GetFileModTime(watcher->fileName);
+    if (now == *modified) return false;
+    *modified = now;
+    return true;
+}
 
-            // Player Shooting
-            playerBulletTimer += deltaTime;
-            if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-                if (playerBulletTimer >= playerBulletFireRate) {
-                    for (int i = 0; i < MAX_PLAYER_BULLETS; i++) {
-                        if (!playerBullets[i].active) {
-                            playerBullets[i].position = camera.position;
-                            playerBullets[i].velocity = Vector3Scale(Vector3Normalize(Vector3Subtract(camera.target, camera.position)), BULLET_SPEED);
-                            playerBullets[i].active = true;
-                            playerBullets[i].mass = BULLET_MASS;
-                            playerBulletTimer = 0.0f;
-                            PlaySound(bulletShotSound);
-                            break;
-                        }
-                    }
-                }
-            }
+void *ConfigWatcherThread(void *argument) {
+    ConfigWatcher *watcher = argument;
+    int notify = -1;
+#ifdef __linux__
+    const char *slash = strrchr(watcher->fileName, '/');
+    char directory[sizeof(watcher->fileName)];
+    if (slash != NULL) snprintf(directory, sizeof(directory), "%.*s", (int)(slash - watcher->fileName) + 1, watcher->fileName);
+    else snprintf(directory, sizeof(directory), ".");
+    notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify >= 0 && inotify_add_watch(notify, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(notify);
+        notify = -1;
+    }
+    if (notify < 0) TraceLog(LOG_WARNING, "CONFIG: cannot watch %s, polling %s instead", directory, watcher->fileName);
+#endif
+    long modified = GetFileModTime(watcher->fileName);
+    while (!atomic_load(&watcher->quit)) {
+        if (WaitForConfigChange(watcher, notify, &modified)) ReloadWatchedConfig(watcher);
+    }
+#ifdef __linux__
+    if (notify >= 0) close(notify);
+#endif
+    return NULL;
+}
 
-            // Update player bullets
-            for (int i = 0; i < MAX_PLAYER_BULLETS; i++) {
-                if (playerBullets[i].active) {
-                    playerBullets[i].velocity.y -= gravity * deltaTime;
-                    playerBullets[i].position = Vector3Add(playerBullets[i].position, Vector3Scale(playerBullets[i].velocity, deltaTime));
-                    if (Vector3Length(playerBullets[i].position) > 100.0f || playerBullets[i].position.y < -5.0f) {
-                        playerBullets[i].active = false;
-                    }
-                }
-            }
+// base is the config before fileName was applied, loaded the config after; later saves of the
+// file are applied on top of base again, so a deleted key returns to its default
+bool StartConfigWatcher(ConfigWatcher *watcher, const char *fileName, const GameConfig *base, const GameConfig *loaded) {
+#ifdef BAKED_CONFIG
+    TraceLog(LOG_WARNING, "CONFIG: built with BAKED_CONFIG, not watching %s", fileName); // The kernel never reads config
+    (void)watcher; (void)base; (void)loaded;
+    return false;
+#else
+    snprintf(watcher->fileName, sizeof(watcher->fileName), "%s", fileName);
+    watcher->base = *base;
+    watcher->current = *loaded;
+    atomic_init(&watcher->pending, NULL);
+    atomic_init(&watcher->quit, false);
+    watcher->running = pthread_create(&watcher->thread, NULL, ConfigWatcherThread, watcher) == 0;
+    if (!watcher->running) TraceLog(LOG_WARNING, "CONFIG: could not start the watcher for %s", fileName);
+    else TraceLog(LOG_INFO, "CONFIG: watching %s for changes", fileName);
+    return watcher->running;
+#endif
+}
 
-            // Update entity bullets (from both enemies and friendly forces)
-            for (int i = 0; i < MAX_ENTITY_BULLETS; i++) {
-                if (entityBullets[i].active) {
-                    entityBullets[i].velocity.y -= gravity * deltaTime;
-                    entityBullets[i].position = Vector3Add(entityBullets[i].position, Vector3Scale(entityBullets[i].velocity, deltaTime));
-                    if (Vector3Length(entityBullets[i].position) > 100.0f || entityBullets[i].position.y < 0.0f) {
-                        entityBullets[i].active = false;
-                    }
-                }
-            }
+void StopConfigWatcher(ConfigWatcher *watcher) {
+    if (!watcher->running) return;
+    atomic_store(&watcher->quit, true);
+    pthread_join(watcher->thread, NULL);
+    free(atomic_exchange(&watcher->pending, NULL));
+    watcher->running = false;
+}
 
-            // Update tank bullets
-            for (int i = 0; i < MAX_TANK_BULLETS; i++) {
-                if (tankBullets[i].active) {
-                    tankBullets[i].velocity.y -= gravity * deltaTime; // Apply gravity to tank bullets
-                    tankBullets[i].position = Vector3Add(tankBullets[i].position, Vector3Scale(tankBullets[i].velocity, deltaTime));
-                    if (Vector3Length(tankBullets[i].position) > 100.0f || tankBullets[i].position.y < 0.0f) {
-                        tankBullets[i].active = false;
-                    }
-                }
-            }
+// Called by the simulation between ticks: takes the newest reloaded config, if any, into target
+bool AdoptWatchedConfig(ConfigWatcher *watcher, GameConfig *target) {
+    if (atomic_load_explicit(&watcher->pending, memory_order_relaxed) == NULL) return false;
+    GameConfig *next = atomic_exchange_explicit(&watcher->pending, NULL, memory_order_acquire);
+    if (next == NULL) return false;
+    *target = *next;
+    free(next);
+    CountTelemetry(TELEMETRY_CONFIG_RELOADS, 1);
+    return true;
+}
 
-            // Player Bullet-combat entity collisions
-            for (int i = 0; i < MAX_PLAYER_BULLETS; i++) {
-                if (playerBullets[i].active) {
-                    for (int j = 0; j < MAX_ENTITIES; j++) {
-                        if (combatEntities[j].active) {
-                            Vector3 boxMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
-                            Vector3 boxMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
-                            if (CheckCollisionPointBox3D(playerBullets[i].position, boxMin, boxMax)) {
-                                playerBullets[i].active = false;
-                                combatEntities[j].health -= 25.0f;
-                                if (combatEntities[j].health <= 0) {
-                                    combatEntities[j].active = false;
-                                    if (combatEntities[j].type == ENTITY_ENEMY) {
-                                        activeEnemiesCount--;
-                                    } else {
-                                        activeFriendliesCount--;
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                    }
-                    // Player Bullet-tank collision
-                    for (int j = 0; j < MAX_TANKS; j++) {
-                        if (tanks[j].active) {
-                             // Adjust tank hitbox based on new scale
-                             Vector3 tankMin = { tanks[j].position.x - (1.5f * TANK_SCALE_FACTOR), tanks[j].position.y, tanks[j].position.z - (2.5f * TANK_SCALE_FACTOR) };
-                             Vector3 tankMax = { tanks[j].position.x + (1.5f * TANK_SCALE_FACTOR), tanks[j].position.y + (1.5f * TANK_SCALE_FACTOR), tanks[j].position.z + (2.5f * TANK_SCALE_FACTOR) };
-                            if (CheckCollisionPointBox3D(playerBullets[i].position, tankMin, tankMax)) {
-                                playerBullets[i].active = false;
-                                tanks[j].health -= 15.0f; // Player bullets do less damage to tank
-                                if (tanks[j].health <= 0) {
-                                    tanks[j].active = false;
-                                    activeTanksCount--;
-                                }
-                                break; // Bullet hit a tank, stop checking
-                            }
-                        }
-                    }
-                }
-            }
+// --- Sounds ---
+Sound bulletShotSound;
+Sound crateHitSound;
+Sound entityShotSound;
+Sound bombDropSound;
+Sound explosionSound;
+Sound tankShotSound;
+Sound tankBombSound;
+Sound missileLaunchSound;
+Sound missileImpactSound;
+bool audioEnabled = false; // Only the interactive game loads sounds; headless worlds stay silent
 
-            // Player Bullet-crate collisions
-            for (int i = 0; i < MAX_PLAYER_BULLETS; i++) {
-                if (playerBullets[i].active) {
-                    for (int j = 0; j < MAX_CRATES; j++) {
-                        if (crates[j].active) {
-                            Vector3 boxMin = { crates[j].position.x - 0.5f, crates[j].position.y - 0.5f, crates[j].position.z - 0.5f };
-                            Vector3 boxMax = { crates[j].position.x + 0.5f, crates[j].position.y + 0.5f, crates[j].position.z + 0.5f };
-                            if (CheckCollisionPointBox3D(playerBullets[i].position, boxMin, boxMax)) {
-                                playerBullets[i].active = false;
-                                Vector3 bulletDir = Vector3Normalize(playerBullets[i].velocity);
-                                float impulseMagnitude = (playerBullets[i].mass * Vector3Length(playerBullets[i].velocity));
-                                crates[j].velocity = Vector3Add(crates[j].velocity, Vector3Scale(bulletDir, impulseMagnitude / crates[j].mass));
-
-                                Vector3 impactPoint = playerBullets[i].position;
-                                Vector3 r = Vector3Subtract(impactPoint, crates[j].position);
-                                Vector3 forceVector = Vector3Scale(bulletDir, impulseMagnitude);
-                                Vector3 torque = Vector3CrossProduct(r, forceVector);
-
-                                float inverseInertia = 1.0f / crates[j].mass;
-                                crates[j].angularVelocity = Vector3Add(crates[j].angularVelocity, Vector3Scale(torque, inverseInertia * 0.1f));
-
-                                crates[j].isPhysicsActive = true;
-
-                                float distance = Vector3Distance(camera.position, crates[j].position);
-                                float maxDistance = 30.0f;
-                                float attenuatedVolume = 1.0f - (distance / maxDistance);
-                                if (attenuatedVolume < 0.0f) attenuatedVolume = 0.0f;
-                                SetSoundVolume(crateHitSound, attenuatedVolume * 0.7f);
-
-                                Vector3 relativePos = Vector3Subtract(crates[j].position, camera.position);
-                                Vector3 cameraRight = Vector3CrossProduct(Vector3Normalize(Vector3Subtract(camera.target, camera.position)), camera.up);
-                                float pan = Vector3DotProduct(relativePos, cameraRight) / maxDistance;
-                                pan = Clamp(pan, -1.0f, 1.0f);
-                                SetSoundPan(crateHitSound, pan);
-                                PlaySound(crateHitSound);
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+// A sound the simulation wants played. On the pipelined simulation thread these go through
+// soundEventRing to the audio thread instead of calling into the audio device directly.
+typedef struct {
+    Sound sound;
+    bool positional;   // Apply volume and pan before playing
+    float volume;
+    float pan;
+    double queuedTime; // WallClockSeconds() when the simulation emitted it
+} SoundEvent;
+
+WORLD_LOCAL SpscRing *soundEventRing = NULL;
+WORLD_LOCAL int soundEventsDropped = 0; // Events lost to a full ring
+
+void PlaySoundEvent(const SoundEvent *event) {
+    if (soundEventRing != NULL) {
+        if (!SpscRingPush(soundEventRing, event)) {
+            soundEventsDropped++;
+            CountTelemetry(TELEMETRY_SOUNDS_DROPPED, 1);
+        }
+        return;
+    }
+    if (event->positional) {
+        SetSoundVolume(event->sound, event->volume);
+        SetSoundPan(event->sound, event->pan);
+    }
+    PlaySound(event->sound);
+    CountTelemetry(TELEMETRY_SOUNDS_STARTED, 1);
+}
 
-            // Entity Bullet-player and Entity Bullet-combat entity collisions
-            for (int i = 0; i < MAX_ENTITY_BULLETS; i++) {
-                if (entityBullets[i].active) {
-                    Vector3 bulletMin = { entityBullets[i].position.x - 0.1f, entityBullets[i].position.y - 0.1f, entityBullets[i].position.z - 0.1f };
-                    Vector3 bulletMax = { entityBullets[i].position.x + 0.1f, entityBullets[i].position.y + 0.1f, entityBullets[i].position.z + 0.1f };
-
-                    // Collision with player
-                    if (CheckCollisionBoxes3D(playerMin, playerMax, bulletMin, bulletMax)) {
-                        entityBullets[i].active = false;
-                        playerHealth -= 10.0f;
-                        if (playerHealth <= 0) {
-                            playerHealth = 0;
-                            gameOver = true;
-                            EnableCursor();
-                        }
-                        continue; // Bullet hit player, no need to check other entities
-                    }
-
-                    // Collision with other combat entities
-                    for (int j = 0; j < MAX_ENTITIES; j++) {
-                        if (combatEntities[j].active) {
-                            Vector3 entityBoxMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
-                            Vector3 entityBoxMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
-                            if (CheckCollisionBoxes3D(entityBoxMin, entityBoxMax, bulletMin, bulletMax)) {
-                                entityBullets[i].active = false;
-                                combatEntities[j].health -= 10.0f; // Damage from entity bullets
-                                if (combatEntities[j].health <= 0) {
-                                    combatEntities[j].active = false;
-                                    if (combatEntities[j].type == ENTITY_ENEMY) {
-                                        activeEnemiesCount--;
-                                    } else {
-                                        activeFriendliesCount--;
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                    }
-                    // Entity Bullet-tank collision
-                    for (int j = 0; j < MAX_TANKS; j++) {
-                        if (tanks[j].active) {
-                             Vector3 tankMin = { tanks[j].position.x - (1.5f * TANK_SCALE_FACTOR), tanks[j].position.y, tanks[j].position.z - (2.5f * TANK_SCALE_FACTOR) };
-                             Vector3 tankMax = { tanks[j].position.x + (1.5f * TANK_SCALE_FACTOR), tanks[j].position.y + (1.5f * TANK_SCALE_FACTOR), tanks[j].position.z + (2.5f * TANK_SCALE_FACTOR) };
-                            if (CheckCollisionBoxes3D(tankMin, tankMax, bulletMin, bulletMax)) {
-                                entityBullets[i].active = false;
-                                tanks[j].health -= 5.0f; // Smaller damage from entity bullets
-                                if (tanks[j].health <= 0) {
-                                    tanks[j].active = false;
-                                    activeTanksCount--;
-                                }
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+void PlayGameSound(Sound sound) {
+    if (!audioEnabled) return;
+    SoundEvent event = { sound, false, 1.0f, 0.0f, WallClockSeconds() };
+    PlaySoundEvent(&event);
+}
 
-            // Tank Bullet-player and Tank Bullet-combat entity collisions
-            for (int i = 0; i < MAX_TANK_BULLETS; i++) {
-                if (tankBullets[i].active) {
-                    Vector3 bulletMin = { tankBullets[i].position.x - TANK_BULLET_RADIUS, tankBullets[i].position.y - TANK_BULLET_RADIUS, tankBullets[i].position.z - TANK_BULLET_RADIUS };
-                    Vector3 bulletMax = { tankBullets[i].position.x + TANK_BULLET_RADIUS, tankBullets[i].position.y + TANK_BULLET_RADIUS, tankBullets[i].position.z + TANK_BULLET_RADIUS };
-
-                    // Collision with player
-                    if (CheckCollisionBoxes3D(playerMin, playerMax, bulletMin, bulletMax)) {
-                        tankBullets[i].active = false;
-                        playerHealth -= 20.0f; // Tank bullets do more damage
-                        if (playerHealth <= 0) {
-                            playerHealth = 0;
-                            gameOver = true;
-                            EnableCursor();
-                        }
-                        continue;
-                    }
-
-                    // Collision with combat entities
-                    for (int j = 0; j < MAX_ENTITIES; j++) {
-                        if (combatEntities[j].active) {
-                            Vector3 entityBoxMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
-                            Vector3 entityBoxMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
-                            if (CheckCollisionBoxes3D(entityBoxMin, entityBoxMax, bulletMin, bulletMax)) {
-                                tankBullets[i].active = false;
-                                combatEntities[j].health -= 20.0f; // Tank bullets do more damage to entities
-                                if (combatEntities[j].health <= 0) {
-                                    combatEntities[j].active = false;
-                                    if (combatEntities[j].type == ENTITY_ENEMY) {
-                                        activeEnemiesCount--;
-                                    } else {
-                                        activeFriendliesCount--;
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+void PlayGameSoundAt(Sound sound, float volume, float pan) {
+    if (!audioEnabled) return;
+    SoundEvent event = { sound, true, volume, pan, WallClockSeconds() };
+    PlaySoundEvent(&event);
+}
 
-            // Player-combat entity collisions (melee damage, only from enemies)
-            for (int i = 0; i < MAX_ENTITIES; i++) {
-                if (combatEntities[i].active && combatEntities[i].type == ENTITY_ENEMY) { // Only enemies deal melee damage
-                    Vector3 entityMin = { combatEntities[i].position.x - 0.5f, combatEntities[i].position.y - 1.0f, combatEntities[i].position.z - 0.5f };
-                    Vector3 entityMax = { combatEntities[i].position.x + 0.5f, combatEntities[i].position.y + 1.0f, combatEntities[i].position.z + 0.5f };
-                    if (CheckCollisionBoxes3D(playerMin, playerMax, entityMin, entityMax)) {
-                        playerHealth -= 10.0f * deltaTime;
-                        if (playerHealth <= 0) {
-                            playerHealth = 0;
-                            gameOver = true;
-                            EnableCursor();
-                        }
-                    }
-                }
-            }
+// --- Effects ---
+// Visual feedback the simulation asks for (detonations, impacts, muzzle flashes). Like sounds,
+// effects never feed back into the simulation: headless worlds drop them, the pipelined simulation
+// thread hands them to the render thread through effectEventRing, and otherwise they spawn
+// particles straight away (Particles below).
+typedef enum {
+    EFFECT_EXPLOSION,      // Bomb detonation, scaled by blast radius
+    EFFECT_MISSILE_IMPACT,
+    EFFECT_BULLET_SPARKS,  // Bullet hits on crates and tanks
+    EFFECT_ENTITY_HIT,     // Bullet hits on combat entities
+    EFFECT_MUZZLE_FLASH,
+    EFFECT_KIND_COUNT
+} EffectKind;
 
-            // --- Jet and Bomb Logic ---
-            // Update jet position and rotation
-            jetAngle += jetSpeed * deltaTime;
-            if (jetAngle > 2 * PI) jetAngle -= 2 * PI;
-
-            Vector3 currentJetPosition = {
-                jetCenterPoint.x + jetRadius * cosf(jetAngle),
-                jetFlightHeight,
-                jetCenterPoint.z + jetRadius * sinf(jetAngle)
-            };
-
-            // Calculate the jet's forward direction (still needed for jet orientation)
-            Vector3 nextJetPosition = {
-                jetCenterPoint.x + jetRadius * cosf(jetAngle + 0.01f),
-                jetFlightHeight,
-                jetCenterPoint.z + jetRadius * sinf(jetAngle + 0.01f)
-            };
-            Vector3 jetForward = Vector3Normalize(Vector3Subtract(nextJetPosition, currentJetPosition));
-            jetYawRotation = atan2f(jetForward.x, jetForward.z);
-
-            // Bomb dropping logic: only if there are active enemies
-            jetDropBombTimer += deltaTime;
-            if (activeEnemiesCount > 0 && jetDropBombTimer >= jetBombDropRate) {
-                for (int i = 0; i < MAX_BOMBS; i++) {
-                    if (!bombs[i].active) {
-                        bombs[i].position = currentJetPosition; // Drop bomb from jet's current position
-                        bombs[i].velocity = (Vector3){0.0f, -BOMB_FALL_SPEED, 0.0f};
-                        bombs[i].active = true;
-                        bombs[i].exploded = false;
-                        bombs[i].explosionTimer = 0.0f;
-                        bombs[i].radius = BOMB_RADIUS;
-                        bombs[i].explosion_radius = BOMB_EXPLOSION_RADIUS;
-                        bombs[i].explosion_duration = BOMB_EXPLOSION_DURATION;
-                        PlaySound(bombDropSound);
-                        jetDropBombTimer = 0.0f; // Reset timer
-                        break;
-                    }
-                }
-            }
+typedef struct {
+    uint8_t kind;      // EffectKind
+    Vector3 position;
+    Vector3 direction; // Where the effect throws its particles, zero for all round
+    float scale;       // Particle count multiplier
+} EffectEvent;
 
-            // Update regular bombs
-            for (int i = 0; i < MAX_BOMBS; i++) {
-                if (bombs[i].active) {
-                    bombs[i].velocity.y -= gravity * deltaTime;
-                    bombs[i].position = Vector3Add(bombs[i].position, Vector3Scale(bombs[i].velocity, deltaTime));
-
-                    if (bombs[i].position.y - bombs[i].radius <= 0.0f && !bombs[i].exploded) {
-                        bombs[i].position.y = bombs[i].radius;
-                        bombs[i].velocity = Vector3Zero();
-                        bombs[i].exploded = true;
-                        PlaySound(explosionSound);
-
-                        // Area damage to all combat entities (friendly and enemy)
-                        for (int j = 0; j < MAX_ENTITIES; j++) {
-                            if (combatEntities[j].active) {
-                                float distance = Vector3Distance(bombs[i].position, combatEntities[j].position);
-                                if (distance <= bombs[i].explosion_radius) {
-                                    combatEntities[j].active = false;
-                                    if (combatEntities[j].type == ENTITY_ENEMY) {
-                                        activeEnemiesCount--;
-                                    } else {
-                                        activeFriendliesCount--;
-                                    }
-                                }
-                            }
-                        }
-                        // Damage tanks
-                        for (int j = 0; j < MAX_TANKS; j++) {
-                            if (tanks[j].active) {
-                                float distance = Vector3Distance(bombs[i].position, tanks[j].position);
-                                if (distance <= bombs[i].explosion_radius) {
-                                    tanks[j].health -= 50.0f; // Bombs do significant damage to tanks
-                                    if (tanks[j].health <= 0) {
-                                        tanks[j].active = false;
-                                        activeTanksCount--;
-                                    }
-                                }
-                            }
-                        }
-                        // Also check for player
-                        float distToPlayer = Vector3Distance(bombs[i].position, camera.position);
-                        if (distToPlayer <= bombs[i].explosion_radius) {
-                            playerHealth = 0;
-                            gameOver = true;
-                            EnableCursor();
-                        }
-                    }
-
-                    if (bombs[i].exploded) {
-                        bombs[i].explosionTimer += deltaTime;
-                        if (bombs[i].explosionTimer >= bombs[i].explosion_duration) {
-                            bombs[i].active = false;
-                        }
-                    }
-                }
-            }
-            // --- End Jet and Bomb Logic ---
-
-            // --- Jet Missile Logic ---
-            jetMissileTimer += deltaTime;
-
-            // Find closest tank to lock on
-            float closestTankDistance = FLT_MAX;
-            int potentialTargetIndex = -1;
-            for (int i = 0; i < MAX_TANKS; i++) {
-                if (tanks[i].active) {
-                    float dist = Vector3Distance(currentJetPosition, tanks[i].position);
-                    if (dist < closestTankDistance && dist <= JET_MISSILE_LOCK_ON_RANGE) {
-                        closestTankDistance = dist;
-                        potentialTargetIndex = i;
-                    }
-                }
-            }
-            jetLockedTargetIndex = potentialTargetIndex; // Update the jet's locked target
-
-            // Fire missile if target is locked and timer allows
-            if (jetLockedTargetIndex != -1 && jetMissileTimer >= JET_MISSILE_FIRE_RATE) {
-                for (int i = 0; i < MAX_MISSILES; i++) {
-                    if (!missiles[i].active) {
-                        missiles[i].position = currentJetPosition; // Missile starts from jet's position
-                        missiles[i].velocity = Vector3Scale(jetForward, MISSILE_SPEED); // Initial velocity same as jet's forward
-                        missiles[i].active = true;
-                        missiles[i].targetTankIndex = jetLockedTargetIndex;
-                        missiles[i].speed = MISSILE_SPEED;
-                        missiles[i].damage = MISSILE_DAMAGE;
-                        PlaySound(missileLaunchSound);
-                        jetMissileTimer = 0.0f; // Reset missile fire timer
-                        break;
-                    }
-                }
-            }
+bool effectsEnabled = false; // Only the interactive game draws particles; headless worlds emit nothing
+WORLD_LOCAL SpscRing *effectEventRing = NULL;
 
-            // Update missiles
-            for (int i = 0; i < MAX_MISSILES; i++) {
-                if (missiles[i].active) {
-                    // Apply gravity
-                    missiles[i].velocity.y -= gravity * deltaTime;
-
-                    // Missile guidance: follow the target tank
-                    if (missiles[i].targetTankIndex != -1 && tanks[missiles[i].targetTankIndex].active) {
-                        Vector3 targetPos = tanks[missiles[i].targetTankIndex].position;
-                        Vector3 directionToTarget = Vector3Normalize(Vector3Subtract(targetPos, missiles[i].position));
-                        // Simple proportional navigation: steer towards target
-                        missiles[i].velocity = Vector3Lerp(missiles[i].velocity, Vector3Scale(directionToTarget, missiles[i].speed), 2.0f * deltaTime); // Adjust 2.0f for turning speed
-                    } else {
-                        // If target is destroyed or lost, missile continues straight
-                        missiles[i].targetTankIndex = -1; // Clear target
-                    }
-
-                    missiles[i].position = Vector3Add(missiles[i].position, Vector3Scale(missiles[i].velocity, deltaTime));
-
-                    // Collision detection with tanks
-                    if (missiles[i].targetTankIndex != -1 && tanks[missiles[i].targetTankIndex].active) {
-                        Vector3 tankMin = { tanks[missiles[i].targetTankIndex].position.x - (1.5f * TANK_SCALE_FACTOR), tanks[missiles[i].targetTankIndex].position.y, tanks[missiles[i].targetTankIndex].position.z - (2.5f * TANK_SCALE_FACTOR) };
-                        Vector3 tankMax = { tanks[missiles[i].targetTankIndex].position.x + (1.5f * TANK_SCALE_FACTOR), tanks[missiles[i].targetTankIndex].position.y + (1.5f * TANK_SCALE_FACTOR), tanks[missiles[i].targetTankIndex].position.z + (2.5f * TANK_SCALE_FACTOR) };
-
-                        if (CheckCollisionPointBox3D(missiles[i].position, tankMin, tankMax)) {
-                            tanks[missiles[i].targetTankIndex].health -= missiles[i].damage;
-                            if (tanks[missiles[i].targetTankIndex].health <= 0) {
-                                tanks[missiles[i].targetTankIndex].active = false;
-                                activeTanksCount--;
-                            }
-                            missiles[i].active = false; // Deactivate missile on impact
-                            PlaySound(missileImpactSound);
-                        }
-                    }
-
-                    // Deactivate missile if it goes too far or hits the ground
-                    if (Vector3Length(missiles[i].position) > 150.0f || missiles[i].position.y < 0.0f) {
-                        missiles[i].active = false;
-                    }
-                }
-            }
-            // --- End Jet Missile Logic ---
-
-
-            // --- Tank Logic ---
-            for (int idx = 0; idx < MAX_TANKS; idx++) {
-                if (tanks[idx].active) {
-                    // Tank movement and targeting
-                    Vector3 tankTargetPosition = Vector3Zero();
-                    bool tankHasTarget = false;
-
-                    // Tank prioritizes player
-                    if (Vector3Distance(tanks[idx].position, camera.position) < 35.0f * TANK_SCALE_FACTOR) { // Tank has longer target range, scaled
-                        tankTargetPosition = camera.position;
-                        tankHasTarget = true;
-                    } else { // Then look for friendly forces
-                        for (int j = 0; j < MAX_ENTITIES; j++) {
-                            if (combatEntities[j].active && combatEntities[j].type == ENTITY_FRIENDLY) {
-                                if (Vector3Distance(tanks[idx].position, combatEntities[j].position) < 35.0f * TANK_SCALE_FACTOR) {
-                                    tankTargetPosition = combatEntities[j].position;
-                                    tankHasTarget = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-
-                    if (tankHasTarget) {
-                        Vector3 directionToTankTarget = Vector3Normalize(Vector3Subtract(tankTargetPosition, tanks[idx].position));
-
-                        // Update tank rotation to face target
-                        tanks[idx].yawRotation = atan2f(directionToTankTarget.x, directionToTankTarget.z);
-
-                        // Move tank towards target
-                        float tankMoveSpeed = 2.0f / 3.0f; // Tank movement speed, 1/3 of previous
-                        Vector3 tankForce = Vector3Scale(directionToTankTarget, tankMoveSpeed);
-                        tanks[idx].velocity = Vector3Add(tanks[idx].velocity, Vector3Scale(tankForce, deltaTime));
-                    } else {
-                        // Simple patrolling if no target: move randomly
-                        if (Vector3LengthSqr(tanks[idx].velocity) < 0.1f) { // If tank stopped
-                            tanks[idx].velocity = Vector3Normalize((Vector3){(float)(rand()%20 - 10), 0.0f, (float)(rand()%20 - 10)});
-                            tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 1.0f / 3.0f); // Gentle patrol speed, 1/3 of previous
-                        }
-                        tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 0.98f); // Dampen velocity
-                        tanks[idx].yawRotation = atan2f(tanks[idx].velocity.x, tanks[idx].velocity.z); // Adjust rotation based on movement
-                    }
-
-                    // Apply gravity to tanks
-                    tanks[idx].velocity.y -= gravity * deltaTime;
-                    tanks[idx].position = Vector3Add(tanks[idx].position, Vector3Scale(tanks[idx].velocity, deltaTime));
-
-                    // Ground collision for tanks
-                    if (tanks[idx].position.y < 1.0f) {
-                        tanks[idx].position.y = 1.0f;
-                        tanks[idx].velocity.y = 0.0f; // Stop vertical movement
-                        // Add a slight damping to horizontal velocity when hitting ground
-                        tanks[idx].velocity.x *= 0.9f;
-                        tanks[idx].velocity.z *= 0.9f;
-                    }
-
-                    // Tank-Crate collisions
-                    Vector3 tankMin = { tanks[idx].position.x - (1.5f * TANK_SCALE_FACTOR), tanks[idx].position.y, tanks[idx].position.z - (2.5f * TANK_SCALE_FACTOR) };
-                    Vector3 tankMax = { tanks[idx].position.x + (1.5f * TANK_SCALE_FACTOR), tanks[idx].position.y + (1.5f * TANK_SCALE_FACTOR), tanks[idx].position.z + (2.5f * TANK_SCALE_FACTOR) };
-
-                    for (int j = 0; j < MAX_CRATES; j++) {
-                        if (crates[j].active) {
-                            Vector3 crateMin = { crates[j].position.x - 0.5f, crates[j].position.y - 0.5f, crates[j].position.z - 0.5f };
-                            Vector3 crateMax = { crates[j].position.x + 0.5f, crates[j].position.y + 0.5f, crates[j].position.z + 0.5f };
-
-                            if (CheckCollisionBoxes3D(tankMin, tankMax, crateMin, crateMax)) {
-                                // Simple push effect
-                                Vector3 pushDirection = Vector3Normalize(Vector3Subtract(crates[j].position, tanks[idx].position));
-                                // Ensure push is primarily horizontal
-                                pushDirection.y = 0.0f;
-                                pushDirection = Vector3Normalize(pushDirection);
-
-                                float pushStrength = 0.5f; // How hard tank pushes crate
-                                crates[j].velocity = Vector3Add(crates[j].velocity, Vector3Scale(pushDirection, pushStrength));
-                                crates[j].isPhysicsActive = true; // Activate physics on pushed crate
-
-                                // Also push the tank back slightly to prevent sticking
-                                tanks[idx].position = Vector3Subtract(tanks[idx].position, Vector3Scale(pushDirection, 0.1f));
-                                tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 0.5f); // Dampen tank velocity
-                            }
-                        }
-                    }
-
-                    // Tank-CombatEntity collisions
-                    for (int j = 0; j < MAX_ENTITIES; j++) {
-                        if (combatEntities[j].active) {
-                            Vector3 entityMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
-                            Vector3 entityMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
-
-                            if (CheckCollisionBoxes3D(tankMin, tankMax, entityMin, entityMax)) {
-                                Vector3 pushDirection = Vector3Normalize(Vector3Subtract(combatEntities[j].position, tanks[idx].position));
-                                pushDirection.y = 0.0f;
-                                pushDirection = Vector3Normalize(pushDirection);
-
-                                float pushStrength = 1.0f; // How hard tank pushes entity
-                                combatEntities[j].velocity = Vector3Add(combatEntities[j].velocity, Vector3Scale(pushDirection, pushStrength));
-
-                                // Apply damage to combat entity
-                                combatEntities[j].health -= 5.0f * deltaTime; // Continuous damage while colliding
-                                if (combatEntities[j].health <= 0) {
-                                    combatEntities[j].active = false;
-                                    if (combatEntities[j].type == ENTITY_ENEMY) {
-                                        activeEnemiesCount--;
-                                    } else {
-                                        activeFriendliesCount--;
-                                    }
-                                }
-                                // Push tank back slightly too
-                                tanks[idx].position = Vector3Subtract(tanks[idx].position, Vector3Scale(pushDirection, 0.05f));
-                                tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 0.8f); // Dampen tank velocity
-                            }
-                        }
-                    }
-
-                    // Tank-Tank collisions (only check with tanks with higher index to avoid double-checking)
-                    for (int j = idx + 1; j < MAX_TANKS; j++) {
-                        if (tanks[j].active) {
-                            Vector3 otherTankMin = { tanks[j].position.x - (1.5f * TANK_SCALE_FACTOR), tanks[j].position.y, tanks[j].position.z - (2.5f * TANK_SCALE_FACTOR) };
-                            Vector3 otherTankMax = { tanks[j].position.x + (1.5f * TANK_SCALE_FACTOR), tanks[j].position.y + (1.5f * TANK_SCALE_FACTOR), tanks[j].position.z + (2.5f * TANK_SCALE_FACTOR) };
-
-                            if (CheckCollisionBoxes3D(tankMin, tankMax, otherTankMin, otherTankMax)) {
-                                Vector3 collisionAxis = Vector3Normalize(Vector3Subtract(tanks[idx].position, tanks[j].position));
-                                collisionAxis.y = 0.0f; // Only resolve horizontal collision
-                                collisionAxis = Vector3Normalize(collisionAxis);
-
-                                // Simple repulsion
-                                float repulsionStrength = 0.2f;
-                                tanks[idx].velocity = Vector3Add(tanks[idx].velocity, Vector3Scale(collisionAxis, repulsionStrength));
-                                tanks[j].velocity = Vector3Subtract(tanks[j].velocity, Vector3Scale(collisionAxis, repulsionStrength));
-
-                                // Separate positions slightly to prevent sticking
-                                tanks[idx].position = Vector3Add(tanks[idx].position, Vector3Scale(collisionAxis, 0.05f));
-                                tanks[j].position = Vector3Subtract(tanks[j].position, Vector3Scale(collisionAxis, 0.05f));
-                            }
-                        }
-                    }
-
-                    // Tank bullet shooting
-                    tanks[idx].bulletShootTimer += deltaTime;
-                    if (tankHasTarget && Vector3Distance(tanks[idx].position, tankTargetPosition) < 30.0f * TANK_SCALE_FACTOR && tanks[idx].bulletShootTimer >= TANK_FIRE_RATE) {
-                        for (int i = 0; i < MAX_TANK_BULLETS; i++) {
-                            if (!tankBullets[i].active) {
-                                tankBullets[i].position = (Vector3){tanks[idx].position.x, tanks[idx].position.y + (1.0f * TANK_SCALE_FACTOR), tanks[idx].position.z}; // Bullet originates higher, scaled
-                                Vector3 aimTarget = Vector3Equals(tankTargetPosition, camera.position) ? (Vector3){tankTargetPosition.x, tankTargetPosition.y + 0.5f, tankTargetPosition.z} : tankTargetPosition;
-                                Vector3 bulletDirection = Vector3Normalize(Vector3Subtract(aimTarget, tankBullets[i].position));
-                                tankBullets[i].velocity = Vector3Scale(bulletDirection, TANK_BULLET_SPEED);
-                                tankBullets[i].active = true;
-                                tankBullets[i].mass = BULLET_MASS * 5.0f; // Heavier tank bullets
-                                tanks[idx].bulletShootTimer = 0.0f;
-                                PlaySound(tankShotSound);
-                                break;
-                            }
-                        }
-                    }
-
-                    // Tank bomb dropping
-                    tanks[idx].bombDropTimer += deltaTime;
-                    if (tankHasTarget && tanks[idx].bombDropTimer >= TANK_BOMB_DROP_RATE) {
-                        for (int i = 0; i < MAX_TANK_BOMBS; i++) {
-                            if (!tankBombs[i].active) {
-                                tankBombs[i].position = (Vector3){tanks[idx].position.x, tanks[idx].position.y + (2.0f * TANK_SCALE_FACTOR), tanks[idx].position.z}; // Drop from above tank, scaled
-                                tankBombs[i].velocity = (Vector3){0.0f, -TANK_BOMB_FALL_SPEED, 0.0f};
-                                tankBombs[i].active = true;
-                                tankBombs[i].exploded = false;
-                                tankBombs[i].explosionTimer = 0.0f;
-                                tankBombs[i].radius = TANK_BOMB_RADIUS;
-                                tankBombs[i].explosion_radius = TANK_BOMB_EXPLOSION_RADIUS;
-                                tankBombs[i].explosion_duration = TANK_BOMB_EXPLOSION_DURATION;
-                                PlaySound(tankBombSound);
-                                tanks[idx].bombDropTimer = 0.0f;
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
+void SpawnEffect(const EffectEvent *event);
+
+void EmitEffect(EffectKind kind, Vector3 position, Vector3 direction, float scale) {
+    if (!effectsEnabled) return;
+    EffectEvent event = { (uint8_t)kind, position, direction, scale };
+    if (effectEventRing != NULL) {
+        SpscRingPush(effectEventRing, &event); // A full ring only costs a puff of smoke
+        return;
+    }
+    SpawnEffect(&event);
+}
+
+// --- Custom Collision Functions ---
+bool CheckCollisionPointBox3D(Vector3 point, Vector3 boxMin, Vector3 boxMax) {
+    return (point.x >= boxMin.x && point.x <= boxMax.x &&
+            point.y >= boxMin.y && point.y <= boxMax.y &&
+            point.z >= boxMin.z && point.z <= boxMax.z);
+}
+
+bool CheckCollisionBoxes3D(Vector3 box1Min, Vector3 box1Max, Vector3 box2Min, Vector3 box2Max) {
+    return (box1Min.x <= box2Max.x && box1Max.x >= box2Min.x &&
+            box1Min.y <= box2Max.y && box1Max.y >= box2Min.y &&
+            box1Min.z <= box2Max.z && box1Max.z >= box2Min.z);
+}
+
+float AxisComponent(Vector3 v, int axis) {
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+// Box of any orientation: centre, unit axes in world space and the half extent along each axis
+typedef struct {
+    Vector3 center;
+    Vector3 axes[3];
+    Vector3 halfExtents;
+} OrientedBox;
+
+OrientedBox MakeOrientedBox(Vector3 center, Vector3 halfExtents, Quaternion rotation) {
+    return (OrientedBox){
+        .center = center,
+        .axes = {
+            Vector3RotateByQuaternion((Vector3){ 1.0f, 0.0f, 0.0f }, rotation),
+            Vector3RotateByQuaternion((Vector3){ 0.0f, 1.0f, 0.0f }, rotation),
+            Vector3RotateByQuaternion((Vector3){ 0.0f, 0.0f, 1.0f }, rotation),
+        },
+        .halfExtents = halfExtents,
+    };
+}
 
-            // Update tank bombs
-            for (int i = 0; i < MAX_TANK_BOMBS; i++) {
-                if (tankBombs[i].active) {
-                    tankBombs[i].velocity.y -= gravity * deltaTime;
-                    tankBombs[i].position = Vector3Add(tankBombs[i].position, Vector3Scale(tankBombs[i].velocity, deltaTime));
-
-                    if (tankBombs[i].position.y - tankBombs[i].radius <= 0.0f && !tankBombs[i].exploded) {
-                        tankBombs[i].position.y = tankBombs[i].radius;
-                        tankBombs[i].velocity = Vector3Zero();
-                        tankBombs[i].exploded = true;
-                        PlaySound(explosionSound); // Use general explosion sound for tank bombs too
-
-                        // Area damage to player
-                        float distToPlayer = Vector3Distance(tankBombs[i].position, camera.position);
-                        if (distToPlayer <= tankBombs[i].explosion_radius) {
-                            playerHealth = 0;
-                            gameOver = true;
-                            EnableCursor();
-                        }
-
-                        // Area damage to combat entities
-                        for (int j = 0; j < MAX_ENTITIES; j++) {
-                            if (combatEntities[j].active) {
-                                float distance = Vector3Distance(tankBombs[i].position, combatEntities[j].position);
-                                if (distance <= tankBombs[i].explosion_radius) {
-                                    combatEntities[j].active = false;
-                                    if (combatEntities[j].type == ENTITY_ENEMY) {
-                                        activeEnemiesCount--;
-                                    } else {
-                                        activeFriendliesCount--;
-                                    }
-                                }
-                            }
-                        }
-                         // Tank bombs can also damage crates (and potentially other tanks if more were added)
-                        for (int j = 0; j < MAX_CRATES; j++) {
-                            if (crates[j].active) {
-                                float distance = Vector3Distance(tankBombs[i].position, crates[j].position);
-                                if (distance <= tankBombs[i].explosion_radius) {
-                                    crates[j].active = false; // Destroy crate
-                                }
-                            }
-                        }
-                         // Tank bombs can damage other tanks if too close
-                        for (int j = 0; j < MAX_TANKS; j++) {
-                             if (tanks[j].active) {
-                                 float distance = Vector3Distance(tankBombs[i].position, tanks[j].position);
-                                 if (distance <= tankBombs[i].explosion_radius) {
-                                     tanks[j].health -= 50.0f; // Self-damage for tank
-                                     if (tanks[j].health <= 0) {
-                                         tanks[j].active = false;
-                                         activeTanksCount--;
-                                     }
-                                 }
-                             }
-                        }
-                    }
-
-                    if (tankBombs[i].exploded) {
-                        tankBombs[i].explosionTimer += deltaTime;
-                        if (tankBombs[i].explosionTimer >= tankBombs[i].explosion_duration) {
-                            tankBombs[i].active = false;
-                        }
-                    }
+// Turned about the vertical axis only, as tanks are (a yaw of 0 faces +Z)
+OrientedBox MakeYawedBox(Vector3 center, Vector3 halfExtents, float yaw) {
+    float c = cosf(yaw), s = sinf(yaw);
+    return (OrientedBox){ center, { { c, 0.0f, -s }, { 0.0f, 1.0f, 0.0f }, { s, 0.0f, c } }, halfExtents };
+}
+
+OrientedBox MakeAxisAlignedBox(Vector3 center, Vector3 halfExtents) {
+    return (OrientedBox){ center, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, halfExtents };
+}
+
+// World AABB enclosing the box
+void OrientedBoxBounds(const OrientedBox *box, Vector3 *boundsMin, Vector3 *boundsMax) {
+    Vector3 extent = { 0.0f, 0.0f, 0.0f };
+    for (int a = 0; a < 3; a++) {
+        float half = AxisComponent(box->halfExtents, a);
+        extent.x += fabsf(box->axes[a].x) * half;
+        extent.y += fabsf(box->axes[a].y) * half;
+        extent.z += fabsf(box->axes[a].z) * half;
+    }
+    *boundsMin = Vector3Subtract(box->center, extent);
+    *boundsMax = Vector3Add(box->center, extent);
+}
+
+bool CheckCollisionPointOrientedBox(Vector3 point, const OrientedBox *box) {
+    Vector3 offset = Vector3Subtract(point, box->center);
+    return (fabsf(Vector3DotProduct(offset, box->axes[0])) <= box->halfExtents.x &&
+            fabsf(Vector3DotProduct(offset, box->axes[1])) <= box->halfExtents.y &&
+            fabsf(Vector3DotProduct(offset, box->axes[2])) <= box->halfExtents.z);
+}
+
+// Collision boxes of the pooled objects
+OrientedBox CombatEntityBox(int index) {
+    return MakeAxisAlignedBox(combatEntities[index].position, (Vector3){ 0.5f, 1.0f, 0.5f });
+}
+
+OrientedBox TankBox(int index) {
+    Vector3 center = { tanks[index].position.x, tanks[index].position.y + 0.75f * TANK_SCALE_FACTOR, tanks[index].position.z };
+    Vector3 halfExtents = { 1.5f * TANK_SCALE_FACTOR, 0.75f * TANK_SCALE_FACTOR, 2.5f * TANK_SCALE_FACTOR };
+    return MakeYawedBox(center, halfExtents, tanksCold[index].yawRotation);
+}
+
+OrientedBox CrateBox(int index) {
+    return MakeOrientedBox(crates[index].position, (Vector3){ 0.5f, 0.5f, 0.5f }, crates[index].rotation);
+}
+
+// --- Terrain ---
+// The ground is a procedural heightmap far larger than anything kept in memory. A thread holds
+// only the chunks in a STREAM_WINDOW_CHUNKS square around its streaming focus (the player for a
+// simulation, the camera for rendering). A chunk is TERRAIN_CHUNK_TILES x TERRAIN_CHUNK_TILES
+// tiles; each tile stores its samples contiguously and repeats its neighbours' border row and
+// column, so the four corners of any cell come from one small block of memory. Chunks live in the
+// window slot given by their coordinates modulo the window size, so finding one is two masks and a
+// tag compare. Queries outside the resident set evaluate the generator for the same four corners,
+// which gives bit-identical heights, so results never depend on what has been loaded yet.
+#define TERRAIN_TILE_SAMPLES (TERRAIN_TILE_CELLS + 1)
+#define TERRAIN_CHUNK_CELLS (TERRAIN_CHUNK_TILES * TERRAIN_TILE_CELLS) // Cells per side of a chunk
+#define TERRAIN_CHUNK_SIZE (TERRAIN_CHUNK_CELLS * TERRAIN_CELL_SIZE)   // World units per side of a chunk
+#define TERRAIN_CELLS (WORLD_CHUNKS * TERRAIN_CHUNK_CELLS)             // Cells per side of the whole map
+#define TERRAIN_HALF_EXTENT (TERRAIN_CELLS * TERRAIN_CELL_SIZE * 0.5f)
+_Static_assert((STREAM_WINDOW_CHUNKS & (STREAM_WINDOW_CHUNKS - 1)) == 0, "the stream window must be a power of two");
+_Static_assert(STREAM_WINDOW_CHUNKS <= WORLD_CHUNKS, "the stream window must fit on the map");
+
+typedef struct {
+    float heights[TERRAIN_TILE_SAMPLES][TERRAIN_TILE_SAMPLES]; // [z][x]
+    float minHeight, maxHeight;
+} TerrainTile;
+
+// Scenery scattered over the hills outside the arena. Drawn only, nothing collides with it.
+typedef struct {
+    Vector3 position; // Centre of the rock
+    Vector3 size;
+} StaticProp;
+
+typedef enum {
+    CHUNK_EMPTY,    // Slot holds nothing usable
+    CHUNK_LOADING,  // Owned by the loader thread until it publishes CHUNK_RESIDENT
+    CHUNK_RESIDENT
+} ChunkState;
+
+typedef struct {
+    int chunkX, chunkZ;      // Map chunk the slot holds or is loading (written by the owning thread only)
+    atomic_int state;        // ChunkState; CHUNK_RESIDENT is published with release
+    unsigned int generation; // Bumped by every load, so renderers notice a slot's contents changed
+    TerrainTile tiles[TERRAIN_CHUNK_TILES][TERRAIN_CHUNK_TILES]; // [z][x]
+    float minHeight, maxHeight;
+    int propCount;
+    StaticProp props[STREAM_PROPS_PER_CHUNK];
+} StreamChunk;
+
+typedef struct {
+    StreamChunk chunks[STREAM_WINDOW_CHUNKS][STREAM_WINDOW_CHUNKS]; // [chunkZ % window][chunkX % window]
+    int originX, originZ;    // First map chunk of the window on each axis
+    unsigned int loads;      // Chunks loaded since start
+    // Optional background loader; without one the owning thread loads STREAM_SYNC_LOADS per update
+    bool hasLoader;
+    SpscRing requests;       // StreamChunk pointers, owner -> loader
+    pthread_t loader;
+    atomic_bool quit;
+} ChunkStreamer;
+
+// Each thread streams the terrain around its own focus: batch worlds, the pipelined simulation and
+// the render thread all stand in different places
+WORLD_LOCAL ChunkStreamer terrainStream;
+
+static uint32_t TerrainLatticeHash(int x, int z, uint32_t seed) {
+    uint32_t h = seed ^ ((uint32_t)x * 0x8DA6B343u) ^ ((uint32_t)z * 0xD8163841u);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    return h ^ (h >> 16);
+}
+
+static float TerrainValueNoise(float x, float z, uint32_t seed) {
+    float fx = floorf(x), fz = floorf(z);
+    int ix = (int)fx, iz = (int)fz;
+    float tx = x - fx, tz = z - fz;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    tz = tz * tz * (3.0f - 2.0f * tz);
+    float v00 = (float)(TerrainLatticeHash(ix, iz, seed) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    float v10 = (float)(TerrainLatticeHash(ix + 1, iz, seed) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    float v01 = (float)(TerrainLatticeHash(ix, iz + 1, seed) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    float v11 = (float)(TerrainLatticeHash(ix + 1, iz + 1, seed) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    return Lerp(Lerp(v00, v10, tx), Lerp(v01, v11, tx), tz);
+}
+
+// Height of the generated landscape at a world position
+static float GenerateTerrainHeight(float x, float z, uint32_t seed) {
+    float height = 0.0f, amplitude = 1.0f, frequency = 1.0f / TERRAIN_FEATURE_SIZE, total = 0.0f;
+    for (int octave = 0; octave < TERRAIN_OCTAVES; octave++) {
+        height += amplitude * TerrainValueNoise(x * frequency, z * frequency, seed + (uint32_t)octave);
+        total += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+    float distance = sqrtf(x * x + z * z);
+    float blend = Clamp((distance - TERRAIN_ARENA_RADIUS) / (TERRAIN_ARENA_BLEND - TERRAIN_ARENA_RADIUS), 0.0f, 1.0f);
+    blend = blend * blend * (3.0f - 2.0f * blend);
+    float scale = TERRAIN_ARENA_FLATNESS + (1.0f - TERRAIN_ARENA_FLATNESS) * blend;
+    return height / total * TERRAIN_HEIGHT_SCALE * scale;
+}
+
+// Height of one heightmap sample, addressed by its index on the whole map
+static inline float GenerateTerrainSample(int sampleX, int sampleZ) {
+    return GenerateTerrainHeight((float)sampleX * TERRAIN_CELL_SIZE - TERRAIN_HALF_EXTENT, (float)sampleZ * TERRAIN_CELL_SIZE - TERRAIN_HALF_EXTENT, TERRAIN_SEED);
+}
+
+// Map chunk containing a world coordinate, clamped to the map
+static inline int TerrainChunkCoord(float worldCoordinate) {
+    float chunk = floorf((worldCoordinate + TERRAIN_HALF_EXTENT) * (1.0f / TERRAIN_CHUNK_SIZE));
+    return (int)fminf(fmaxf(chunk, 0.0f), (float)(WORLD_CHUNKS - 1)); // fmaxf also turns NaN into 0
+}
+
+// Fills a chunk's tiles and scenery. Runs on the loader thread or inline on the owning thread.
+void GenerateStreamChunk(StreamChunk *chunk) {
+    chunk->minHeight = FLT_MAX;
+    chunk->maxHeight = -FLT_MAX;
+    for (int tz = 0; tz < TERRAIN_CHUNK_TILES; tz++) {
+        for (int tx = 0; tx < TERRAIN_CHUNK_TILES; tx++) {
+            TerrainTile *tile = &chunk->tiles[tz][tx];
+            int firstX = chunk->chunkX * TERRAIN_CHUNK_CELLS + tx * TERRAIN_TILE_CELLS;
+            int firstZ = chunk->chunkZ * TERRAIN_CHUNK_CELLS + tz * TERRAIN_TILE_CELLS;
+            tile->minHeight = FLT_MAX;
+            tile->maxHeight = -FLT_MAX;
+            for (int z = 0; z < TERRAIN_TILE_SAMPLES; z++) {
+                for (int x = 0; x < TERRAIN_TILE_SAMPLES; x++) {
+                    float height = GenerateTerrainSample(firstX + x, firstZ + z);
+                    tile->heights[z][x] = height;
+                    tile->minHeight = fminf(tile->minHeight, height);
+                    tile->maxHeight = fmaxf(tile->maxHeight, height);
                 }
             }
-            // --- End Tank Logic ---
+            chunk->minHeight = fminf(chunk->minHeight, tile->minHeight);
+            chunk->maxHeight = fmaxf(chunk->maxHeight, tile->maxHeight);
+        }
+    }
 
-        } else {
-            // Game Over Logic:
-            if (IsKeyPressed(KEY_ENTER)) {
-                ResetGame();
-            }
+    // Rocks at hashed spots, kept off the arena
+    uint32_t hash = TerrainLatticeHash(chunk->chunkX, chunk->chunkZ, TERRAIN_SEED ^ 0x50A7u);
+    int wanted = (int)(hash % (STREAM_PROPS_PER_CHUNK + 1));
+    float chunkMinX = (float)chunk->chunkX * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT;
+    float chunkMinZ = (float)chunk->chunkZ * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT;
+    chunk->propCount = 0;
+    for (int n = 0; n < wanted; n++) {
+        hash = TerrainLatticeHash((int)hash, n, TERRAIN_SEED);
+        float x = chunkMinX + (float)(hash & 0xFFFF) * (TERRAIN_CHUNK_SIZE / 65536.0f);
+        float z = chunkMinZ + (float)(hash >> 16) * (TERRAIN_CHUNK_SIZE / 65536.0f);
+        if (x * x + z * z < TERRAIN_ARENA_BLEND * TERRAIN_ARENA_BLEND) continue;
+        float size = 1.0f + (float)(hash % 7) * 0.5f;
+        // Local height of this chunk's own samples, so the rock sits on the surface being drawn
+        int localX = (int)((x - chunkMinX) / TERRAIN_CELL_SIZE), localZ = (int)((z - chunkMinZ) / TERRAIN_CELL_SIZE);
+        const TerrainTile *tile = &chunk->tiles[localZ / TERRAIN_TILE_CELLS][localX / TERRAIN_TILE_CELLS];
+        float ground = tile->heights[localZ % TERRAIN_TILE_CELLS][localX % TERRAIN_TILE_CELLS];
+        StaticProp *prop = &chunk->props[chunk->propCount++];
+        prop->size = (Vector3){ size, size * 0.6f, size * 0.8f };
+        prop->position = (Vector3){ x, ground + prop->size.y * 0.3f, z }; // Partly buried
+        chunk->maxHeight = fmaxf(chunk->maxHeight, prop->position.y + prop->size.y * 0.5f);
+    }
+}
+
+void *ChunkLoaderThread(void *argument) {
+    ChunkStreamer *stream = argument;
+    while (!atomic_load(&stream->quit)) {
+        StreamChunk *chunk;
+        if (!SpscRingPop(&stream->requests, &chunk)) {
+            SleepSeconds(STREAM_LOADER_POLL_SECONDS);
+            continue;
         }
+        GenerateStreamChunk(chunk);
+        chunk->generation++;
+        atomic_store_explicit(&chunk->state, CHUNK_RESIDENT, memory_order_release);
+    }
+    return NULL;
+}
 
-        // Drawing
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+// Gives the calling thread's streamer a background loader. On failure the thread keeps loading
+// chunks itself.
+void StartChunkLoader(ChunkStreamer *stream) {
+    if (stream->hasLoader) return;
+    if (!InitSpscRing(&stream->requests, sizeof(StreamChunk *), STREAM_LOADER_QUEUE)) {
+        TraceLog(LOG_WARNING, "STREAM: could not allocate the loader queue, loading chunks inline");
+        return;
+    }
+    atomic_init(&stream->quit, false);
+    if (pthread_create(&stream->loader, NULL, ChunkLoaderThread, stream) != 0) {
+        TraceLog(LOG_WARNING, "STREAM: could not start the loader thread, loading chunks inline");
+        FreeSpscRing(&stream->requests);
+        return;
+    }
+    stream->hasLoader = true;
+}
 
-        if (!gameOver) {
-            BeginMode3D(camera);
+void StopChunkLoader(ChunkStreamer *stream) {
+    if (!stream->hasLoader) return;
+    atomic_store(&stream->quit, true);
+    pthread_join(stream->loader, NULL);
+    FreeSpscRing(&stream->requests);
+    stream->hasLoader = false;
+    // Requests the loader never got to
+    for (int z = 0; z < STREAM_WINDOW_CHUNKS; z++) {
+        for (int x = 0; x < STREAM_WINDOW_CHUNKS; x++) {
+            if (atomic_load(&stream->chunks[z][x].state) == CHUNK_LOADING) atomic_store(&stream->chunks[z][x].state, CHUNK_EMPTY);
+        }
+    }
+}
 
-            // UPDATED: Ground size to 100x100
-            DrawPlane((Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 100.0f, 100.0f }, GRAY);
+// Window whose chunks surround focus as evenly as chunk granularity allows: at least
+// (STREAM_WINDOW_CHUNKS / 2 - 0.5) chunks on every side
+static inline void StreamWindowOrigin(Vector3 focus, int *originX, int *originZ) {
+    int maxOrigin = WORLD_CHUNKS - STREAM_WINDOW_CHUNKS;
+    int x = TerrainChunkCoord(focus.x + TERRAIN_CHUNK_SIZE * 0.5f) - STREAM_WINDOW_CHUNKS / 2;
+    int z = TerrainChunkCoord(focus.z + TERRAIN_CHUNK_SIZE * 0.5f) - STREAM_WINDOW_CHUNKS / 2;
+    *originX = (x < 0) ? 0 : (x > maxOrigin) ? maxOrigin : x;
+    *originZ = (z < 0) ? 0 : (z > maxOrigin) ? maxOrigin : z;
+}
 
-            // Draw combat entities (enemies and friendly forces)
-            for (int i = 0; i < MAX_ENTITIES; i++) {
-                if (combatEntities[i].active) {
-                    Color entityColor = (combatEntities[i].type == ENTITY_ENEMY) ? RED : GREEN;
-                    DrawCube(combatEntities[i].position, 1.0f, 2.0f, 1.0f, entityColor);
-                }
-            }
+// World position of the middle of the window starting at chunk (originX, originZ)
+static inline Vector3 StreamWindowCentre(int originX, int originZ) {
+    return (Vector3){ (float)(originX + STREAM_WINDOW_CHUNKS / 2) * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT, 0.0f,
+                      (float)(originZ + STREAM_WINDOW_CHUNKS / 2) * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT };
+}
 
-            for (int i = 0; i < MAX_CRATES; i++) {
-                if (crates[i].active) {
-                    Vector3 rotationAxis;
-                    float rotationAngle;
-                    QuaternionToAxisAngle(crates[i].rotation, &rotationAxis, &rotationAngle);
-                    DrawModelEx(crateModel, crates[i].position, rotationAxis, rotationAngle * RAD2DEG, (Vector3){1.0f, 1.0f, 1.0f}, crates[i].color);
+// Moves the window to focus: slots whose chunk fell out are handed the chunk that came in, and
+// missing chunks are queued for the loader (or loaded inline) nearest first
+void UpdateChunkStreaming(ChunkStreamer *stream, Vector3 focus) {
+    StreamWindowOrigin(focus, &stream->originX, &stream->originZ);
+    int inlineLoads = 0;
+    for (int ring = 0; ring <= STREAM_WINDOW_CHUNKS / 2; ring++) {
+        for (int dz = -ring; dz <= ring; dz++) {
+            for (int dx = -ring; dx <= ring; dx++) {
+                if (abs(dx) != ring && abs(dz) != ring) continue; // Interior was done by an earlier ring
+                int offsetX = STREAM_WINDOW_CHUNKS / 2 + dx, offsetZ = STREAM_WINDOW_CHUNKS / 2 + dz;
+                if (offsetX < 0 || offsetX >= STREAM_WINDOW_CHUNKS || offsetZ < 0 || offsetZ >= STREAM_WINDOW_CHUNKS) continue;
+                int chunkX = stream->originX + offsetX, chunkZ = stream->originZ + offsetZ;
+                StreamChunk *chunk = &stream->chunks[chunkZ & (STREAM_WINDOW_CHUNKS - 1)][chunkX & (STREAM_WINDOW_CHUNKS - 1)];
+                int state = atomic_load_explicit(&chunk->state, memory_order_acquire);
+                if (state == CHUNK_LOADING) continue; // The loader still owns it; look again next update
+                if (state == CHUNK_RESIDENT && chunk->chunkX == chunkX && chunk->chunkZ == chunkZ) continue;
+
+                atomic_store_explicit(&chunk->state, CHUNK_EMPTY, memory_order_relaxed);
+                chunk->chunkX = chunkX;
+                chunk->chunkZ = chunkZ;
+                if (stream->hasLoader) {
+                    atomic_store_explicit(&chunk->state, CHUNK_LOADING, memory_order_relaxed);
+                    if (!SpscRingPush(&stream->requests, &chunk)) atomic_store_explicit(&chunk->state, CHUNK_EMPTY, memory_order_relaxed);
+                } else if (inlineLoads < STREAM_SYNC_LOADS) {
+                    GenerateStreamChunk(chunk);
+                    chunk->generation++;
+                    atomic_store_explicit(&chunk->state, CHUNK_RESIDENT, memory_order_relaxed);
+                    inlineLoads++;
                 }
+                if (atomic_load_explicit(&chunk->state, memory_order_relaxed) != CHUNK_EMPTY) stream->loads++;
             }
+        }
+    }
+}
 
-            for (int i = 0; i < MAX_PLAYER_BULLETS; i++) {
-                if (playerBullets[i].active) {
-                    DrawSphere(playerBullets[i].position, 0.1f, DARKBLUE);
-                }
-            }
+// Resident chunk of the calling thread's streamer, or NULL
+static inline const StreamChunk *FindResidentChunk(int chunkX, int chunkZ) {
+    const StreamChunk *chunk = &terrainStream.chunks[chunkZ & (STREAM_WINDOW_CHUNKS - 1)][chunkX & (STREAM_WINDOW_CHUNKS - 1)];
+    if (chunk->chunkX != chunkX || chunk->chunkZ != chunkZ) return NULL;
+    return (atomic_load_explicit(&chunk->state, memory_order_acquire) == CHUNK_RESIDENT) ? chunk : NULL;
+}
 
-            for (int i = 0; i < MAX_ENTITY_BULLETS; i++) {
-                if (entityBullets[i].active) {
-                    DrawSphere(entityBullets[i].position, 0.1f, ORANGE);
-                }
-            }
+// Heights at the four corners of the cell under (x, z) and the position inside that cell.
+// Positions off the map (and NaNs) clamp to its edge.
+static inline void TerrainCellCorners(float x, float z, float corners[4], float *fracX, float *fracZ) {
+    float gridX = fminf(fmaxf((x + TERRAIN_HALF_EXTENT) * (1.0f / TERRAIN_CELL_SIZE), 0.0f), (float)TERRAIN_CELLS);
+    float gridZ = fminf(fmaxf((z + TERRAIN_HALF_EXTENT) * (1.0f / TERRAIN_CELL_SIZE), 0.0f), (float)TERRAIN_CELLS);
+    int globalX = (int)gridX, globalZ = (int)gridZ;
+    if (globalX > TERRAIN_CELLS - 1) globalX = TERRAIN_CELLS - 1;
+    if (globalZ > TERRAIN_CELLS - 1) globalZ = TERRAIN_CELLS - 1;
+    *fracX = gridX - (float)globalX;
+    *fracZ = gridZ - (float)globalZ;
+
+    const StreamChunk *chunk = FindResidentChunk(globalX / TERRAIN_CHUNK_CELLS, globalZ / TERRAIN_CHUNK_CELLS);
+    if (chunk != NULL) {
+        int localX = globalX % TERRAIN_CHUNK_CELLS, localZ = globalZ % TERRAIN_CHUNK_CELLS;
+        const TerrainTile *tile = &chunk->tiles[localZ / TERRAIN_TILE_CELLS][localX / TERRAIN_TILE_CELLS];
+        int cellX = localX % TERRAIN_TILE_CELLS, cellZ = localZ % TERRAIN_TILE_CELLS;
+        corners[0] = tile->heights[cellZ][cellX];
+        corners[1] = tile->heights[cellZ][cellX + 1];
+        corners[2] = tile->heights[cellZ + 1][cellX];
+        corners[3] = tile->heights[cellZ + 1][cellX + 1];
+    } else {
+        corners[0] = GenerateTerrainSample(globalX, globalZ);
+        corners[1] = GenerateTerrainSample(globalX + 1, globalZ);
+        corners[2] = GenerateTerrainSample(globalX, globalZ + 1);
+        corners[3] = GenerateTerrainSample(globalX + 1, globalZ + 1);
+    }
+}
 
-            // Draw tank bullets
-            for (int i = 0; i < MAX_TANK_BULLETS; i++) {
-                if (tankBullets[i].active) {
-                    DrawSphere(tankBullets[i].position, TANK_BULLET_RADIUS, BROWN); // Tank bullets are brown
-                }
-            }
+float SampleTerrainHeight(float x, float z) {
+    float corners[4], fracX, fracZ;
+    TerrainCellCorners(x, z, corners, &fracX, &fracZ);
+    return Lerp(Lerp(corners[0], corners[1], fracX), Lerp(corners[2], corners[3], fracX), fracZ);
+}
 
-            // Draw regular bombs (from jet)
-            for (int i = 0; i < MAX_BOMBS; i++) {
-                if (bombs[i].active && !bombs[i].exploded) {
-                    DrawSphere(bombs[i].position, bombs[i].radius, BLACK);
-                } else if (bombs[i].active && bombs[i].exploded && bombs[i].explosionTimer < bombs[i].explosion_duration) {
-                     DrawSphere(bombs[i].position, bombs[i].explosion_radius * (bombs[i].explosionTimer / bombs[i].explosion_duration), (Color){255, 165, 0, 100});
-                }
-            }
+// Unit normal of the bilinear surface at (x, z)
+Vector3 SampleTerrainNormal(float x, float z) {
+    float corners[4], fracX, fracZ;
+    TerrainCellCorners(x, z, corners, &fracX, &fracZ);
+    float slopeX = Lerp(corners[1] - corners[0], corners[3] - corners[2], fracZ) * (1.0f / TERRAIN_CELL_SIZE);
+    float slopeZ = Lerp(corners[2] - corners[0], corners[3] - corners[1], fracX) * (1.0f / TERRAIN_CELL_SIZE);
+    return Vector3Normalize((Vector3){ -slopeX, 1.0f, -slopeZ });
+}
 
-            // Draw tank bombs
-            for (int i = 0; i < MAX_TANK_BOMBS; i++) {
-                if (tankBombs[i].active && !tankBombs[i].exploded) {
-                    DrawSphere(tankBombs[i].position, tankBombs[i].radius, DARKGRAY); // Tank bombs are dark gray
-                } else if (tankBombs[i].active && tankBombs[i].exploded && tankBombs[i].explosionTimer < tankBombs[i].explosion_duration) {
-                     DrawSphere(tankBombs[i].position, tankBombs[i].explosion_radius * (tankBombs[i].explosionTimer / tankBombs[i].explosion_duration), (Color){255, 100, 0, 150}); // Slightly different explosion color
-                }
-            }
+// Ground height under count positions. xs and zs point at the first x and z and advance by
+// strideBytes, so the same call reads packed float arrays and the position field of a struct pool.
+void SampleTerrainHeights(const float *xs, const float *zs, size_t strideBytes, int count, float *heights) {
+    const char *x = (const char *)xs, *z = (const char *)zs;
+    for (int i = 0; i < count; i++, x += strideBytes, z += strideBytes) {
+        heights[i] = SampleTerrainHeight(*(const float *)x, *(const float *)z);
+    }
+}
 
-            // Draw missiles
-            for (int i = 0; i < MAX_MISSILES; i++) {
-                if (missiles[i].active) {
-                    // Calculate missile orientation to face its velocity direction
-                    Vector3 missileForward = Vector3Normalize(missiles[i].velocity);
-                    Vector3 missileUp = {0.0f, 1.0f, 0.0f}; // Assume up is always Y-axis for simplicity
-                    Vector3 missileRight = Vector3Normalize(Vector3CrossProduct(missileForward, missileUp));
-                    missileUp = Vector3Normalize(Vector3CrossProduct(missileRight, missileForward)); // Recalculate up to be orthogonal
-
-                    // Create a transformation matrix for the missile
-                    Matrix mat = MatrixIdentity();
-                    mat.m0 = missileRight.x; mat.m4 = missileUp.x; mat.m8 = missileForward.x;
-                    mat.m1 = missileRight.y; mat.m5 = missileUp.y; mat.m9 = missileForward.y;
-                    mat.m2 = missileRight.z; mat.m6 = missileUp.z; mat.m10 = missileForward.z;
-                    mat.m12 = missiles[i].position.x; mat.m13 = missiles[i].position.y; mat.m14 = missiles[i].position.z;
-
-                    // Draw the missile as a cylinder (or use a model if you have one)
-                    // For now, using DrawModel with a fixed rotation for visual representation.
-                    // You might need to adjust the rotation axis/angle for your specific missile model orientation.
-                    DrawModel(missileModel, missiles[i].position, 1.0f, RED); // Scale 1.0f, color RED
-                }
-            }
+// Ground height under every element of a pool whose elements have a Vector3 position
+#define SAMPLE_POOL_GROUND(pool, count, heights) \
+    SampleTerrainHeights(&(pool)[0].position.x, &(pool)[0].position.z, sizeof((pool)[0]), (count), (heights))
 
+// --- Handles ---
+// Slot table for one packed pool: slots are stable, the dense index they map to follows the element
+// through swap-removes, and releasing a slot bumps its generation so outstanding handles go stale.
+typedef struct {
+    int dense[MAX_HANDLE_SLOTS];               // Slot -> packed pool index, -1 while free
+    unsigned int generation[MAX_HANDLE_SLOTS];
+    int nextFree[MAX_HANDLE_SLOTS];
+    int freeHead;
+} HandleTable;
+
+WORLD_LOCAL HandleTable combatEntityHandles;
+WORLD_LOCAL HandleTable crateHandles;
+WORLD_LOCAL HandleTable tankHandles;
+WORLD_LOCAL HandleTable bombHandles;
+WORLD_LOCAL HandleTable tankBombHandles;
+WORLD_LOCAL HandleTable aircraftHandles;
+
+_Static_assert(MAX_ENTITIES <= MAX_HANDLE_SLOTS && MAX_CRATES <= MAX_HANDLE_SLOTS && MAX_TANKS <= MAX_HANDLE_SLOTS &&
+               MAX_BOMBS <= MAX_HANDLE_SLOTS && MAX_TANK_BOMBS <= MAX_HANDLE_SLOTS && MAX_AIRCRAFT <= MAX_HANDLE_SLOTS,
+               "MAX_HANDLE_SLOTS must cover every pool that hands out handles");
+
+// Frees every slot. Slots still in use get a new generation, so handles from before the reset stay stale.
+void ResetHandleTable(HandleTable *table, int capacity) {
+    for (int slot = 0; slot < MAX_HANDLE_SLOTS; slot++) {
+        if (table->dense[slot] != -1) table->generation[slot]++;
+        table->dense[slot] = -1;
+        table->nextFree[slot] = (slot + 1 < capacity) ? slot + 1 : -1;
+    }
+    table->freeHead = (capacity > 0) ? 0 : -1;
+}
 
-            // Draw the jet
-            Vector3 currentJetPosition = {
-                jetCenterPoint.x + jetRadius * cosf(jetAngle),
-                jetFlightHeight,
-                jetCenterPoint.z + jetRadius * sinf(jetAngle)
-            };
-            float finalRotationAngle = (jetYawRotation + 0.0f) * RAD2DEG;
-            DrawModelEx(jetModel, currentJetPosition, (Vector3){0.0f, 1.0f, 0.0f}, finalRotationAngle, (Vector3){0.1f, 0.1f, 0.1f}, WHITE);
+Handle AcquireHandle(HandleTable *table, int denseIndex) {
+    int slot = table->freeHead;
+    if (slot == -1) return NULL_HANDLE;
+    table->freeHead = table->nextFree[slot];
+    table->dense[slot] = denseIndex;
+    return (Handle){ slot, table->generation[slot] };
+}
 
-            // Draw the tanks
-            for (int i = 0; i < MAX_TANKS; i++) {
-                if (tanks[i].active) {
-                    DrawModelEx(tankModel, tanks[i].position, (Vector3){0.0f, 1.0f, 0.0f}, tanks[i].yawRotation * RAD2DEG + 180.0f, (Vector3){TANK_SCALE_FACTOR, TANK_SCALE_FACTOR, TANK_SCALE_FACTOR}, WHITE);
-                }
-            }
+void ReleaseHandle(HandleTable *table, Handle handle) {
+    table->dense[handle.slot] = -1;
+    table->generation[handle.slot]++;
+    table->nextFree[handle.slot] = table->freeHead;
+    table->freeHead = handle.slot;
+}
 
-            EndMode3D();
+// Packed pool index of the element, or -1 when the handle is null or stale. O(1).
+int ResolveHandle(const HandleTable *table, Handle handle) {
+    if (handle.slot < 0 || table->generation[handle.slot] != handle.generation) return -1;
+    return table->dense[handle.slot];
+}
+
+// --- Pool Management ---
+// Spawns append to the end of a packed pool; removals swap the last element into the hole.
+// Loops that remove while iterating walk their pool backwards so the swapped-in element has
+// already been processed.
+Bullet *SpawnBullet(Bullet *pool, int *count, int capacity) {
+    if (*count >= capacity) return NULL;
+    return &pool[(*count)++];
+}
 
-            // --- Draw Combat Entity Health Bars (after EndMode3D to draw in 2D overlay) ---
-            for (int i = 0; i < MAX_ENTITIES; i++) {
-                if (combatEntities[i].active) {
-                    Vector3 entityHeadPos = {combatEntities[i].position.x, combatEntities[i].position.y + 1.2f, combatEntities[i].position.z};
-                    Vector2 screenPos = GetWorldToScreen(entityHeadPos, camera);
+void RemoveBullet(Bullet *pool, int *count, int index) {
+    pool[index] = pool[--(*count)];
+}
 
-                    int barWidth = 40;
-                    int barHeight = 6;
-                    int barPadding = 2;
+ProjectileBomb *SpawnBomb(ProjectileBomb *pool, int *count, int capacity, HandleTable *handles) {
+    if (*count >= capacity) return NULL;
+    int index = (*count)++;
+    pool[index].handle = AcquireHandle(handles, index);
+    return &pool[index];
+}
 
-                    float healthPercent = combatEntities[i].health / 100.0f;
+void RemoveBomb(ProjectileBomb *pool, int *count, HandleTable *handles, int index) {
+    int last = --(*count);
+    ReleaseHandle(handles, pool[index].handle);
+    pool[index] = pool[last];
+    if (last != index) handles->dense[pool[index].handle.slot] = index;
+}
 
-                    int outerBarX = (int)screenPos.x - (barWidth / 2) - barPadding;
-                    int outerBarY = (int)screenPos.y - (barHeight / 2) - barPadding;
-                    int innerBarX = (int)screenPos.x - (barWidth / 2);
-                    int innerBarY = (int)screenPos.y - (barHeight / 2);
+// Pools that other code refers to also keep a handle per element (in the cold data)
+int AddCombatEntity(void) {
+    if (combatEntityCount >= MAX_ENTITIES) return -1;
+    int index = combatEntityCount++;
+    combatEntitiesCold[index].handle = AcquireHandle(&combatEntityHandles, index);
+    return index;
+}
 
-                    DrawRectangle(outerBarX, outerBarY, barWidth + (barPadding * 2), barHeight + (barPadding * 2), (combatEntities[i].type == ENTITY_ENEMY) ? DARKBROWN : DARKGREEN); // Background for health bar
-                    DrawRectangle(innerBarX, innerBarY, (int)(barWidth * healthPercent), barHeight, (combatEntities[i].type == ENTITY_ENEMY) ? RED : GREEN);
-                }
+int AddCrate(void) {
+    if (crateCount >= MAX_CRATES) return -1;
+    int index = crateCount++;
+    cratesCold[index].handle = AcquireHandle(&crateHandles, index);
+    return index;
+}
+
+void RemoveCrate(int index) {
+    int last = --crateCount;
+    ReleaseHandle(&crateHandles, cratesCold[index].handle);
+    crates[index] = crates[last];
+    cratesCold[index] = cratesCold[last];
+    if (last != index) crateHandles.dense[cratesCold[index].handle.slot] = index;
+}
+
+int AddTank(void) {
+    if (tankCount >= MAX_TANKS) return -1;
+    int index = tankCount++;
+    tanksCold[index].handle = AcquireHandle(&tankHandles, index);
+    return index;
+}
+
+int AddAircraft(void) {
+    if (aircraftCount >= MAX_AIRCRAFT) return -1;
+    int index = aircraftCount++;
+    aircraftCold[index].handle = AcquireHandle(&aircraftHandles, index);
+    return index;
+}
+
+int AddMissile(void) {
+    if (missileCount >= MAX_MISSILES) return -1;
+    return missileCount++;
+}
+
+void RemoveMissile(int index) {
+    int last = --missileCount;
+    missiles.positionX[index] = missiles.positionX[last];
+    missiles.positionY[index] = missiles.positionY[last];
+    missiles.positionZ[index] = missiles.positionZ[last];
+    missiles.velocityX[index] = missiles.velocityX[last];
+    missiles.velocityY[index] = missiles.velocityY[last];
+    missiles.velocityZ[index] = missiles.velocityZ[last];
+    missiles.speed[index] = missiles.speed[last];
+    missiles.targetTank[index] = missiles.targetTank[last];
+    missiles.damage[index] = missiles.damage[last];
+}
+
+// --- Death Bookkeeping ---
+void KillCombatEntity(int index) {
+    if (combatEntitiesCold[index].type == ENTITY_ENEMY) {
+        activeEnemiesCount--;
+    } else {
+        activeFriendliesCount--;
+    }
+    int last = --combatEntityCount;
+    ReleaseHandle(&combatEntityHandles, combatEntitiesCold[index].handle);
+    combatEntities[index] = combatEntities[last];
+    combatEntitiesCold[index] = combatEntitiesCold[last];
+    if (last != index) combatEntityHandles.dense[combatEntitiesCold[index].handle.slot] = index;
+}
+
+void KillTank(int index) {
+    int last = --tankCount;
+    ReleaseHandle(&tankHandles, tanksCold[index].handle);
+    tanks[index] = tanks[last];
+    tanksCold[index] = tanksCold[last];
+    if (last != index) tankHandles.dense[tanksCold[index].handle.slot] = index;
+}
+
+// Frees the cursor on the game over screen and captures it while playing. Headless worlds have no
+// window, and the pipelined simulation thread leaves the window to the render thread.
+WORLD_LOCAL bool worldDrivesCursor = true;
+
+void SetGameCursor(bool visible) {
+    if (!worldDrivesCursor || !IsWindowReady()) return;
+    if (visible) EnableCursor();
+    else DisableCursor();
+}
+
+void KillPlayer(void) {
+    playerHealth = 0;
+    gameOver = true;
+    SetGameCursor(true);
+}
+
+// --- Broadphase ---
+// Uniform XZ grid built from SoA positions into the frame arena (counting sort by cell).
+// Queries return candidate indices; callers still run the exact test on the candidates. Cells
+// repeat every dim cells, so the grid works anywhere on the map: items a grid width apart share a
+// cell, which only adds candidates.
+typedef struct {
+    float cellSize;
+    int dim;
+    int *cellStart; // dim * dim + 1 offsets into items
+    int *items;     // Item indices sorted by cell
+    int itemCount;
+} SpatialGrid;
+
+int WrapSpatialGridCell(const SpatialGrid *grid, int cell) {
+    cell %= grid->dim;
+    return (cell < 0) ? cell + grid->dim : cell;
+}
+
+int SpatialGridCell(const SpatialGrid *grid, float coord) {
+    return WrapSpatialGridCell(grid, (int)floorf(coord / grid->cellSize));
+}
+
+bool BuildSpatialGrid(SpatialGrid *grid, FrameArena *arena, const float *xs, const float *zs, int count, float cellSize, int dim) {
+    grid->cellSize = cellSize;
+    grid->dim = dim;
+    grid->itemCount = count;
+    grid->cellStart = ARENA_ALLOC_ARRAY(arena, int, dim * dim + 1);
+    grid->items = ARENA_ALLOC_ARRAY(arena, int, count > 0 ? count : 1);
+    int *cellOf = ARENA_ALLOC_ARRAY(arena, int, count > 0 ? count : 1);
+    if (grid->cellStart == NULL || grid->items == NULL || cellOf == NULL) {
+        grid->itemCount = 0;
+        return false;
+    }
+
+    memset(grid->cellStart, 0, sizeof(int) * (size_t)(dim * dim + 1));
+    for (int i = 0; i < count; i++) {
+        cellOf[i] = SpatialGridCell(grid, zs[i]) * dim + SpatialGridCell(grid, xs[i]);
+        grid->cellStart[cellOf[i] + 1]++;
+    }
+    for (int c = 0; c < dim * dim; c++) {
+        grid->cellStart[c + 1] += grid->cellStart[c];
+    }
+    // cellOf is reused as the per-cell write cursor once its cell has been consumed
+    for (int i = 0; i < count; i++) {
+        int cell = cellOf[i];
+        cellOf[i] = grid->cellStart[cell]++;
+    }
+    for (int c = dim * dim; c > 0; c--) {
+        grid->cellStart[c] = grid->cellStart[c - 1];
+    }
+    grid->cellStart[0] = 0;
+    for (int i = 0; i < count; i++) {
+        grid->items[cellOf[i]] = i;
+    }
+    return true;
+}
+
+// Collects items from every cell overlapping the square [x - radius, x + radius] x [z - radius, z + radius]
+int QuerySpatialGrid(const SpatialGrid *grid, float x, float z, float radius, int *out, int maxOut) {
+    if (grid->itemCount == 0) return 0;
+    int minX = (int)floorf((x - radius) / grid->cellSize);
+    int maxX = (int)floorf((x + radius) / grid->cellSize);
+    int minZ = (int)floorf((z - radius) / grid->cellSize);
+    int maxZ = (int)floorf((z + radius) / grid->cellSize);
+    if (maxX - minX >= grid->dim) maxX = minX + grid->dim - 1; // Wider than the grid: visit every column once
+    if (maxZ - minZ >= grid->dim) maxZ = minZ + grid->dim - 1;
+    int found = 0;
+    for (int cz = minZ; cz <= maxZ; cz++) {
+        int row = WrapSpatialGridCell(grid, cz) * grid->dim;
+        for (int cx = minX; cx <= maxX; cx++) {
+            int cell = row + WrapSpatialGridCell(grid, cx);
+            for (int k = grid->cellStart[cell]; k < grid->cellStart[cell + 1] && found < maxOut; k++) {
+                out[found++] = grid->items[k];
             }
-            // Draw Tank Health Bars
-            for (int i = 0; i < MAX_TANKS; i++) {
-                if (tanks[i].active) {
-                    Vector3 tankHeadPos = {tanks[i].position.x, tanks[i].position.y + (3.0f * TANK_SCALE_FACTOR), tanks[i].position.z}; // Adjusted height for larger tank
-                    Vector2 screenPos = GetWorldToScreen(tankHeadPos, camera);
+        }
+    }
+    return found;
+}
+
+// --- Hit-Scan ---
+// With player_hit_scan set, a player shot is resolved on the tick it is fired by one ray cast
+// against a bounding volume hierarchy over entity boxes, tank boxes and crate OBBs. The first shot
+// of a step updates the tree and every later shot of that step casts against it; only a kill,
+// which reorders a pool, makes the next shot update it again. While the box count stays the same
+// the tree keeps its topology and is refit to the moved boxes; it is rebuilt when boxes come or
+// go or refitting has loosened it too much.
+typedef enum {
+    HIT_COMBAT_ENTITY,
+    HIT_TANK,
+    HIT_CRATE
+} HitKind;
+
+typedef struct {
+    OrientedBox shape;
+    Vector3 boundsMin, boundsMax; // World AABB enclosing the shape
+    HitKind kind;
+    int index;                    // Pool index of the object the box belongs to
+} HitScanBox;
 
-                    int barWidth = 60;
-                    int barHeight = 8;
-                    int barPadding = 3;
+typedef struct {
+    Vector3 boundsMin, boundsMax;
+    int left;  // First of two adjacent children, -1 for a leaf
+    int axis;  // Split axis, the child on the ray's side of it is visited first
+    int first; // Leaf boxes are order[first, first + count)
+    int count;
+} BvhNode;
 
-                    float healthPercent = tanks[i].health / 200.0f; // Max tank health is 200
+typedef struct {
+    HitScanBox *boxes;
+    int *order;         // Box indices grouped by leaf
+    BvhNode *nodes;     // Children always follow their parent, so a reverse pass refits bottom-up
+    int boxCount;
+    int nodeCount;
+    int builtBoxCount;  // Box count the topology was built for
+    float builtArea;    // Root surface area right after the build
+} Bvh;
 
-                    int outerBarX = (int)screenPos.x - (barWidth / 2) - barPadding;
-                    int outerBarY = (int)screenPos.y - (barHeight / 2) - barPadding;
-                    int innerBarX = (int)screenPos.x - (barWidth / 2);
-                    int innerBarY = (int)screenPos.y - (barHeight / 2);
+typedef struct {
+    bool hit;
+    float distance;
+    int box; // Index into the boxes array
+} RayHit;
+
+WORLD_LOCAL HitScanBox hitScanBoxes[HITSCAN_MAX_BOXES];
+WORLD_LOCAL int hitScanOrder[HITSCAN_MAX_BOXES];
+WORLD_LOCAL BvhNode hitScanNodes[2 * HITSCAN_MAX_BOXES];
+WORLD_LOCAL Bvh hitScanBvh = { .builtBoxCount = -1 };
+WORLD_LOCAL bool hitScanBvhCurrent = false; // The boxes match the pools as they are now
+WORLD_LOCAL bool hitScanReference = false; // Rays test every box instead of walking the BVH (divergence checks)
+
+float BoundsSurfaceArea(Vector3 boundsMin, Vector3 boundsMax) {
+    Vector3 size = Vector3Subtract(boundsMax, boundsMin);
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
 
-                    DrawRectangle(outerBarX, outerBarY, barWidth + (barPadding * 2), barHeight + (barPadding * 2), DARKBROWN);
-                    DrawRectangle(innerBarX, innerBarY, (int)(barWidth * healthPercent), barHeight, MAROON); // Tank health bar color
-                }
+void SetHitScanBox(HitScanBox *box, HitKind kind, int index, OrientedBox shape) {
+    box->kind = kind;
+    box->index = index;
+    box->shape = shape;
+    OrientedBoxBounds(&box->shape, &box->boundsMin, &box->boundsMax);
+}
+
+// Reorders order[0, count) so that order[k] holds the box with the k-th smallest centre along
+// axis, smaller ones before it and larger ones after (quickselect)
+void SelectBoxesByCenter(const HitScanBox *boxes, int *order, int count, int k, int axis) {
+    int lo = 0, hi = count - 1;
+    while (lo < hi) {
+        float pivot = AxisComponent(boxes[order[(lo + hi) / 2]].shape.center, axis);
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (AxisComponent(boxes[order[i]].shape.center, axis) < pivot) i++;
+            while (AxisComponent(boxes[order[j]].shape.center, axis) > pivot) j--;
+            if (i <= j) {
+                int swap = order[i];
+                order[i++] = order[j];
+                order[j--] = swap;
             }
-            // --- End Draw Combat Entity Health Bars ---
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+}
+
+void FitBvhLeaf(Bvh *bvh, BvhNode *node) {
+    node->boundsMin = (Vector3){ FLT_MAX, FLT_MAX, FLT_MAX };
+    node->boundsMax = (Vector3){ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int k = node->first; k < node->first + node->count; k++) {
+        const HitScanBox *box = &bvh->boxes[bvh->order[k]];
+        node->boundsMin = Vector3Min(node->boundsMin, box->boundsMin);
+        node->boundsMax = Vector3Max(node->boundsMax, box->boundsMax);
+    }
+}
 
-            DrawText(TextFormat("Health: %.0f", playerHealth), 10, 10, 20, BLACK);
-            DrawText(TextFormat("Enemies: %d", activeEnemiesCount), 10, 40, 20, RED);
-            DrawText(TextFormat("Friendlies: %d", activeFriendliesCount), 10, 70, 20, GREEN);
-            DrawText(TextFormat("Tanks: %d", activeTanksCount), 10, 100, 20, MAROON); // Display active tanks count
-            if (jetLockedTargetIndex != -1 && tanks[jetLockedTargetIndex].active) {
-                 DrawText(TextFormat("Jet Target: Tank %d", jetLockedTargetIndex), 10, 130, 20, BLUE);
+// Splits order[first, first + count) at the median centre along the widest axis of the centres
+void BuildBvhNode(Bvh *bvh, int nodeIndex, int first, int count) {
+    BvhNode *node = &bvh->nodes[nodeIndex];
+    node->first = first;
+    node->count = count;
+    node->left = -1;
+    node->axis = 0;
+    FitBvhLeaf(bvh, node);
+    if (count <= BVH_LEAF_SIZE) return;
+
+    Vector3 centerMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vector3 centerMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int k = first; k < first + count; k++) {
+        centerMin = Vector3Min(centerMin, bvh->boxes[bvh->order[k]].shape.center);
+        centerMax = Vector3Max(centerMax, bvh->boxes[bvh->order[k]].shape.center);
+    }
+    Vector3 spread = Vector3Subtract(centerMax, centerMin);
+    node->axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : ((spread.y >= spread.z) ? 1 : 2);
+    int half = count / 2;
+    SelectBoxesByCenter(bvh->boxes, bvh->order + first, count, half, node->axis);
+    node->left = bvh->nodeCount;
+    bvh->nodeCount += 2;
+    BuildBvhNode(bvh, node->left, first, half);
+    BuildBvhNode(bvh, node->left + 1, first + half, count - half);
+}
+
+// Brings the tree up to date after bvh->boxes[0, boxCount) were refilled
+void UpdateBvh(Bvh *bvh) {
+    if (bvh->boxCount == 0) {
+        bvh->nodeCount = 0;
+        bvh->builtBoxCount = 0;
+        return;
+    }
+    if (bvh->boxCount == bvh->builtBoxCount) {
+        for (int n = bvh->nodeCount - 1; n >= 0; n--) {
+            BvhNode *node = &bvh->nodes[n];
+            if (node->left < 0) {
+                FitBvhLeaf(bvh, node);
             } else {
-                 DrawText("Jet Target: None", 10, 130, 20, GRAY);
+                node->boundsMin = Vector3Min(bvh->nodes[node->left].boundsMin, bvh->nodes[node->left + 1].boundsMin);
+                node->boundsMax = Vector3Max(bvh->nodes[node->left].boundsMax, bvh->nodes[node->left + 1].boundsMax);
             }
+        }
+        if (BoundsSurfaceArea(bvh->nodes[0].boundsMin, bvh->nodes[0].boundsMax) <= bvh->builtArea * BVH_REBUILD_GROWTH) return;
+    }
 
+    for (int i = 0; i < bvh->boxCount; i++) bvh->order[i] = i;
+    bvh->nodeCount = 1;
+    BuildBvhNode(bvh, 0, 0, bvh->boxCount);
+    bvh->builtBoxCount = bvh->boxCount;
+    bvh->builtArea = BoundsSurfaceArea(bvh->nodes[0].boundsMin, bvh->nodes[0].boundsMax);
+}
 
-        } else {
-            // Game Over Screen drawing
-            DrawText("GAME OVER", GetScreenWidth() / 2 - MeasureText("GAME OVER", 40) / 2, GetScreenHeight() / 2 - 20, 40, DARKGRAY);
-            DrawText("Press ENTER to Restart", GetScreenWidth() / 2 - MeasureText("Press ENTER to Restart", 20) / 2, GetScreenHeight() / 2 + 30, 20, DARKGRAY);
+// Slab test against an AABB. Returns the entry distance, or FLT_MAX if the ray misses it within
+// maxDistance. fminf/fmaxf drop the NaN of a ray lying in a slab plane.
+float RayBoundsDistance(Vector3 origin, Vector3 inverseDirection, Vector3 boundsMin, Vector3 boundsMax, float maxDistance) {
+    float x1 = (boundsMin.x - origin.x) * inverseDirection.x, x2 = (boundsMax.x - origin.x) * inverseDirection.x;
+    float y1 = (boundsMin.y - origin.y) * inverseDirection.y, y2 = (boundsMax.y - origin.y) * inverseDirection.y;
+    float z1 = (boundsMin.z - origin.z) * inverseDirection.z, z2 = (boundsMax.z - origin.z) * inverseDirection.z;
+    float entry = fmaxf(fmaxf(fminf(x1, x2), fminf(y1, y2)), fmaxf(fminf(z1, z2), 0.0f));
+    float exit = fminf(fminf(fmaxf(x1, x2), fmaxf(y1, y2)), fminf(fmaxf(z1, z2), maxDistance));
+    return (entry <= exit) ? entry : FLT_MAX;
+}
+
+// Slab test in the box's own frame; same result convention as RayBoundsDistance
+float RayBoxDistance(Vector3 origin, Vector3 direction, const OrientedBox *box, float maxDistance) {
+    Vector3 offset = Vector3Subtract(origin, box->center);
+    float entry = 0.0f, exit = maxDistance;
+    for (int a = 0; a < 3; a++) {
+        float half = AxisComponent(box->halfExtents, a);
+        float start = Vector3DotProduct(offset, box->axes[a]);
+        float step = Vector3DotProduct(direction, box->axes[a]);
+        if (fabsf(step) < 1.0e-8f) {
+            if (fabsf(start) > half) return FLT_MAX;
+            continue;
         }
+        float t1 = (-half - start) / step, t2 = (half - start) / step;
+        entry = fmaxf(entry, fminf(t1, t2));
+        exit = fminf(exit, fmaxf(t1, t2));
+        if (entry > exit) return FLT_MAX;
+    }
+    return entry;
+}
 
-        EndDrawing();
+// Keeps the nearer hit; equal distances go to the lower box index so the result does not depend
+// on the tree's shape
+void RecordRayHit(RayHit *result, int box, float distance) {
+    if (distance == FLT_MAX) return;
+    if (!result->hit || distance < result->distance || (distance == result->distance && box < result->box)) {
+        result->hit = true;
+        result->distance = distance;
+        result->box = box;
+    }
+}
+
+// First box along a ray (direction of unit length) within maxDistance
+RayHit RaycastBvh(const Bvh *bvh, Vector3 origin, Vector3 direction, float maxDistance) {
+    RayHit result = { .hit = false, .distance = maxDistance, .box = -1 };
+    if (bvh->nodeCount == 0) return result;
+    Vector3 inverseDirection = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BvhNode *node = &bvh->nodes[stack[--top]];
+        if (RayBoundsDistance(origin, inverseDirection, node->boundsMin, node->boundsMax, result.distance) == FLT_MAX) continue;
+        if (node->left < 0) {
+            for (int k = node->first; k < node->first + node->count; k++) {
+                int box = bvh->order[k];
+                RecordRayHit(&result, box, RayBoxDistance(origin, direction, &bvh->boxes[box].shape, result.distance));
+            }
+            continue;
+        }
+        // Far child first, so the near one is popped next and shortens the ray for the far one
+        int nearChild = (AxisComponent(direction, node->axis) >= 0.0f) ? node->left : node->left + 1;
+        stack[top++] = (nearChild == node->left) ? node->left + 1 : node->left;
+        stack[top++] = nearChild;
+    }
+    return result;
+}
+
+// Reference cast testing every box, for the benchmark
+RayHit RaycastBoxes(const HitScanBox *boxes, int boxCount, Vector3 origin, Vector3 direction, float maxDistance) {
+    RayHit result = { .hit = false, .distance = maxDistance, .box = -1 };
+    for (int i = 0; i < boxCount; i++) {
+        RecordRayHit(&result, i, RayBoxDistance(origin, direction, &boxes[i].shape, result.distance));
+    }
+    return result;
+}
+
+// Distance along the ray to where it first passes below the heightmap, or maxDistance if it never
+// does. Marches in HITSCAN_TERRAIN_STEP steps and bisects the step that crosses the ground.
+float RaycastTerrain(Vector3 origin, Vector3 direction, float maxDistance) {
+    int steps = (int)ceilf(maxDistance / HITSCAN_TERRAIN_STEP);
+    float above = 0.0f;
+    for (int s = 1; s <= steps; s++) {
+        float t = fminf((float)s * HITSCAN_TERRAIN_STEP, maxDistance);
+        Vector3 point = Vector3Add(origin, Vector3Scale(direction, t));
+        if (point.y >= SampleTerrainHeight(point.x, point.z)) {
+            above = t;
+            continue;
+        }
+        float below = t;
+        for (int n = 0; n < 8; n++) {
+            float middle = 0.5f * (above + below);
+            Vector3 probe = Vector3Add(origin, Vector3Scale(direction, middle));
+            if (probe.y >= SampleTerrainHeight(probe.x, probe.z)) above = middle;
+            else below = middle;
+        }
+        return below;
     }
+    return maxDistance;
+}
+
+// Refills the world's boxes from the pools and refits or rebuilds its tree
+void UpdateHitScanBvh(void) {
+    Bvh *bvh = &hitScanBvh;
+    bvh->boxes = hitScanBoxes;
+    bvh->order = hitScanOrder;
+    bvh->nodes = hitScanNodes;
+    int count = 0;
+    for (int i = 0; i < combatEntityCount; i++) SetHitScanBox(&hitScanBoxes[count++], HIT_COMBAT_ENTITY, i, CombatEntityBox(i));
+    for (int i = 0; i < tankCount; i++) SetHitScanBox(&hitScanBoxes[count++], HIT_TANK, i, TankBox(i));
+    for (int i = 0; i < crateCount; i++) SetHitScanBox(&hitScanBoxes[count++], HIT_CRATE, i, CrateBox(i));
+    bvh->boxCount = count;
+    UpdateBvh(bvh);
+    hitScanBvhCurrent = true;
+}
+
+// Pushes and spins a crate struck at impactPoint, shared by bullets and hit-scan shots
+void HitCrate(int index, Vector3 impactPoint, Vector3 direction, float impulseMagnitude) {
+    crates[index].velocity = Vector3Add(crates[index].velocity, Vector3Scale(direction, impulseMagnitude / cratesCold[index].mass));
+
+    Vector3 r = Vector3Subtract(impactPoint, crates[index].position);
+    Vector3 forceVector = Vector3Scale(direction, impulseMagnitude);
+    Vector3 torque = Vector3CrossProduct(r, forceVector);
+
+    float inverseInertia = 1.0f / cratesCold[index].mass;
+    crates[index].angularVelocity = Vector3Add(crates[index].angularVelocity, Vector3Scale(torque, inverseInertia * 0.1f));
+
+    crates[index].isPhysicsActive = true;
+    EmitEffect(EFFECT_BULLET_SPARKS, impactPoint, Vector3Negate(direction), 1.0f);
+
+    if (audioEnabled) {
+        float distance = Vector3Distance(camera.position, crates[index].position);
+        float maxDistance = 30.0f;
+        float attenuatedVolume = 1.0f - (distance / maxDistance);
+        if (attenuatedVolume < 0.0f) attenuatedVolume = 0.0f;
+
+        Vector3 relativePos = Vector3Subtract(crates[index].position, camera.position);
+        Vector3 cameraRight = Vector3CrossProduct(Vector3Normalize(Vector3Subtract(camera.target, camera.position)), camera.up);
+        float pan = Vector3DotProduct(relativePos, cameraRight) / maxDistance;
+        pan = Clamp(pan, -1.0f, 1.0f);
+        PlayGameSoundAt(crateHitSound, attenuatedVolume * 0.7f, pan);
+    }
+}
+
+// Resolves one hit-scan shot with the damage and impulse a player bullet would have delivered
+void FireHitScan(Vector3 origin, Vector3 direction, const GameConfig *cfg) {
+    if (!hitScanBvhCurrent) UpdateHitScanBvh();
+    float maxDistance = RaycastTerrain(origin, direction, HITSCAN_RANGE);
+    RayHit hit = hitScanReference ? RaycastBoxes(hitScanBoxes, hitScanBvh.boxCount, origin, direction, maxDistance)
+                                  : RaycastBvh(&hitScanBvh, origin, direction, maxDistance);
+    if (!hit.hit) return;
+    const HitScanBox *box = &hitScanBoxes[hit.box];
+    Vector3 hitPoint = Vector3Add(origin, Vector3Scale(direction, hit.distance));
+    switch (box->kind) {
+        case HIT_COMBAT_ENTITY:
+            EmitEffect(EFFECT_ENTITY_HIT, hitPoint, Vector3Negate(direction), 1.0f);
+            combatEntities[box->index].health -= 25.0f;
+            if (combatEntities[box->index].health <= 0) {
+                KillCombatEntity(box->index);
+                hitScanBvhCurrent = false; // The box indices no longer match the pool
+            }
+            break;
+        case HIT_TANK:
+            EmitEffect(EFFECT_BULLET_SPARKS, hitPoint, Vector3Negate(direction), 1.0f);
+            tanks[box->index].health -= 15.0f;
+            if (tanks[box->index].health <= 0) {
+                KillTank(box->index);
+                hitScanBvhCurrent = false;
+            }
+            break;
+        case HIT_CRATE:
+            HitCrate(box->index, hitPoint, direction, cfg->bulletMass * cfg->bulletSpeed);
+            break;
+    }
+}
+
+// --- Batched Explosion Resolution ---
+// Detonations only queue an event; damage for the whole frame is applied in one pass so that
+// carpet bombing costs one broadphase build plus a radius query per explosion.
+typedef struct {
+    Vector3 center;
+    float radius;
+    float falloff; // 0 = flat damage inside the radius, 1 = fades to zero at the edge (quadratic)
+    float entityDamage;
+    float tankDamage;
+    bool destroysCrates;
+    bool killsPlayer;
+    Handle directTank; // Tank hit directly (missile impacts), null for none
+    float directTankDamage;
+} ExplosionEvent;
+
+WORLD_LOCAL ExplosionEvent pendingExplosions[MAX_PENDING_EXPLOSIONS];
+WORLD_LOCAL int pendingExplosionCount = 0;
+
+void ResolveExplosions(void);
+
+void QueueExplosion(ExplosionEvent explosion) {
+    if (pendingExplosionCount >= MAX_PENDING_EXPLOSIONS) ResolveExplosions();
+    pendingExplosions[pendingExplosionCount++] = explosion;
+}
+
+// SoA view of one target pool: packed positions of live targets plus their pool index
+typedef struct {
+    float *x;
+    float *y;
+    float *z;
+    int *poolIndex;
+    float *damage; // Accumulated per packed target
+    int count;
+    SpatialGrid grid;
+} ExplosionTargets;
+
+bool AllocExplosionTargets(ExplosionTargets *targets, int capacity) {
+    targets->x = ARENA_ALLOC_ARRAY(&frameArena, float, capacity);
+    targets->y = ARENA_ALLOC_ARRAY(&frameArena, float, capacity);
+    targets->z = ARENA_ALLOC_ARRAY(&frameArena, float, capacity);
+    targets->poolIndex = ARENA_ALLOC_ARRAY(&frameArena, int, capacity);
+    targets->damage = ARENA_ALLOC_ARRAY(&frameArena, float, capacity);
+    targets->count = 0;
+    return targets->x && targets->y && targets->z && targets->poolIndex && targets->damage;
+}
+
+void PushExplosionTarget(ExplosionTargets *targets, Vector3 position, int poolIndex) {
+    int n = targets->count++;
+    targets->x[n] = position.x;
+    targets->y[n] = position.y;
+    targets->z[n] = position.z;
+    targets->poolIndex[n] = poolIndex;
+    targets->damage[n] = 0.0f;
+}
+
+// Radius query against the broadphase, then a branch-free falloff over the gathered candidates
+void AccumulateExplosionDamage(ExplosionTargets *targets, const ExplosionEvent *explosion, float damage, int *candidates, float *candX, float *candY, float *candZ, float *candDamage) {
+    if (damage <= 0.0f || explosion->radius <= 0.0f) return;
+    int n = QuerySpatialGrid(&targets->grid, explosion->center.x, explosion->center.z, explosion->radius, candidates, targets->count);
+    for (int k = 0; k < n; k++) {
+        candX[k] = targets->x[candidates[k]];
+        candY[k] = targets->y[candidates[k]];
+        candZ[k] = targets->z[candidates[k]];
+    }
+
+    float radiusSqr = explosion->radius * explosion->radius;
+    float invRadiusSqr = 1.0f / radiusSqr;
+    for (int k = 0; k < n; k++) {
+        float dx = candX[k] - explosion->center.x;
+        float dy = candY[k] - explosion->center.y;
+        float dz = candZ[k] - explosion->center.z;
+        float distSqr = dx * dx + dy * dy + dz * dz;
+        float scale = 1.0f - explosion->falloff * distSqr * invRadiusSqr;
+        candDamage[k] = (distSqr <= radiusSqr) ? damage * scale : 0.0f;
+    }
+
+    for (int k = 0; k < n; k++) {
+        targets->damage[candidates[k]] += candDamage[k];
+    }
+}
+
+void ResolveExplosions(void) {
+    if (pendingExplosionCount == 0) return;
+
+    ExplosionTargets entityTargets, tankTargets, crateTargets;
+    int maxTargets = MAX_ENTITIES;
+    if (MAX_TANKS > maxTargets) maxTargets = MAX_TANKS;
+    if (MAX_CRATES > maxTargets) maxTargets = MAX_CRATES;
+    int *candidates = ARENA_ALLOC_ARRAY(&frameArena, int, maxTargets);
+    float *candX = ARENA_ALLOC_ARRAY(&frameArena, float, maxTargets);
+    float *candY = ARENA_ALLOC_ARRAY(&frameArena, float, maxTargets);
+    float *candZ = ARENA_ALLOC_ARRAY(&frameArena, float, maxTargets);
+    float *candDamage = ARENA_ALLOC_ARRAY(&frameArena, float, maxTargets);
+    if (!AllocExplosionTargets(&entityTargets, MAX_ENTITIES) || !AllocExplosionTargets(&tankTargets, MAX_TANKS) ||
+        !AllocExplosionTargets(&crateTargets, MAX_CRATES) || !candidates || !candX || !candY || !candZ || !candDamage) {
+        TraceLog(LOG_WARNING, "EXPLOSIONS: Frame arena exhausted, dropping %d explosions", pendingExplosionCount);
+        pendingExplosionCount = 0;
+        return;
+    }
+
+    for (int j = 0; j < combatEntityCount; j++) {
+        PushExplosionTarget(&entityTargets, combatEntities[j].position, j);
+    }
+    for (int j = 0; j < tankCount; j++) {
+        PushExplosionTarget(&tankTargets, tanks[j].position, j);
+    }
+    for (int j = 0; j < crateCount; j++) {
+        PushExplosionTarget(&crateTargets, crates[j].position, j);
+    }
+    BuildSpatialGrid(&entityTargets.grid, &frameArena, entityTargets.x, entityTargets.z, entityTargets.count, BROADPHASE_CELL_SIZE, BROADPHASE_GRID_DIM);
+    BuildSpatialGrid(&tankTargets.grid, &frameArena, tankTargets.x, tankTargets.z, tankTargets.count, BROADPHASE_CELL_SIZE, BROADPHASE_GRID_DIM);
+    BuildSpatialGrid(&crateTargets.grid, &frameArena, crateTargets.x, crateTargets.z, crateTargets.count, BROADPHASE_CELL_SIZE, BROADPHASE_GRID_DIM);
+
+    bool playerKilled = false;
+    for (int e = 0; e < pendingExplosionCount; e++) {
+        const ExplosionEvent *explosion = &pendingExplosions[e];
+        AccumulateExplosionDamage(&entityTargets, explosion, explosion->entityDamage, candidates, candX, candY, candZ, candDamage);
+        AccumulateExplosionDamage(&tankTargets, explosion, explosion->tankDamage, candidates, candX, candY, candZ, candDamage);
+        if (explosion->destroysCrates) {
+            AccumulateExplosionDamage(&crateTargets, explosion, 1.0f, candidates, candX, candY, candZ, candDamage);
+        }
+        int directTank = ResolveHandle(&tankHandles, explosion->directTank);
+        if (directTank != -1) {
+            // Packed targets mirror the packed tank pool, so the pool index is the target index
+            tankTargets.damage[directTank] += explosion->directTankDamage;
+        }
+        if (explosion->killsPlayer && Vector3Distance(explosion->center, camera.position) <= explosion->radius) {
+            playerKilled = true;
+        }
+    }
+    pendingExplosionCount = 0;
+
+    // Apply accumulated damage and death bookkeeping once per target. Targets were packed in
+    // ascending pool order, so walking them backwards keeps swap-removals from moving unvisited ones.
+    for (int k = entityTargets.count - 1; k >= 0; k--) {
+        if (entityTargets.damage[k] <= 0.0f) continue;
+        int j = entityTargets.poolIndex[k];
+        combatEntities[j].health -= entityTargets.damage[k];
+        if (combatEntities[j].health <= 0) KillCombatEntity(j);
+    }
+    for (int k = tankTargets.count - 1; k >= 0; k--) {
+        if (tankTargets.damage[k] <= 0.0f) continue;
+        int j = tankTargets.poolIndex[k];
+        tanks[j].health -= tankTargets.damage[k];
+        if (tanks[j].health <= 0) KillTank(j);
+    }
+    for (int k = crateTargets.count - 1; k >= 0; k--) {
+        if (crateTargets.damage[k] > 0.0f) RemoveCrate(crateTargets.poolIndex[k]); // Destroy crate
+    }
+    if (playerKilled) KillPlayer();
+}
+
+// --- Flow Fields ---
+// One integration field per target group over the ground grid. Seeds are the group's possible
+// targets, resting crates block cells and tanks make cells expensive. Every agent of a group then
+// steers by reading one precomputed direction from its cell instead of doing its own avoidance.
+typedef enum {
+    FLOW_GROUP_ENEMY,    // Enemies converge on the player, friendlies and tanks
+    FLOW_GROUP_FRIENDLY, // Friendlies converge on enemies and tanks
+    FLOW_GROUP_TANK,     // Tanks converge on the player and friendlies
+    FLOW_GROUP_COUNT
+} FlowGroup;
+
+typedef struct {
+    unsigned short *integration; // Path cost to the nearest seed, FLOWFIELD_UNREACHED if there is none
+    unsigned char *direction;    // Index into flowDirectionX/Z, FLOWFIELD_NO_DIRECTION at seeds and dead ends
+} FlowField;
+
+typedef struct {
+    float originX, originZ; // World position of the outer corner of cell (0, 0)
+    unsigned char *cost; // Cost of entering each cell, FLOWFIELD_BLOCKED when impassable
+    int *bucketNext;     // Dial queue links, shared by every group's integration pass
+    int *bucketPrev;
+    FlowField fields[FLOW_GROUP_COUNT];
+} FlowFieldSet;
+
+WORLD_LOCAL FlowFieldSet flowFields = { 0 };
+
+// Neighbour offsets: the first four are orthogonal, the last four diagonal
+const int flowNeighborX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+const int flowNeighborZ[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+const float flowDirectionX[8] = { 1.0f, -1.0f, 0.0f, 0.0f, 0.70710678f, -0.70710678f, 0.70710678f, -0.70710678f };
+const float flowDirectionZ[8] = { 0.0f, 0.0f, 1.0f, -1.0f, 0.70710678f, 0.70710678f, -0.70710678f, -0.70710678f };
+const unsigned char flowOppositeDirection[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+
+// Cell along one axis, clamped to the field
+int FlowFieldCell(float coord, float origin) {
+    int cell = (int)floorf((coord - origin) / FLOWFIELD_CELL_SIZE);
+    if (cell < 0) cell = 0;
+    if (cell >= FLOWFIELD_DIM) cell = FLOWFIELD_DIM - 1;
+    return cell;
+}
+
+// Raises the cost of every cell overlapping the XZ rectangle to at least "value"
+void StampFlowFieldCost(FlowFieldSet *set, float minX, float minZ, float maxX, float maxZ, unsigned char value) {
+    int x0 = FlowFieldCell(minX, set->originX), x1 = FlowFieldCell(maxX, set->originX);
+    int z0 = FlowFieldCell(minZ, set->originZ), z1 = FlowFieldCell(maxZ, set->originZ);
+    for (int z = z0; z <= z1; z++) {
+        for (int x = x0; x <= x1; x++) {
+            unsigned char *cell = &set->cost[z * FLOWFIELD_DIM + x];
+            if (*cell < value) *cell = value;
+        }
+    }
+}
+
+// Unlinks a cell from its bucket in the Dial queue (buckets are intrusive doubly linked lists)
+void FlowBucketUnlink(FlowFieldSet *set, int *bucketHead, int bucket, int cell) {
+    if (set->bucketPrev[cell] != -1) set->bucketNext[set->bucketPrev[cell]] = set->bucketNext[cell];
+    else bucketHead[bucket] = set->bucketNext[cell];
+    if (set->bucketNext[cell] != -1) set->bucketPrev[set->bucketNext[cell]] = set->bucketPrev[cell];
+}
+
+void FlowBucketPush(FlowFieldSet *set, int *bucketHead, int bucket, int cell) {
+    set->bucketPrev[cell] = -1;
+    set->bucketNext[cell] = bucketHead[bucket];
+    if (bucketHead[bucket] != -1) set->bucketPrev[bucketHead[bucket]] = cell;
+    bucketHead[bucket] = cell;
+}
+
+// Multi-source Dijkstra over 8-neighbours with a circular bucket queue (edge weights are small
+// integers, so every cell is settled exactly once). Each relaxation also points the cell back at the
+// neighbour that improved it, so the direction field falls out of the same pass. Diagonal moves are
+// skipped when they would cut the corner of a blocked cell.
+void IntegrateFlowField(FlowFieldSet *set, FlowField *field, const float *seedX, const float *seedZ, int seedCount) {
+    const int cellCount = FLOWFIELD_DIM * FLOWFIELD_DIM;
+    unsigned short *integration = field->integration;
+    int bucketHead[FLOWFIELD_BUCKETS];
+    int pending = 0;
+
+    for (int b = 0; b < FLOWFIELD_BUCKETS; b++) bucketHead[b] = -1;
+    for (int c = 0; c < cellCount; c++) integration[c] = FLOWFIELD_UNREACHED;
+    memset(field->direction, FLOWFIELD_NO_DIRECTION, (size_t)cellCount);
+    for (int s = 0; s < seedCount; s++) {
+        int cell = FlowFieldCell(seedZ[s], set->originZ) * FLOWFIELD_DIM + FlowFieldCell(seedX[s], set->originX); // Far seeds pull towards the edge
+        if (integration[cell] == 0) continue;
+        integration[cell] = 0;
+        FlowBucketPush(set, bucketHead, 0, cell);
+        pending++;
+    }
+
+    for (int distance = 0; pending > 0; distance++) {
+        int bucket = distance % FLOWFIELD_BUCKETS;
+        while (bucketHead[bucket] != -1) {
+            int cell = bucketHead[bucket];
+            FlowBucketUnlink(set, bucketHead, bucket, cell);
+            pending--;
+            int cx = cell % FLOWFIELD_DIM, cz = cell / FLOWFIELD_DIM;
+            for (int n = 0; n < 8; n++) {
+                int nx = cx + flowNeighborX[n], nz = cz + flowNeighborZ[n];
+                if (nx < 0 || nx >= FLOWFIELD_DIM || nz < 0 || nz >= FLOWFIELD_DIM) continue;
+                int neighbor = nz * FLOWFIELD_DIM + nx;
+                if (set->cost[neighbor] == FLOWFIELD_BLOCKED) continue;
+                if (n >= 4 && (set->cost[cz * FLOWFIELD_DIM + nx] == FLOWFIELD_BLOCKED || set->cost[nz * FLOWFIELD_DIM + cx] == FLOWFIELD_BLOCKED)) continue;
+                int candidate = distance + set->cost[neighbor] * (n < 4 ? FLOWFIELD_STRAIGHT_STEP : FLOWFIELD_DIAGONAL_STEP);
+                if (candidate >= integration[neighbor]) continue;
+                if (integration[neighbor] == FLOWFIELD_UNREACHED) pending++;
+                else FlowBucketUnlink(set, bucketHead, integration[neighbor] % FLOWFIELD_BUCKETS, neighbor);
+                integration[neighbor] = (unsigned short)candidate;
+                field->direction[neighbor] = flowOppositeDirection[n];
+                FlowBucketPush(set, bucketHead, candidate % FLOWFIELD_BUCKETS, neighbor);
+            }
+        }
+    }
+}
+
+// Rebuilds the cost field and all group fields, centred on "centre", into the frame arena. Called once
+// per simulation tick with the centre of the simulation window, so the field moves with the window;
+// on arena exhaustion the fields are left empty and SampleFlowField() falls back to direct steering.
+bool BuildFlowFields(FlowFieldSet *set, FrameArena *arena, Vector3 centre) {
+    const int cellCount = FLOWFIELD_DIM * FLOWFIELD_DIM;
+    memset(set, 0, sizeof(*set));
+    set->originX = centre.x - FLOWFIELD_DIM / 2 * FLOWFIELD_CELL_SIZE;
+    set->originZ = centre.z - FLOWFIELD_DIM / 2 * FLOWFIELD_CELL_SIZE;
+    unsigned char *cost = ARENA_ALLOC_ARRAY(arena, unsigned char, cellCount);
+    int *bucketNext = ARENA_ALLOC_ARRAY(arena, int, cellCount);
+    int *bucketPrev = ARENA_ALLOC_ARRAY(arena, int, cellCount);
+    int seedCapacity = 1 + MAX_ENTITIES + MAX_TANKS;
+    float *seedX = ARENA_ALLOC_ARRAY(arena, float, seedCapacity);
+    float *seedZ = ARENA_ALLOC_ARRAY(arena, float, seedCapacity);
+    if (cost == NULL || bucketNext == NULL || bucketPrev == NULL || seedX == NULL || seedZ == NULL) return false;
+    set->cost = cost;
+    set->bucketNext = bucketNext;
+    set->bucketPrev = bucketPrev;
+
+    memset(cost, 1, (size_t)cellCount);
+    for (int i = 0; i < crateCount; i++) {
+        if (crates[i].position.y > SampleTerrainHeight(crates[i].position.x, crates[i].position.z) + 1.0f) continue; // Stacked or airborne crates do not block the ground
+        StampFlowFieldCost(set, crates[i].position.x - 0.5f, crates[i].position.z - 0.5f, crates[i].position.x + 0.5f, crates[i].position.z + 0.5f, FLOWFIELD_BLOCKED);
+    }
+    for (int i = 0; i < tankCount; i++) {
+        StampFlowFieldCost(set, tanks[i].position.x - (1.5f * TANK_SCALE_FACTOR), tanks[i].position.z - (2.5f * TANK_SCALE_FACTOR),
+                           tanks[i].position.x + (1.5f * TANK_SCALE_FACTOR), tanks[i].position.z + (2.5f * TANK_SCALE_FACTOR), FLOWFIELD_TANK_COST);
+    }
+
+    for (int group = 0; group < FLOW_GROUP_COUNT; group++) {
+        FlowField *field = &set->fields[group];
+        unsigned short *integration = ARENA_ALLOC_ARRAY(arena, unsigned short, cellCount);
+        unsigned char *direction = ARENA_ALLOC_ARRAY(arena, unsigned char, cellCount);
+        if (integration == NULL || direction == NULL) return false;
+
+        int seedCount = 0;
+        if (group != FLOW_GROUP_FRIENDLY && !gameOver) {
+            seedX[seedCount] = camera.position.x;
+            seedZ[seedCount++] = camera.position.z;
+        }
+        EntityType seedType = (group == FLOW_GROUP_FRIENDLY) ? ENTITY_ENEMY : ENTITY_FRIENDLY;
+        for (int i = 0; i < combatEntityCount; i++) {
+            if (combatEntitiesCold[i].type != seedType) continue;
+            seedX[seedCount] = combatEntities[i].position.x;
+            seedZ[seedCount++] = combatEntities[i].position.z;
+        }
+        if (group != FLOW_GROUP_TANK) {
+            for (int i = 0; i < tankCount; i++) {
+                seedX[seedCount] = tanks[i].position.x;
+                seedZ[seedCount++] = tanks[i].position.z;
+            }
+        }
+
+        field->integration = integration;
+        field->direction = direction;
+        IntegrateFlowField(set, field, seedX, seedZ, seedCount);
+    }
+    return true;
+}
+
+// Unit XZ steering direction at a world position, or zero at a seed, a dead end, outside the field
+// or without a field
+Vector3 SampleFlowField(const FlowFieldSet *set, FlowGroup group, Vector3 position) {
+    const FlowField *field = &set->fields[group];
+    if (field->direction == NULL) return Vector3Zero();
+    float cellX = floorf((position.x - set->originX) / FLOWFIELD_CELL_SIZE), cellZ = floorf((position.z - set->originZ) / FLOWFIELD_CELL_SIZE);
+    if (!(cellX >= 0.0f && cellX < FLOWFIELD_DIM && cellZ >= 0.0f && cellZ < FLOWFIELD_DIM)) return Vector3Zero();
+    unsigned char direction = field->direction[(int)cellZ * FLOWFIELD_DIM + (int)cellX];
+    if (direction == FLOWFIELD_NO_DIRECTION) return Vector3Zero();
+    return (Vector3){ flowDirectionX[direction], 0.0f, flowDirectionZ[direction] };
+}
+
+// --- AI Scheduler ---
+// Target searches are the expensive, slowly changing part of the AI. Each tick only a rotating
+// slice of agents (entities first, then tanks) re-runs its search; everyone else keeps steering
+// and shooting at the target cached in its hot data.
+typedef struct {
+    int cursor;                // Next agent to re-evaluate
+    int agentsPerTick;         // Re-evaluations per tick, 0 for no count limit
+    double budgetMicroseconds; // Wall-clock cap per tick, 0 to disable
+    int lastEvaluated;         // Agents re-evaluated during the last tick
+    double lastMicroseconds;   // Time spent during the last tick
+} AiScheduler;
+
+WORLD_LOCAL AiScheduler aiScheduler = { 0, AI_AGENTS_PER_TICK, AI_BUDGET_MICROSECONDS, 0, 0.0 };
+
+// Current position of a cached target; false when there is nothing to chase
+bool GetAiTargetPosition(AiTarget target, Vector3 *position) {
+    switch (target.kind) {
+        case AI_TARGET_PLAYER: *position = camera.position; return !gameOver;
+        case AI_TARGET_ENTITY: {
+            int index = ResolveHandle(&combatEntityHandles, target.handle);
+            if (index != -1) *position = combatEntities[index].position;
+            return index != -1;
+        }
+        case AI_TARGET_TANK: {
+            int index = ResolveHandle(&tankHandles, target.handle);
+            if (index != -1) *position = tanks[index].position;
+            return index != -1;
+        }
+        default: return false;
+    }
+}
+
+// Enemies prioritize the player, then friendly forces, then tanks; friendlies go for enemies, then tanks
+AiTarget SelectCombatEntityTarget(int i) {
+    Vector3 position = combatEntities[i].position;
+    EntityType preyType = ENTITY_FRIENDLY;
+    if (combatEntitiesCold[i].type == ENTITY_ENEMY) {
+        if (Vector3Distance(position, camera.position) < AI_ENTITY_TARGET_RANGE) return (AiTarget){ AI_TARGET_PLAYER, NULL_HANDLE };
+    } else {
+        preyType = ENTITY_ENEMY;
+    }
+    for (int j = 0; j < combatEntityCount; j++) {
+        if (combatEntitiesCold[j].type == preyType && Vector3Distance(position, combatEntities[j].position) < AI_ENTITY_TARGET_RANGE) {
+            return (AiTarget){ AI_TARGET_ENTITY, combatEntitiesCold[j].handle };
+        }
+    }
+    for (int j = 0; j < tankCount; j++) {
+        if (Vector3Distance(position, tanks[j].position) < AI_ENTITY_TARGET_RANGE) return (AiTarget){ AI_TARGET_TANK, tanksCold[j].handle };
+    }
+    return (AiTarget){ AI_TARGET_NONE, NULL_HANDLE };
+}
+
+// Tanks prioritize the player, then friendly forces
+AiTarget SelectTankTarget(int idx) {
+    if (Vector3Distance(tanks[idx].position, camera.position) < AI_TANK_TARGET_RANGE) return (AiTarget){ AI_TARGET_PLAYER, NULL_HANDLE };
+    for (int j = 0; j < combatEntityCount; j++) {
+        if (combatEntitiesCold[j].type == ENTITY_FRIENDLY && Vector3Distance(tanks[idx].position, combatEntities[j].position) < AI_TANK_TARGET_RANGE) {
+            return (AiTarget){ AI_TARGET_ENTITY, combatEntitiesCold[j].handle };
+        }
+    }
+    return (AiTarget){ AI_TARGET_NONE, NULL_HANDLE };
+}
+
+// Re-evaluates the next slice of agents, bounded by the agent count and/or the time budget
+void RunAiScheduler(AiScheduler *scheduler) {
+    double start = WallClockSeconds();
+    int agentCount = combatEntityCount + tankCount;
+    int evaluations = agentCount;
+    if (scheduler->agentsPerTick > 0 && scheduler->agentsPerTick < evaluations) evaluations = scheduler->agentsPerTick;
+
+    scheduler->lastEvaluated = 0;
+    for (int n = 0; n < evaluations; n++) {
+        int agent = scheduler->cursor % agentCount; // Cursor may point past the end after deaths
+        if (agent < combatEntityCount) {
+            combatEntities[agent].target = SelectCombatEntityTarget(agent);
+        } else {
+            tanks[agent - combatEntityCount].target = SelectTankTarget(agent - combatEntityCount);
+        }
+        scheduler->cursor = agent + 1;
+        scheduler->lastEvaluated++;
+        if (scheduler->budgetMicroseconds > 0.0 && (WallClockSeconds() - start) * 1e6 >= scheduler->budgetMicroseconds) break;
+    }
+    scheduler->lastMicroseconds = (WallClockSeconds() - start) * 1e6;
+}
+
+// --- Multi-Rate Scheduler ---
+// Unit classes update at their own fixed rate rather than once per frame. Each class accumulates
+// unsimulated time and runs as many whole sub-steps as fit: tanks (slow, heavy and the most
+// expensive to collide) at TANK_UPDATE_RATE, with only their kinematics integrated every frame so
+// positions extrapolate along the velocity of the last tick; missiles at MISSILE_UPDATE_RATE so
+// homing does not overshoot; infantry, crates and bullets at the frame rate.
+typedef struct {
+    float period;       // Seconds per sub-step
+    float accumulator;  // Time this class has not simulated yet
+} RateClock;
+
+WORLD_LOCAL RateClock tankClock = { 1.0f / TANK_UPDATE_RATE, 0.0f };
+WORLD_LOCAL RateClock missileClock = { 1.0f / MISSILE_UPDATE_RATE, 0.0f };
+
+// Adds a frame's time and returns the number of sub-steps to run now
+int AdvanceRateClock(RateClock *clock, float deltaTime) {
+    clock->accumulator += deltaTime;
+    int steps = (int)(clock->accumulator / clock->period);
+    if (steps > RATE_CLASS_MAX_STEPS) {
+        steps = RATE_CLASS_MAX_STEPS;
+        clock->accumulator = 0.0f; // Too far behind (hitch or debugger): drop the backlog
+    } else {
+        clock->accumulator -= steps * clock->period;
+    }
+    return steps;
+}
+
+// Tank broadphase buckets, rebuilt every tank tick with a cell sized for tanks. Entity items are
+// looked up through handles, so an entity crushed earlier in the tick (and swap-removed) is
+// skipped rather than mistaken for the one moved into its index.
+typedef struct {
+    SpatialGrid crates;
+    SpatialGrid entities;
+    SpatialGrid tanks;
+    Handle *entityHandles;
+    int *candidates;
+    int capacity;
+} TankBuckets;
+
+void BuildTankBuckets(TankBuckets *buckets, FrameArena *arena) {
+    buckets->capacity = MAX_CRATES + MAX_ENTITIES + MAX_TANKS;
+    buckets->candidates = ARENA_ALLOC_ARRAY(arena, int, buckets->capacity);
+    buckets->entityHandles = ARENA_ALLOC_ARRAY(arena, Handle, MAX_ENTITIES);
+    float *x = ARENA_ALLOC_ARRAY(arena, float, buckets->capacity);
+    float *z = ARENA_ALLOC_ARRAY(arena, float, buckets->capacity);
+    if (buckets->candidates == NULL || buckets->entityHandles == NULL || x == NULL || z == NULL) {
+        buckets->capacity = 0;
+        return;
+    }
+
+    float *crateX = x, *crateZ = z;
+    for (int i = 0; i < crateCount; i++) {
+        crateX[i] = crates[i].position.x;
+        crateZ[i] = crates[i].position.z;
+    }
+    float *entityX = crateX + crateCount, *entityZ = crateZ + crateCount;
+    for (int i = 0; i < combatEntityCount; i++) {
+        entityX[i] = combatEntities[i].position.x;
+        entityZ[i] = combatEntities[i].position.z;
+        buckets->entityHandles[i] = combatEntitiesCold[i].handle;
+    }
+    float *tankX = entityX + combatEntityCount, *tankZ = entityZ + combatEntityCount;
+    for (int i = 0; i < tankCount; i++) {
+        tankX[i] = tanks[i].position.x;
+        tankZ[i] = tanks[i].position.z;
+    }
+    BuildSpatialGrid(&buckets->crates, arena, crateX, crateZ, crateCount, TANK_BROADPHASE_CELL_SIZE, TANK_BROADPHASE_GRID_DIM);
+    BuildSpatialGrid(&buckets->entities, arena, entityX, entityZ, combatEntityCount, TANK_BROADPHASE_CELL_SIZE, TANK_BROADPHASE_GRID_DIM);
+    BuildSpatialGrid(&buckets->tanks, arena, tankX, tankZ, tankCount, TANK_BROADPHASE_CELL_SIZE, TANK_BROADPHASE_GRID_DIM);
+}
+
+// --- Timer Wheel ---
+// Cooldowns and delayed events are due at an absolute timer tick instead of being counted down on
+// every object each frame. Pending events hang off a hierarchical wheel: level 0 has one slot per
+// tick for the next 64 ticks, and each level above has slots 64 times as wide. Advancing a tick
+// fires one level-0 slot and, on every 64th tick, re-files the current slot of the level above one
+// level down, so the cost per tick follows the number of due events, not the number of objects.
+// Events name their object by handle; if the object is gone by then the event does nothing.
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE (1u << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) // Ticks ahead the wheel reaches
+
+typedef enum {
+    TIMER_PLAYER_GUN_READY,
+    TIMER_ENTITY_GUN_READY,
+    TIMER_TANK_GUN_READY,
+    TIMER_TANK_BOMB_READY,
+    TIMER_AIRCRAFT_BOMB_READY,
+    TIMER_AIRCRAFT_MISSILE_READY,
+    TIMER_BOMB_EXPLOSION_END,
+    TIMER_TANK_BOMB_EXPLOSION_END
+} TimerKind;
+
+typedef struct {
+    uint32_t deadline; // Tick the event fires on
+    int16_t next;      // Next event in the same slot (or in the free list), -1 ends the list
+    uint8_t kind;      // TimerKind
+    Handle target;     // Object the event applies to, NULL_HANDLE for world-level timers
+} TimerEvent;
+
+typedef struct {
+    uint32_t now; // Ticks since the match started
+    int16_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; // First event filed in each slot, -1 when empty
+    int16_t freeHead;
+    int pending;
+    TimerEvent events[MAX_TIMERS];
+} TimerWheel;
+
+WORLD_LOCAL TimerWheel timerWheel;
+WORLD_LOCAL RateClock timerClock = { 1.0f / TIMER_TICK_RATE, 0.0f };
+WORLD_LOCAL bool timerOverflowWarned = false; // A full wheel is logged once per reset, then only counted
+
+void ResetTimerWheel(TimerWheel *wheel) {
+    wheel->now = 0;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) wheel->slots[level][slot] = -1;
+    }
+    for (int e = 0; e < MAX_TIMERS; e++) wheel->events[e].next = (int16_t)((e + 1 < MAX_TIMERS) ? e + 1 : -1);
+    wheel->freeHead = 0;
+    wheel->pending = 0;
+    timerOverflowWarned = false;
+}
+
+// Files an event on the lowest level whose span covers its distance from now
+void LinkTimerEvent(TimerWheel *wheel, int16_t index) {
+    TimerEvent *event = &wheel->events[index];
+    uint32_t delta = event->deadline - wheel->now;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1u << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) level++;
+    int slot = (int)((event->deadline >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_MASK);
+    event->next = wheel->slots[level][slot];
+    wheel->slots[level][slot] = index;
+}
+
+// A delay in whole ticks: at least one, and short enough for the wheel to reach
+uint32_t TimerTicks(float seconds) {
+    float ticks = roundf(seconds * TIMER_TICK_RATE);
+    if (ticks < 1.0f) return 1u;
+    if (ticks >= (float)TIMER_WHEEL_RANGE) return TIMER_WHEEL_RANGE - 1u;
+    return (uint32_t)ticks;
+}
+
+// Schedules an event delaySeconds ahead. Returns false when every event is in use.
+bool ScheduleTimer(TimerWheel *wheel, TimerKind kind, Handle target, float delaySeconds) {
+    int16_t index = wheel->freeHead;
+    if (index == -1) {
+        CountTelemetry(TELEMETRY_TIMER_OVERFLOWS, 1);
+        if (!timerOverflowWarned) {
+            TraceLog(LOG_WARNING, "TIMERS: all %d timer events are pending, event %d runs immediately (further overflows are only counted)", MAX_TIMERS, (int)kind);
+            timerOverflowWarned = true;
+        }
+        return false;
+    }
+    wheel->freeHead = wheel->events[index].next;
+    wheel->events[index].deadline = wheel->now + TimerTicks(delaySeconds);
+    wheel->events[index].kind = (uint8_t)kind;
+    wheel->events[index].target = target;
+    LinkTimerEvent(wheel, index);
+    wheel->pending++;
+    return true;
+}
+
+// Clears a ready flag and schedules the event that sets it again; if the wheel is full the flag
+// stays set, so a weapon never locks up
+void StartCooldown(bool *ready, TimerKind kind, Handle target, float seconds) {
+    *ready = !ScheduleTimer(&timerWheel, kind, target, seconds);
+}
+
+void FireTimerEvent(const TimerEvent *event) {
+    int index;
+    switch ((TimerKind)event->kind) {
+        case TIMER_PLAYER_GUN_READY: playerGunReady = true; break;
+        case TIMER_ENTITY_GUN_READY:
+            index = ResolveHandle(&combatEntityHandles, event->target);
+            if (index != -1) combatEntitiesCold[index].gunReady = true;
+            break;
+        case TIMER_TANK_GUN_READY:
+            index = ResolveHandle(&tankHandles, event->target);
+            if (index != -1) tanksCold[index].gunReady = true;
+            break;
+        case TIMER_TANK_BOMB_READY:
+            index = ResolveHandle(&tankHandles, event->target);
+            if (index != -1) tanksCold[index].bombReady = true;
+            break;
+        case TIMER_AIRCRAFT_BOMB_READY:
+            index = ResolveHandle(&aircraftHandles, event->target);
+            if (index != -1) aircraftCold[index].bombReady = true;
+            break;
+        case TIMER_AIRCRAFT_MISSILE_READY:
+            index = ResolveHandle(&aircraftHandles, event->target);
+            if (index != -1) aircraftCold[index].missileReady = true;
+            break;
+        case TIMER_BOMB_EXPLOSION_END:
+            index = ResolveHandle(&bombHandles, event->target);
+            if (index != -1) RemoveBomb(bombs, &bombCount, &bombHandles, index);
+            break;
+        case TIMER_TANK_BOMB_EXPLOSION_END:
+            index = ResolveHandle(&tankBombHandles, event->target);
+            if (index != -1) RemoveBomb(tankBombs, &tankBombCount, &tankBombHandles, index);
+            break;
+    }
+}
+
+// Moves the wheel one tick forward and fires everything due on it. Higher levels cascade first,
+// so an event can drop more than one level on the same tick.
+void AdvanceTimerWheel(TimerWheel *wheel) {
+    wheel->now++;
+    for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        uint32_t span = 1u << (TIMER_WHEEL_SLOT_BITS * level);
+        if ((wheel->now & (span - 1)) != 0) continue;
+        int slot = (int)((wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_MASK);
+        int16_t index = wheel->slots[level][slot];
+        wheel->slots[level][slot] = -1;
+        while (index != -1) {
+            int16_t next = wheel->events[index].next;
+            LinkTimerEvent(wheel, index);
+            index = next;
+        }
+    }
+
+    int slot = (int)(wheel->now & TIMER_WHEEL_MASK);
+    int16_t index = wheel->slots[0][slot];
+    wheel->slots[0][slot] = -1;
+    while (index != -1) {
+        // Free the event before firing it, so the handler may schedule a follow-up
+        TimerEvent event = wheel->events[index];
+        wheel->events[index].next = wheel->freeHead;
+        wheel->freeHead = index;
+        wheel->pending--;
+        FireTimerEvent(&event);
+        index = event.next;
+    }
+}
+
+// Marks a bomb exploded and schedules its removal for when the explosion ends. Returns false if
+// that could not be scheduled, in which case the caller removes the bomb right away.
+bool StartBombExplosion(ProjectileBomb *bomb, TimerKind endKind) {
+    bomb->exploded = true;
+    bomb->explosionStartTick = timerWheel.now;
+    bomb->explosionEndTick = timerWheel.now + TimerTicks(bomb->explosion_duration);
+    return ScheduleTimer(&timerWheel, endKind, bomb->handle, bomb->explosion_duration);
+}
+
+// Explosion growth for drawing and replication, 0 when it starts and 1 when it ends
+float BombExplosionProgress(const ProjectileBomb *bomb) {
+    uint32_t length = bomb->explosionEndTick - bomb->explosionStartTick;
+    if (length == 0) return 1.0f;
+    return Clamp((float)(timerWheel.now - bomb->explosionStartTick) / (float)length, 0.0f, 1.0f);
+}
+
+// --- Aircraft ---
+// The jet is aircraft 0 and keeps its orbit; aircraft_count adds aircraft on random closed
+// waypoint loops, flown along a Catmull-Rom spline at the jet's ground speed. Their cooldowns are
+// timer events aimed at the aircraft's handle, like every other per-object cooldown.
+SIM_KERNEL Vector3 OrbitPosition(float angle, const GameConfig *cfg) {
+    return (Vector3){
+        jetCenterPoint.x + cfg->jetRadius * cosf(angle),
+        cfg->jetFlightHeight,
+        jetCenterPoint.z + cfg->jetRadius * sinf(angle)
+    };
+}
+
+float CatmullRom(float p0, float p1, float p2, float p3, float u) {
+    return 0.5f * (2.0f * p1 + (p2 - p0) * u + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u * u +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * u * u * u);
+}
+
+// Point t segments along the loop; segment k runs from waypoint k to waypoint k + 1
+Vector3 WaypointLoopPosition(const AircraftCold *cold, float t) {
+    int count = cold->waypointCount;
+    int segment = (int)floorf(t);
+    float u = t - (float)segment;
+    const Vector3 *p0 = &cold->waypoints[(segment + count - 1) % count];
+    const Vector3 *p1 = &cold->waypoints[segment % count];
+    const Vector3 *p2 = &cold->waypoints[(segment + 1) % count];
+    const Vector3 *p3 = &cold->waypoints[(segment + 2) % count];
+    return (Vector3){
+        CatmullRom(p0->x, p1->x, p2->x, p3->x, u),
+        CatmullRom(p0->y, p1->y, p2->y, p3->y, u),
+        CatmullRom(p0->z, p1->z, p2->z, p3->z, u)
+    };
+}
+
+// Length of the segment the loop parameter is on, measured as the chord between its waypoints
+float WaypointSegmentLength(const AircraftCold *cold, float t) {
+    int segment = (int)floorf(t);
+    float length = Vector3Distance(cold->waypoints[segment % cold->waypointCount], cold->waypoints[(segment + 1) % cold->waypointCount]);
+    return (length > 1.0f) ? length : 1.0f;
+}
+
+// Evaluates the path at the aircraft's current parameter. The heading is the direction to a point
+// a little further along, so both path kinds get it the same way.
+SIM_KERNEL void PlaceAircraft(int index, const GameConfig *cfg) {
+    Aircraft *plane = &aircraft[index];
+    const AircraftCold *cold = &aircraftCold[index];
+    Vector3 next;
+    if (cold->path == AIRCRAFT_PATH_ORBIT) {
+        plane->position = OrbitPosition(plane->pathParameter, cfg);
+        next = OrbitPosition(plane->pathParameter + 0.01f, cfg);
+    } else {
+        plane->position = WaypointLoopPosition(cold, plane->pathParameter);
+        next = WaypointLoopPosition(cold, plane->pathParameter + 0.01f);
+    }
+    plane->forward = Vector3Normalize(Vector3Subtract(next, plane->position));
+    plane->yawRotation = atan2f(plane->forward.x, plane->forward.z);
+}
+
+void ResetAircraftFleet(void) {
+    aircraftCount = 0;
+    ResetHandleTable(&aircraftHandles, MAX_AIRCRAFT);
+    int fleetSize = (int)config.aircraftCount;
+    if (fleetSize > MAX_AIRCRAFT) {
+        TraceLog(LOG_WARNING, "AIRCRAFT: aircraft_count %d exceeds MAX_AIRCRAFT, flying %d", fleetSize, MAX_AIRCRAFT);
+        fleetSize = MAX_AIRCRAFT;
+    }
+    for (int n = 0; n < fleetSize; n++) {
+        int i = AddAircraft();
+        AircraftCold *cold = &aircraftCold[i];
+        cold->lockedTarget = NULL_HANDLE;
+        aircraft[i].pathParameter = 0.0f;
+        if (n == 0) {
+            cold->path = AIRCRAFT_PATH_ORBIT;
+            cold->waypointCount = 0;
+            StartCooldown(&cold->bombReady, TIMER_AIRCRAFT_BOMB_READY, cold->handle, config.jetBombDropRate);
+            StartCooldown(&cold->missileReady, TIMER_AIRCRAFT_MISSILE_READY, cold->handle, config.jetMissileFireRate);
+        } else {
+            cold->path = AIRCRAFT_PATH_WAYPOINTS;
+            cold->waypointCount = AIRCRAFT_MIN_WAYPOINTS + WorldRand() % (AIRCRAFT_MAX_WAYPOINTS - AIRCRAFT_MIN_WAYPOINTS + 1);
+            for (int w = 0; w < cold->waypointCount; w++) {
+                cold->waypoints[w].x = (float)(WorldRand() % (2 * AIRCRAFT_PATROL_EXTENT + 1) - AIRCRAFT_PATROL_EXTENT);
+                cold->waypoints[w].y = config.jetFlightHeight + (float)(WorldRand() % (2 * AIRCRAFT_HEIGHT_SPREAD + 1) - AIRCRAFT_HEIGHT_SPREAD);
+                cold->waypoints[w].z = (float)(WorldRand() % (2 * AIRCRAFT_PATROL_EXTENT + 1) - AIRCRAFT_PATROL_EXTENT);
+            }
+            // First drop and launch anywhere within one extra cooldown, so a raid doesn't release in unison
+            StartCooldown(&cold->bombReady, TIMER_AIRCRAFT_BOMB_READY, cold->handle, config.jetBombDropRate * (1.0f + (WorldRand() % 100) / 100.0f));
+            StartCooldown(&cold->missileReady, TIMER_AIRCRAFT_MISSILE_READY, cold->handle, config.jetMissileFireRate * (1.0f + (WorldRand() % 100) / 100.0f));
+        }
+        PlaceAircraft(i, &config);
+    }
+}
+
+// --- World Streaming ---
+// The simulation keeps its terrain window on the player. Crates in chunks that leave the window
+// are frozen: moved out of the live pool into a compact store, skipped by every system, and put
+// back unchanged when their chunk comes back into the window. Combat units keep full-rate updates
+// wherever they are. Projectiles that leave the window are retired, replacing the fixed distance
+// limits around the origin.
+typedef struct {
+    Crate crate;
+    CrateCold cold; // The handle is reissued when the crate thaws
+} FrozenCrate;
+
+WORLD_LOCAL FrozenCrate frozenCrates[MAX_FROZEN_CRATES];
+WORLD_LOCAL int frozenCrateCount = 0;
+WORLD_LOCAL int simulationWindowX = 0, simulationWindowZ = 0; // Origin chunk of the player's window
+
+bool InSimulationWindow(Vector3 position) {
+    int chunkX = TerrainChunkCoord(position.x), chunkZ = TerrainChunkCoord(position.z);
+    return chunkX >= simulationWindowX && chunkX < simulationWindowX + STREAM_WINDOW_CHUNKS &&
+           chunkZ >= simulationWindowZ && chunkZ < simulationWindowZ + STREAM_WINDOW_CHUNKS;
+}
+
+// Runs at the start of every step. Which crates freeze depends only on the player's position, never
+// on how far the terrain loader has got, so replays and batch runs stay deterministic.
+void UpdateWorldStreaming(void) {
+    UpdateChunkStreaming(&terrainStream, camera.position);
+    StreamWindowOrigin(camera.position, &simulationWindowX, &simulationWindowZ);
+
+    for (int i = crateCount - 1; i >= 0; i--) {
+        if (InSimulationWindow(crates[i].position) || frozenCrateCount >= MAX_FROZEN_CRATES) continue;
+        frozenCrates[frozenCrateCount].crate = crates[i];
+        frozenCrates[frozenCrateCount].cold = cratesCold[i];
+        frozenCrateCount++;
+        RemoveCrate(i);
+    }
+    for (int i = frozenCrateCount - 1; i >= 0; i--) {
+        if (!InSimulationWindow(frozenCrates[i].crate.position)) continue;
+        int index = AddCrate();
+        if (index == -1) break; // Pool full: stays frozen until a slot frees up
+        Handle handle = cratesCold[index].handle;
+        crates[index] = frozenCrates[i].crate;
+        cratesCold[index] = frozenCrates[i].cold;
+        cratesCold[index].handle = handle;
+        frozenCrates[i] = frozenCrates[--frozenCrateCount];
+    }
+}
+
+// --- Game Initialization/Reset Function ---
+void ResetGame() {
+    // Reset player
+    playerHealth = 100.0f;
+    // UPDATED: Player position to one side of the 100x100 ground
+    float playerStartY = SampleTerrainHeight(0.0f, -45.0f) + 1.0f;
+    camera.position = (Vector3){ 0.0f, playerStartY, -45.0f };
+    camera.target = (Vector3){ 0.0f, playerStartY, -44.0f }; // Look slightly forward
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    jumpVelocity = 0.0f;
+    onGround = true;
+    gameOver = false;
+    SetGameCursor(false);
+
+    // Drop every pending timer; the cooldowns below start over from tick 0
+    ResetTimerWheel(&timerWheel);
+    timerClock.accumulator = 0.0f;
+
+    // Empty all projectile pools
+    playerBulletCount = 0;
+    entityBulletCount = 0;
+    tankBulletCount = 0;
+    bombCount = 0;
+    tankBombCount = 0;
+    ResetHandleTable(&bombHandles, MAX_BOMBS);
+    ResetHandleTable(&tankBombHandles, MAX_TANK_BOMBS);
+    missileCount = 0;
+    frozenCrateCount = 0;
+
+    // Reset combat entities (enemies and friendly forces)
+    activeEnemiesCount = 0;
+    activeFriendliesCount = 0;
+    combatEntityCount = 0;
+    ResetHandleTable(&combatEntityHandles, MAX_ENTITIES);
+    for (int n = 0; n < MAX_ENTITIES; n++) { // Loop up to new MAX_ENTITIES
+        int i = AddCombatEntity();
+        combatEntities[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
+        combatEntities[i].health = 100.0f;
+        combatEntities[i].target = (AiTarget){ AI_TARGET_NONE, NULL_HANDLE };
+        combatEntitiesCold[i].mass = 1.0f;
+        StartCooldown(&combatEntitiesCold[i].gunReady, TIMER_ENTITY_GUN_READY, combatEntitiesCold[i].handle, config.entityFireRate);
+
+        // Assign type and spawn position:
+        if (WorldRand() % 10 < 6) { // 6 out of 10 chance for enemy
+            combatEntitiesCold[i].type = ENTITY_ENEMY;
+            // UPDATED: Enemies spawn on the positive Z side of the 100x100 ground, spread out
+            combatEntities[i].position = (Vector3){ (float)(WorldRand() % 90 - 45), 1.0f, (float)(WorldRand() % 40 + 10) }; // Z from 10 to 49
+            activeEnemiesCount++;
+        } else {
+            combatEntitiesCold[i].type = ENTITY_FRIENDLY;
+            // UPDATED: Friendlies spawn on the negative Z side of the 100x100 ground, spread out
+            combatEntities[i].position = (Vector3){ (float)(WorldRand() % 90 - 45), 1.0f, (float)(WorldRand() % 40 - 50) }; // Z from -50 to -11
+            activeFriendliesCount++;
+        }
+        combatEntities[i].position.y = SampleTerrainHeight(combatEntities[i].position.x, combatEntities[i].position.z) + 1.0f;
+    }
+
+    // Reset crates (5 green, 5 yellow, 10 blue stacked)
+    float crateSize = 1.0f;
+    float halfCrate = crateSize / 2.0f;
+
+    crateCount = 0;
+    ResetHandleTable(&crateHandles, MAX_CRATES);
+    for (int n = 0; n < 10; n++) {
+        int i = AddCrate();
+        crates[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
+        crates[i].rotation = QuaternionIdentity();
+        crates[i].angularVelocity = Vector3Zero();
+        crates[i].isPhysicsActive = true;
+        cratesCold[i].mass = 2.0f;
+        cratesCold[i].color = (n < 5) ? GREEN : YELLOW;
+
+        bool placed = false;
+        int attempts = 0;
+        while (!placed && attempts < 50) {
+            // UPDATED: Random crate positions to cover 100x100 ground
+            Vector3 potentialPos = (Vector3){ (float)(WorldRand() % 90 - 45), halfCrate, (float)(WorldRand() % 90 - 45) };
+            potentialPos.y += SampleTerrainHeight(potentialPos.x, potentialPos.z);
+            bool overlap = false;
+
+            for (int j = 0; j < i; j++) {
+                Vector3 box1Min = { potentialPos.x - halfCrate, potentialPos.y - halfCrate, potentialPos.z - halfCrate };
+                Vector3 box1Max = { potentialPos.x + halfCrate, potentialPos.y + halfCrate, potentialPos.z + halfCrate };
+                Vector3 box2Min = { crates[j].position.x - halfCrate, crates[j].position.y - halfCrate, crates[j].position.z - halfCrate };
+                Vector3 box2Max = { crates[j].position.x + halfCrate, crates[j].position.y + halfCrate, crates[j].position.z + halfCrate };
+
+                if (CheckCollisionBoxes3D(box1Min, box1Max, box2Min, box2Max)) {
+                    overlap = true;
+                    break;
+                }
+            }
+            Vector3 playerInitialMin = { camera.position.x - config.playerRadius, camera.position.y - (config.playerHeight / 2.0f), camera.position.z - config.playerRadius };
+            Vector3 playerInitialMax = { camera.position.x + config.playerRadius, camera.position.y + (config.playerHeight / 2.0f), camera.position.z + config.playerRadius };
+            Vector3 potentialCrateMin = { potentialPos.x - halfCrate, potentialPos.y - halfCrate, potentialPos.z - halfCrate };
+            Vector3 potentialCrateMax = { potentialPos.x + halfCrate, potentialPos.y + halfCrate, potentialPos.z + halfCrate };
+            if (CheckCollisionBoxes3D(playerInitialMin, playerInitialMax, potentialCrateMin, potentialCrateMax)) {
+                overlap = true;
+            }
+
+            if (!overlap) {
+                crates[i].position = potentialPos;
+                placed = true;
+            }
+            attempts++;
+        }
+        if (!placed) {
+            crates[i].position = (Vector3){ (float)(WorldRand() % 90 - 45), halfCrate, (float)(WorldRand() % 90 - 45) }; // Fallback to new wider random range
+            crates[i].position.y += SampleTerrainHeight(crates[i].position.x, crates[i].position.z);
+            TraceLog(LOG_WARNING, "Failed to place crate %d without overlap after %d attempts. Placed randomly.", i, attempts);
+        }
+    }
+    // New blue stacked crates
+    // UPDATED: Stacked crates moved to a corner within the new 100x100 bounds
+    Vector3 resetStackBasePosition = { -40.0f, SampleTerrainHeight(-40.0f, -40.0f) + 0.5f, -40.0f };
+    for (int n = 0; n < 10; n++) {
+        int i = AddCrate();
+        crates[i].position = (Vector3){ resetStackBasePosition.x, resetStackBasePosition.y + n * 1.0f, resetStackBasePosition.z };
+        crates[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
+        crates[i].rotation = QuaternionIdentity();
+        crates[i].angularVelocity = Vector3Zero();
+        crates[i].isPhysicsActive = false;
+        cratesCold[i].mass = 2.0f;
+        cratesCold[i].color = BLUE;
+    }
+
+    // Initialize the tanks
+    tankCount = 0;
+    ResetHandleTable(&tankHandles, MAX_TANKS);
+    // UPDATED: Tank spawn positions to the positive Z side of the 100x100 ground, for 6 tanks
+    Vector3 tankSpawnPositions[MAX_TANKS] = {
+        { 40.0f, 1.0f, 40.0f },
+        { -40.0f, 1.0f, 40.0f },
+        { 0.0f, 1.0f, 45.0f },
+        { 30.0f, 1.0f, 35.0f }, // New tank 4
+        { -30.0f, 1.0f, 35.0f },// New tank 5
+        { 15.0f, 1.0f, 42.0f }  // New tank 6
+    };
+
+    for (int n = 0; n < MAX_TANKS; n++) { // Loop up to new MAX_TANKS
+        int i = AddTank();
+        tanks[i].position = tankSpawnPositions[n];
+        tanks[i].position.y += SampleTerrainHeight(tanks[i].position.x, tanks[i].position.z);
+        tanks[i].velocity = (Vector3){ 0.0f, 0.0f, 0.0f };
+        tanks[i].health = 200.0f; // Tank has more health
+        tanks[i].target = (AiTarget){ AI_TARGET_NONE, NULL_HANDLE };
+        StartCooldown(&tanksCold[i].gunReady, TIMER_TANK_GUN_READY, tanksCold[i].handle, config.tankFireRate);
+        StartCooldown(&tanksCold[i].bombReady, TIMER_TANK_BOMB_READY, tanksCold[i].handle, config.tankBombDropRate);
+        tanksCold[i].yawRotation = 0.0f;
+    }
+
+    // Reset aircraft and weapon timers so every game (and every batch match) starts from the same state
+    ResetAircraftFleet();
+    StartCooldown(&playerGunReady, TIMER_PLAYER_GUN_READY, NULL_HANDLE, config.playerFireRate);
+
+    pendingExplosionCount = 0;
+    aiScheduler.cursor = 0;
+    tankClock.accumulator = 0.0f;
+    missileClock.accumulator = 0.0f;
+    StreamWindowOrigin(camera.position, &simulationWindowX, &simulationWindowZ);
+}
+
+// --- World Snapshots ---
+// Plain-old-data copy of every pool plus player and camera state. Because all game
+// state already lives in fixed-size POD arrays a snapshot is a handful of memcpy calls.
+// Only the live prefix of each pool is captured, compared and restored: the slots past a
+// pool's count keep whatever an earlier capture left there, like dead slots in the world.
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int size;
+
+    // Player and camera
+    Camera camera;
+    float playerHealth;
+    bool onGround;
+    float jumpVelocity;
+    bool playerGunReady;
+    bool gameOver;
+    int activeEnemiesCount;
+    int activeFriendliesCount;
+
+    // AI and randomness
+    int aiCursor;
+    float tankClockAccumulator;
+    float missileClockAccumulator;
+    float timerClockAccumulator;
+    unsigned int randomState;
+
+    // Pool counts
+    int playerBulletCount;
+    int entityBulletCount;
+    int tankBulletCount;
+    int combatEntityCount;
+    int crateCount;
+    int bombCount;
+    int tankBombCount;
+    int tankCount;
+    int missileCount;
+    int frozenCrateCount;
+    int aircraftCount;
+
+    // Pools (hot and cold arrays)
+    Bullet playerBullets[MAX_PLAYER_BULLETS];
+    Bullet entityBullets[MAX_ENTITY_BULLETS];
+    Bullet tankBullets[MAX_TANK_BULLETS];
+    CombatEntity combatEntities[MAX_ENTITIES];
+    CombatEntityCold combatEntitiesCold[MAX_ENTITIES];
+    Crate crates[MAX_CRATES];
+    CrateCold cratesCold[MAX_CRATES];
+    ProjectileBomb bombs[MAX_BOMBS];
+    ProjectileBomb tankBombs[MAX_TANK_BOMBS];
+    Vehicle tanks[MAX_TANKS];
+    VehicleCold tanksCold[MAX_TANKS];
+    MissilePool missiles;
+    FrozenCrate frozenCrates[MAX_FROZEN_CRATES]; // Crates of chunks outside the player's window
+    Aircraft aircraft[MAX_AIRCRAFT];
+    AircraftCold aircraftCold[MAX_AIRCRAFT];
+
+    // Handle tables (slot maps and generations)
+    HandleTable combatEntityHandles;
+    HandleTable crateHandles;
+    HandleTable tankHandles;
+    HandleTable bombHandles;
+    HandleTable tankBombHandles;
+    HandleTable aircraftHandles;
+
+    // Pending cooldowns and delayed events
+    TimerWheel timerWheel;
+} WorldSnapshot;
+
+// Worst case for the delta encoder: one 4 byte run header per SNAPSHOT_MIN_ZERO_RUN + 1 input bytes
+#define SNAPSHOT_DELTA_CAPACITY (sizeof(WorldSnapshot) + sizeof(WorldSnapshot) / SNAPSHOT_MIN_ZERO_RUN + 16)
+
+// Pool arrays of a snapshot and the count field bounding their live prefix, in layout order
+typedef struct {
+    int offset;
+    int elementSize;
+    int capacity;
+    int countOffset;
+} SnapshotPool;
+
+#define SNAPSHOT_POOL(array, count) { (int)offsetof(WorldSnapshot, array), (int)sizeof(((WorldSnapshot *)0)->array[0]), \
+    (int)(sizeof(((WorldSnapshot *)0)->array) / sizeof(((WorldSnapshot *)0)->array[0])), (int)offsetof(WorldSnapshot, count) }
+
+const SnapshotPool snapshotPools[] = {
+    SNAPSHOT_POOL(playerBullets, playerBulletCount),
+    SNAPSHOT_POOL(entityBullets, entityBulletCount),
+    SNAPSHOT_POOL(tankBullets, tankBulletCount),
+    SNAPSHOT_POOL(combatEntities, combatEntityCount),
+    SNAPSHOT_POOL(combatEntitiesCold, combatEntityCount),
+    SNAPSHOT_POOL(crates, crateCount),
+    SNAPSHOT_POOL(cratesCold, crateCount),
+    SNAPSHOT_POOL(bombs, bombCount),
+    SNAPSHOT_POOL(tankBombs, tankBombCount),
+    SNAPSHOT_POOL(tanks, tankCount),
+    SNAPSHOT_POOL(tanksCold, tankCount),
+    SNAPSHOT_POOL(missiles.positionX, missileCount),
+    SNAPSHOT_POOL(missiles.positionY, missileCount),
+    SNAPSHOT_POOL(missiles.positionZ, missileCount),
+    SNAPSHOT_POOL(missiles.velocityX, missileCount),
+    SNAPSHOT_POOL(missiles.velocityY, missileCount),
+    SNAPSHOT_POOL(missiles.velocityZ, missileCount),
+    SNAPSHOT_POOL(missiles.speed, missileCount),
+    SNAPSHOT_POOL(missiles.targetTank, missileCount),
+    SNAPSHOT_POOL(missiles.damage, missileCount),
+    SNAPSHOT_POOL(frozenCrates, frozenCrateCount),
+    SNAPSHOT_POOL(aircraft, aircraftCount),
+    SNAPSHOT_POOL(aircraftCold, aircraftCount),
+};
+
+#define SNAPSHOT_POOL_COUNT ((int)(sizeof(snapshotPools) / sizeof(snapshotPools[0])))
+#define SNAPSHOT_MAX_RANGES (SNAPSHOT_POOL_COUNT + 2) // Every pool plus the fields before and after them
+
+typedef struct {
+    int offset;
+    int size;
+} SnapshotRange;
+
+int SnapshotPoolCount(const WorldSnapshot *snapshot, const SnapshotPool *pool) {
+    int count;
+    memcpy(&count, (const unsigned char *)snapshot + pool->countOffset, sizeof(count));
+    return count;
+}
+
+bool SnapshotCountsValid(const WorldSnapshot *snapshot) {
+    for (int p = 0; p < SNAPSHOT_POOL_COUNT; p++) {
+        int count = SnapshotPoolCount(snapshot, &snapshotPools[p]);
+        if (count < 0 || count > snapshotPools[p].capacity) return false;
+    }
+    return true;
+}
+
+// Byte ranges live in either snapshot, sorted and with touching ranges merged: every field outside
+// the pools, and each pool up to the larger of the two counts
+int SnapshotLiveRanges(const WorldSnapshot *a, const WorldSnapshot *b, SnapshotRange *ranges) {
+    int rangeCount = 0;
+    ranges[rangeCount++] = (SnapshotRange){ 0, snapshotPools[0].offset };
+    for (int p = 0; p < SNAPSHOT_POOL_COUNT; p++) {
+        const SnapshotPool *pool = &snapshotPools[p];
+        int countA = SnapshotPoolCount(a, pool), countB = SnapshotPoolCount(b, pool);
+        int count = (countA > countB) ? countA : countB;
+        if (count <= 0) continue;
+        if (count > pool->capacity) count = pool->capacity;
+        SnapshotRange *last = &ranges[rangeCount - 1];
+        if (last->offset + last->size == pool->offset) last->size += count * pool->elementSize;
+        else ranges[rangeCount++] = (SnapshotRange){ pool->offset, count * pool->elementSize };
+    }
+    const SnapshotPool *lastPool = &snapshotPools[SNAPSHOT_POOL_COUNT - 1];
+    int tail = lastPool->offset + lastPool->capacity * lastPool->elementSize;
+    SnapshotRange *last = &ranges[rangeCount - 1];
+    if (last->offset + last->size == tail) last->size += (int)sizeof(WorldSnapshot) - tail;
+    else ranges[rangeCount++] = (SnapshotRange){ tail, (int)sizeof(WorldSnapshot) - tail };
+    return rangeCount;
+}
+
+void CopySnapshotRanges(WorldSnapshot *to, const WorldSnapshot *from, const SnapshotRange *ranges, int rangeCount) {
+    for (int r = 0; r < rangeCount; r++) {
+        memcpy((unsigned char *)to + ranges[r].offset, (const unsigned char *)from + ranges[r].offset, (size_t)ranges[r].size);
+    }
+}
+
+void CopyMissiles(MissilePool *to, const MissilePool *from, int count) {
+    size_t lane = sizeof(float) * (size_t)count;
+    memcpy(to->positionX, from->positionX, lane);
+    memcpy(to->positionY, from->positionY, lane);
+    memcpy(to->positionZ, from->positionZ, lane);
+    memcpy(to->velocityX, from->velocityX, lane);
+    memcpy(to->velocityY, from->velocityY, lane);
+    memcpy(to->velocityZ, from->velocityZ, lane);
+    memcpy(to->speed, from->speed, lane);
+    memcpy(to->targetTank, from->targetTank, sizeof(Handle) * (size_t)count);
+    memcpy(to->damage, from->damage, lane);
+}
+
+WorldSnapshot matchStartSnapshot; // Captured after ResetGame(), restored for instant restarts
+WorldSnapshot rewindLatestSnapshot; // Most recent frame recorded into the rewind history
+WorldSnapshot snapshotScratch;
+unsigned char rewindDeltas[REWIND_HISTORY_FRAMES][SNAPSHOT_DELTA_CAPACITY];
+int rewindDeltaSizes[REWIND_HISTORY_FRAMES];
+int rewindHead = 0; // Slot the next delta is written to
+int rewindCount = 0; // Number of valid deltas behind rewindLatestSnapshot
+bool rewindHasLatest = false;
+
+void CaptureWorldSnapshot(WorldSnapshot *snapshot) {
+    snapshot->magic = SNAPSHOT_MAGIC;
+    snapshot->version = SNAPSHOT_VERSION;
+    snapshot->size = sizeof(WorldSnapshot);
+
+    snapshot->camera = camera;
+    snapshot->playerHealth = playerHealth;
+    snapshot->onGround = onGround;
+    snapshot->jumpVelocity = jumpVelocity;
+    snapshot->playerGunReady = playerGunReady;
+    snapshot->gameOver = gameOver;
+    snapshot->activeEnemiesCount = activeEnemiesCount;
+    snapshot->activeFriendliesCount = activeFriendliesCount;
+
+    snapshot->aiCursor = aiScheduler.cursor;
+    snapshot->tankClockAccumulator = tankClock.accumulator;
+    snapshot->missileClockAccumulator = missileClock.accumulator;
+    snapshot->timerClockAccumulator = timerClock.accumulator;
+    snapshot->randomState = worldRandomState;
+
+    snapshot->playerBulletCount = playerBulletCount;
+    snapshot->entityBulletCount = entityBulletCount;
+    snapshot->tankBulletCount = tankBulletCount;
+    snapshot->combatEntityCount = combatEntityCount;
+    snapshot->crateCount = crateCount;
+    snapshot->bombCount = bombCount;
+    snapshot->tankBombCount = tankBombCount;
+    snapshot->tankCount = tankCount;
+    snapshot->missileCount = missileCount;
+    snapshot->frozenCrateCount = frozenCrateCount;
+    snapshot->aircraftCount = aircraftCount;
+
+    memcpy(snapshot->playerBullets, playerBullets, sizeof(Bullet) * (size_t)playerBulletCount);
+    memcpy(snapshot->entityBullets, entityBullets, sizeof(Bullet) * (size_t)entityBulletCount);
+    memcpy(snapshot->tankBullets, tankBullets, sizeof(Bullet) * (size_t)tankBulletCount);
+    memcpy(snapshot->combatEntities, combatEntities, sizeof(CombatEntity) * (size_t)combatEntityCount);
+    memcpy(snapshot->combatEntitiesCold, combatEntitiesCold, sizeof(CombatEntityCold) * (size_t)combatEntityCount);
+    memcpy(snapshot->crates, crates, sizeof(Crate) * (size_t)crateCount);
+    memcpy(snapshot->cratesCold, cratesCold, sizeof(CrateCold) * (size_t)crateCount);
+    memcpy(snapshot->bombs, bombs, sizeof(ProjectileBomb) * (size_t)bombCount);
+    memcpy(snapshot->tankBombs, tankBombs, sizeof(ProjectileBomb) * (size_t)tankBombCount);
+    memcpy(snapshot->tanks, tanks, sizeof(Vehicle) * (size_t)tankCount);
+    memcpy(snapshot->tanksCold, tanksCold, sizeof(VehicleCold) * (size_t)tankCount);
+    CopyMissiles(&snapshot->missiles, &missiles, missileCount);
+    memcpy(snapshot->frozenCrates, frozenCrates, sizeof(FrozenCrate) * (size_t)frozenCrateCount);
+    memcpy(snapshot->aircraft, aircraft, sizeof(Aircraft) * (size_t)aircraftCount);
+    memcpy(snapshot->aircraftCold, aircraftCold, sizeof(AircraftCold) * (size_t)aircraftCount);
+    snapshot->combatEntityHandles = combatEntityHandles;
+    snapshot->crateHandles = crateHandles;
+    snapshot->tankHandles = tankHandles;
+    snapshot->bombHandles = bombHandles;
+    snapshot->tankBombHandles = tankBombHandles;
+    snapshot->aircraftHandles = aircraftHandles;
+    snapshot->timerWheel = timerWheel;
+}
+
+bool RestoreWorldSnapshot(const WorldSnapshot *snapshot) {
+    if (snapshot->magic != SNAPSHOT_MAGIC || snapshot->version != SNAPSHOT_VERSION || snapshot->size != sizeof(WorldSnapshot)) {
+        TraceLog(LOG_WARNING, "SNAPSHOT: Rejected snapshot (version %u, size %u), expected version %d, size %u",
+                 snapshot->version, snapshot->size, SNAPSHOT_VERSION, (unsigned int)sizeof(WorldSnapshot));
+        return false;
+    }
+    if (!SnapshotCountsValid(snapshot)) {
+        TraceLog(LOG_WARNING, "SNAPSHOT: Rejected snapshot with a pool count out of range");
+        return false;
+    }
+
+    camera = snapshot->camera;
+    playerHealth = snapshot->playerHealth;
+    onGround = snapshot->onGround;
+    jumpVelocity = snapshot->jumpVelocity;
+    playerGunReady = snapshot->playerGunReady;
+    gameOver = snapshot->gameOver;
+    activeEnemiesCount = snapshot->activeEnemiesCount;
+    activeFriendliesCount = snapshot->activeFriendliesCount;
+
+    aiScheduler.cursor = snapshot->aiCursor;
+    tankClock.accumulator = snapshot->tankClockAccumulator;
+    missileClock.accumulator = snapshot->missileClockAccumulator;
+    timerClock.accumulator = snapshot->timerClockAccumulator;
+    worldRandomState = snapshot->randomState;
+
+    playerBulletCount = snapshot->playerBulletCount;
+    entityBulletCount = snapshot->entityBulletCount;
+    tankBulletCount = snapshot->tankBulletCount;
+    combatEntityCount = snapshot->combatEntityCount;
+    crateCount = snapshot->crateCount;
+    bombCount = snapshot->bombCount;
+    tankBombCount = snapshot->tankBombCount;
+    tankCount = snapshot->tankCount;
+    missileCount = snapshot->missileCount;
+    frozenCrateCount = snapshot->frozenCrateCount;
+    aircraftCount = snapshot->aircraftCount;
+
+    memcpy(playerBullets, snapshot->playerBullets, sizeof(Bullet) * (size_t)playerBulletCount);
+    memcpy(entityBullets, snapshot->entityBullets, sizeof(Bullet) * (size_t)entityBulletCount);
+    memcpy(tankBullets, snapshot->tankBullets, sizeof(Bullet) * (size_t)tankBulletCount);
+    memcpy(combatEntities, snapshot->combatEntities, sizeof(CombatEntity) * (size_t)combatEntityCount);
+    memcpy(combatEntitiesCold, snapshot->combatEntitiesCold, sizeof(CombatEntityCold) * (size_t)combatEntityCount);
+    memcpy(crates, snapshot->crates, sizeof(Crate) * (size_t)crateCount);
+    memcpy(cratesCold, snapshot->cratesCold, sizeof(CrateCold) * (size_t)crateCount);
+    memcpy(bombs, snapshot->bombs, sizeof(ProjectileBomb) * (size_t)bombCount);
+    memcpy(tankBombs, snapshot->tankBombs, sizeof(ProjectileBomb) * (size_t)tankBombCount);
+    memcpy(tanks, snapshot->tanks, sizeof(Vehicle) * (size_t)tankCount);
+    memcpy(tanksCold, snapshot->tanksCold, sizeof(VehicleCold) * (size_t)tankCount);
+    CopyMissiles(&missiles, &snapshot->missiles, missileCount);
+    memcpy(frozenCrates, snapshot->frozenCrates, sizeof(FrozenCrate) * (size_t)frozenCrateCount);
+    memcpy(aircraft, snapshot->aircraft, sizeof(Aircraft) * (size_t)aircraftCount);
+    memcpy(aircraftCold, snapshot->aircraftCold, sizeof(AircraftCold) * (size_t)aircraftCount);
+    combatEntityHandles = snapshot->combatEntityHandles;
+    crateHandles = snapshot->crateHandles;
+    tankHandles = snapshot->tankHandles;
+    bombHandles = snapshot->bombHandles;
+    tankBombHandles = snapshot->tankBombHandles;
+    aircraftHandles = snapshot->aircraftHandles;
+    timerWheel = snapshot->timerWheel;
+
+    SetGameCursor(gameOver);
+    return true;
+}
+
+// Delta format: repeated [u16 zero run][u16 literal length][literal bytes], where literals are
+// the XOR of the two inputs. XOR makes the delta symmetric: it turns base into target and back.
+// Only the given ranges (sorted, not overlapping) are compared; the bytes between them are
+// written as unchanged without being read.
+int EncodeSnapshotDeltaRanges(const unsigned char *base, const unsigned char *target, const SnapshotRange *ranges, int rangeCount,
+                              unsigned char *out, int capacity) {
+    int written = 0;
+    int pos = 0;
+    int zeroRun = 0; // Unchanged bytes not yet written out
+    for (int r = 0; r < rangeCount; r++) {
+        zeroRun += ranges[r].offset - pos;
+        pos = ranges[r].offset;
+        int end = ranges[r].offset + ranges[r].size;
+        while (pos < end) {
+            while (pos < end && base[pos] == target[pos]) {
+                pos++;
+                zeroRun++;
+            }
+            if (pos == end) break;
+
+            // Literal run lasts until SNAPSHOT_MIN_ZERO_RUN unchanged bytes in a row are found
+            int literalStart = pos;
+            int unchanged = 0;
+            while (pos < end && pos - literalStart < 0xFFFF) {
+                if (base[pos] == target[pos]) {
+                    unchanged++;
+                    if (unchanged >= SNAPSHOT_MIN_ZERO_RUN) break;
+                } else {
+                    unchanged = 0;
+                }
+                pos++;
+            }
+            if (unchanged >= SNAPSHOT_MIN_ZERO_RUN) pos -= unchanged - 1; // Leave the unchanged bytes for the next zero run
+            else pos -= unchanged;
+            int literalRun = pos - literalStart;
+
+            for (; zeroRun > 0xFFFF; zeroRun -= 0xFFFF) {
+                if (written + 4 > capacity) return -1;
+                out[written++] = 0xFF;
+                out[written++] = 0xFF;
+                out[written++] = 0;
+                out[written++] = 0;
+            }
+            if (written + 4 + literalRun > capacity) return -1;
+            out[written++] = (unsigned char)(zeroRun & 0xFF);
+            out[written++] = (unsigned char)(zeroRun >> 8);
+            out[written++] = (unsigned char)(literalRun & 0xFF);
+            out[written++] = (unsigned char)(literalRun >> 8);
+            for (int i = 0; i < literalRun; i++) {
+                out[written++] = base[literalStart + i] ^ target[literalStart + i];
+            }
+            zeroRun = 0;
+        }
+    }
+    return written; // Trailing unchanged bytes are implied
+}
+
+int EncodeSnapshotDelta(const unsigned char *base, const unsigned char *target, int size, unsigned char *out, int capacity) {
+    SnapshotRange whole = { 0, size };
+    return EncodeSnapshotDeltaRanges(base, target, &whole, 1, out, capacity);
+}
+
+// Applies a delta in place: base becomes target (or target becomes base when walking backwards)
+bool ApplySnapshotDelta(unsigned char *data, int size, const unsigned char *delta, int deltaSize) {
+    int pos = 0;
+    int read = 0;
+    while (read + 4 <= deltaSize) {
+        int zeroRun = delta[read] | (delta[read + 1] << 8);
+        int literalRun = delta[read + 2] | (delta[read + 3] << 8);
+        read += 4;
+        pos += zeroRun;
+        if (pos + literalRun > size || read + literalRun > deltaSize) return false;
+        for (int i = 0; i < literalRun; i++) {
+            data[pos + i] ^= delta[read + i];
+        }
+        pos += literalRun;
+        read += literalRun;
+    }
+    return read == deltaSize;
+}
+
+void ClearRewindHistory(void) {
+    rewindHead = 0;
+    rewindCount = 0;
+    rewindHasLatest = false;
+}
+
+// Called once per frame after the simulation has run. The delta covers the pool slots live in
+// either frame, and exactly those bytes are then copied into the latest frame, so walking the
+// deltas backwards rebuilds every earlier frame's live state.
+void RecordRewindFrame(void) {
+    CaptureWorldSnapshot(&snapshotScratch);
+    SnapshotRange ranges[SNAPSHOT_MAX_RANGES];
+    int rangeCount = SnapshotLiveRanges(&rewindLatestSnapshot, &snapshotScratch, ranges);
+    if (rewindHasLatest) {
+        int deltaSize = EncodeSnapshotDeltaRanges((const unsigned char *)&rewindLatestSnapshot, (const unsigned char *)&snapshotScratch,
+                                                  ranges, rangeCount, rewindDeltas[rewindHead], (int)SNAPSHOT_DELTA_CAPACITY);
+        if (deltaSize < 0) {
+            TraceLog(LOG_WARNING, "SNAPSHOT: Delta did not fit, rewind history cleared");
+            ClearRewindHistory();
+        } else {
+            rewindDeltaSizes[rewindHead] = deltaSize;
+            rewindHead = (rewindHead + 1) % REWIND_HISTORY_FRAMES;
+            if (rewindCount < REWIND_HISTORY_FRAMES) rewindCount++;
+        }
+    }
+    CopySnapshotRanges(&rewindLatestSnapshot, &snapshotScratch, ranges, rangeCount);
+    rewindHasLatest = true;
+}
+
+// Walks the delta history backwards and restores the resulting world
+void RewindWorld(int frames) {
+    if (!rewindHasLatest) return;
+    int steps = 0;
+    while (steps < frames && rewindCount > 0) {
+        rewindHead = (rewindHead + REWIND_HISTORY_FRAMES - 1) % REWIND_HISTORY_FRAMES;
+        if (!ApplySnapshotDelta((unsigned char *)&rewindLatestSnapshot, (int)sizeof(WorldSnapshot), rewindDeltas[rewindHead], rewindDeltaSizes[rewindHead])) {
+            TraceLog(LOG_WARNING, "SNAPSHOT: Corrupt rewind delta, history cleared");
+            ClearRewindHistory();
+            return;
+        }
+        rewindCount--;
+        steps++;
+    }
+    RestoreWorldSnapshot(&rewindLatestSnapshot);
+}
+
+bool SaveWorldSnapshot(const char *fileName) {
+    memset(&snapshotScratch, 0, sizeof(WorldSnapshot)); // Files hold zeros, not stale slots
+    CaptureWorldSnapshot(&snapshotScratch);
+    return SaveFileData(fileName, &snapshotScratch, (int)sizeof(WorldSnapshot));
+}
+
+bool LoadWorldSnapshot(const char *fileName) {
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(fileName, &dataSize);
+    if (data == NULL) return false;
+
+    bool loaded = false;
+    if (dataSize == (int)sizeof(WorldSnapshot)) {
+        memcpy(&snapshotScratch, data, sizeof(WorldSnapshot));
+        loaded = RestoreWorldSnapshot(&snapshotScratch);
+    } else {
+        TraceLog(LOG_WARNING, "SNAPSHOT: %s has %d bytes, expected %u", fileName, dataSize, (unsigned int)sizeof(WorldSnapshot));
+    }
+    UnloadFileData(data);
+    if (loaded) ClearRewindHistory();
+    return loaded;
+}
+
+// --- State Hashing ---
+// 64-bit hashes of the canonical world state for determinism checks: one hash per field of every
+// pool, folded into one hash per tick. Only live elements are hashed (dead pool slots hold stale
+// copies), values are fed one field at a time so struct padding never reaches the hash, and -0 and
+// NaN floats each hash as a single bit pattern. Handles hash as the pool index they resolve to (-1
+// once stale): slot numbers and generations depend on every match the thread played before. The
+// mixing is xxHash64's round and avalanche.
+#define STATE_HASH_PRIME1 0x9E3779B185EBCA87ull
+#define STATE_HASH_PRIME2 0xC2B2AE3D27D4EB4Full
+#define STATE_HASH_PRIME3 0x165667B19E3779F9ull
+
+uint64_t StateHashRound(uint64_t acc, uint64_t input) {
+    acc += input * STATE_HASH_PRIME2;
+    acc = (acc << 31) | (acc >> 33);
+    return acc * STATE_HASH_PRIME1;
+}
+
+uint64_t StateHashAvalanche(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= STATE_HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= STATE_HASH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t StateHashInt(uint64_t acc, int value) {
+    return StateHashRound(acc, (uint32_t)value);
+}
+
+uint64_t StateHashUint(uint64_t acc, unsigned int value) {
+    return StateHashRound(acc, value);
+}
+
+uint64_t StateHashBool(uint64_t acc, bool value) {
+    return StateHashRound(acc, value ? 1u : 0u);
+}
+
+uint64_t StateHashFloat(uint64_t acc, float value) {
+    uint32_t bits;
+    if (value == 0.0f) value = 0.0f; // -0 hashes as +0
+    memcpy(&bits, &value, sizeof(bits));
+    if (value != value) bits = 0x7FC00000u;
+    return StateHashRound(acc, bits);
+}
+
+uint64_t StateHashVector3(uint64_t acc, Vector3 value) {
+    return StateHashFloat(StateHashFloat(StateHashFloat(acc, value.x), value.y), value.z);
+}
+
+uint64_t StateHashVector4(uint64_t acc, Vector4 value) {
+    return StateHashFloat(StateHashFloat(StateHashFloat(StateHashFloat(acc, value.x), value.y), value.z), value.w);
+}
+
+uint64_t StateHashColor(uint64_t acc, Color value) {
+    return StateHashRound(acc, (uint32_t)value.r | (uint32_t)value.g << 8 | (uint32_t)value.b << 16 | (uint32_t)value.a << 24);
+}
+
+uint64_t StateHashAiTarget(uint64_t acc, AiTarget value) {
+    int index = -1;
+    if (value.kind == AI_TARGET_ENTITY) index = ResolveHandle(&combatEntityHandles, value.handle);
+    else if (value.kind == AI_TARGET_TANK) index = ResolveHandle(&tankHandles, value.handle);
+    return StateHashInt(StateHashInt(acc, (int)value.kind), index);
+}
+
+// Pending events in firing order (level, slot, then list order); free events are skipped
+uint64_t StateHashTimerWheel(uint64_t acc, TimerWheel *wheel) {
+    acc = StateHashInt(StateHashUint(acc, wheel->now), wheel->pending);
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            for (int e = wheel->slots[level][slot]; e != -1; e = wheel->events[e].next) {
+                const TimerEvent *event = &wheel->events[e];
+                const HandleTable *table = NULL;
+                switch ((TimerKind)event->kind) {
+                    case TIMER_ENTITY_GUN_READY: table = &combatEntityHandles; break;
+                    case TIMER_TANK_GUN_READY: case TIMER_TANK_BOMB_READY: table = &tankHandles; break;
+                    case TIMER_BOMB_EXPLOSION_END: table = &bombHandles; break;
+                    case TIMER_TANK_BOMB_EXPLOSION_END: table = &tankBombHandles; break;
+                    case TIMER_AIRCRAFT_BOMB_READY: case TIMER_AIRCRAFT_MISSILE_READY: table = &aircraftHandles; break;
+                    default: break;
+                }
+                acc = StateHashInt(StateHashUint(acc, event->deadline), event->kind);
+                acc = StateHashInt(acc, (table != NULL) ? ResolveHandle(table, event->target) : -1);
+            }
+        }
+    }
+    return acc;
+}
+
+#define StateHashValue(acc, value) _Generic((value), \
+    int: StateHashInt, unsigned int: StateHashUint, bool: StateHashBool, float: StateHashFloat, Vector3: StateHashVector3, \
+    Vector4: StateHashVector4, Color: StateHashColor, AiTarget: StateHashAiTarget, TimerWheel *: StateHashTimerWheel)((acc), (value))
+
+#define STATE_HASH_ELEMENT(element) StateHashAvalanche(StateHashValue(STATE_HASH_PRIME3, (element)))
+
+// Every hashed field as (pool, field, live element count, element i). Covers what a WorldSnapshot
+// holds except the handle tables, which only matter through the handles resolved here, and patrol
+// waypoints, which are drawn at reset and never change; derived and render-only state (streaming
+// windows, BVHs, aircraft headings) is left out. Explosion ticks are only set once a bomb
+// explodes, so before that they hold whatever the slot's previous bomb left.
+#define WORLD_STATE_FIELDS(X) \
+    X(player, camera_position, 1, camera.position) \
+    X(player, camera_target, 1, camera.target) \
+    X(player, health, 1, playerHealth) \
+    X(player, on_ground, 1, onGround) \
+    X(player, jump_velocity, 1, jumpVelocity) \
+    X(player, gun_ready, 1, playerGunReady) \
+    X(player, game_over, 1, gameOver) \
+    X(world, random_state, 1, worldRandomState) \
+    X(world, ai_cursor, 1, aiScheduler.cursor) \
+    X(world, tank_clock, 1, tankClock.accumulator) \
+    X(world, missile_clock, 1, missileClock.accumulator) \
+    X(world, timer_clock, 1, timerClock.accumulator) \
+    X(world, active_enemies, 1, activeEnemiesCount) \
+    X(world, active_friendlies, 1, activeFriendliesCount) \
+    X(world, timers, 1, &timerWheel) \
+    X(combat_entities, count, 1, combatEntityCount) \
+    X(combat_entities, position, combatEntityCount, combatEntities[i].position) \
+    X(combat_entities, velocity, combatEntityCount, combatEntities[i].velocity) \
+    X(combat_entities, health, combatEntityCount, combatEntities[i].health) \
+    X(combat_entities, target, combatEntityCount, combatEntities[i].target) \
+    X(combat_entities, mass, combatEntityCount, combatEntitiesCold[i].mass) \
+    X(combat_entities, gun_ready, combatEntityCount, combatEntitiesCold[i].gunReady) \
+    X(combat_entities, type, combatEntityCount, (int)combatEntitiesCold[i].type) \
+    X(combat_entities, handle, combatEntityCount, ResolveHandle(&combatEntityHandles, combatEntitiesCold[i].handle)) \
+    X(crates, count, 1, crateCount) \
+    X(crates, position, crateCount, crates[i].position) \
+    X(crates, velocity, crateCount, crates[i].velocity) \
+    X(crates, rotation, crateCount, crates[i].rotation) \
+    X(crates, angular_velocity, crateCount, crates[i].angularVelocity) \
+    X(crates, physics_active, crateCount, crates[i].isPhysicsActive) \
+    X(crates, mass, crateCount, cratesCold[i].mass) \
+    X(crates, color, crateCount, cratesCold[i].color) \
+    X(crates, handle, crateCount, ResolveHandle(&crateHandles, cratesCold[i].handle)) \
+    X(frozen_crates, count, 1, frozenCrateCount) \
+    X(frozen_crates, position, frozenCrateCount, frozenCrates[i].crate.position) \
+    X(frozen_crates, velocity, frozenCrateCount, frozenCrates[i].crate.velocity) \
+    X(frozen_crates, rotation, frozenCrateCount, frozenCrates[i].crate.rotation) \
+    X(frozen_crates, angular_velocity, frozenCrateCount, frozenCrates[i].crate.angularVelocity) \
+    X(frozen_crates, physics_active, frozenCrateCount, frozenCrates[i].crate.isPhysicsActive) \
+    X(frozen_crates, mass, frozenCrateCount, frozenCrates[i].cold.mass) \
+    X(frozen_crates, color, frozenCrateCount, frozenCrates[i].cold.color) \
+    X(tanks, count, 1, tankCount) \
+    X(tanks, position, tankCount, tanks[i].position) \
+    X(tanks, velocity, tankCount, tanks[i].velocity) \
+    X(tanks, health, tankCount, tanks[i].health) \
+    X(tanks, target, tankCount, tanks[i].target) \
+    X(tanks, gun_ready, tankCount, tanksCold[i].gunReady) \
+    X(tanks, bomb_ready, tankCount, tanksCold[i].bombReady) \
+    X(tanks, yaw, tankCount, tanksCold[i].yawRotation) \
+    X(tanks, handle, tankCount, ResolveHandle(&tankHandles, tanksCold[i].handle)) \
+    X(player_bullets, count, 1, playerBulletCount) \
+    X(player_bullets, position, playerBulletCount, playerBullets[i].position) \
+    X(player_bullets, velocity, playerBulletCount, playerBullets[i].velocity) \
+    X(player_bullets, mass, playerBulletCount, playerBullets[i].mass) \
+    X(entity_bullets, count, 1, entityBulletCount) \
+    X(entity_bullets, position, entityBulletCount, entityBullets[i].position) \
+    X(entity_bullets, velocity, entityBulletCount, entityBullets[i].velocity) \
+    X(entity_bullets, mass, entityBulletCount, entityBullets[i].mass) \
+    X(tank_bullets, count, 1, tankBulletCount) \
+    X(tank_bullets, position, tankBulletCount, tankBullets[i].position) \
+    X(tank_bullets, velocity, tankBulletCount, tankBullets[i].velocity) \
+    X(tank_bullets, mass, tankBulletCount, tankBullets[i].mass) \
+    X(bombs, count, 1, bombCount) \
+    X(bombs, position, bombCount, bombs[i].position) \
+    X(bombs, velocity, bombCount, bombs[i].velocity) \
+    X(bombs, mass, bombCount, bombs[i].mass) \
+    X(bombs, explosion_start, bombCount, bombs[i].exploded ? bombs[i].explosionStartTick : 0u) \
+    X(bombs, explosion_end, bombCount, bombs[i].exploded ? bombs[i].explosionEndTick : 0u) \
+    X(bombs, exploded, bombCount, bombs[i].exploded) \
+    X(bombs, radius, bombCount, bombs[i].radius) \
+    X(bombs, explosion_radius, bombCount, bombs[i].explosion_radius) \
+    X(bombs, explosion_duration, bombCount, bombs[i].explosion_duration) \
+    X(bombs, handle, bombCount, ResolveHandle(&bombHandles, bombs[i].handle)) \
+    X(tank_bombs, count, 1, tankBombCount) \
+    X(tank_bombs, position, tankBombCount, tankBombs[i].position) \
+    X(tank_bombs, velocity, tankBombCount, tankBombs[i].velocity) \
+    X(tank_bombs, mass, tankBombCount, tankBombs[i].mass) \
+    X(tank_bombs, explosion_start, tankBombCount, tankBombs[i].exploded ? tankBombs[i].explosionStartTick : 0u) \
+    X(tank_bombs, explosion_end, tankBombCount, tankBombs[i].exploded ? tankBombs[i].explosionEndTick : 0u) \
+    X(tank_bombs, exploded, tankBombCount, tankBombs[i].exploded) \
+    X(tank_bombs, radius, tankBombCount, tankBombs[i].radius) \
+    X(tank_bombs, explosion_radius, tankBombCount, tankBombs[i].explosion_radius) \
+    X(tank_bombs, explosion_duration, tankBombCount, tankBombs[i].explosion_duration) \
+    X(tank_bombs, handle, tankBombCount, ResolveHandle(&tankBombHandles, tankBombs[i].handle)) \
+    X(aircraft, count, 1, aircraftCount) \
+    X(aircraft, position, aircraftCount, aircraft[i].position) \
+    X(aircraft, path_parameter, aircraftCount, aircraft[i].pathParameter) \
+    X(aircraft, path, aircraftCount, (int)aircraftCold[i].path) \
+    X(aircraft, waypoint_count, aircraftCount, aircraftCold[i].waypointCount) \
+    X(aircraft, bomb_ready, aircraftCount, aircraftCold[i].bombReady) \
+    X(aircraft, missile_ready, aircraftCount, aircraftCold[i].missileReady) \
+    X(aircraft, locked_target, aircraftCount, ResolveHandle(&tankHandles, aircraftCold[i].lockedTarget)) \
+    X(aircraft, handle, aircraftCount, ResolveHandle(&aircraftHandles, aircraftCold[i].handle)) \
+    X(missiles, count, 1, missileCount) \
+    X(missiles, position, missileCount, ((Vector3){ missiles.positionX[i], missiles.positionY[i], missiles.positionZ[i] })) \
+    X(missiles, velocity, missileCount, ((Vector3){ missiles.velocityX[i], missiles.velocityY[i], missiles.velocityZ[i] })) \
+    X(missiles, speed, missileCount, missiles.speed[i]) \
+    X(missiles, target, missileCount, ResolveHandle(&tankHandles, missiles.targetTank[i])) \
+    X(missiles, damage, missileCount, missiles.damage[i])
+
+typedef enum {
+#define STATE_FIELD_ENUM(pool, field, count, element) STATE_FIELD_##pool##_##field,
+    WORLD_STATE_FIELDS(STATE_FIELD_ENUM)
+#undef STATE_FIELD_ENUM
+    STATE_FIELD_COUNT
+} StateField;
+
+const char *stateFieldNames[STATE_FIELD_COUNT] = {
+#define STATE_FIELD_NAME(pool, field, count, element) #pool "." #field,
+    WORLD_STATE_FIELDS(STATE_FIELD_NAME)
+#undef STATE_FIELD_NAME
+};
+
+// Hashes the calling thread's world. Fills fieldHashes (STATE_FIELD_COUNT entries) unless it is
+// NULL and returns all of them folded into one.
+uint64_t HashWorldState(uint64_t *fieldHashes) {
+    uint64_t world = STATE_HASH_PRIME1;
+#define STATE_FIELD_HASH(pool, field, count, element) { \
+        int elementCount = (count); \
+        uint64_t hash = StateHashRound(STATE_HASH_PRIME2, (uint64_t)elementCount); \
+        for (int i = 0; i < elementCount; i++) hash = StateHashRound(hash, STATE_HASH_ELEMENT(element)); \
+        hash = StateHashAvalanche(hash); \
+        if (fieldHashes != NULL) fieldHashes[STATE_FIELD_##pool##_##field] = hash; \
+        world = StateHashRound(world, hash); \
+    }
+    WORLD_STATE_FIELDS(STATE_FIELD_HASH)
+#undef STATE_FIELD_HASH
+    return StateHashAvalanche(world);
+}
+
+// Per-element hashes of one field, for pinning a divergence to an element. Returns the live
+// element count, of which the first capacity are written.
+int HashWorldStateElements(StateField stateField, uint64_t *elementHashes, int capacity) {
+    switch (stateField) {
+#define STATE_FIELD_ELEMENTS(pool, field, count, element) \
+        case STATE_FIELD_##pool##_##field: \
+            for (int i = 0; i < (count) && i < capacity; i++) elementHashes[i] = STATE_HASH_ELEMENT(element); \
+            return (count);
+        WORLD_STATE_FIELDS(STATE_FIELD_ELEMENTS)
+#undef STATE_FIELD_ELEMENTS
+        default: return 0;
+    }
+}
+
+// --- Simulation Step ---
+// Player controls for one step. The interactive loop fills it from the keyboard and mouse, headless
+// worlds from a bot; camera look is applied to the camera directly before stepping.
+typedef struct {
+    bool forward;
+    bool back;
+    bool left;
+    bool right;
+    bool run;
+    bool jump;
+    bool fire;
+} PlayerInput;
+
+PlayerInput ReadPlayerInput(void) {
+    PlayerInput input = { 0 };
+    input.forward = IsKeyDown(KEY_W);
+    input.back = IsKeyDown(KEY_S);
+    input.left = IsKeyDown(KEY_A);
+    input.right = IsKeyDown(KEY_D);
+    input.run = IsKeyDown(KEY_LEFT_SHIFT);
+    input.jump = IsKeyPressed(KEY_SPACE);
+    input.fire = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+    return input;
+}
+
+// --- Missile Guidance ---
+// Missiles home with true proportional navigation: the commanded acceleration is N times the
+// closing speed times the line-of-sight rotation rate, applied normal to the line of sight, plus a
+// small pursuit term so a missile launched facing away still comes round. The turn per sub-step is
+// capped at missileTurnRate and speed is held constant. Each sub-step gathers the target states
+// through the handles into flat arrays, runs the arithmetic MISSILE_LANES missiles at a time with
+// no branches, then walks the results once to detonate and retire missiles.
+_Static_assert(MAX_MISSILES % MISSILE_LANES == 0, "the missile pool must hold whole lane blocks");
+
+#if MISSILE_LANES > 1
+static inline MissileLane LaneSplat(float value) {
+    return (MissileLane){ 0 } + value;
+}
+
+static inline MissileLane LaneSelect(MissileMask mask, MissileLane a, MissileLane b) {
+    return (MissileLane)(((MissileMask)a & mask) | ((MissileMask)b & ~mask));
+}
+
+// Bit-trick estimate refined by three Newton steps (about float precision)
+static inline MissileLane LaneRsqrt(MissileLane x) {
+    MissileLane y = (MissileLane)(0x5f375a86 - ((MissileMask)x >> 1));
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y * (1.5f - 0.5f * x * y * y);
+}
+#else
+static inline MissileLane LaneSplat(float value) {
+    return value;
+}
+
+static inline MissileLane LaneSelect(MissileMask mask, MissileLane a, MissileLane b) {
+    return mask ? a : b;
+}
+
+static inline MissileLane LaneRsqrt(MissileLane x) {
+    return 1.0f / sqrtf(x);
+}
+#endif
+
+static inline MissileLane LaneMin(MissileLane a, MissileLane b) { return LaneSelect(a < b, a, b); }
+static inline MissileLane LaneMax(MissileLane a, MissileLane b) { return LaneSelect(a > b, a, b); }
+
+static inline MissileLane LaneLoad(const float *source) {
+    MissileLane lane;
+    memcpy(&lane, source, sizeof(lane));
+    return lane;
+}
+
+static inline void LaneStore(float *destination, MissileLane lane) {
+    memcpy(destination, &lane, sizeof(lane));
+}
+
+// Per-missile target state for one sub-step, plus the kernel's output. Allocated once per frame
+// for every sub-step of that frame.
+typedef struct {
+    float *targetX, *targetY, *targetZ;          // Tank position (bottom centre of its box)
+    float *targetVelX, *targetVelY, *targetVelZ;
+    float *hasTarget;                            // 1 while the target handle resolves, else 0
+    float *hitFraction;                          // Out: point of the sub-step at which the missile enters the box, > 1 for none
+    float *ground;                               // Terrain height under each missile after the sub-step
+    int capacity;
+} MissileGuidanceLanes;
+
+bool AllocMissileGuidanceLanes(MissileGuidanceLanes *lanes, FrameArena *arena) {
+    int capacity = (missileCount + MISSILE_LANES - 1) / MISSILE_LANES * MISSILE_LANES;
+    float *block = ARENA_ALLOC_ARRAY(arena, float, 9 * (capacity > 0 ? capacity : MISSILE_LANES));
+    if (block == NULL) return false;
+    float **arrays[] = { &lanes->targetX, &lanes->targetY, &lanes->targetZ, &lanes->targetVelX, &lanes->targetVelY,
+                         &lanes->targetVelZ, &lanes->hasTarget, &lanes->hitFraction, &lanes->ground };
+    for (int a = 0; a < 9; a++) *arrays[a] = block + a * capacity;
+    lanes->capacity = capacity;
+    return true;
+}
+
+// Gathers each missile's target through its handle. Lanes past missileCount and missiles whose
+// target is gone get no target and fly on ballistically.
+void GatherMissileTargets(MissileGuidanceLanes *lanes) {
+    for (int i = 0; i < lanes->capacity; i++) {
+        int targetTank = (i < missileCount) ? ResolveHandle(&tankHandles, missiles.targetTank[i]) : -1;
+        if (targetTank != -1) {
+            lanes->targetX[i] = tanks[targetTank].position.x;
+            lanes->targetY[i] = tanks[targetTank].position.y;
+            lanes->targetZ[i] = tanks[targetTank].position.z;
+            lanes->targetVelX[i] = tanks[targetTank].velocity.x;
+            lanes->targetVelY[i] = tanks[targetTank].velocity.y;
+            lanes->targetVelZ[i] = tanks[targetTank].velocity.z;
+            lanes->hasTarget[i] = 1.0f;
+        } else {
+            lanes->targetX[i] = lanes->targetY[i] = lanes->targetZ[i] = 0.0f;
+            lanes->targetVelX[i] = lanes->targetVelY[i] = lanes->targetVelZ[i] = 0.0f;
+            lanes->hasTarget[i] = 0.0f;
+        }
+    }
+}
+
+// Guidance, swept impact test and integration for one block of MISSILE_LANES missiles
+SIM_KERNEL void GuideMissileLanes(int i, const MissileGuidanceLanes *lanes, float deltaTime, float cosTurn, float sinTurn, const GameConfig *cfg) {
+    const MissileLane zero = LaneSplat(0.0f), epsilon = LaneSplat(1.0e-6f);
+    MissileLane px = LaneLoad(&missiles.positionX[i]), py = LaneLoad(&missiles.positionY[i]), pz = LaneLoad(&missiles.positionZ[i]);
+    MissileLane vx = LaneLoad(&missiles.velocityX[i]), vy = LaneLoad(&missiles.velocityY[i]), vz = LaneLoad(&missiles.velocityZ[i]);
+    MissileLane speed = LaneLoad(&missiles.speed[i]);
+    MissileLane tx = LaneLoad(&lanes->targetX[i]), ty = LaneLoad(&lanes->targetY[i]), tz = LaneLoad(&lanes->targetZ[i]);
+    MissileMask guided = LaneLoad(&lanes->hasTarget[i]) > 0.5f;
+
+    vy = vy - cfg->gravity * deltaTime;
+
+    // Line of sight (aimed at the middle of the box) and the target's velocity relative to the missile
+    MissileLane rx = tx - px, ry = ty + 0.75f * TANK_SCALE_FACTOR - py, rz = tz - pz;
+    MissileLane inverseRange = LaneRsqrt(LaneMax(rx * rx + ry * ry + rz * rz, epsilon));
+    rx = rx * inverseRange; ry = ry * inverseRange; rz = rz * inverseRange;
+    MissileLane wx = LaneLoad(&lanes->targetVelX[i]) - vx, wy = LaneLoad(&lanes->targetVelY[i]) - vy, wz = LaneLoad(&lanes->targetVelZ[i]) - vz;
+    MissileLane alongSight = wx * rx + wy * ry + wz * rz;
+
+    // The part of the relative velocity normal to the line of sight is range * LOS rate, so
+    // N * Vc * LOS rate along it is N * Vc / range times that part. Opening targets get no PN term.
+    MissileLane navigation = cfg->missileNavigationGain * LaneMax(-alongSight, zero) * inverseRange;
+    MissileLane ax = navigation * (wx - alongSight * rx) + MISSILE_PURSUIT_GAIN * (rx * speed - vx);
+    MissileLane ay = navigation * (wy - alongSight * ry) + MISSILE_PURSUIT_GAIN * (ry * speed - vy);
+    MissileLane az = navigation * (wz - alongSight * rz) + MISSILE_PURSUIT_GAIN * (rz * speed - vz);
+
+    // Desired heading, then rotate the current heading towards it by at most the turn limit
+    MissileLane dx = vx + ax * deltaTime, dy = vy + ay * deltaTime, dz = vz + az * deltaTime;
+    MissileLane inverseDesired = LaneRsqrt(LaneMax(dx * dx + dy * dy + dz * dz, epsilon));
+    dx = dx * inverseDesired; dy = dy * inverseDesired; dz = dz * inverseDesired;
+    MissileLane inverseSpeed = LaneRsqrt(LaneMax(vx * vx + vy * vy + vz * vz, epsilon));
+    MissileLane ux = vx * inverseSpeed, uy = vy * inverseSpeed, uz = vz * inverseSpeed;
+    MissileLane turnCosine = ux * dx + uy * dy + uz * dz;
+    MissileLane ex = dx - turnCosine * ux, ey = dy - turnCosine * uy, ez = dz - turnCosine * uz;
+    MissileLane inverseNormal = LaneRsqrt(LaneMax(ex * ex + ey * ey + ez * ez, epsilon));
+    MissileMask limited = turnCosine < cosTurn;
+    dx = LaneSelect(limited, ux * cosTurn + ex * inverseNormal * sinTurn, dx);
+    dy = LaneSelect(limited, uy * cosTurn + ey * inverseNormal * sinTurn, dy);
+    dz = LaneSelect(limited, uz * cosTurn + ez * inverseNormal * sinTurn, dz);
+    vx = LaneSelect(guided, dx * speed, vx);
+    vy = LaneSelect(guided, dy * speed, vy);
+    vz = LaneSelect(guided, dz * speed, vz);
+
+    // Swept impact: slab test of this sub-step's segment against the target box grown by the
+    // missile radius, so fast missiles cannot tunnel through a tank between sub-steps
+    MissileLane sx = vx * deltaTime, sy = vy * deltaTime, sz = vz * deltaTime;
+    MissileLane invX = 1.0f / LaneSelect(sx * sx < epsilon * epsilon, LaneSelect(sx < 0.0f, -epsilon, epsilon), sx);
+    MissileLane invY = 1.0f / LaneSelect(sy * sy < epsilon * epsilon, LaneSelect(sy < 0.0f, -epsilon, epsilon), sy);
+    MissileLane invZ = 1.0f / LaneSelect(sz * sz < epsilon * epsilon, LaneSelect(sz < 0.0f, -epsilon, epsilon), sz);
+    const float halfX = 1.5f * TANK_SCALE_FACTOR + MISSILE_RADIUS, halfZ = 2.5f * TANK_SCALE_FACTOR + MISSILE_RADIUS;
+    MissileLane x1 = (tx - halfX - px) * invX, x2 = (tx + halfX - px) * invX;
+    MissileLane y1 = (ty - MISSILE_RADIUS - py) * invY, y2 = (ty + 1.5f * TANK_SCALE_FACTOR + MISSILE_RADIUS - py) * invY;
+    MissileLane z1 = (tz - halfZ - pz) * invZ, z2 = (tz + halfZ - pz) * invZ;
+    MissileLane enter = LaneMax(LaneMax(LaneMin(x1, x2), LaneMin(y1, y2)), LaneMin(z1, z2));
+    MissileLane exit = LaneMin(LaneMin(LaneMax(x1, x2), LaneMax(y1, y2)), LaneMax(z1, z2));
+    MissileMask hit = guided & (enter <= exit) & (exit >= 0.0f) & (enter <= 1.0f);
+    LaneStore(&lanes->hitFraction[i], LaneSelect(hit, LaneMax(enter, zero), LaneSplat(2.0f)));
+
+    LaneStore(&missiles.positionX[i], px + sx);
+    LaneStore(&missiles.positionY[i], py + sy);
+    LaneStore(&missiles.positionZ[i], pz + sz);
+    LaneStore(&missiles.velocityX[i], vx);
+    LaneStore(&missiles.velocityY[i], vy);
+    LaneStore(&missiles.velocityZ[i], vz);
+}
+
+// One missile sub-step for every missile in flight
+SIM_KERNEL void StepMissiles(float deltaTime, MissileGuidanceLanes *lanes, const GameConfig *cfg) {
+    GatherMissileTargets(lanes);
+    float maxTurn = fminf(cfg->missileTurnRate * deltaTime, PI);
+    float cosTurn = cosf(maxTurn), sinTurn = sinf(maxTurn);
+    for (int i = 0; i < lanes->capacity; i += MISSILE_LANES) GuideMissileLanes(i, lanes, deltaTime, cosTurn, sinTurn, cfg);
+    SampleTerrainHeights(missiles.positionX, missiles.positionZ, sizeof(float), missileCount, lanes->ground);
+
+    bool impacted = false;
+    for (int i = missileCount - 1; i >= 0; i--) {
+        Vector3 position = { missiles.positionX[i], missiles.positionY[i], missiles.positionZ[i] };
+        if (lanes->hitFraction[i] <= 1.0f) {
+            // Direct hit only: no blast radius, damage goes to the tracked tank
+            float remaining = (1.0f - lanes->hitFraction[i]) * deltaTime;
+            Vector3 impactPoint = { position.x - missiles.velocityX[i] * remaining, position.y - missiles.velocityY[i] * remaining,
+                                    position.z - missiles.velocityZ[i] * remaining };
+            ExplosionEvent impact = { impactPoint, 0.0f, 0.0f, 0.0f, 0.0f, false, false, missiles.targetTank[i], missiles.damage[i] };
+            QueueExplosion(impact);
+            EmitEffect(EFFECT_MISSILE_IMPACT, impactPoint, Vector3Normalize(Vector3Negate((Vector3){ missiles.velocityX[i], missiles.velocityY[i], missiles.velocityZ[i] })), 1.0f);
+            impacted = true;
+            RemoveMissile(i);
+        } else if (!InSimulationWindow(position) || position.y < lanes->ground[i]) {
+            RemoveMissile(i); // Left the streamed world or flew into the ground
+        }
+    }
+    if (impacted) PlayGameSound(missileImpactSound); // One sound per sub-step, however large the salvo
+}
+
+// --- Particles ---
+// Render-side particle pools, one per emitter type, kept as parallel arrays so the update runs
+// MISSILE_LANES particles per operation with the missile lane helpers. Each pool is drawn as a
+// single batch of camera-facing quads with that emitter's blend mode, so the whole system costs
+// one draw call per emitter type. Effects spawn fewer particles with distance from the camera
+// and share a per-frame budget, so a carpet of bombs cannot stall a frame.
+_Static_assert(MAX_PARTICLES % MISSILE_LANES == 0, "particle pools must hold whole lane blocks");
+_Static_assert(MAX_PARTICLES <= RL_DEFAULT_BATCH_BUFFER_ELEMENTS, "a particle pool must fit in one rlgl batch");
+
+typedef enum {
+    PARTICLE_FIRE,
+    PARTICLE_SMOKE,
+    PARTICLE_SPARK,
+    PARTICLE_PUFF,  // Dust kicked off a hit combat entity
+    PARTICLE_FLASH,
+    PARTICLE_KIND_COUNT
+} ParticleKind;
+
+typedef struct {
+    Color startColor;  // Colour over the particle's life, alpha included
+    Color endColor;
+    float gravity;     // Downward acceleration; negative rises
+    float drag;        // Share of the velocity lost per second
+    float speedMin, speedMax;
+    float lifeMin, lifeMax;
+    float sizeStart, sizeEnd; // Quad edge length over the particle's life
+    bool additive;
+} ParticleEmitterInfo;
+
+const ParticleEmitterInfo particleEmitters[PARTICLE_KIND_COUNT] = {
+    [PARTICLE_FIRE] = { { 255, 200, 80, 255 }, { 200, 40, 0, 0 }, -2.0f, 2.0f, 4.0f, 12.0f, 0.4f, 0.9f, 1.2f, 2.5f, true },
+    [PARTICLE_SMOKE] = { { 90, 90, 90, 160 }, { 60, 60, 60, 0 }, -1.5f, 1.5f, 1.0f, 4.0f, 1.2f, 2.5f, 1.5f, 4.0f, false },
+    [PARTICLE_SPARK] = { { 255, 240, 160, 255 }, { 255, 120, 0, 0 }, 20.0f, 0.5f, 6.0f, 14.0f, 0.2f, 0.5f, 0.12f, 0.04f, true },
+    [PARTICLE_PUFF] = { { 120, 30, 20, 220 }, { 80, 60, 50, 0 }, 8.0f, 3.0f, 1.0f, 3.0f, 0.3f, 0.6f, 0.25f, 0.5f, false },
+    [PARTICLE_FLASH] = { { 255, 230, 150, 255 }, { 255, 150, 50, 0 }, 0.0f, 8.0f, 2.0f, 6.0f, 0.05f, 0.12f, 0.5f, 0.2f, true },
+};
+
+// Particles one effect throws from one emitter at scale 1 and full detail
+typedef struct {
+    ParticleKind kind;
+    int count;
+    float directionBias; // Weight of the effect's direction against a random one
+} ParticleBurst;
+
+const ParticleBurst effectBursts[EFFECT_KIND_COUNT][EFFECT_MAX_BURSTS] = {
+    [EFFECT_EXPLOSION] = { { PARTICLE_FIRE, 48, 0.5f }, { PARTICLE_SMOKE, 24, 0.8f }, { PARTICLE_SPARK, 24, 0.3f } },
+    [EFFECT_MISSILE_IMPACT] = { { PARTICLE_FIRE, 16, 0.3f }, { PARTICLE_SMOKE, 8, 0.5f }, { PARTICLE_SPARK, 16, 0.0f } },
+    [EFFECT_BULLET_SPARKS] = { { PARTICLE_SPARK, 8, 1.0f } },
+    [EFFECT_ENTITY_HIT] = { { PARTICLE_PUFF, 10, 1.0f } },
+    [EFFECT_MUZZLE_FLASH] = { { PARTICLE_FLASH, 6, 3.0f } },
+};
+
+typedef struct {
+    float positionX[MAX_PARTICLES];
+    float positionY[MAX_PARTICLES];
+    float positionZ[MAX_PARTICLES];
+    float velocityX[MAX_PARTICLES];
+    float velocityY[MAX_PARTICLES];
+    float velocityZ[MAX_PARTICLES];
+    float age[MAX_PARTICLES];      // Seconds since spawn
+    float lifetime[MAX_PARTICLES];
+    float size[MAX_PARTICLES];     // Multiplier on the emitter's size
+    int count;
+} ParticlePool;
+
+ParticlePool particlePools[PARTICLE_KIND_COUNT];
+int particleFrameSpawns = 0; // Spawned since the last UpdateParticles, against PARTICLE_FRAME_BUDGET
+unsigned int particleRandomState = 0x2545F491u; // Own stream: effects must not consume WorldRand()
+
+// xorshift32 mapped to [0, 1)
+float ParticleRandom(void) {
+    unsigned int x = particleRandomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    particleRandomState = x;
+    return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Share of an effect's particles spawned at this distance from the camera
+float ParticleDetail(Vector3 position) {
+    float distance = Vector3Distance(position, camera.position);
+    if (distance <= PARTICLE_LOD_NEAR) return 1.0f;
+    if (distance >= PARTICLE_LOD_FAR) return 0.0f;
+    return Lerp(1.0f, PARTICLE_LOD_MIN_DETAIL, (distance - PARTICLE_LOD_NEAR) / (PARTICLE_LOD_FAR - PARTICLE_LOD_NEAR));
+}
+
+void SpawnParticles(ParticleKind kind, Vector3 position, Vector3 direction, float directionBias, int count) {
+    ParticlePool *pool = &particlePools[kind];
+    const ParticleEmitterInfo *info = &particleEmitters[kind];
+    for (int n = 0; n < count && pool->count < MAX_PARTICLES; n++) {
+        // Uniform direction on the sphere, pulled towards the effect's direction
+        float y = ParticleRandom() * 2.0f - 1.0f;
+        float angle = ParticleRandom() * 2.0f * PI;
+        float ring = sqrtf(fmaxf(1.0f - y * y, 0.0f));
+        Vector3 heading = Vector3Normalize(Vector3Add((Vector3){ ring * cosf(angle), y, ring * sinf(angle) }, Vector3Scale(direction, directionBias)));
+        float speed = Lerp(info->speedMin, info->speedMax, ParticleRandom());
+        int i = pool->count++;
+        pool->positionX[i] = position.x;
+        pool->positionY[i] = position.y;
+        pool->positionZ[i] = position.z;
+        pool->velocityX[i] = heading.x * speed;
+        pool->velocityY[i] = heading.y * speed;
+        pool->velocityZ[i] = heading.z * speed;
+        pool->age[i] = 0.0f;
+        pool->lifetime[i] = Lerp(info->lifeMin, info->lifeMax, ParticleRandom());
+        pool->size[i] = 0.7f + 0.6f * ParticleRandom();
+    }
+}
+
+void SpawnEffect(const EffectEvent *event) {
+    float detail = ParticleDetail(event->position) * event->scale;
+    for (int b = 0; b < EFFECT_MAX_BURSTS; b++) {
+        const ParticleBurst *burst = &effectBursts[event->kind][b];
+        if (burst->count == 0) continue;
+        int requested = (int)ceilf((float)burst->count * detail);
+        int count = requested;
+        if (count > PARTICLE_FRAME_BUDGET - particleFrameSpawns) count = PARTICLE_FRAME_BUDGET - particleFrameSpawns;
+        if (count > MAX_PARTICLES - particlePools[burst->kind].count) count = MAX_PARTICLES - particlePools[burst->kind].count;
+        if (count < 0) count = 0;
+        SpawnParticles(burst->kind, event->position, event->direction, burst->directionBias, count);
+        particleFrameSpawns += count;
+        CountTelemetry(TELEMETRY_PARTICLES_SPAWNED, count);
+        CountTelemetry(TELEMETRY_PARTICLES_CULLED, (unsigned long long)(requested - count));
+    }
+}
+
+// Ages, accelerates and moves one block of MISSILE_LANES particles
+static inline void UpdateParticleLanes(ParticlePool *pool, int i, float deltaTime, float fall, float damping) {
+    MissileLane velocityX = LaneLoad(&pool->velocityX[i]) * damping;
+    MissileLane velocityY = (LaneLoad(&pool->velocityY[i]) - fall) * damping;
+    MissileLane velocityZ = LaneLoad(&pool->velocityZ[i]) * damping;
+    LaneStore(&pool->velocityX[i], velocityX);
+    LaneStore(&pool->velocityY[i], velocityY);
+    LaneStore(&pool->velocityZ[i], velocityZ);
+    LaneStore(&pool->positionX[i], LaneLoad(&pool->positionX[i]) + velocityX * deltaTime);
+    LaneStore(&pool->positionY[i], LaneLoad(&pool->positionY[i]) + velocityY * deltaTime);
+    LaneStore(&pool->positionZ[i], LaneLoad(&pool->positionZ[i]) + velocityZ * deltaTime);
+    LaneStore(&pool->age[i], LaneLoad(&pool->age[i]) + deltaTime);
+}
+
+void RemoveParticle(ParticlePool *pool, int index) {
+    int last = --pool->count;
+    pool->positionX[index] = pool->positionX[last];
+    pool->positionY[index] = pool->positionY[last];
+    pool->positionZ[index] = pool->positionZ[last];
+    pool->velocityX[index] = pool->velocityX[last];
+    pool->velocityY[index] = pool->velocityY[last];
+    pool->velocityZ[index] = pool->velocityZ[last];
+    pool->age[index] = pool->age[last];
+    pool->lifetime[index] = pool->lifetime[last];
+    pool->size[index] = pool->size[last];
+}
+
+// Lanes past the live count update stale slots, which is harmless; expired particles are retired
+// in one backwards pass afterwards
+void UpdateParticlePool(ParticlePool *pool, const ParticleEmitterInfo *info, float deltaTime) {
+    float fall = info->gravity * deltaTime;
+    float damping = 1.0f / (1.0f + info->drag * deltaTime);
+    for (int i = 0; i < pool->count; i += MISSILE_LANES) UpdateParticleLanes(pool, i, deltaTime, fall, damping);
+    for (int i = pool->count - 1; i >= 0; i--) {
+        if (pool->age[i] >= pool->lifetime[i]) RemoveParticle(pool, i);
+    }
+}
+
+// Called once per drawn frame; also opens the next frame's spawn budget
+void UpdateParticles(float deltaTime) {
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; kind++) UpdateParticlePool(&particlePools[kind], &particleEmitters[kind], deltaTime);
+    particleFrameSpawns = 0;
+}
+
+// One rlgl batch per emitter type inside BeginMode3D. Depth writes are off so the translucent
+// quads don't hide each other; they still sort against the opaque scene through the depth test.
+void DrawParticles(Camera3D view) {
+    Matrix viewMatrix = GetCameraMatrix(view);
+    Vector3 right = { viewMatrix.m0, viewMatrix.m4, viewMatrix.m8 };
+    Vector3 up = { viewMatrix.m1, viewMatrix.m5, viewMatrix.m9 };
+    rlDrawRenderBatchActive(); // Everything drawn so far goes out first, so each emitter starts an empty batch
+    rlDisableDepthMask();
+    rlDisableBackfaceCulling();
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; kind++) {
+        const ParticlePool *pool = &particlePools[kind];
+        const ParticleEmitterInfo *info = &particleEmitters[kind];
+        if (pool->count == 0) continue;
+        if (info->additive) BeginBlendMode(BLEND_ADDITIVE);
+        rlBegin(RL_QUADS);
+        for (int i = 0; i < pool->count; i++) {
+            float t = pool->age[i] / pool->lifetime[i];
+            Color color = ColorLerp(info->startColor, info->endColor, t);
+            float half = 0.5f * pool->size[i] * Lerp(info->sizeStart, info->sizeEnd, t);
+            Vector3 center = { pool->positionX[i], pool->positionY[i], pool->positionZ[i] };
+            Vector3 r = Vector3Scale(right, half), u = Vector3Scale(up, half);
+            rlColor4ub(color.r, color.g, color.b, color.a);
+            rlVertex3f(center.x - r.x - u.x, center.y - r.y - u.y, center.z - r.z - u.z);
+            rlVertex3f(center.x + r.x - u.x, center.y + r.y - u.y, center.z + r.z - u.z);
+            rlVertex3f(center.x + r.x + u.x, center.y + r.y + u.y, center.z + r.z + u.z);
+            rlVertex3f(center.x - r.x + u.x, center.y - r.y + u.y, center.z - r.z + u.z);
+        }
+        rlEnd();
+        rlDrawRenderBatchActive();
+        if (info->additive) EndBlendMode();
+    }
+    rlEnableBackfaceCulling();
+    rlEnableDepthMask();
+}
+
+// --- Oriented Box Contacts ---
+// Separating-axis narrowphase for pairs of oriented boxes, MISSILE_LANES pairs per operation with
+// the lane helpers above. Callers queue candidate pairs, test them in one pass and read back, per
+// pair, the contact normal (from the first box towards the second) and the penetration depth.
+// The contact is the least overlapping of the 15 axes: the three faces of each box and the nine
+// edge-edge cross products. Edge-edge axes have to beat the faces by OBB_EDGE_AXIS_BIAS, so boxes
+// resting face to face keep a steady face normal.
+typedef struct {
+    float *offset[3]; // Centre of the second box minus centre of the first
+    float *axesA[9];  // Axes of the first box, component c of axis k at [3 * k + c]
+    float *axesB[9];
+    float *halfA[3];
+    float *halfB[3];
+    float *depth;     // Out: overlap along the contact axis, negative once the boxes are apart
+    float *axis;      // Out: contact axis, 0-2 faces of the first box, 3-5 of the second, 6 + 3 * i + j edge i x edge j
+    int count;
+    int capacity;
+} ObbPairLanes;
+
+typedef struct {
+    bool touching;
+    Vector3 normal; // From the first box towards the second
+    float depth;
+} ObbContact;
+
+bool AllocObbPairLanes(ObbPairLanes *pairs, FrameArena *arena, int maxPairs) {
+    int capacity = (maxPairs + MISSILE_LANES - 1) / MISSILE_LANES * MISSILE_LANES;
+    if (capacity == 0) capacity = MISSILE_LANES;
+    float *block = ARENA_ALLOC_ARRAY(arena, float, 29 * capacity);
+    pairs->count = 0;
+    pairs->capacity = 0;
+    if (block == NULL) return false;
+    for (int c = 0; c < 3; c++) pairs->offset[c] = block + c * capacity;
+    for (int c = 0; c < 9; c++) pairs->axesA[c] = block + (3 + c) * capacity;
+    for (int c = 0; c < 9; c++) pairs->axesB[c] = block + (12 + c) * capacity;
+    for (int c = 0; c < 3; c++) pairs->halfA[c] = block + (21 + c) * capacity;
+    for (int c = 0; c < 3; c++) pairs->halfB[c] = block + (24 + c) * capacity;
+    pairs->depth = block + 27 * capacity;
+    pairs->axis = block + 28 * capacity;
+    pairs->capacity = capacity;
+    return true;
+}
+
+// Queues a pair and returns its index, or -1 once the lanes are full
+int AddObbPair(ObbPairLanes *pairs, const OrientedBox *a, const OrientedBox *b) {
+    if (pairs->count == pairs->capacity) return -1;
+    int p = pairs->count++;
+    Vector3 offset = Vector3Subtract(b->center, a->center);
+    for (int c = 0; c < 3; c++) {
+        pairs->offset[c][p] = AxisComponent(offset, c);
+        pairs->halfA[c][p] = AxisComponent(a->halfExtents, c);
+        pairs->halfB[c][p] = AxisComponent(b->halfExtents, c);
+        for (int k = 0; k < 3; k++) {
+            pairs->axesA[3 * k + c][p] = AxisComponent(a->axes[k], c);
+            pairs->axesB[3 * k + c][p] = AxisComponent(b->axes[k], c);
+        }
+    }
+    return p;
+}
+
+static inline MissileLane LaneAbs(MissileLane x) { return LaneMax(x, -x); }
+
+// Separating-axis test of one block of MISSILE_LANES pairs
+static inline void TestObbPairLanes(ObbPairLanes *pairs, int i) {
+    const MissileLane epsilon = LaneSplat(OBB_PARALLEL_EPSILON);
+    MissileLane offset[3], axesA[9], axesB[9], a[3], b[3];
+    for (int c = 0; c < 3; c++) {
+        offset[c] = LaneLoad(&pairs->offset[c][i]);
+        a[c] = LaneLoad(&pairs->halfA[c][i]);
+        b[c] = LaneLoad(&pairs->halfB[c][i]);
+    }
+    for (int c = 0; c < 9; c++) {
+        axesA[c] = LaneLoad(&pairs->axesA[c][i]);
+        axesB[c] = LaneLoad(&pairs->axesB[c][i]);
+    }
+
+    // Second box's axes and the centre offset in the first box's frame
+    MissileLane r[3][3], absR[3][3], t[3];
+    for (int p = 0; p < 3; p++) {
+        for (int q = 0; q < 3; q++) {
+            r[p][q] = axesA[3 * p] * axesB[3 * q] + axesA[3 * p + 1] * axesB[3 * q + 1] + axesA[3 * p + 2] * axesB[3 * q + 2];
+            absR[p][q] = LaneAbs(r[p][q]) + epsilon;
+        }
+        t[p] = offset[0] * axesA[3 * p] + offset[1] * axesA[3 * p + 1] + offset[2] * axesA[3 * p + 2];
+    }
+
+    MissileLane best = LaneSplat(FLT_MAX), bestAxis = LaneSplat(0.0f);
+    for (int p = 0; p < 3; p++) {
+        MissileLane depth = a[p] + b[0] * absR[p][0] + b[1] * absR[p][1] + b[2] * absR[p][2] - LaneAbs(t[p]);
+        MissileMask take = depth < best;
+        best = LaneSelect(take, depth, best);
+        bestAxis = LaneSelect(take, LaneSplat((float)p), bestAxis);
+    }
+    for (int q = 0; q < 3; q++) {
+        MissileLane depth = b[q] + a[0] * absR[0][q] + a[1] * absR[1][q] + a[2] * absR[2][q] - LaneAbs(t[0] * r[0][q] + t[1] * r[1][q] + t[2] * r[2][q]);
+        MissileMask take = depth < best;
+        best = LaneSelect(take, depth, best);
+        bestAxis = LaneSelect(take, LaneSplat((float)(3 + q)), bestAxis);
+    }
+    for (int p = 0; p < 3; p++) {
+        int p1 = (p + 1) % 3, p2 = (p + 2) % 3;
+        for (int q = 0; q < 3; q++) {
+            int q1 = (q + 1) % 3, q2 = (q + 2) % 3;
+            // The cross product of two unit axes has length sin(angle); depths are scaled to unit length
+            MissileLane lengthSq = 1.0f - r[p][q] * r[p][q];
+            MissileLane ra = a[p1] * absR[p2][q] + a[p2] * absR[p1][q];
+            MissileLane rb = b[q1] * absR[p][q2] + b[q2] * absR[p][q1];
+            MissileLane depth = (ra + rb - LaneAbs(t[p2] * r[p1][q] - t[p1] * r[p2][q])) * LaneRsqrt(LaneMax(lengthSq, epsilon));
+            MissileMask take = (lengthSq > epsilon) & (depth * OBB_EDGE_AXIS_BIAS < best);
+            best = LaneSelect(take, depth, best);
+            bestAxis = LaneSelect(take, LaneSplat((float)(6 + 3 * p + q)), bestAxis);
+        }
+    }
+    LaneStore(&pairs->depth[i], best);
+    LaneStore(&pairs->axis[i], bestAxis);
+}
+
+// Tests every queued pair. Lanes past the last pair are zeroed first so the final block computes
+// on defined values; their results are never read.
+void TestObbPairs(ObbPairLanes *pairs) {
+    int padded = (pairs->count + MISSILE_LANES - 1) / MISSILE_LANES * MISSILE_LANES;
+    for (int p = pairs->count; p < padded; p++) {
+        for (int c = 0; c < 3; c++) pairs->offset[c][p] = pairs->halfA[c][p] = pairs->halfB[c][p] = 0.0f;
+        for (int c = 0; c < 9; c++) pairs->axesA[c][p] = pairs->axesB[c][p] = 0.0f;
+    }
+    for (int i = 0; i < padded; i += MISSILE_LANES) TestObbPairLanes(pairs, i);
+    int touching = 0;
+    for (int p = 0; p < pairs->count; p++) touching += (pairs->depth[p] > 0.0f);
+    CountTelemetry(TELEMETRY_CONTACT_PAIRS_TESTED, (unsigned long long)pairs->count);
+    CountTelemetry(TELEMETRY_CONTACT_PAIRS_HIT, (unsigned long long)touching);
+}
+
+ObbContact GetObbContact(const ObbPairLanes *pairs, int p) {
+    ObbContact contact = { pairs->depth[p] > 0.0f, { 0.0f, 0.0f, 0.0f }, pairs->depth[p] };
+    if (!contact.touching) return contact;
+    int axis = (int)pairs->axis[p];
+    if (axis < 3) {
+        contact.normal = (Vector3){ pairs->axesA[3 * axis][p], pairs->axesA[3 * axis + 1][p], pairs->axesA[3 * axis + 2][p] };
+    } else if (axis < 6) {
+        contact.normal = (Vector3){ pairs->axesB[3 * (axis - 3)][p], pairs->axesB[3 * (axis - 3) + 1][p], pairs->axesB[3 * (axis - 3) + 2][p] };
+    } else {
+        int k = (axis - 6) / 3, m = (axis - 6) % 3;
+        Vector3 axisA = { pairs->axesA[3 * k][p], pairs->axesA[3 * k + 1][p], pairs->axesA[3 * k + 2][p] };
+        Vector3 axisB = { pairs->axesB[3 * m][p], pairs->axesB[3 * m + 1][p], pairs->axesB[3 * m + 2][p] };
+        contact.normal = Vector3Normalize(Vector3CrossProduct(axisA, axisB));
+    }
+    Vector3 offset = { pairs->offset[0][p], pairs->offset[1][p], pairs->offset[2][p] };
+    if (Vector3DotProduct(offset, contact.normal) < 0.0f) contact.normal = Vector3Negate(contact.normal);
+    return contact;
+}
+
+// Sideways part of a contact normal for pushes that keep objects on the ground. A contact from
+// straight above or below has none, so the centre-to-centre direction stands in.
+Vector3 HorizontalContactNormal(ObbContact contact, Vector3 from, Vector3 to) {
+    Vector3 normal = { contact.normal.x, 0.0f, contact.normal.z };
+    if (Vector3LengthSqr(normal) < 1.0e-4f) normal = (Vector3){ to.x - from.x, 0.0f, to.z - from.z };
+    return Vector3Normalize(normal);
+}
+
+// --- Simulation Kernels ---
+// Per-frame tank kinematics: gravity, integration and ground contact. Between tank ticks this
+// carries each tank along the velocity its last tick left it with.
+SIM_KERNEL void IntegrateTanks(float deltaTime, const GameConfig *cfg) {
+    for (int idx = 0; idx < tankCount; idx++) {
+        tanks[idx].velocity.y -= cfg->gravity * deltaTime;
+        tanks[idx].position = Vector3Add(tanks[idx].position, Vector3Scale(tanks[idx].velocity, deltaTime));
+    }
+
+    float ground[MAX_TANKS];
+    SAMPLE_POOL_GROUND(tanks, tankCount, ground);
+    for (int idx = 0; idx < tankCount; idx++) {
+        // Ground collision for tanks
+        if (tanks[idx].position.y < ground[idx] + 1.0f) {
+            tanks[idx].position.y = ground[idx] + 1.0f;
+            tanks[idx].velocity.y = 0.0f; // Stop vertical movement
+            // Add a slight damping to horizontal velocity when hitting ground
+            tanks[idx].velocity.x *= 0.9f;
+            tanks[idx].velocity.z *= 0.9f;
+        }
+    }
+}
+
+// One tank tick: steering, collisions against the tank buckets, and weapons
+SIM_KERNEL void StepTanks(float deltaTime, const GameConfig *cfg) {
+    TankBuckets buckets;
+    BuildTankBuckets(&buckets, &frameArena);
+    ObbPairLanes contacts;
+    int contactTarget[MAX_CRATES + MAX_ENTITIES + MAX_TANKS]; // Crate index, entity bucket item or tank index per pair
+    AllocObbPairLanes(&contacts, &frameArena, MAX_CRATES + MAX_ENTITIES + MAX_TANKS); // No room for pairs if the arena is full
+
+    for (int idx = 0; idx < tankCount; idx++) {
+        // Tank movement towards its scheduled target
+        Vector3 tankTargetPosition = Vector3Zero();
+        bool tankHasTarget = GetAiTargetPosition(tanks[idx].target, &tankTargetPosition);
+
+        if (tankHasTarget) {
+            Vector3 directionToTankTarget = Vector3Normalize(Vector3Subtract(tankTargetPosition, tanks[idx].position));
+
+            // Update tank rotation to face target
+            tanksCold[idx].yawRotation = atan2f(directionToTankTarget.x, directionToTankTarget.z);
+
+            // Move tank towards target, routed around crates and other tanks by the flow field
+            Vector3 tankMoveDirection = SampleFlowField(&flowFields, FLOW_GROUP_TANK, tanks[idx].position);
+            if (Vector3LengthSqr(tankMoveDirection) == 0.0f) tankMoveDirection = directionToTankTarget;
+            float tankMoveSpeed = 2.0f / 3.0f; // Tank movement speed, 1/3 of previous
+            Vector3 tankForce = Vector3Scale(tankMoveDirection, tankMoveSpeed);
+            tanks[idx].velocity = Vector3Add(tanks[idx].velocity, Vector3Scale(tankForce, deltaTime));
+        } else {
+            // Simple patrolling if no target: move randomly
+            if (Vector3LengthSqr(tanks[idx].velocity) < 0.1f) { // If tank stopped
+                tanks[idx].velocity = Vector3Normalize((Vector3){(float)(WorldRand()%20 - 10), 0.0f, (float)(WorldRand()%20 - 10)});
+                tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 1.0f / 3.0f); // Gentle patrol speed, 1/3 of previous
+            }
+            tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 0.98f); // Dampen velocity
+            tanksCold[idx].yawRotation = atan2f(tanks[idx].velocity.x, tanks[idx].velocity.z); // Adjust rotation based on movement
+        }
+
+        // Tank collisions. Crates, combat entities and higher-index tanks found in the buckets are
+        // box-tested against the tank in one batch, then resolved in that order.
+        OrientedBox tankBox = TankBox(idx);
+        float tankX = tanks[idx].position.x, tankZ = tanks[idx].position.z;
+        contacts.count = 0;
+        int found = QuerySpatialGrid(&buckets.crates, tankX, tankZ, 2.5f * TANK_SCALE_FACTOR + 0.5f, buckets.candidates, buckets.capacity);
+        for (int k = 0; k < found; k++) {
+            OrientedBox crateBox = CrateBox(buckets.candidates[k]);
+            int p = AddObbPair(&contacts, &tankBox, &crateBox);
+            if (p != -1) contactTarget[p] = buckets.candidates[k];
+        }
+        int entityPairs = contacts.count;
+        found = QuerySpatialGrid(&buckets.entities, tankX, tankZ, 2.5f * TANK_SCALE_FACTOR + 0.5f, buckets.candidates, buckets.capacity);
+        for (int k = 0; k < found; k++) {
+            int j = ResolveHandle(&combatEntityHandles, buckets.entityHandles[buckets.candidates[k]]);
+            if (j == -1) continue;
+            OrientedBox entityBox = CombatEntityBox(j);
+            int p = AddObbPair(&contacts, &tankBox, &entityBox);
+            if (p != -1) contactTarget[p] = buckets.candidates[k];
+        }
+        int tankPairs = contacts.count;
+        found = QuerySpatialGrid(&buckets.tanks, tankX, tankZ, 5.0f * TANK_SCALE_FACTOR, buckets.candidates, buckets.capacity);
+        for (int k = 0; k < found; k++) {
+            if (buckets.candidates[k] <= idx) continue; // Only with higher indices to avoid double-checking
+            OrientedBox otherTankBox = TankBox(buckets.candidates[k]);
+            int p = AddObbPair(&contacts, &tankBox, &otherTankBox);
+            if (p != -1) contactTarget[p] = buckets.candidates[k];
+        }
+        TestObbPairs(&contacts);
+
+        // Tank-Crate collisions
+        for (int p = 0; p < entityPairs; p++) {
+            ObbContact contact = GetObbContact(&contacts, p);
+            if (!contact.touching) continue;
+            int j = contactTarget[p];
+            // Push along the contact normal, kept horizontal
+            Vector3 pushDirection = HorizontalContactNormal(contact, tanks[idx].position, crates[j].position);
+
+            float pushStrength = 0.5f; // How hard tank pushes crate
+            crates[j].velocity = Vector3Add(crates[j].velocity, Vector3Scale(pushDirection, pushStrength));
+            crates[j].isPhysicsActive = true; // Activate physics on pushed crate
+
+            // Also push the tank back slightly to prevent sticking, no further than the overlap
+            tanks[idx].position = Vector3Subtract(tanks[idx].position, Vector3Scale(pushDirection, fminf(contact.depth, 0.1f)));
+            tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 0.5f); // Dampen tank velocity
+        }
+
+        // Tank-CombatEntity collisions (entities are resolved through their handles, as a crushed
+        // entity swap-removes another into its index)
+        for (int p = entityPairs; p < tankPairs; p++) {
+            ObbContact contact = GetObbContact(&contacts, p);
+            if (!contact.touching) continue;
+            int j = ResolveHandle(&combatEntityHandles, buckets.entityHandles[contactTarget[p]]);
+            if (j == -1) continue;
+            Vector3 pushDirection = HorizontalContactNormal(contact, tanks[idx].position, combatEntities[j].position);
+
+            float pushStrength = 1.0f; // How hard tank pushes entity
+            combatEntities[j].velocity = Vector3Add(combatEntities[j].velocity, Vector3Scale(pushDirection, pushStrength));
+
+            // Apply damage to combat entity
+            combatEntities[j].health -= 5.0f * deltaTime; // Continuous damage while colliding
+            if (combatEntities[j].health <= 0) {
+                KillCombatEntity(j);
+            }
+            // Push tank back slightly too
+            tanks[idx].position = Vector3Subtract(tanks[idx].position, Vector3Scale(pushDirection, fminf(contact.depth, 0.05f)));
+            tanks[idx].velocity = Vector3Scale(tanks[idx].velocity, 0.8f); // Dampen tank velocity
+        }
+
+        // Tank-Tank collisions
+        for (int p = tankPairs; p < contacts.count; p++) {
+            ObbContact contact = GetObbContact(&contacts, p);
+            if (!contact.touching) continue;
+            int j = contactTarget[p];
+            // Contact normals point from this tank to the other, the repulsion axis the other way
+            Vector3 collisionAxis = Vector3Negate(HorizontalContactNormal(contact, tanks[idx].position, tanks[j].position));
+
+            // Simple repulsion
+            float repulsionStrength = 0.2f;
+            tanks[idx].velocity = Vector3Add(tanks[idx].velocity, Vector3Scale(collisionAxis, repulsionStrength));
+            tanks[j].velocity = Vector3Subtract(tanks[j].velocity, Vector3Scale(collisionAxis, repulsionStrength));
+
+            // Separate positions slightly to prevent sticking, together no further than the overlap
+            float separation = fminf(0.5f * contact.depth, 0.05f);
+            tanks[idx].position = Vector3Add(tanks[idx].position, Vector3Scale(collisionAxis, separation));
+            tanks[j].position = Vector3Subtract(tanks[j].position, Vector3Scale(collisionAxis, separation));
+        }
+
+        // Tank bullet shooting
+        if (tankHasTarget && Vector3Distance(tanks[idx].position, tankTargetPosition) < 30.0f * TANK_SCALE_FACTOR && tanksCold[idx].gunReady) {
+            Bullet *bullet = SpawnBullet(tankBullets, &tankBulletCount, MAX_TANK_BULLETS);
+            if (bullet == NULL) CountSpawnFailure(TELEMETRY_POOL_TANK_BULLETS);
+            if (bullet != NULL) {
+                bullet->position = (Vector3){tanks[idx].position.x, tanks[idx].position.y + (1.0f * TANK_SCALE_FACTOR), tanks[idx].position.z}; // Bullet originates higher, scaled
+                Vector3 aimTarget = (tanks[idx].target.kind == AI_TARGET_PLAYER) ? (Vector3){tankTargetPosition.x, tankTargetPosition.y + 0.5f, tankTargetPosition.z} : tankTargetPosition;
+                Vector3 bulletDirection = Vector3Normalize(Vector3Subtract(aimTarget, bullet->position));
+                bullet->velocity = Vector3Scale(bulletDirection, cfg->tankBulletSpeed);
+                bullet->mass = cfg->bulletMass * 5.0f; // Heavier tank bullets
+                StartCooldown(&tanksCold[idx].gunReady, TIMER_TANK_GUN_READY, tanksCold[idx].handle, cfg->tankFireRate);
+                PlayGameSound(tankShotSound);
+                EmitEffect(EFFECT_MUZZLE_FLASH, bullet->position, bulletDirection, 1.0f);
+            }
+        }
+
+        // Tank bomb dropping
+        if (tankHasTarget && tanksCold[idx].bombReady) {
+            ProjectileBomb *bomb = SpawnBomb(tankBombs, &tankBombCount, MAX_TANK_BOMBS, &tankBombHandles);
+            if (bomb == NULL) CountSpawnFailure(TELEMETRY_POOL_TANK_BOMBS);
+            if (bomb != NULL) {
+                bomb->position = (Vector3){tanks[idx].position.x, tanks[idx].position.y + (2.0f * TANK_SCALE_FACTOR), tanks[idx].position.z}; // Drop from above tank, scaled
+                bomb->velocity = (Vector3){0.0f, -cfg->tankBombFallSpeed, 0.0f};
+                bomb->exploded = false;
+                bomb->radius = TANK_BOMB_RADIUS;
+                bomb->explosion_radius = cfg->tankBombExplosionRadius;
+                bomb->explosion_duration = cfg->tankBombExplosionDuration;
+                PlayGameSound(tankBombSound);
+                StartCooldown(&tanksCold[idx].bombReady, TIMER_TANK_BOMB_READY, tanksCold[idx].handle, cfg->tankBombDropRate);
+            }
+        }
+    }
+
+}
+
+// Moves every aircraft along its path once per tick; the rest of the tick and rendering reuse
+// the stored position and heading
+SIM_KERNEL void FlyAircraft(float deltaTime, const GameConfig *cfg) {
+    for (int i = 0; i < aircraftCount; i++) {
+        Aircraft *plane = &aircraft[i];
+        const AircraftCold *cold = &aircraftCold[i];
+        if (cold->path == AIRCRAFT_PATH_ORBIT) {
+            plane->pathParameter += cfg->jetSpeed * deltaTime;
+            if (plane->pathParameter > 2 * PI) plane->pathParameter -= 2 * PI;
+        } else {
+            // Same ground speed as the orbit, spread over the length of the current segment
+            plane->pathParameter += cfg->jetSpeed * cfg->jetRadius * deltaTime / WaypointSegmentLength(cold, plane->pathParameter);
+            if (plane->pathParameter >= (float)cold->waypointCount) plane->pathParameter -= (float)cold->waypointCount;
+        }
+        PlaceAircraft(i, cfg);
+    }
+}
+
+// Locks every aircraft onto the closest tank within range. The tanks go into one grid per tick
+// with cells sized for the lock-on range, so each aircraft only measures the tanks around it.
+SIM_KERNEL void LockAircraftTargets(FrameArena *arena, const GameConfig *cfg) {
+    float *tankX = ARENA_ALLOC_ARRAY(arena, float, MAX_TANKS);
+    float *tankZ = ARENA_ALLOC_ARRAY(arena, float, MAX_TANKS);
+    int *candidates = ARENA_ALLOC_ARRAY(arena, int, MAX_TANKS);
+    SpatialGrid grid;
+    bool indexed = tankX != NULL && tankZ != NULL && candidates != NULL;
+    if (indexed) {
+        for (int i = 0; i < tankCount; i++) {
+            tankX[i] = tanks[i].position.x;
+            tankZ[i] = tanks[i].position.z;
+        }
+        indexed = BuildSpatialGrid(&grid, arena, tankX, tankZ, tankCount, AIRCRAFT_LOCK_CELL_SIZE, AIRCRAFT_LOCK_GRID_DIM);
+    }
+
+    for (int a = 0; a < aircraftCount; a++) {
+        Vector3 position = aircraft[a].position;
+        // Without the grid (arena exhausted) every tank is a candidate
+        int found = indexed ? QuerySpatialGrid(&grid, position.x, position.z, cfg->jetMissileLockOnRange, candidates, MAX_TANKS) : tankCount;
+        float closestTankDistance = FLT_MAX;
+        int closest = -1;
+        for (int k = 0; k < found; k++) {
+            int i = indexed ? candidates[k] : k;
+            float dist = Vector3Distance(position, tanks[i].position);
+            // Candidates come in cell order: ties go to the lower pool index, as a scan of the pool would
+            if (dist <= cfg->jetMissileLockOnRange && (dist < closestTankDistance || (dist == closestTankDistance && i < closest))) {
+                closestTankDistance = dist;
+                closest = i;
+            }
+        }
+        aircraftCold[a].lockedTarget = (closest != -1) ? tanksCold[closest].handle : NULL_HANDLE;
+    }
+}
+
+// The whole step is one kernel taking the config by pointer, instantiated twice below. Forced
+// inlining lets the compiler constant-fold the baked instance, while the runtime instance reloads
+// values through the pointer (floats it writes may alias the config).
+SIM_KERNEL void StepSimulationKernel(float deltaTime, const PlayerInput *input, const GameConfig *cfg) {
+    // Terrain and crates around the player, then cooldowns that ran out and explosions that ended
+    // since the last step
+    UpdateWorldStreaming();
+    for (int n = AdvanceRateClock(&timerClock, deltaTime); n > 0; n--) AdvanceTimerWheel(&timerWheel);
+    hitScanBvhCurrent = false; // Last step's tree is stale once anything moves
+
+    // Player movement
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    Vector3 right = Vector3CrossProduct(forward, camera.up);
+    right.y = 0;
+    right = Vector3Normalize(right);
+
+    Vector3 move = { 0.0f, 0.0f, 0.0f };
+    float currentSpeed = input->run ? cfg->runSpeed : cfg->walkSpeed;
+    if (input->forward) move = Vector3Add(move, Vector3Scale(forward, currentSpeed * deltaTime));
+    if (input->back) move = Vector3Add(move, Vector3Scale(forward, -currentSpeed * deltaTime));
+    if (input->right) move = Vector3Add(move, Vector3Scale(right, currentSpeed * deltaTime));
+    if (input->left) move = Vector3Add(move, Vector3Scale(right, -currentSpeed * deltaTime));
+
+    Vector3 prevCameraPosition = camera.position;
+    camera.position = Vector3Add(camera.position, move);
+    Vector3 lookDirection = Vector3Normalize(Vector3Subtract(camera.target, prevCameraPosition));
+    camera.target = Vector3Add(camera.position, lookDirection);
+
+    // Jump mechanics
+    if (input->jump && onGround) {
+        jumpVelocity = cfg->jumpStrength;
+        onGround = false;
+    }
+
+    // Apply cfg->gravity and update vertical position
+    jumpVelocity -= cfg->gravity * deltaTime;
+    float newY = camera.position.y + jumpVelocity * deltaTime;
+    float playerFeetY = newY - (cfg->playerHeight / 2.0f);
+    onGround = false;
+
+    // Player-crate vertical collision (standing on top)
+    for (int i = 0; i < crateCount; i++) {
+        float crateTopY = crates[i].position.y + 0.5f;
+        bool horizontalOverlap = (camera.position.x + cfg->playerRadius > crates[i].position.x - 0.5f &&
+                                  camera.position.x - cfg->playerRadius < crates[i].position.x + 0.5f &&
+                                  camera.position.z + cfg->playerRadius > crates[i].position.z - 0.5f &&
+                                  camera.position.z - cfg->playerRadius < crates[i].position.z + 0.5f);
+
+        if (horizontalOverlap && jumpVelocity <= 0 && playerFeetY <= crateTopY && (prevCameraPosition.y - (cfg->playerHeight / 2.0f)) >= crateTopY) {
+            newY = crateTopY + (cfg->playerHeight / 2.0f);
+            jumpVelocity = 0.0f;
+            onGround = true;
+            // If player lands on a blue crate, activate its physics
+            if (cratesCold[i].color.r == BLUE.r && cratesCold[i].color.g == BLUE.g && cratesCold[i].color.b == BLUE.b) {
+                 crates[i].isPhysicsActive = true;
+            }
+            break;
+        }
+    }
+
+    // Ground check
+    float playerGroundY = SampleTerrainHeight(camera.position.x, camera.position.z) + 1.0f;
+    if (!onGround && newY <= playerGroundY) {
+        newY = playerGroundY;
+        jumpVelocity = 0.0f;
+        onGround = true;
+    }
+    camera.position.y = newY;
+    camera.target = Vector3Add(camera.position, lookDirection);
+
+    Vector3 playerMin = { camera.position.x - cfg->playerRadius, camera.position.y - (cfg->playerHeight / 2.0f), camera.position.z - cfg->playerRadius };
+    Vector3 playerMax = { camera.position.x + cfg->playerRadius, camera.position.y + (cfg->playerHeight / 2.0f), camera.position.z + cfg->playerRadius };
+
+    // Shared steering fields for this tick (crates and tanks are the obstacles)
+    BuildFlowFields(&flowFields, &frameArena, StreamWindowCentre(simulationWindowX, simulationWindowZ));
+
+    // Re-evaluate targeting for this tick's slice of entities and tanks
+    RunAiScheduler(&aiScheduler);
+
+    // Update combat entities (chase target along their group's flow field and shoot)
+    float chaseSpeed = cfg->entityChaseSpeed;
+    for (int i = 0; i < combatEntityCount; i++) {
+        // Target is chosen by the AI scheduler; in between the entity just chases it
+        Vector3 targetPosition = Vector3Zero();
+        bool hasTarget = GetAiTargetPosition(combatEntities[i].target, &targetPosition);
+
+        if (hasTarget) {
+            Vector3 directionToTarget = Vector3Normalize(Vector3Subtract(targetPosition, combatEntities[i].position));
+            FlowGroup group = (combatEntitiesCold[i].type == ENTITY_ENEMY) ? FLOW_GROUP_ENEMY : FLOW_GROUP_FRIENDLY;
+            Vector3 flowDirection = SampleFlowField(&flowFields, group, combatEntities[i].position);
+            if (Vector3LengthSqr(flowDirection) > 0.0f) directionToTarget = flowDirection; // Direct chase once in the target's cell
+            Vector3 force = Vector3Scale(directionToTarget, chaseSpeed);
+            combatEntities[i].velocity = Vector3Add(combatEntities[i].velocity, Vector3Scale(force, deltaTime / combatEntitiesCold[i].mass));
+
+            // Shooting logic
+            float distanceToTarget = Vector3Distance(combatEntities[i].position, targetPosition);
+            if (distanceToTarget <= cfg->entityShootingRange && combatEntitiesCold[i].gunReady) {
+                Bullet *bullet = SpawnBullet(entityBullets, &entityBulletCount, MAX_ENTITY_BULLETS);
+                if (bullet == NULL) CountSpawnFailure(TELEMETRY_POOL_ENTITY_BULLETS);
+                if (bullet != NULL) {
+                    bullet->position = combatEntities[i].position;
+                    // Aim slightly higher for player, or at center for other entities
+                    Vector3 aimTarget = (combatEntities[i].target.kind == AI_TARGET_PLAYER) ? (Vector3){targetPosition.x, targetPosition.y + 0.5f, targetPosition.z} : targetPosition;
+                    Vector3 bulletDirection = Vector3Normalize(Vector3Subtract(aimTarget, combatEntities[i].position));
+                    bullet->velocity = Vector3Scale(bulletDirection, cfg->entityBulletSpeed);
+                    bullet->mass = cfg->bulletMass;
+                    StartCooldown(&combatEntitiesCold[i].gunReady, TIMER_ENTITY_GUN_READY, combatEntitiesCold[i].handle, cfg->entityFireRate);
+                    PlayGameSound(entityShotSound);
+                    EmitEffect(EFFECT_MUZZLE_FLASH, bullet->position, bulletDirection, 1.0f);
+                }
+            }
+        } else {
+            // If no target, gradually slow down
+            combatEntities[i].velocity = Vector3Scale(combatEntities[i].velocity, 0.95f);
+        }
+
+        combatEntities[i].position = Vector3Add(combatEntities[i].position, Vector3Scale(combatEntities[i].velocity, deltaTime));
+    }
+
+    // Combat entities walk on the ground, up and down its slopes
+    float entityGround[MAX_ENTITIES];
+    SAMPLE_POOL_GROUND(combatEntities, combatEntityCount, entityGround);
+    for (int i = 0; i < combatEntityCount; i++) {
+        combatEntities[i].position.y = entityGround[i] + 1.0f;
+        combatEntities[i].velocity.y = 0.0f;
+    }
+
+    // Update crates
+    float crateGround[MAX_CRATES];
+    SAMPLE_POOL_GROUND(crates, crateCount, crateGround);
+    for (int i = 0; i < crateCount; i++) {
+        // Only apply physics if isPhysicsActive is true
+        if (crates[i].isPhysicsActive) {
+            crates[i].velocity.y -= cfg->gravity * deltaTime;
+            crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.95f);
+
+            float angle = Vector3Length(crates[i].angularVelocity) * deltaTime;
+            Vector3 axis = Vector3Normalize(crates[i].angularVelocity);
+            if (Vector3LengthSqr(crates[i].angularVelocity) > 0.0001f) {
+                Quaternion frameRotation = QuaternionFromAxisAngle(axis, angle);
+                crates[i].rotation = QuaternionMultiply(crates[i].rotation, frameRotation);
+                crates[i].rotation = QuaternionNormalize(crates[i].rotation);
+            }
+
+            Vector3 predictedPosition = Vector3Add(crates[i].position, Vector3Scale(crates[i].velocity, deltaTime));
+            if (predictedPosition.y - 0.5f <= crateGround[i]) {
+                if (crates[i].position.y - 0.5f > crateGround[i]) { // Only bounce if not already on ground
+                    crates[i].velocity.y *= -0.5f; // Simple bounce
+                    crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.5f); // Dampen angular velocity
+                } else {
+                    crates[i].velocity.y = 0.0f; // Stop vertical movement
+                    crates[i].angularVelocity = Vector3Scale(crates[i].angularVelocity, 0.5f); // Dampen angular velocity
+                }
+                crates[i].position.y = crateGround[i] + 0.5f; // Snap to ground
+            } else {
+                crates[i].position.y = predictedPosition.y;
+            }
+            crates[i].position.x = predictedPosition.x;
+            crates[i].position.z = predictedPosition.z;
+            crates[i].velocity = Vector3Scale(crates[i].velocity, 0.9f); // Linear damping
+        } else {
+            // If physics is NOT active, ensure it stays completely still
+            crates[i].velocity = Vector3Zero();
+            crates[i].angularVelocity = Vector3Zero();
+            crates[i].rotation = QuaternionIdentity();
+        }
+    }
+
+    // CombatEntity-CombatEntity collisions
+    for (int i = 0; i < combatEntityCount; i++) {
+        for (int j = i + 1; j < combatEntityCount; j++) {
+            Vector3 box1Min = { combatEntities[i].position.x - 0.5f, combatEntities[i].position.y - 1.0f, combatEntities[i].position.z - 0.5f };
+            Vector3 box1Max = { combatEntities[i].position.x + 0.5f, combatEntities[i].position.y + 1.0f, combatEntities[i].position.z + 0.5f };
+            Vector3 box2Min = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
+            Vector3 box2Max = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
+            if (CheckCollisionBoxes3D(box1Min, box1Max, box2Min, box2Max)) {
+                combatEntities[i].velocity = Vector3Scale(combatEntities[i].velocity, -0.5f);
+                combatEntities[j].velocity = Vector3Scale(combatEntities[j].velocity, -0.5f);
+            }
+        }
+    }
+
+    // Player-crate horizontal collisions. Crates whose bounds reach the player are box-tested in one batch.
+    ObbPairLanes crateContacts;
+    int contactCrates[MAX_CRATES * (MAX_CRATES - 1) / 2][2]; // The crate (or crates) of each pair
+    AllocObbPairLanes(&crateContacts, &frameArena, MAX_CRATES * (MAX_CRATES - 1) / 2); // No room for pairs if the arena is full
+    OrientedBox playerBox = MakeAxisAlignedBox(camera.position, (Vector3){ cfg->playerRadius, cfg->playerHeight / 2.0f, cfg->playerRadius });
+    OrientedBox crateBoxes[MAX_CRATES];
+    Vector3 crateMin[MAX_CRATES], crateMax[MAX_CRATES];
+    for (int i = 0; i < crateCount; i++) {
+        crateBoxes[i] = CrateBox(i);
+        OrientedBoxBounds(&crateBoxes[i], &crateMin[i], &crateMax[i]);
+        if (CheckCollisionBoxes3D(playerMin, playerMax, crateMin[i], crateMax[i])) {
+            int p = AddObbPair(&crateContacts, &playerBox, &crateBoxes[i]);
+            if (p != -1) contactCrates[p][0] = i;
+        }
+    }
+    TestObbPairs(&crateContacts);
+    for (int p = 0; p < crateContacts.count; p++) {
+        if (!GetObbContact(&crateContacts, p).touching) continue;
+        int i = contactCrates[p][0];
+        Vector3 pushDir = Vector3Normalize(move);
+        bool isStandingOnThisCrate = onGround && (fabsf(camera.position.y - (cfg->playerHeight / 2.0f) - (crates[i].position.y + 0.5f)) < 0.1f);
+
+        if (!isStandingOnThisCrate) {
+            crates[i].velocity = Vector3Add(crates[i].velocity, Vector3Scale(pushDir, currentSpeed / cratesCold[i].mass));
+            if (!crates[i].isPhysicsActive) {
+                crates[i].isPhysicsActive = true;
+            }
+        }
+    }
+
+    // Crate-crate collisions. Pairs whose bounds overlap are box-tested in one batch. Side contacts
+    // push the two crates apart, steep ones lift the upper crate out of the lower one.
+    crateContacts.count = 0;
+    for (int i = 0; i < crateCount; i++) {
+        for (int j = i + 1; j < crateCount; j++) {
+            if (!CheckCollisionBoxes3D(crateMin[i], crateMax[i], crateMin[j], crateMax[j])) continue;
+            int p = AddObbPair(&crateContacts, &crateBoxes[i], &crateBoxes[j]);
+            if (p == -1) continue;
+            contactCrates[p][0] = i;
+            contactCrates[p][1] = j;
+        }
+    }
+    TestObbPairs(&crateContacts);
+    for (int p = 0; p < crateContacts.count; p++) {
+        ObbContact contact = GetObbContact(&crateContacts, p);
+        if (!contact.touching) continue;
+        int i = contactCrates[p][0], j = contactCrates[p][1];
+        crates[i].isPhysicsActive = true;
+        crates[j].isPhysicsActive = true;
+
+        if (fabsf(contact.normal.y) < OBB_STACKED_NORMAL_Y) {
+            Vector3 collisionNormal = HorizontalContactNormal(contact, crates[i].position, crates[j].position);
+            crates[i].velocity = Vector3Subtract(crates[i].velocity, Vector3Scale(collisionNormal, 0.5f));
+            crates[j].velocity = Vector3Add(crates[j].velocity, Vector3Scale(collisionNormal, 0.5f));
+            crates[i].position = Vector3Subtract(crates[i].position, Vector3Scale(collisionNormal, 0.5f * contact.depth));
+            crates[j].position = Vector3Add(crates[j].position, Vector3Scale(collisionNormal, 0.5f * contact.depth));
+        } else {
+            int upper = (contact.normal.y > 0.0f) ? j : i;
+            crates[upper].position.y += contact.depth / fabsf(contact.normal.y);
+            if (crates[upper].velocity.y < 0) {
+                crates[upper].velocity.y *= -0.5f;
+                crates[upper].angularVelocity = Vector3Scale(crates[upper].angularVelocity, 0.5f);
+            }
+        }
+    }
+
+    // Player Shooting
+    if (input->fire) {
+        if (playerGunReady && cfg->playerHitScan != 0.0f) {
+            FireHitScan(camera.position, Vector3Normalize(Vector3Subtract(camera.target, camera.position)), cfg);
+            StartCooldown(&playerGunReady, TIMER_PLAYER_GUN_READY, NULL_HANDLE, cfg->playerFireRate);
+            PlayGameSound(bulletShotSound);
+        } else if (playerGunReady) {
+            Bullet *bullet = SpawnBullet(playerBullets, &playerBulletCount, MAX_PLAYER_BULLETS);
+            if (bullet == NULL) CountSpawnFailure(TELEMETRY_POOL_PLAYER_BULLETS);
+            if (bullet != NULL) {
+                bullet->position = camera.position;
+                bullet->velocity = Vector3Scale(Vector3Normalize(Vector3Subtract(camera.target, camera.position)), cfg->bulletSpeed);
+                bullet->mass = cfg->bulletMass;
+                StartCooldown(&playerGunReady, TIMER_PLAYER_GUN_READY, NULL_HANDLE, cfg->playerFireRate);
+                PlayGameSound(bulletShotSound);
+            }
+        }
+    }
+
+    // Update player bullets
+    float bulletGround[MAX_PLAYER_BULLETS];
+    for (int i = 0; i < playerBulletCount; i++) {
+        playerBullets[i].velocity.y -= cfg->gravity * deltaTime;
+        playerBullets[i].position = Vector3Add(playerBullets[i].position, Vector3Scale(playerBullets[i].velocity, deltaTime));
+    }
+    SAMPLE_POOL_GROUND(playerBullets, playerBulletCount, bulletGround);
+    for (int i = playerBulletCount - 1; i >= 0; i--) {
+        if (!InSimulationWindow(playerBullets[i].position) || playerBullets[i].position.y < bulletGround[i]) {
+            RemoveBullet(playerBullets, &playerBulletCount, i);
+        }
+    }
+
+    // Update entity bullets (from both enemies and friendly forces)
+    for (int i = 0; i < entityBulletCount; i++) {
+        entityBullets[i].velocity.y -= cfg->gravity * deltaTime;
+        entityBullets[i].position = Vector3Add(entityBullets[i].position, Vector3Scale(entityBullets[i].velocity, deltaTime));
+    }
+    SAMPLE_POOL_GROUND(entityBullets, entityBulletCount, bulletGround);
+    for (int i = entityBulletCount - 1; i >= 0; i--) {
+        if (!InSimulationWindow(entityBullets[i].position) || entityBullets[i].position.y < bulletGround[i]) {
+            RemoveBullet(entityBullets, &entityBulletCount, i);
+        }
+    }
+
+    // Update tank bullets
+    for (int i = 0; i < tankBulletCount; i++) {
+        tankBullets[i].velocity.y -= cfg->gravity * deltaTime; // Apply cfg->gravity to tank bullets
+        tankBullets[i].position = Vector3Add(tankBullets[i].position, Vector3Scale(tankBullets[i].velocity, deltaTime));
+    }
+    SAMPLE_POOL_GROUND(tankBullets, tankBulletCount, bulletGround);
+    for (int i = tankBulletCount - 1; i >= 0; i--) {
+        if (!InSimulationWindow(tankBullets[i].position) || tankBullets[i].position.y < bulletGround[i]) {
+            RemoveBullet(tankBullets, &tankBulletCount, i);
+        }
+    }
+
+    // Player Bullet-combat entity collisions
+    for (int i = playerBulletCount - 1; i >= 0; i--) {
+        bool hit = false;
+        for (int j = 0; j < combatEntityCount; j++) {
+            Vector3 boxMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
+            Vector3 boxMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
+            if (CheckCollisionPointBox3D(playerBullets[i].position, boxMin, boxMax)) {
+                hit = true;
+                EmitEffect(EFFECT_ENTITY_HIT, playerBullets[i].position, Vector3Negate(Vector3Normalize(playerBullets[i].velocity)), 1.0f);
+                combatEntities[j].health -= 25.0f;
+                if (combatEntities[j].health <= 0) {
+                    KillCombatEntity(j);
+                }
+                break;
+            }
+        }
+        // Player Bullet-tank collision
+        for (int j = 0; j < tankCount && !hit; j++) {
+            OrientedBox tankBox = TankBox(j);
+            if (CheckCollisionPointOrientedBox(playerBullets[i].position, &tankBox)) {
+                hit = true;
+                EmitEffect(EFFECT_BULLET_SPARKS, playerBullets[i].position, Vector3Negate(Vector3Normalize(playerBullets[i].velocity)), 1.0f);
+                tanks[j].health -= 15.0f; // Player bullets do less damage to tank
+                if (tanks[j].health <= 0) {
+                    KillTank(j);
+                }
+                break; // Bullet hit a tank, stop checking
+            }
+        }
+        if (hit) RemoveBullet(playerBullets, &playerBulletCount, i);
+    }
+
+    // Player Bullet-crate collisions
+    for (int i = playerBulletCount - 1; i >= 0; i--) {
+        for (int j = 0; j < crateCount; j++) {
+            OrientedBox crateBox = CrateBox(j);
+            if (CheckCollisionPointOrientedBox(playerBullets[i].position, &crateBox)) {
+                Vector3 bulletDir = Vector3Normalize(playerBullets[i].velocity);
+                float impulseMagnitude = (playerBullets[i].mass * Vector3Length(playerBullets[i].velocity));
+                HitCrate(j, playerBullets[i].position, bulletDir, impulseMagnitude);
+                RemoveBullet(playerBullets, &playerBulletCount, i);
+                break;
+            }
+        }
+    }
+
+    // Entity Bullet-player and Entity Bullet-combat entity collisions
+    for (int i = entityBulletCount - 1; i >= 0; i--) {
+        Vector3 bulletMin = { entityBullets[i].position.x - 0.1f, entityBullets[i].position.y - 0.1f, entityBullets[i].position.z - 0.1f };
+        Vector3 bulletMax = { entityBullets[i].position.x + 0.1f, entityBullets[i].position.y + 0.1f, entityBullets[i].position.z + 0.1f };
+
+        // Collision with player
+        if (CheckCollisionBoxes3D(playerMin, playerMax, bulletMin, bulletMax)) {
+            RemoveBullet(entityBullets, &entityBulletCount, i);
+            playerHealth -= 10.0f;
+            if (playerHealth <= 0) {
+                KillPlayer();
+            }
+            continue; // Bullet hit player, no need to check other entities
+        }
+
+        // Collision with other combat entities
+        bool hit = false;
+        for (int j = 0; j < combatEntityCount; j++) {
+            Vector3 entityBoxMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
+            Vector3 entityBoxMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
+            if (CheckCollisionBoxes3D(entityBoxMin, entityBoxMax, bulletMin, bulletMax)) {
+                hit = true;
+                EmitEffect(EFFECT_ENTITY_HIT, entityBullets[i].position, Vector3Negate(Vector3Normalize(entityBullets[i].velocity)), 1.0f);
+                combatEntities[j].health -= 10.0f; // Damage from entity bullets
+                if (combatEntities[j].health <= 0) {
+                    KillCombatEntity(j);
+                }
+                break;
+            }
+        }
+        // Entity Bullet-tank collision
+        for (int j = 0; j < tankCount && !hit; j++) {
+            // The bullet's 0.1 box as a point against the tank box grown by as much
+            OrientedBox tankBox = TankBox(j);
+            tankBox.halfExtents = Vector3Add(tankBox.halfExtents, (Vector3){ 0.1f, 0.1f, 0.1f });
+            if (CheckCollisionPointOrientedBox(entityBullets[i].position, &tankBox)) {
+                hit = true;
+                EmitEffect(EFFECT_BULLET_SPARKS, entityBullets[i].position, Vector3Negate(Vector3Normalize(entityBullets[i].velocity)), 1.0f);
+                tanks[j].health -= 5.0f; // Smaller damage from entity bullets
+                if (tanks[j].health <= 0) {
+                    KillTank(j);
+                }
+                break;
+            }
+        }
+        if (hit) RemoveBullet(entityBullets, &entityBulletCount, i);
+    }
+
+    // Tank Bullet-player and Tank Bullet-combat entity collisions
+    for (int i = tankBulletCount - 1; i >= 0; i--) {
+        Vector3 bulletMin = { tankBullets[i].position.x - TANK_BULLET_RADIUS, tankBullets[i].position.y - TANK_BULLET_RADIUS, tankBullets[i].position.z - TANK_BULLET_RADIUS };
+        Vector3 bulletMax = { tankBullets[i].position.x + TANK_BULLET_RADIUS, tankBullets[i].position.y + TANK_BULLET_RADIUS, tankBullets[i].position.z + TANK_BULLET_RADIUS };
+
+        // Collision with player
+        if (CheckCollisionBoxes3D(playerMin, playerMax, bulletMin, bulletMax)) {
+            RemoveBullet(tankBullets, &tankBulletCount, i);
+            playerHealth -= 20.0f; // Tank bullets do more damage
+            if (playerHealth <= 0) {
+                KillPlayer();
+            }
+            continue;
+        }
+
+        // Collision with combat entities
+        for (int j = 0; j < combatEntityCount; j++) {
+            Vector3 entityBoxMin = { combatEntities[j].position.x - 0.5f, combatEntities[j].position.y - 1.0f, combatEntities[j].position.z - 0.5f };
+            Vector3 entityBoxMax = { combatEntities[j].position.x + 0.5f, combatEntities[j].position.y + 1.0f, combatEntities[j].position.z + 0.5f };
+            if (CheckCollisionBoxes3D(entityBoxMin, entityBoxMax, bulletMin, bulletMax)) {
+                EmitEffect(EFFECT_ENTITY_HIT, tankBullets[i].position, Vector3Negate(Vector3Normalize(tankBullets[i].velocity)), 1.0f);
+                RemoveBullet(tankBullets, &tankBulletCount, i);
+                combatEntities[j].health -= 20.0f; // Tank bullets do more damage to entities
+                if (combatEntities[j].health <= 0) {
+                    KillCombatEntity(j);
+                }
+                break;
+            }
+        }
+    }
+
+    // Player-combat entity collisions (melee damage, only from enemies)
+    for (int i = 0; i < combatEntityCount; i++) {
+        if (combatEntitiesCold[i].type == ENTITY_ENEMY) { // Only enemies deal melee damage
+            Vector3 entityMin = { combatEntities[i].position.x - 0.5f, combatEntities[i].position.y - 1.0f, combatEntities[i].position.z - 0.5f };
+            Vector3 entityMax = { combatEntities[i].position.x + 0.5f, combatEntities[i].position.y + 1.0f, combatEntities[i].position.z + 0.5f };
+            if (CheckCollisionBoxes3D(playerMin, playerMax, entityMin, entityMax)) {
+                playerHealth -= 10.0f * deltaTime;
+                if (playerHealth <= 0) {
+                    KillPlayer();
+                }
+            }
+        }
+    }
+
+    // --- Aircraft and Bomb Logic ---
+    FlyAircraft(deltaTime, cfg);
+
+    // Bomb dropping logic: only if there are active enemies
+    for (int a = 0; a < aircraftCount && activeEnemiesCount > 0; a++) {
+        if (!aircraftCold[a].bombReady) continue;
+        ProjectileBomb *bomb = SpawnBomb(bombs, &bombCount, MAX_BOMBS, &bombHandles);
+        if (bomb == NULL) CountSpawnFailure(TELEMETRY_POOL_BOMBS);
+        if (bomb != NULL) {
+            bomb->position = aircraft[a].position; // Drop bomb from the aircraft's current position
+            bomb->velocity = (Vector3){0.0f, -cfg->bombFallSpeed, 0.0f};
+            bomb->exploded = false;
+            bomb->radius = BOMB_RADIUS;
+            bomb->explosion_radius = cfg->bombExplosionRadius;
+            bomb->explosion_duration = cfg->bombExplosionDuration;
+            PlayGameSound(bombDropSound);
+            StartCooldown(&aircraftCold[a].bombReady, TIMER_AIRCRAFT_BOMB_READY, aircraftCold[a].handle, cfg->jetBombDropRate);
+        }
+    }
+
+    // Update falling bombs; exploded ones wait for their explosion-end timer
+    float bombGround[MAX_BOMBS];
+    for (int i = 0; i < bombCount; i++) {
+        if (bombs[i].exploded) continue;
+        bombs[i].velocity.y -= cfg->gravity * deltaTime;
+        bombs[i].position = Vector3Add(bombs[i].position, Vector3Scale(bombs[i].velocity, deltaTime));
+    }
+    SAMPLE_POOL_GROUND(bombs, bombCount, bombGround);
+    for (int i = bombCount - 1; i >= 0; i--) {
+        if (bombs[i].exploded) continue;
+        if (bombs[i].position.y - bombs[i].radius <= bombGround[i]) {
+            bombs[i].position.y = bombGround[i] + bombs[i].radius;
+            bombs[i].velocity = Vector3Zero();
+            PlayGameSound(explosionSound);
+
+            // Area damage is resolved with every other detonation of this frame
+            ExplosionEvent explosion = { bombs[i].position, bombs[i].explosion_radius, 0.0f, EXPLOSION_LETHAL_DAMAGE, BOMB_TANK_DAMAGE, false, true, NULL_HANDLE, 0.0f };
+            QueueExplosion(explosion);
+            EmitEffect(EFFECT_EXPLOSION, bombs[i].position, (Vector3){ 0.0f, 1.0f, 0.0f }, bombs[i].explosion_radius / BOMB_EXPLOSION_RADIUS);
+            if (!StartBombExplosion(&bombs[i], TIMER_BOMB_EXPLOSION_END)) RemoveBomb(bombs, &bombCount, &bombHandles, i);
+        }
+    }
+    // --- End Aircraft and Bomb Logic ---
+
+    // --- Aircraft Missile Logic ---
+    LockAircraftTargets(&frameArena, cfg);
+
+    // Fire a salvo if target is locked and timer allows. Missiles leave on a sunflower spiral
+    // across the launch cone, so a large salvo fans out instead of flying as one clump.
+    for (int a = 0; a < aircraftCount; a++) {
+        AircraftCold *cold = &aircraftCold[a];
+        if (cold->lockedTarget.slot == -1 || !cold->missileReady) continue;
+        const Aircraft *plane = &aircraft[a];
+        int salvo = (int)cfg->jetMissileSalvo;
+        Vector3 launchRight = Vector3Normalize(Vector3CrossProduct(plane->forward, (Vector3){ 0.0f, 1.0f, 0.0f }));
+        Vector3 launchUp = Vector3CrossProduct(launchRight, plane->forward);
+        int launched = 0;
+        for (int k = 0; k < salvo; k++) {
+            int i = AddMissile();
+            if (i == -1) {
+                CountSpawnFailure(TELEMETRY_POOL_MISSILES);
+                break;
+            }
+            float spread = (salvo > 1) ? JET_MISSILE_SALVO_SPREAD * sqrtf((k + 0.5f) / salvo) : 0.0f;
+            float angle = k * 2.39996323f; // Golden angle
+            Vector3 direction = Vector3Add(plane->forward, Vector3Add(Vector3Scale(launchRight, spread * cosf(angle)), Vector3Scale(launchUp, spread * sinf(angle))));
+            Vector3 velocity = Vector3Scale(Vector3Normalize(direction), cfg->missileSpeed); // Leaves along the aircraft's forward
+            missiles.positionX[i] = plane->position.x; // Missile starts from the aircraft's position
+            missiles.positionY[i] = plane->position.y;
+            missiles.positionZ[i] = plane->position.z;
+            missiles.velocityX[i] = velocity.x;
+            missiles.velocityY[i] = velocity.y;
+            missiles.velocityZ[i] = velocity.z;
+            missiles.targetTank[i] = cold->lockedTarget;
+            missiles.speed[i] = cfg->missileSpeed;
+            missiles.damage[i] = cfg->missileDamage;
+            launched++;
+        }
+        if (launched > 0) {
+            PlayGameSound(missileLaunchSound);
+            StartCooldown(&cold->missileReady, TIMER_AIRCRAFT_MISSILE_READY, cold->handle, cfg->jetMissileFireRate);
+        }
+    }
+
+    // Update missiles at the missile rate
+    int missileSteps = AdvanceRateClock(&missileClock, deltaTime);
+    MissileGuidanceLanes missileLanes;
+    if (missileSteps > 0 && missileCount > 0 && AllocMissileGuidanceLanes(&missileLanes, &frameArena)) {
+        for (int n = missileSteps; n > 0; n--) StepMissiles(missileClock.period, &missileLanes, cfg);
+    }
+    // --- End Aircraft Missile Logic ---
+
+
+    // --- Tank Logic ---
+    // Kinematics every frame (the position extrapolates between ticks), AI, collisions and weapons
+    // at the tank rate
+    IntegrateTanks(deltaTime, cfg);
+    for (int n = AdvanceRateClock(&tankClock, deltaTime); n > 0; n--) StepTanks(tankClock.period, cfg);
+
+    // Update falling tank bombs
+    float tankBombGround[MAX_TANK_BOMBS];
+    for (int i = 0; i < tankBombCount; i++) {
+        if (tankBombs[i].exploded) continue;
+        tankBombs[i].velocity.y -= cfg->gravity * deltaTime;
+        tankBombs[i].position = Vector3Add(tankBombs[i].position, Vector3Scale(tankBombs[i].velocity, deltaTime));
+    }
+    SAMPLE_POOL_GROUND(tankBombs, tankBombCount, tankBombGround);
+    for (int i = tankBombCount - 1; i >= 0; i--) {
+        if (tankBombs[i].exploded) continue;
+        if (tankBombs[i].position.y - tankBombs[i].radius <= tankBombGround[i]) {
+            tankBombs[i].position.y = tankBombGround[i] + tankBombs[i].radius;
+            tankBombs[i].velocity = Vector3Zero();
+            PlayGameSound(explosionSound); // Use general explosion sound for tank bombs too
+
+            // Area damage to player, entities, crates and tanks is resolved in the batched pass
+            ExplosionEvent explosion = { tankBombs[i].position, tankBombs[i].explosion_radius, 0.0f, EXPLOSION_LETHAL_DAMAGE, TANK_BOMB_TANK_DAMAGE, true, true, NULL_HANDLE, 0.0f };
+            QueueExplosion(explosion);
+            EmitEffect(EFFECT_EXPLOSION, tankBombs[i].position, (Vector3){ 0.0f, 1.0f, 0.0f }, tankBombs[i].explosion_radius / BOMB_EXPLOSION_RADIUS);
+            if (!StartBombExplosion(&tankBombs[i], TIMER_TANK_BOMB_EXPLOSION_END)) RemoveBomb(tankBombs, &tankBombCount, &tankBombHandles, i);
+        }
+    }
+    // --- End Tank Logic ---
+
+    // Apply all bomb, tank bomb and missile damage queued during this frame
+    ResolveExplosions();
+}
+
+// Step reading tuning values from this world's (file-loaded or swept) config
+void StepSimulationRuntime(float deltaTime, const PlayerInput *input) {
+    StepSimulationKernel(deltaTime, input, &config);
+}
+
+// Step specialised for defaultConfig: every tuning value folds into the generated code
+void StepSimulationBaked(float deltaTime, const PlayerInput *input) {
+    StepSimulationKernel(deltaTime, input, &defaultConfig);
+}
+
+// Advances the calling thread's world by deltaTime. Touches no window, input or audio state
+// (sounds go through PlayGameSound), so it runs unchanged in headless worlds.
+void StepSimulation(float deltaTime, const PlayerInput *input) {
+    double start = WallClockSeconds();
+#ifdef BAKED_CONFIG
+    StepSimulationBaked(deltaTime, input);
+#else
+    StepSimulationRuntime(deltaTime, input);
+#endif
+    RecordSimulationStep(WallClockSeconds() - start);
+}
+
+// --- Benchmarks ---
+// Headless runs selected from the command line; they drive the simulation systems without a window.
+
+// Moves agentCount agents towards the world's targets for FLOWFIELD_BENCH_TICKS ticks, reading the
+// shared flow fields, and compares with per-agent direct steering plus pairwise avoidance
+int RunFlowFieldBenchmark(int agentCount) {
+    if (agentCount <= 0) agentCount = FLOWFIELD_BENCH_AGENTS;
+    const float dt = 1.0f / 60.0f;
+    const float agentSpeed = 3.0f;
+    float *agentX = malloc(sizeof(float) * (size_t)agentCount);
+    float *agentZ = malloc(sizeof(float) * (size_t)agentCount);
+    if (agentX == NULL || agentZ == NULL) {
+        free(agentX);
+        free(agentZ);
+        TraceLog(LOG_ERROR, "BENCH: could not allocate %d agents", agentCount);
+        return 1;
+    }
+
+    SeedWorldRandom(1234);
+    ResetGame();
+    for (int i = 0; i < agentCount; i++) {
+        agentX[i] = (float)(WorldRand() % 9000) / 100.0f - 45.0f;
+        agentZ[i] = (float)(WorldRand() % 9000) / 100.0f - 45.0f;
+    }
+
+    double buildSeconds = 0.0, moveSeconds = 0.0;
+    for (int tick = 0; tick < FLOWFIELD_BENCH_TICKS; tick++) {
+        ResetFrameArena(&frameArena);
+        double start = WallClockSeconds();
+        BuildFlowFields(&flowFields, &frameArena, StreamWindowCentre(simulationWindowX, simulationWindowZ));
+        double built = WallClockSeconds();
+        for (int i = 0; i < agentCount; i++) {
+            Vector3 position = { agentX[i], 1.0f, agentZ[i] };
+            Vector3 direction = SampleFlowField(&flowFields, (FlowGroup)(i & 1), position);
+            agentX[i] += direction.x * agentSpeed * dt;
+            agentZ[i] += direction.z * agentSpeed * dt;
+        }
+        buildSeconds += built - start;
+        moveSeconds += WallClockSeconds() - built;
+    }
+
+    // Baseline: every agent searches its own target and tests every other agent for overlap
+    double baselineStart = WallClockSeconds();
+    for (int tick = 0; tick < FLOWFIELD_BENCH_BASELINE_TICKS; tick++) {
+        for (int i = 0; i < agentCount; i++) {
+            float bestDistance = FLT_MAX, dirX = 0.0f, dirZ = 0.0f;
+            for (int j = 0; j < combatEntityCount; j++) {
+                float dx = combatEntities[j].position.x - agentX[i], dz = combatEntities[j].position.z - agentZ[i];
+                float distance = sqrtf(dx * dx + dz * dz);
+                if (distance > 0.0f && distance < bestDistance) {
+                    bestDistance = distance;
+                    dirX = dx / distance;
+                    dirZ = dz / distance;
+                }
+            }
+            for (int j = i + 1; j < agentCount; j++) {
+                if (fabsf(agentX[i] - agentX[j]) < 1.0f && fabsf(agentZ[i] - agentZ[j]) < 1.0f) {
+                    dirX = -dirX * 0.5f;
+                    dirZ = -dirZ * 0.5f;
+                }
+            }
+            agentX[i] += dirX * agentSpeed * dt;
+            agentZ[i] += dirZ * agentSpeed * dt;
+        }
+    }
+    double baselineSeconds = WallClockSeconds() - baselineStart;
+
+    double flowAgentsPerMs = (double)agentCount * FLOWFIELD_BENCH_TICKS / ((buildSeconds + moveSeconds) * 1000.0);
+    double baselineAgentsPerMs = (double)agentCount * FLOWFIELD_BENCH_BASELINE_TICKS / (baselineSeconds * 1000.0);
+    printf("flowfield: %d agents, %d ticks, %dx%d grid, %d groups\n", agentCount, FLOWFIELD_BENCH_TICKS, FLOWFIELD_DIM, FLOWFIELD_DIM, FLOW_GROUP_COUNT);
+    printf("  field build   %8.3f ms/tick\n", buildSeconds * 1000.0 / FLOWFIELD_BENCH_TICKS);
+    printf("  agent update  %8.3f ms/tick\n", moveSeconds * 1000.0 / FLOWFIELD_BENCH_TICKS);
+    printf("  flow field    %10.1f agents moved/ms (build included)\n", flowAgentsPerMs);
+    printf("  direct+pairs  %10.1f agents moved/ms (%d ticks)\n", baselineAgentsPerMs, FLOWFIELD_BENCH_BASELINE_TICKS);
+
+    free(agentX);
+    free(agentZ);
+    return 0;
+}
+
+int CompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Launches a benchmark missile at a random tank from a random point around the arena
+void LaunchBenchMissile(void) {
+    int i = AddMissile();
+    if (i == -1) return;
+    float angle = (float)(WorldRand() % 3600) * (2.0f * PI / 3600.0f);
+    float distance = 60.0f + (float)(WorldRand() % 300) / 10.0f;
+    missiles.positionX[i] = cosf(angle) * distance;
+    missiles.positionZ[i] = sinf(angle) * distance;
+    missiles.positionY[i] = SampleTerrainHeight(missiles.positionX[i], missiles.positionZ[i]) + 20.0f + (float)(WorldRand() % 300) / 10.0f;
+    float heading = (float)(WorldRand() % 3600) * (2.0f * PI / 3600.0f); // Launched in any direction
+    missiles.velocityX[i] = cosf(heading) * MISSILE_SPEED;
+    missiles.velocityY[i] = 0.0f;
+    missiles.velocityZ[i] = sinf(heading) * MISSILE_SPEED;
+    missiles.speed[i] = MISSILE_SPEED;
+    missiles.targetTank[i] = tanksCold[WorldRand() % tankCount].handle;
+    missiles.damage[i] = 0.0f; // Tanks must survive the whole run
+}
+
+// Keeps missileTarget missiles in flight against moving tanks for MISSILE_BENCH_TICKS guidance
+// sub-steps and reports the sub-step time. Missiles that hit or leave are replaced outside the
+// timed region, so every timed sub-step guides the full salvo.
+int RunMissileBenchmark(int missileTarget) {
+    if (missileTarget <= 0 || missileTarget > MAX_MISSILES) missileTarget = MAX_MISSILES;
+    const float dt = 1.0f / MISSILE_UPDATE_RATE;
+    double *tickSeconds = malloc(sizeof(double) * MISSILE_BENCH_TICKS);
+    if (tickSeconds == NULL) {
+        TraceLog(LOG_ERROR, "BENCH: could not allocate the tick timings");
+        return 1;
+    }
+
+    config = defaultConfig;
+    SeedWorldRandom(4321);
+    ResetGame();
+    if (tankCount == 0) {
+        TraceLog(LOG_ERROR, "BENCH: the world has no tanks to target");
+        free(tickSeconds);
+        return 1;
+    }
+    for (int t = 0; t < tankCount; t++) tanks[t].velocity = (Vector3){ 4.0f * cosf((float)t), 0.0f, 4.0f * sinf((float)t) };
+    // Ground queries should hit resident chunks, not the generator fallback
+    for (int n = 0; n < STREAM_WINDOW_CHUNKS * STREAM_WINDOW_CHUNKS / STREAM_SYNC_LOADS; n++) UpdateChunkStreaming(&terrainStream, camera.position);
+
+    long long impacts = 0, retired = 0;
+    for (int tick = 0; tick < MISSILE_BENCH_TICKS; tick++) {
+        ResetFrameArena(&frameArena);
+        while (missileCount < missileTarget) LaunchBenchMissile();
+        IntegrateTanks(dt, &config);
+        MissileGuidanceLanes lanes;
+        if (!AllocMissileGuidanceLanes(&lanes, &frameArena)) {
+            free(tickSeconds);
+            return 1;
+        }
+        double start = WallClockSeconds();
+        StepMissiles(dt, &lanes, &config);
+        tickSeconds[tick] = WallClockSeconds() - start;
+        for (int i = 0; i < missileTarget; i++) impacts += (lanes.hitFraction[i] <= 1.0f);
+        retired += missileTarget - missileCount;
+        ResolveExplosions();
+    }
+
+    double totalSeconds = 0.0;
+    for (int tick = 0; tick < MISSILE_BENCH_TICKS; tick++) totalSeconds += tickSeconds[tick];
+    qsort(tickSeconds, MISSILE_BENCH_TICKS, sizeof(double), CompareDoubles);
+    printf("missiles: %d in flight, %d sub-steps at %.0f Hz, %d lanes\n", missileTarget, MISSILE_BENCH_TICKS, MISSILE_UPDATE_RATE, MISSILE_LANES);
+    printf("  sub-step  mean %8.3f us  p50 %8.3f us  p99 %8.3f us  max %8.3f us\n", totalSeconds * 1.0e6 / MISSILE_BENCH_TICKS,
+           tickSeconds[MISSILE_BENCH_TICKS / 2] * 1.0e6, tickSeconds[MISSILE_BENCH_TICKS * 99 / 100] * 1.0e6, tickSeconds[MISSILE_BENCH_TICKS - 1] * 1.0e6);
+    printf("  %10.1f missiles guided/ms, %lld of %lld retired missiles hit their tank\n",
+           (double)missileTarget * MISSILE_BENCH_TICKS / (totalSeconds * 1000.0), impacts, retired);
+
+    free(tickSeconds);
+    return 0;
+}
+
+// Random unit vector, uniform over the sphere
+Vector3 RandomBenchDirection(void) {
+    float y = (float)(WorldRand() % 20001) / 10000.0f - 1.0f;
+    float angle = (float)(WorldRand() % 3600) * (2.0f * PI / 3600.0f);
+    float ring = sqrtf(fmaxf(1.0f - y * y, 0.0f));
+    return (Vector3){ ring * cosf(angle), y, ring * sinf(angle) };
+}
+
+// Scatters boxCount randomly sized and rotated boxes over a 200 x 200 area, then times the BVH
+// build, a refit after every box moved, HITSCAN_BENCH_RAYS ray casts through the tree and the same
+// rays against every box. Both casts must agree on every baseline ray.
+int RunHitScanBenchmark(int boxCount) {
+    if (boxCount <= 0) boxCount = HITSCAN_BENCH_BOXES;
+    const int rayCount = 4096; // Distinct rays, cycled through for the timed casts
+    Bvh bvh = { .builtBoxCount = -1 };
+    bvh.boxes = malloc(sizeof(HitScanBox) * (size_t)boxCount);
+    bvh.order = malloc(sizeof(int) * (size_t)boxCount);
+    bvh.nodes = malloc(sizeof(BvhNode) * 2 * (size_t)boxCount);
+    Vector3 *origins = malloc(sizeof(Vector3) * rayCount);
+    Vector3 *directions = malloc(sizeof(Vector3) * rayCount);
+    if (bvh.boxes == NULL || bvh.order == NULL || bvh.nodes == NULL || origins == NULL || directions == NULL) {
+        free(bvh.boxes);
+        free(bvh.order);
+        free(bvh.nodes);
+        free(origins);
+        free(directions);
+        TraceLog(LOG_ERROR, "BENCH: could not allocate %d boxes", boxCount);
+        return 1;
+    }
+
+    SeedWorldRandom(2468);
+    for (int i = 0; i < boxCount; i++) {
+        Vector3 center = { (float)(WorldRand() % 20000) / 100.0f - 100.0f, (float)(WorldRand() % 1000) / 100.0f, (float)(WorldRand() % 20000) / 100.0f - 100.0f };
+        Vector3 halfExtents = { 0.5f + (float)(WorldRand() % 200) / 100.0f, 0.5f + (float)(WorldRand() % 200) / 100.0f, 0.5f + (float)(WorldRand() % 200) / 100.0f };
+        Quaternion rotation = QuaternionFromAxisAngle(RandomBenchDirection(), (float)(WorldRand() % 3600) * (2.0f * PI / 3600.0f));
+        SetHitScanBox(&bvh.boxes[i], HIT_CRATE, i, MakeOrientedBox(center, halfExtents, rotation));
+    }
+    for (int r = 0; r < rayCount; r++) {
+        origins[r] = (Vector3){ (float)(WorldRand() % 20000) / 100.0f - 100.0f, 2.0f + (float)(WorldRand() % 1000) / 100.0f, (float)(WorldRand() % 20000) / 100.0f - 100.0f };
+        directions[r] = RandomBenchDirection();
+    }
+
+    bvh.boxCount = boxCount;
+    double start = WallClockSeconds();
+    UpdateBvh(&bvh);
+    double buildSeconds = WallClockSeconds() - start;
+    float builtArea = bvh.builtArea;
+
+    for (int i = 0; i < boxCount; i++) {
+        HitScanBox *box = &bvh.boxes[i];
+        Vector3 moved = Vector3Add(box->shape.center, Vector3Scale(RandomBenchDirection(), 0.5f));
+        SetHitScanBox(box, box->kind, box->index, MakeOrientedBox(moved, box->shape.halfExtents, QuaternionFromAxisAngle(RandomBenchDirection(), 0.3f)));
+    }
+    start = WallClockSeconds();
+    UpdateBvh(&bvh);
+    double refitSeconds = WallClockSeconds() - start;
+    bool refitOnly = (bvh.builtArea == builtArea);
+
+    long long bvhHits = 0;
+    start = WallClockSeconds();
+    for (int n = 0; n < HITSCAN_BENCH_RAYS; n++) {
+        bvhHits += RaycastBvh(&bvh, origins[n % rayCount], directions[n % rayCount], HITSCAN_RANGE).hit;
+    }
+    double bvhSeconds = WallClockSeconds() - start;
+
+    long long baselineHits = 0;
+    int mismatches = 0;
+    start = WallClockSeconds();
+    for (int n = 0; n < HITSCAN_BENCH_BASELINE_RAYS; n++) {
+        baselineHits += RaycastBoxes(bvh.boxes, boxCount, origins[n % rayCount], directions[n % rayCount], HITSCAN_RANGE).hit;
+    }
+    double baselineSeconds = WallClockSeconds() - start;
+    for (int r = 0; r < rayCount && r < HITSCAN_BENCH_BASELINE_RAYS; r++) {
+        RayHit tree = RaycastBvh(&bvh, origins[r], directions[r], HITSCAN_RANGE);
+        RayHit brute = RaycastBoxes(bvh.boxes, boxCount, origins[r], directions[r], HITSCAN_RANGE);
+        mismatches += (tree.hit != brute.hit || tree.box != brute.box || tree.distance != brute.distance);
+    }
+
+    printf("hitscan: %d oriented boxes, %d nodes, leaves of %d, range %.0f\n", boxCount, bvh.nodeCount, BVH_LEAF_SIZE, HITSCAN_RANGE);
+    printf("  build   %8.3f ms\n", buildSeconds * 1000.0);
+    printf("  refit   %8.3f ms%s\n", refitSeconds * 1000.0, refitOnly ? "" : " (grew past the rebuild threshold and was rebuilt)");
+    printf("  bvh         %12.0f rays/s, %.1f%% hit\n", HITSCAN_BENCH_RAYS / bvhSeconds, 100.0 * (double)bvhHits / HITSCAN_BENCH_RAYS);
+    printf("  brute force %12.0f rays/s, %.1f%% hit (%d rays)\n", HITSCAN_BENCH_BASELINE_RAYS / baselineSeconds,
+           100.0 * (double)baselineHits / HITSCAN_BENCH_BASELINE_RAYS, HITSCAN_BENCH_BASELINE_RAYS);
+    printf("  %d of %d rays disagree with the brute-force cast\n", mismatches, rayCount < HITSCAN_BENCH_BASELINE_RAYS ? rayCount : HITSCAN_BENCH_BASELINE_RAYS);
+
+    free(bvh.boxes);
+    free(bvh.order);
+    free(bvh.nodes);
+    free(origins);
+    free(directions);
+    return (mismatches == 0) ? 0 : 1;
+}
+
+// One particle at a time, the update UpdateParticlePool did before it ran in lanes
+void UpdateParticlePoolScalar(ParticlePool *pool, const ParticleEmitterInfo *info, float deltaTime) {
+    float fall = info->gravity * deltaTime;
+    float damping = 1.0f / (1.0f + info->drag * deltaTime);
+    for (int i = 0; i < pool->count; i++) {
+        pool->velocityX[i] = pool->velocityX[i] * damping;
+        pool->velocityY[i] = (pool->velocityY[i] - fall) * damping;
+        pool->velocityZ[i] = pool->velocityZ[i] * damping;
+        pool->positionX[i] += pool->velocityX[i] * deltaTime;
+        pool->positionY[i] += pool->velocityY[i] * deltaTime;
+        pool->positionZ[i] += pool->velocityZ[i] * deltaTime;
+        pool->age[i] += deltaTime;
+    }
+    for (int i = pool->count - 1; i >= 0; i--) {
+        if (pool->age[i] >= pool->lifetime[i]) RemoveParticle(pool, i);
+    }
+}
+
+// Fills a spark pool with particleCount particles that outlive the run and times
+// PARTICLE_BENCH_FRAMES updates in lanes against the scalar loop on a copy of the same pool. Both
+// must end in the same place. Then one frame of explosions next to the camera shows the budget.
+int RunParticleBenchmark(int particleCount) {
+    if (particleCount <= 0 || particleCount > MAX_PARTICLES) particleCount = MAX_PARTICLES;
+    const float dt = 1.0f / 60.0f;
+    const ParticleEmitterInfo *info = &particleEmitters[PARTICLE_SPARK];
+    ParticlePool *lanes = malloc(sizeof(ParticlePool));
+    ParticlePool *scalar = malloc(sizeof(ParticlePool));
+    if (lanes == NULL || scalar == NULL) {
+        TraceLog(LOG_ERROR, "BENCH: could not allocate the particle pools");
+        free(lanes);
+        free(scalar);
+        return 1;
+    }
+
+    particlePools[PARTICLE_SPARK].count = 0;
+    SpawnParticles(PARTICLE_SPARK, (Vector3){ 0.0f, 10.0f, 0.0f }, (Vector3){ 0.0f, 1.0f, 0.0f }, 0.5f, particleCount);
+    *lanes = particlePools[PARTICLE_SPARK];
+    particlePools[PARTICLE_SPARK].count = 0;
+    for (int i = 0; i < lanes->count; i++) lanes->lifetime[i] = 2.0f * PARTICLE_BENCH_FRAMES * dt;
+    *scalar = *lanes;
+
+    double start = WallClockSeconds();
+    for (int frame = 0; frame < PARTICLE_BENCH_FRAMES; frame++) UpdateParticlePool(lanes, info, dt);
+    double laneSeconds = WallClockSeconds() - start;
+    start = WallClockSeconds();
+    for (int frame = 0; frame < PARTICLE_BENCH_FRAMES; frame++) UpdateParticlePoolScalar(scalar, info, dt);
+    double scalarSeconds = WallClockSeconds() - start;
+
+    float drift = 0.0f;
+    for (int i = 0; i < particleCount; i++) {
+        Vector3 a = { lanes->positionX[i], lanes->positionY[i], lanes->positionZ[i] };
+        Vector3 b = { scalar->positionX[i], scalar->positionY[i], scalar->positionZ[i] };
+        drift = fmaxf(drift, Vector3Distance(a, b));
+    }
+    bool agree = lanes->count == particleCount && scalar->count == particleCount && drift <= 1.0e-3f;
+
+    // A carpet of bombs in one frame: everything past the budget is culled
+    EffectEvent explosion = { EFFECT_EXPLOSION, camera.position, { 0.0f, 1.0f, 0.0f }, 1.0f };
+    unsigned long long spawnedBefore = telemetryLocal.counters[TELEMETRY_PARTICLES_SPAWNED];
+    unsigned long long culledBefore = telemetryLocal.counters[TELEMETRY_PARTICLES_CULLED];
+    for (int n = 0; n < 100; n++) SpawnEffect(&explosion);
+    unsigned long long spawned = telemetryLocal.counters[TELEMETRY_PARTICLES_SPAWNED] - spawnedBefore;
+    unsigned long long culled = telemetryLocal.counters[TELEMETRY_PARTICLES_CULLED] - culledBefore;
+    UpdateParticles(dt);
+
+    printf("particles: %d, %d updates at %.0f Hz, %d lanes\n", particleCount, PARTICLE_BENCH_FRAMES, 1.0f / dt, MISSILE_LANES);
+    printf("  lanes   %12.1f particle updates/ms\n", (double)particleCount * PARTICLE_BENCH_FRAMES / (laneSeconds * 1000.0));
+    printf("  scalar  %12.1f particle updates/ms (%.2fx)\n", (double)particleCount * PARTICLE_BENCH_FRAMES / (scalarSeconds * 1000.0),
+           scalarSeconds / laneSeconds);
+    printf("  lanes and scalar %s (max drift %.2g)\n", agree ? "agree" : "DISAGREE", drift);
+    printf("  100 explosions in one frame: %llu particles spawned, %llu culled by the %d budget\n", spawned, culled, PARTICLE_FRAME_BUDGET);
+
+    free(lanes);
+    free(scalar);
+    return agree ? 0 : 1;
+}
+
+// --- Telemetry Export ---
+// Renders the telemetry totals in the Prometheus text exposition format. A background thread
+// rewrites --metrics-file every --metrics-interval seconds (through a temporary file, so readers
+// never see half a write) and answers GET /metrics on 127.0.0.1:--metrics-port.
+typedef struct {
+    const char *filePath; // NULL: no file export
+    int port;             // 0: no HTTP endpoint
+    double fileInterval;  // Seconds between file writes
+} TelemetryOptions;
+
+#define DEFAULT_TELEMETRY_OPTIONS ((TelemetryOptions){ NULL, 0, TELEMETRY_EXPORT_SECONDS })
+
+typedef struct {
+    TelemetryOptions options;
+    pthread_t thread;
+    atomic_bool quit;
+    bool running;
+    int listenSocket; // -1 without an HTTP endpoint
+    char *text;       // TELEMETRY_TEXT_CAPACITY bytes, owned by the exporter thread while it runs
+} TelemetryExporter;
+
+typedef struct {
+    char *buffer;
+    size_t length;
+    size_t capacity;
+} TelemetryText;
+
+void AppendTelemetryText(TelemetryText *out, const char *format, ...) {
+    if (out->length >= out->capacity) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(out->buffer + out->length, out->capacity - out->length, format, args);
+    va_end(args);
+    if (written > 0) out->length += (size_t)written;
+}
+
+void AppendTelemetryHeader(TelemetryText *out, const char *name, const char *help, const char *type) {
+    AppendTelemetryText(out, "# HELP battleforce_%s %s\n# TYPE battleforce_%s %s\n", name, help, name, type);
+}
+
+// Returns the text length, clamped to the buffer when the text did not fit
+size_t FormatTelemetry(char *buffer, size_t capacity) {
+    TelemetryText out = { buffer, 0, capacity };
+    for (int c = 0; c < TELEMETRY_COUNTER_COUNT; c++) {
+        AppendTelemetryHeader(&out, telemetryCounterInfo[c].name, telemetryCounterInfo[c].help, "counter");
+        AppendTelemetryText(&out, "battleforce_%s %llu\n", telemetryCounterInfo[c].name, atomic_load_explicit(&telemetryTotals.counters[c], memory_order_relaxed));
+    }
+
+    AppendTelemetryHeader(&out, "worlds", "Worlds currently publishing pool gauges", "gauge");
+    AppendTelemetryText(&out, "battleforce_worlds %d\n", atomic_load_explicit(&telemetryTotals.worlds, memory_order_relaxed));
+    AppendTelemetryHeader(&out, "pool_live", "Live objects per pool, summed over the publishing worlds", "gauge");
+    for (int p = 0; p < TELEMETRY_POOL_COUNT; p++) {
+        AppendTelemetryText(&out, "battleforce_pool_live{pool=\"%s\"} %lld\n", telemetryPoolNames[p], atomic_load_explicit(&telemetryTotals.live[p], memory_order_relaxed));
+    }
+    AppendTelemetryHeader(&out, "spawn_failures_total", "Spawns refused because their pool was full", "counter");
+    for (int p = 0; p < TELEMETRY_POOL_COUNT; p++) {
+        AppendTelemetryText(&out, "battleforce_spawn_failures_total{pool=\"%s\"} %llu\n", telemetryPoolNames[p],
+                            atomic_load_explicit(&telemetryTotals.spawnFailures[p], memory_order_relaxed));
+    }
+
+    for (int h = 0; h < TELEMETRY_HISTOGRAM_COUNT; h++) {
+        const char *name = telemetryHistogramInfo[h].name;
+        AppendTelemetryHeader(&out, name, telemetryHistogramInfo[h].help, "histogram");
+        unsigned long long cumulative = 0;
+        for (int b = 0; b <= TELEMETRY_HISTOGRAM_BUCKETS; b++) {
+            cumulative += atomic_load_explicit(&telemetryTotals.buckets[h][b], memory_order_relaxed);
+            if (b < TELEMETRY_HISTOGRAM_BUCKETS) AppendTelemetryText(&out, "battleforce_%s_bucket{le=\"%g\"} %llu\n", name, telemetryBucketBounds[b], cumulative);
+            else AppendTelemetryText(&out, "battleforce_%s_bucket{le=\"+Inf\"} %llu\n", name, cumulative);
+        }
+        AppendTelemetryText(&out, "battleforce_%s_sum %.9f\n", name, atomic_load_explicit(&telemetryTotals.sumNanos[h], memory_order_relaxed) * 1.0e-9);
+        AppendTelemetryText(&out, "battleforce_%s_count %llu\n", name, cumulative);
+    }
+    return (out.length < capacity) ? out.length : capacity - 1;
+}
+
+bool WriteTelemetryFile(const char *path, const char *text, size_t length) {
+    char temporaryPath[1024];
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path);
+    FILE *file = fopen(temporaryPath, "wb");
+    if (file == NULL) return false;
+    bool written = fwrite(text, 1, length, file) == length;
+    written = (fclose(file) == 0) && written;
+#ifdef _WIN32
+    remove(path); // rename() does not replace an existing file here
+#endif
+    return written && rename(temporaryPath, path) == 0;
+}
+
+#ifdef NET_SUPPORTED
+int OpenTelemetryListener(int port) {
+    int socketHandle = socket(AF_INET, SOCK_STREAM, 0);
+    if (socketHandle < 0) return -1;
+    int reuse = 1;
+    setsockopt(socketHandle, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in address = { 0 };
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Scrapers run on the same machine
+    address.sin_port = htons((unsigned short)port);
+    if (bind(socketHandle, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(socketHandle, 8) < 0 ||
+        fcntl(socketHandle, F_SETFL, O_NONBLOCK) < 0) {
+        close(socketHandle);
+        return -1;
+    }
+    return socketHandle;
+}
+
+// One request per connection: GET /metrics gets the exposition text, anything else a 404
+void ServeTelemetryRequest(int connection, const char *text, size_t length) {
+    struct timeval timeout = { (time_t)TELEMETRY_REQUEST_TIMEOUT, 0 };
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)); // A scraper that stops reading must not stall the exporter
+    double deadline = WallClockSeconds() + TELEMETRY_REQUEST_TIMEOUT;
+    char request[1024];
+    size_t received = 0;
+    while (received < sizeof(request) - 1) {
+        ssize_t bytes = recv(connection, request + received, sizeof(request) - 1 - received, 0);
+        if (bytes <= 0) break;
+        received += (size_t)bytes;
+        request[received] = '\0';
+        if (strstr(request, "\r\n\r\n") != NULL || strstr(request, "\n\n") != NULL) break;
+    }
+    request[received] = '\0';
+
+    bool found = strncmp(request, "GET /metrics ", 13) == 0 || strncmp(request, "GET /metrics?", 13) == 0;
+    char header[256];
+    int headerLength = snprintf(header, sizeof(header), "HTTP/1.0 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                                found ? "200 OK" : "404 Not Found", found ? length : (size_t)0);
+    bool replying = send(connection, header, (size_t)headerLength, MSG_NOSIGNAL) == headerLength;
+    for (size_t sent = 0; replying && found && sent < length && WallClockSeconds() < deadline;) {
+        ssize_t bytes = send(connection, text + sent, length - sent, MSG_NOSIGNAL);
+        if (bytes <= 0) break;
+        sent += (size_t)bytes;
+    }
+    close(connection);
+}
+#endif
+
+void *TelemetryExporterThread(void *argument) {
+    TelemetryExporter *exporter = argument;
+    double nextFileTime = WallClockSeconds();
+    while (!atomic_load(&exporter->quit)) {
+#ifdef NET_SUPPORTED
+        int connection;
+        while (exporter->listenSocket >= 0 && (connection = accept(exporter->listenSocket, NULL, NULL)) >= 0) {
+            fcntl(connection, F_SETFL, 0); // Accepted sockets may inherit O_NONBLOCK; the request read relies on the timeout
+            size_t length = FormatTelemetry(exporter->text, TELEMETRY_TEXT_CAPACITY);
+            ServeTelemetryRequest(connection, exporter->text, length);
+        }
+#endif
+        if (exporter->options.filePath != NULL && WallClockSeconds() >= nextFileTime) {
+            size_t length = FormatTelemetry(exporter->text, TELEMETRY_TEXT_CAPACITY);
+            if (!WriteTelemetryFile(exporter->options.filePath, exporter->text, length)) {
+                TraceLog(LOG_WARNING, "TELEMETRY: could not write %s", exporter->options.filePath);
+            }
+            nextFileTime = WallClockSeconds() + exporter->options.fileInterval;
+        }
+        SleepSeconds(TELEMETRY_POLL_SECONDS);
+    }
+    return NULL;
+}
+
+// Starts the exporter when the options ask for one; false only when a requested export cannot run
+bool StartTelemetryExporter(TelemetryExporter *exporter, const TelemetryOptions *options) {
+    memset(exporter, 0, sizeof(TelemetryExporter));
+    exporter->options = *options;
+    exporter->listenSocket = -1;
+    if (options->filePath == NULL && options->port <= 0) return true;
+    if (exporter->options.fileInterval <= 0.0) exporter->options.fileInterval = TELEMETRY_EXPORT_SECONDS;
+    if (options->port > 0) {
+#ifdef NET_SUPPORTED
+        exporter->listenSocket = OpenTelemetryListener(options->port);
+        if (exporter->listenSocket < 0) {
+            TraceLog(LOG_ERROR, "TELEMETRY: could not listen on 127.0.0.1:%d", options->port);
+            return false;
+        }
+#else
+        TraceLog(LOG_ERROR, "TELEMETRY: --metrics-port is not supported on this platform");
+        return false;
+#endif
+    }
+    exporter->text = malloc(TELEMETRY_TEXT_CAPACITY);
+    atomic_init(&exporter->quit, false);
+    if (exporter->text == NULL || pthread_create(&exporter->thread, NULL, TelemetryExporterThread, exporter) != 0) {
+        TraceLog(LOG_ERROR, "TELEMETRY: could not start the exporter thread");
+#ifdef NET_SUPPORTED
+        if (exporter->listenSocket >= 0) close(exporter->listenSocket);
+#endif
+        free(exporter->text);
+        exporter->text = NULL;
+        return false;
+    }
+    exporter->running = true;
+    if (options->port > 0) TraceLog(LOG_INFO, "TELEMETRY: serving http://127.0.0.1:%d/metrics", options->port);
+    if (options->filePath != NULL) TraceLog(LOG_INFO, "TELEMETRY: writing %s every %.1f s", options->filePath, exporter->options.fileInterval);
+    return true;
+}
+
+// Stops the exporter thread and writes the metrics file one last time with the final totals
+void StopTelemetryExporter(TelemetryExporter *exporter) {
+    if (!exporter->running) return;
+    atomic_store(&exporter->quit, true);
+    pthread_join(exporter->thread, NULL);
+    exporter->running = false;
+    if (exporter->options.filePath != NULL) {
+        size_t length = FormatTelemetry(exporter->text, TELEMETRY_TEXT_CAPACITY);
+        if (!WriteTelemetryFile(exporter->options.filePath, exporter->text, length)) {
+            TraceLog(LOG_WARNING, "TELEMETRY: could not write %s", exporter->options.filePath);
+        }
+    }
+#ifdef NET_SUPPORTED
+    if (exporter->listenSocket >= 0) close(exporter->listenSocket);
+#endif
+    free(exporter->text);
+    exporter->text = NULL;
+}
+
+// --metrics-file path, --metrics-port P and --metrics-interval s, shared by every mode that
+// steps worlds. True when argv[*a] was one of them; *a is left on its value.
+bool ParseTelemetryOption(int argc, char **argv, int *a, TelemetryOptions *options) {
+    if (*a + 1 >= argc) return false;
+    if (strcmp(argv[*a], "--metrics-file") == 0) options->filePath = argv[++*a];
+    else if (strcmp(argv[*a], "--metrics-port") == 0) options->port = atoi(argv[++*a]);
+    else if (strcmp(argv[*a], "--metrics-interval") == 0) options->fileInterval = atof(argv[++*a]);
+    else return false;
+    return true;
+}
+
+#ifdef NET_SUPPORTED
+// --scrape-metrics [port]: a minimal local scraper. Fetches /metrics once, prints the body and
+// checks it is a well-formed exposition with the core series present.
+int RunTelemetryScrape(int port) {
+    int socketHandle = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = { 0 };
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((unsigned short)port);
+    if (socketHandle < 0 || connect(socketHandle, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        TraceLog(LOG_ERROR, "TELEMETRY: could not connect to 127.0.0.1:%d", port);
+        if (socketHandle >= 0) close(socketHandle);
+        return 1;
+    }
+    const char *request = "GET /metrics HTTP/1.0\r\nHost: 127.0.0.1\r\n\r\n";
+    send(socketHandle, request, strlen(request), MSG_NOSIGNAL);
+    char *response = malloc(TELEMETRY_TEXT_CAPACITY * 2);
+    size_t received = 0;
+    ssize_t bytes;
+    while (response != NULL && received < TELEMETRY_TEXT_CAPACITY * 2 - 1 &&
+           (bytes = recv(socketHandle, response + received, TELEMETRY_TEXT_CAPACITY * 2 - 1 - received, 0)) > 0) {
+        received += (size_t)bytes;
+    }
+    close(socketHandle);
+    if (response == NULL) return 1;
+    response[received] = '\0';
+
+    char *body = strstr(response, "\r\n\r\n");
+    if (strncmp(response, "HTTP/1.0 200", 12) != 0 || body == NULL) {
+        TraceLog(LOG_ERROR, "TELEMETRY: bad response from 127.0.0.1:%d", port);
+        free(response);
+        return 1;
+    }
+    body += 4;
+    fputs(body, stdout);
+
+    // Every sample line is "name[{labels}] value"
+    int samples = 0, malformed = 0;
+    for (char *line = body; *line != '\0';) {
+        char *end = strchr(line, '\n');
+        if (end == NULL) end = line + strlen(line);
+        if (line[0] != '#' && end > line) {
+            char *space = memchr(line, ' ', (size_t)(end - line));
+            char *valueEnd = NULL;
+            if (space != NULL) strtod(space + 1, &valueEnd);
+            if (space == NULL || valueEnd != end) malformed++;
+            else samples++;
+        }
+        line = (*end == '\n') ? end + 1 : end;
+    }
+    bool complete = strstr(body, "battleforce_simulation_steps_total ") != NULL && strstr(body, "battleforce_step_seconds_count ") != NULL;
+    printf("# scraped %d samples, %d malformed lines%s\n", samples, malformed, complete ? "" : ", core series MISSING");
+    free(response);
+    return (malformed == 0 && complete) ? 0 : 1;
+}
+#endif
+
+// --- Batch Runner ---
+// Headless matches sharded over a thread pool. Every worker thread owns a complete world (all
+// simulation state is WORLD_LOCAL), seeds it per match and steps it at a fixed tick until the
+// player dies, every hostile is gone or the step cap is reached.
+typedef enum {
+    MATCH_TIMEOUT,
+    MATCH_PLAYER_KILLED,
+    MATCH_HOSTILES_CLEARED,
+    MATCH_OUTCOME_COUNT
+} MatchOutcome;
+
+const char *matchOutcomeNames[MATCH_OUTCOME_COUNT] = { "timeout", "player_killed", "hostiles_cleared" };
+
+typedef struct {
+    int paramSet; // Index of the swept parameter combination
+    unsigned int seed;
+    GameConfig config;
+    // Filled in by the worker that ran the match
+    MatchOutcome outcome;
+    int steps;
+    float playerHealth;
+    int enemiesLeft;
+    int friendliesLeft;
+    int tanksLeft;
+    uint64_t stateHash; // World state hash of every tick, chained; equal only for identical matches
+    double wallSeconds;
+} BatchMatch;
+
+typedef struct {
+    BatchMatch *matches;
+    int matchCount;
+    int stepCap;
+    atomic_int nextMatch; // Work queue: workers claim matches in order
+} BatchJob;
+
+// Bot player: face the nearest hostile (aiming over bullet drop), walk in while it is far away
+// and hold the trigger once it is in range
+PlayerInput BotPlayerInput(void) {
+    PlayerInput input = { 0 };
+    Vector3 nearest = Vector3Zero();
+    float nearestDistance = FLT_MAX;
+    for (int i = 0; i < combatEntityCount; i++) {
+        if (combatEntitiesCold[i].type != ENTITY_ENEMY) continue;
+        float distance = Vector3Distance(camera.position, combatEntities[i].position);
+        if (distance < nearestDistance) {
+            nearestDistance = distance;
+            nearest = combatEntities[i].position;
+        }
+    }
+    for (int i = 0; i < tankCount; i++) {
+        float distance = Vector3Distance(camera.position, tanks[i].position);
+        if (distance < nearestDistance) {
+            nearestDistance = distance;
+            nearest = tanks[i].position;
+        }
+    }
+    if (nearestDistance == FLT_MAX) return input;
+
+    float flightTime = nearestDistance / config.bulletSpeed;
+    nearest.y += 0.5f * config.gravity * flightTime * flightTime;
+    camera.target = Vector3Add(camera.position, Vector3Normalize(Vector3Subtract(nearest, camera.position)));
+    input.forward = nearestDistance > BATCH_BOT_ENGAGE_RANGE;
+    input.fire = nearestDistance < BATCH_BOT_FIRE_RANGE;
+    return input;
+}
+
+void RunBatchMatch(BatchMatch *match, int stepCap) {
+    double start = WallClockSeconds();
+    SeedWorldRandom(match->seed);
+    config = match->config;
+    ResetGame();
+
+    match->outcome = MATCH_TIMEOUT;
+    match->steps = stepCap;
+    match->stateHash = HashWorldState(NULL);
+    for (int step = 0; step < stepCap; step++) {
+        ResetFrameArena(&frameArena);
+        PlayerInput input = BotPlayerInput();
+        BEGIN_SIMULATION_STEP();
+        StepSimulation(BATCH_TICK_SECONDS, &input);
+        END_SIMULATION_STEP();
+        match->stateHash = StateHashRound(match->stateHash, HashWorldState(NULL));
+
+        MatchOutcome outcome = MATCH_TIMEOUT;
+        if (gameOver) outcome = MATCH_PLAYER_KILLED;
+        else if (activeEnemiesCount == 0 && tankCount == 0) outcome = MATCH_HOSTILES_CLEARED;
+        if (outcome != MATCH_TIMEOUT) {
+            match->outcome = outcome;
+            match->steps = step + 1;
+            break;
+        }
+    }
+
+    match->playerHealth = playerHealth;
+    match->enemiesLeft = activeEnemiesCount;
+    match->friendliesLeft = activeFriendliesCount;
+    match->tanksLeft = tankCount;
+    match->wallSeconds = WallClockSeconds() - start;
+}
+
+void *BatchWorker(void *arg) {
+    BatchJob *job = (BatchJob *)arg;
+    for (;;) {
+        int index = atomic_fetch_add(&job->nextMatch, 1);
+        if (index >= job->matchCount) break;
+        RunBatchMatch(&job->matches[index], job->stepCap);
+    }
+    FinishTelemetry();
+    return NULL;
+}
+
+int DefaultBatchThreadCount(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0) return (cpus < BATCH_MAX_THREADS) ? (int)cpus : BATCH_MAX_THREADS;
+#endif
+    return 4;
+}
+
+// Parses "name=v1,v2,..." into the sweep table; false on an unknown name or bad value list
+bool ParseConfigSweep(const char *spec, float values[][BATCH_MAX_PARAM_VALUES], int *valueCounts) {
+    const char *equals = strchr(spec, '=');
+    if (equals == NULL) return false;
+    int field = FindGameConfigField(spec, (size_t)(equals - spec));
+    if (field == -1) return false;
+    int count = 0;
+    const char *cursor = equals + 1;
+    while (*cursor != '\0' && count < BATCH_MAX_PARAM_VALUES) {
+        char *end = NULL;
+        values[field][count++] = strtof(cursor, &end);
+        if (end == cursor) return false;
+        cursor = (*end == ',') ? end + 1 : end;
+    }
+    valueCounts[field] = count;
+    return count > 0;
+}
+
+// --batch [--matches N] [--threads N] [--steps N] [--seed S] [--out file.csv] [--config file] [--param name=v1,v2,...]...
+//         [--metrics-file path] [--metrics-port P] [--metrics-interval s]
+// Matches start from the config file (or the defaults) with the swept fields overridden. Writes one
+// CSV row per match to the output file and a per-parameter-set summary CSV to stdout.
+int RunBatch(int argc, char **argv) {
+    int matchCount = BATCH_DEFAULT_MATCHES;
+    int threadCount = DefaultBatchThreadCount();
+    int stepCap = BATCH_DEFAULT_STEP_CAP;
+    unsigned int baseSeed = 1;
+    const char *csvPath = BATCH_DEFAULT_CSV_PATH;
+    GameConfig baseConfig = defaultConfig;
+    float sweepValues[GAME_CONFIG_FIELD_COUNT][BATCH_MAX_PARAM_VALUES];
+    int sweepCounts[GAME_CONFIG_FIELD_COUNT] = { 0 }; // 0 = not swept, the base config value is used
+    TelemetryOptions telemetryOptions = DEFAULT_TELEMETRY_OPTIONS;
+
+    for (int a = 0; a < argc; a++) {
+        bool hasValue = (a + 1 < argc);
+        if (strcmp(argv[a], "--matches") == 0 && hasValue) matchCount = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--threads") == 0 && hasValue) threadCount = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--steps") == 0 && hasValue) stepCap = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--seed") == 0 && hasValue) baseSeed = (unsigned int)strtoul(argv[++a], NULL, 10);
+        else if (strcmp(argv[a], "--out") == 0 && hasValue) csvPath = argv[++a];
+        else if (strcmp(argv[a], "--config") == 0 && hasValue) {
+            if (!LoadGameConfig(argv[++a], &baseConfig)) return 1;
+        } else if (strcmp(argv[a], "--param") == 0 && hasValue) {
+            if (!ParseConfigSweep(argv[++a], sweepValues, sweepCounts)) {
+                TraceLog(LOG_ERROR, "BATCH: bad parameter sweep '%s'", argv[a]);
+                return 1;
+            }
+        } else if (!ParseTelemetryOption(argc, argv, &a, &telemetryOptions)) {
+            TraceLog(LOG_ERROR, "BATCH: unknown option '%s'", argv[a]);
+            return 1;
+        }
+    }
+    if (matchCount <= 0 || stepCap <= 0) {
+        TraceLog(LOG_ERROR, "BATCH: --matches and --steps must be positive");
+        return 1;
+    }
+#ifdef BAKED_CONFIG
+    // The baked step never reads the world config, so a sweep would silently measure the defaults
+    bool overridden = memcmp(&baseConfig, &defaultConfig, sizeof(GameConfig)) != 0;
+    for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) overridden |= (sweepCounts[f] > 0);
+    if (overridden) {
+        TraceLog(LOG_ERROR, "BATCH: built with BAKED_CONFIG, --config and --param have no effect");
+        return 1;
+    }
+#endif
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > BATCH_MAX_THREADS) threadCount = BATCH_MAX_THREADS;
+    if (threadCount > matchCount) threadCount = matchCount;
+
+    // Matches cycle through every combination of swept values (mixed-radix index)
+    int paramSetCount = 1;
+    for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+        if (sweepCounts[f] > 0) paramSetCount *= sweepCounts[f];
+    }
+
+    BatchMatch *matches = calloc((size_t)matchCount, sizeof(BatchMatch));
+    if (matches == NULL) {
+        TraceLog(LOG_ERROR, "BATCH: could not allocate %d matches", matchCount);
+        return 1;
+    }
+    for (int m = 0; m < matchCount; m++) {
+        matches[m].paramSet = m % paramSetCount;
+        matches[m].seed = baseSeed + (unsigned int)m;
+        matches[m].config = baseConfig;
+        int digits = matches[m].paramSet;
+        for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+            if (sweepCounts[f] == 0) continue;
+            *GameConfigValue(&matches[m].config, f) = sweepValues[f][digits % sweepCounts[f]];
+            digits /= sweepCounts[f];
+        }
+    }
+
+    TelemetryExporter exporter;
+    if (!StartTelemetryExporter(&exporter, &telemetryOptions)) {
+        free(matches);
+        return 1;
+    }
+
+    BatchJob job = { matches, matchCount, stepCap, 0 };
+    pthread_t threads[BATCH_MAX_THREADS];
+    int started = 0;
+    double start = WallClockSeconds();
+    for (int t = 0; t < threadCount; t++) {
+        if (pthread_create(&threads[t], NULL, BatchWorker, &job) != 0) break;
+        started++;
+    }
+    if (started == 0) BatchWorker(&job); // No threads available: run everything on this one
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+    double elapsed = WallClockSeconds() - start;
+    StopTelemetryExporter(&exporter);
+
+    FILE *csv = fopen(csvPath, "w");
+    if (csv == NULL) {
+        TraceLog(LOG_ERROR, "BATCH: could not open %s for writing", csvPath);
+    } else {
+        fprintf(csv, "match,param_set,seed");
+        for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+            if (sweepCounts[f] > 0) fprintf(csv, ",%s", gameConfigFields[f].name);
+        }
+        fprintf(csv, ",outcome,steps,sim_seconds,player_health,enemies_left,friendlies_left,tanks_left,state_hash,wall_ms\n");
+        for (int m = 0; m < matchCount; m++) {
+            BatchMatch *match = &matches[m];
+            fprintf(csv, "%d,%d,%u", m, match->paramSet, match->seed);
+            for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+                if (sweepCounts[f] > 0) fprintf(csv, ",%g", *GameConfigValue(&match->config, f));
+            }
+            fprintf(csv, ",%s,%d,%.3f,%.1f,%d,%d,%d,%016llx,%.3f\n", matchOutcomeNames[match->outcome], match->steps, match->steps * BATCH_TICK_SECONDS,
+                    match->playerHealth, match->enemiesLeft, match->friendliesLeft, match->tanksLeft, (unsigned long long)match->stateHash,
+                    match->wallSeconds * 1000.0);
+        }
+        fclose(csv);
+    }
+
+    // Per-parameter-set summary
+    printf("param_set");
+    for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+        if (sweepCounts[f] > 0) printf(",%s", gameConfigFields[f].name);
+    }
+    printf(",matches");
+    for (int o = 0; o < MATCH_OUTCOME_COUNT; o++) printf(",%s", matchOutcomeNames[o]);
+    printf(",mean_steps,mean_enemies_left,mean_friendlies_left,mean_tanks_left\n");
+    long long totalSteps = 0;
+    for (int set = 0; set < paramSetCount && set < matchCount; set++) {
+        int count = 0, outcomes[MATCH_OUTCOME_COUNT] = { 0 };
+        double steps = 0.0, enemies = 0.0, friendlies = 0.0, tanksLeft = 0.0;
+        for (int m = set; m < matchCount; m += paramSetCount) {
+            count++;
+            outcomes[matches[m].outcome]++;
+            steps += matches[m].steps;
+            enemies += matches[m].enemiesLeft;
+            friendlies += matches[m].friendliesLeft;
+            tanksLeft += matches[m].tanksLeft;
+        }
+        totalSteps += (long long)steps;
+        printf("%d", set);
+        for (int f = 0; f < GAME_CONFIG_FIELD_COUNT; f++) {
+            if (sweepCounts[f] > 0) printf(",%g", *GameConfigValue(&matches[set].config, f));
+        }
+        printf(",%d", count);
+        for (int o = 0; o < MATCH_OUTCOME_COUNT; o++) printf(",%d", outcomes[o]);
+        printf(",%.1f,%.2f,%.2f,%.2f\n", steps / count, enemies / count, friendlies / count, tanksLeft / count);
+    }
+    printf("# %d matches on %d threads in %.2f s: %.0f matches/min, %.0f steps/s (per-match rows in %s)\n",
+           matchCount, (started > 0) ? started : 1, elapsed, matchCount * 60.0 / elapsed, totalSteps / elapsed, csvPath);
+
+    free(matches);
+    return 0;
+}
+
+// Live state a config benchmark match ends in. Snapshots also carry dead pool slots, whose stale
+// contents depend on earlier matches, so they cannot be compared byte for byte.
+typedef struct {
+    int counts[9];
+    float playerHealth;
+    Vector3 cameraPosition;
+    Vector3 entityPositions[MAX_ENTITIES];
+    Vector3 cratePositions[MAX_CRATES];
+    Vector3 tankPositions[MAX_TANKS];
+    float tankHealth[MAX_TANKS];
+} BenchEndState;
+
+void CaptureBenchEndState(BenchEndState *state) {
+    memset(state, 0, sizeof(BenchEndState));
+    int counts[9] = { playerBulletCount, entityBulletCount, tankBulletCount, combatEntityCount, crateCount, bombCount, tankBombCount, tankCount, missileCount };
+    memcpy(state->counts, counts, sizeof(counts));
+    state->playerHealth = playerHealth;
+    state->cameraPosition = camera.position;
+    for (int i = 0; i < combatEntityCount; i++) state->entityPositions[i] = combatEntities[i].position;
+    for (int i = 0; i < crateCount; i++) state->cratePositions[i] = crates[i].position;
+    for (int i = 0; i < tankCount; i++) {
+        state->tankPositions[i] = tanks[i].position;
+        state->tankHealth[i] = tanks[i].health;
+    }
+}
+
+// Plays the same seeded bot matches through the runtime-config and the baked step, alternating per
+// match, and reports the time per step of each. The baked kernel only folds constants, so both
+// variants must also finish every match in the identical world state. Every step is also recorded
+// into the rewind history and captured and restored the way the pipeline does, timed on their own.
+int RunConfigBenchmark(int matchCount) {
+    if (matchCount <= 0) matchCount = CONFIG_BENCH_MATCHES;
+    void (*stepVariants[2])(float, const PlayerInput *) = { StepSimulationRuntime, StepSimulationBaked };
+    const char *variantNames[2] = { "runtime", "baked" };
+    double variantSeconds[2] = { 0.0, 0.0 };
+    long long variantSteps[2] = { 0, 0 };
+    static WorldSnapshot frameSnapshot; // Stands in for a pipeline frame slot
+    double recordSeconds = 0.0, roundTripSeconds = 0.0;
+    long long deltaBytes = 0;
+    BenchEndState endStates[2];
+    config = defaultConfig;
+    int mismatches = 0;
+    for (int m = 0; m < matchCount; m++) {
+        for (int v = 0; v < 2; v++) {
+            SeedWorldRandom((unsigned int)m + 1);
+            ResetGame();
+            ClearRewindHistory();
+            double start = WallClockSeconds();
+            double snapshotSeconds = 0.0;
+            for (int step = 0; step < CONFIG_BENCH_STEPS && !gameOver; step++) {
+                ResetFrameArena(&frameArena);
+                PlayerInput input = BotPlayerInput();
+                BEGIN_SIMULATION_STEP();
+                stepVariants[v](BATCH_TICK_SECONDS, &input);
+                END_SIMULATION_STEP();
+                variantSteps[v]++;
+
+                double snapshotStart = WallClockSeconds();
+                RecordRewindFrame();
+                double recorded = WallClockSeconds();
+                CaptureWorldSnapshot(&frameSnapshot);
+                RestoreWorldSnapshot(&frameSnapshot);
+                double restored = WallClockSeconds();
+                recordSeconds += recorded - snapshotStart;
+                roundTripSeconds += restored - recorded;
+                snapshotSeconds += restored - snapshotStart;
+                if (rewindCount > 0) deltaBytes += rewindDeltaSizes[(rewindHead + REWIND_HISTORY_FRAMES - 1) % REWIND_HISTORY_FRAMES];
+            }
+            variantSeconds[v] += WallClockSeconds() - start - snapshotSeconds;
+            CaptureBenchEndState(&endStates[v]);
+        }
+        if (memcmp(&endStates[0], &endStates[1], sizeof(BenchEndState)) != 0) mismatches++;
+    }
+
+    printf("config benchmark: %d matches, up to %d steps each\n", matchCount, CONFIG_BENCH_STEPS);
+    for (int v = 0; v < 2; v++) {
+        printf("  %-8s %8lld steps  %8.2f ms total  %7.2f us/step\n", variantNames[v], variantSteps[v],
+               variantSeconds[v] * 1000.0, variantSeconds[v] * 1.0e6 / (double)variantSteps[v]);
+    }
+    printf("  baked speedup %.3fx, end states %s\n", (variantSeconds[0] / variantSteps[0]) / (variantSeconds[1] / variantSteps[1]),
+           (mismatches == 0) ? "identical" : "DIFFER");
+    long long frames = variantSteps[0] + variantSteps[1];
+    printf("  snapshots %7.2f us/frame rewind record (%.0f B delta), %.2f us/frame capture + restore (%u B snapshot)\n",
+           recordSeconds * 1.0e6 / (double)frames, (double)deltaBytes / (double)frames, roundTripSeconds * 1.0e6 / (double)frames,
+           (unsigned int)sizeof(WorldSnapshot));
+
+    return (mismatches == 0) ? 0 : 1;
+}
+
+// --- Divergence Checker ---
+// Plays the same seeded bot matches under two step variants, hashes the world after every tick,
+// and reports the first tick where they disagree, every field that differs there, and the first
+// differing element of the first such field. Changes to the simulation's data layout, vectorised
+// kernels or threading should leave every variant pair agreeing.
+typedef struct {
+    const char *name;
+    void (*step)(float, const PlayerInput *);
+    bool threaded;         // Matches run concurrently on worker threads instead of one after another
+    bool hitScan;          // Player shots are hit-scan rays (the baked step cannot do this)
+    bool hitScanReference; // ...and every ray tests every box instead of walking the BVH
+} DivergenceVariant;
+
+const DivergenceVariant divergenceVariants[] = {
+    { "runtime", StepSimulationRuntime, false, false, false },
+    { "baked", StepSimulationBaked, false, false, false },
+    { "threaded", StepSimulationRuntime, true, false, false },
+    { "hitscan-bvh", StepSimulationRuntime, false, true, false },
+    { "hitscan-brute", StepSimulationRuntime, false, true, true },
+};
+
+#define DIVERGENCE_VARIANT_COUNT ((int)(sizeof(divergenceVariants) / sizeof(divergenceVariants[0])))
+
+typedef struct {
+    const DivergenceVariant *variant;
+    unsigned int seed;
+    int stepCap;
+    int steps;             // Ticks played; a match stops early at game over
+    uint64_t *fieldHashes; // stepCap + 1 rows of STATE_FIELD_COUNT hashes, row 0 taken right after the reset
+    bool probe;            // Hash probeField per element once the match stops
+    StateField probeField;
+    uint64_t probeElements[MAX_MISSILES]; // Sized for the largest pool
+    int probeCount;
+    double wallSeconds;
+} DivergenceTrace;
+
+typedef struct {
+    DivergenceTrace *traces;
+    int traceCount;
+    atomic_int nextTrace;
+} DivergenceJob;
+
+void RunDivergenceTrace(DivergenceTrace *trace) {
+    const DivergenceVariant *variant = trace->variant;
+    double start = WallClockSeconds();
+    SeedWorldRandom(trace->seed);
+    config = defaultConfig;
+    if (variant->hitScan) config.playerHitScan = 1.0f;
+    hitScanReference = variant->hitScanReference;
+    ResetGame();
+
+    trace->steps = 0;
+    HashWorldState(trace->fieldHashes);
+    for (int step = 1; step <= trace->stepCap && !gameOver; step++) {
+        ResetFrameArena(&frameArena);
+        PlayerInput input = BotPlayerInput();
+        BEGIN_SIMULATION_STEP();
+        variant->step(BATCH_TICK_SECONDS, &input);
+        END_SIMULATION_STEP();
+        HashWorldState(trace->fieldHashes + (size_t)step * STATE_FIELD_COUNT);
+        trace->steps = step;
+    }
+    if (trace->probe) trace->probeCount = HashWorldStateElements(trace->probeField, trace->probeElements, MAX_MISSILES);
+    hitScanReference = false;
+    trace->wallSeconds = WallClockSeconds() - start;
+}
+
+void *DivergenceWorker(void *arg) {
+    DivergenceJob *job = (DivergenceJob *)arg;
+    for (;;) {
+        int index = atomic_fetch_add(&job->nextTrace, 1);
+        if (index >= job->traceCount) break;
+        RunDivergenceTrace(&job->traces[index]);
+    }
+    return NULL;
+}
+
+// Threaded variants run on fresh worker threads, so their worlds also start from thread-initial
+// state rather than from whatever the previous match left behind
+void RunDivergenceTraces(DivergenceTrace *traces, int traceCount, int threadCount) {
+    DivergenceJob job = { traces, traceCount, 0 };
+    if (!traces[0].variant->threaded) {
+        DivergenceWorker(&job);
+        return;
+    }
+    pthread_t threads[BATCH_MAX_THREADS];
+    int started = 0;
+    for (int t = 0; t < threadCount && t < traceCount; t++) {
+        if (pthread_create(&threads[t], NULL, DivergenceWorker, &job) != 0) break;
+        started++;
+    }
+    if (started == 0) DivergenceWorker(&job);
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+}
+
+int FindDivergenceVariant(const char *name) {
+    for (int v = 0; v < DIVERGENCE_VARIANT_COUNT; v++) {
+        if (strcmp(divergenceVariants[v].name, name) == 0) return v;
+    }
+    return -1;
+}
+
+// Replays one match under both variants up to the diverging tick and names the first element of
+// stateField whose hash differs
+void ReportDivergentElement(DivergenceTrace *pair[2], int tick, StateField stateField, int threadCount) {
+    DivergenceTrace *probes = calloc(2, sizeof(DivergenceTrace));
+    uint64_t *hashes = calloc(2 * (size_t)(tick + 1) * STATE_FIELD_COUNT, sizeof(uint64_t));
+    if (probes == NULL || hashes == NULL) {
+        TraceLog(LOG_WARNING, "DIVERGENCE: could not allocate the element probe");
+        free(probes);
+        free(hashes);
+        return;
+    }
+    for (int v = 0; v < 2; v++) {
+        probes[v].variant = pair[v]->variant;
+        probes[v].seed = pair[v]->seed;
+        probes[v].stepCap = tick;
+        probes[v].fieldHashes = hashes + (size_t)v * (tick + 1) * STATE_FIELD_COUNT;
+        probes[v].probe = true;
+        probes[v].probeField = stateField;
+        RunDivergenceTraces(&probes[v], 1, threadCount);
+    }
+
+    int counts[2] = { probes[0].probeCount, probes[1].probeCount };
+    int shared = (counts[0] < counts[1]) ? counts[0] : counts[1];
+    if (shared > MAX_MISSILES) shared = MAX_MISSILES;
+    int element = -1;
+    for (int i = 0; i < shared && element == -1; i++) {
+        if (probes[0].probeElements[i] != probes[1].probeElements[i]) element = i;
+    }
+    if (element != -1) {
+        printf("    first differing element: %s[%d] (%d vs %d live)\n", stateFieldNames[stateField], element, counts[0], counts[1]);
+    } else if (counts[0] != counts[1]) {
+        printf("    live element counts differ: %d vs %d, the shared %d agree\n", counts[0], counts[1], shared);
+    } else {
+        printf("    the replay did not reproduce the divergence (timing or thread dependent?)\n");
+    }
+    free(probes);
+    free(hashes);
+}
+
+// --check-divergence A B [--matches N] [--steps N] [--seed S] [--threads N]
+int RunDivergenceCheck(int argc, char **argv) {
+    int variants[2] = { -1, -1 };
+    int matchCount = DIVERGENCE_DEFAULT_MATCHES;
+    int stepCap = DIVERGENCE_DEFAULT_STEPS;
+    unsigned int baseSeed = 1;
+    int threadCount = DefaultBatchThreadCount();
+    int named = 0;
+    for (int a = 0; a < argc; a++) {
+        bool hasValue = (a + 1 < argc);
+        if (strcmp(argv[a], "--matches") == 0 && hasValue) matchCount = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--steps") == 0 && hasValue) stepCap = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--seed") == 0 && hasValue) baseSeed = (unsigned int)strtoul(argv[++a], NULL, 10);
+        else if (strcmp(argv[a], "--threads") == 0 && hasValue) threadCount = atoi(argv[++a]);
+        else if (named < 2 && FindDivergenceVariant(argv[a]) != -1) variants[named++] = FindDivergenceVariant(argv[a]);
+        else {
+            TraceLog(LOG_ERROR, "DIVERGENCE: unknown option or variant '%s'", argv[a]);
+            return 1;
+        }
+    }
+    if (named < 2) {
+        printf("usage: --check-divergence A B [--matches N] [--steps N] [--seed S] [--threads N]\nvariants:");
+        for (int v = 0; v < DIVERGENCE_VARIANT_COUNT; v++) printf(" %s", divergenceVariants[v].name);
+        printf("\n");
+        return 1;
+    }
+    if (matchCount <= 0 || stepCap <= 0) {
+        TraceLog(LOG_ERROR, "DIVERGENCE: --matches and --steps must be positive");
+        return 1;
+    }
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > BATCH_MAX_THREADS) threadCount = BATCH_MAX_THREADS;
+
+    DivergenceTrace *traces[2];
+    size_t rowsPerMatch = (size_t)(stepCap + 1) * STATE_FIELD_COUNT;
+    uint64_t *hashes = calloc(2 * (size_t)matchCount * rowsPerMatch, sizeof(uint64_t));
+    traces[0] = calloc(2 * (size_t)matchCount, sizeof(DivergenceTrace));
+    if (hashes == NULL || traces[0] == NULL) {
+        TraceLog(LOG_ERROR, "DIVERGENCE: could not allocate hashes for %d matches of %d ticks", matchCount, stepCap);
+        free(hashes);
+        free(traces[0]);
+        return 1;
+    }
+    traces[1] = traces[0] + matchCount;
+    for (int v = 0; v < 2; v++) {
+        for (int m = 0; m < matchCount; m++) {
+            DivergenceTrace *trace = &traces[v][m];
+            trace->variant = &divergenceVariants[variants[v]];
+            trace->seed = baseSeed + (unsigned int)m;
+            trace->stepCap = stepCap;
+            trace->fieldHashes = hashes + ((size_t)v * matchCount + m) * rowsPerMatch;
+        }
+        RunDivergenceTraces(traces[v], matchCount, threadCount);
+    }
+
+    printf("divergence check: %s vs %s, %d matches, up to %d ticks each\n", divergenceVariants[variants[0]].name,
+           divergenceVariants[variants[1]].name, matchCount, stepCap);
+    int diverged = 0;
+    long long ticksCompared = 0;
+    for (int m = 0; m < matchCount; m++) {
+        DivergenceTrace *pair[2] = { &traces[0][m], &traces[1][m] };
+        int shared = (pair[0]->steps < pair[1]->steps) ? pair[0]->steps : pair[1]->steps;
+        int tick = -1;
+        for (int t = 0; t <= shared && tick == -1; t++) {
+            if (memcmp(pair[0]->fieldHashes + (size_t)t * STATE_FIELD_COUNT, pair[1]->fieldHashes + (size_t)t * STATE_FIELD_COUNT,
+                       STATE_FIELD_COUNT * sizeof(uint64_t)) != 0) tick = t;
+        }
+        ticksCompared += shared + 1;
+        if (tick == -1 && pair[0]->steps == pair[1]->steps) continue;
+
+        diverged++;
+        if (tick == -1) {
+            // Unreachable while game over is hashed, kept so a missing field cannot pass silently
+            printf("  match %d (seed %u): match lengths differ (%d vs %d ticks) with every shared tick equal\n", m, pair[0]->seed,
+                   pair[0]->steps, pair[1]->steps);
+            continue;
+        }
+        printf("  match %d (seed %u): first divergence at tick %d (%.3f s), fields:", m, pair[0]->seed, tick, tick * BATCH_TICK_SECONDS);
+        int firstField = -1;
+        for (int f = 0; f < STATE_FIELD_COUNT; f++) {
+            if (pair[0]->fieldHashes[(size_t)tick * STATE_FIELD_COUNT + f] == pair[1]->fieldHashes[(size_t)tick * STATE_FIELD_COUNT + f]) continue;
+            printf(" %s", stateFieldNames[f]);
+            if (firstField == -1) firstField = f;
+        }
+        printf("\n");
+        ReportDivergentElement(pair, tick, (StateField)firstField, threadCount);
+    }
+
+    for (int v = 0; v < 2; v++) {
+        double seconds = 0.0;
+        long long steps = 0;
+        for (int m = 0; m < matchCount; m++) {
+            seconds += traces[v][m].wallSeconds;
+            steps += traces[v][m].steps;
+        }
+        printf("  %-14s %8lld ticks  %8.2f ms in matches\n", divergenceVariants[variants[v]].name, steps, seconds * 1000.0);
+    }
+    printf("  %d of %d matches diverged (%lld ticks compared)\n", diverged, matchCount, ticksCompared);
+
+    free(hashes);
+    free(traces[0]);
+    return (diverged == 0) ? 0 : 1;
+}
+
+// --- Rendering ---
+// The terrain is drawn from the render thread's own streaming window, one mesh per resident chunk
+// in world coordinates with that chunk's rocks baked in. Meshes are rebuilt lazily (a few per
+// frame) when a window slot receives a new chunk, and chunks outside the view frustum are skipped,
+// so both memory and draw cost follow what the camera sees rather than the map size.
+#define TERRAIN_CHUNK_SIDE (TERRAIN_CHUNK_CELLS + 1) // Vertices per side of a chunk's ground grid
+#define TERRAIN_PROP_VERTICES 24 // Four per face, so every face gets its own normal
+#define TERRAIN_PROP_INDICES 36
+_Static_assert(TERRAIN_CHUNK_SIDE * TERRAIN_CHUNK_SIDE + STREAM_PROPS_PER_CHUNK * TERRAIN_PROP_VERTICES <= 65536,
+               "terrain chunk vertices must fit 16-bit indices");
+
+typedef struct {
+    Model model;
+    bool loaded;
+    int chunkX, chunkZ;      // Chunk and load generation the mesh was built from
+    unsigned int generation;
+    BoundingBox bounds;
+} TerrainChunkMesh;
+
+// Main thread only: it owns the GL context
+TerrainChunkMesh terrainMeshes[STREAM_WINDOW_CHUNKS][STREAM_WINDOW_CHUNKS];
+
+static inline float StreamChunkSample(const StreamChunk *chunk, int x, int z) {
+    int tileX = (x / TERRAIN_TILE_CELLS < TERRAIN_CHUNK_TILES) ? x / TERRAIN_TILE_CELLS : TERRAIN_CHUNK_TILES - 1;
+    int tileZ = (z / TERRAIN_TILE_CELLS < TERRAIN_CHUNK_TILES) ? z / TERRAIN_TILE_CELLS : TERRAIN_CHUNK_TILES - 1;
+    return chunk->tiles[tileZ][tileX].heights[z - tileZ * TERRAIN_TILE_CELLS][x - tileX * TERRAIN_TILE_CELLS];
+}
+
+static inline void SetTerrainVertex(Mesh *mesh, int v, Vector3 position, Vector3 normal, Vector2 texcoord, Color color) {
+    mesh->vertices[v * 3 + 0] = position.x;
+    mesh->vertices[v * 3 + 1] = position.y;
+    mesh->vertices[v * 3 + 2] = position.z;
+    mesh->normals[v * 3 + 0] = normal.x;
+    mesh->normals[v * 3 + 1] = normal.y;
+    mesh->normals[v * 3 + 2] = normal.z;
+    mesh->texcoords[v * 2 + 0] = texcoord.x;
+    mesh->texcoords[v * 2 + 1] = texcoord.y;
+    mesh->colors[v * 4 + 0] = color.r;
+    mesh->colors[v * 4 + 1] = color.g;
+    mesh->colors[v * 4 + 2] = color.b;
+    mesh->colors[v * 4 + 3] = color.a;
+}
+
+const Vector3 sunDirection = { 0.3313f, 0.8282f, 0.2485f }; // Normalised (0.4, 1, 0.3)
+
+// Vertex colours carry a height tint with the sun's lambert term baked in, so the default material
+// shades the ground without a lighting shader
+static inline Color ShadeTerrain(Color base, Vector3 normal) {
+    float light = 0.45f + 0.55f * fmaxf(Vector3DotProduct(normal, sunDirection), 0.0f);
+    return (Color){ (unsigned char)(base.r * light), (unsigned char)(base.g * light), (unsigned char)(base.b * light), 255 };
+}
+
+void BuildTerrainChunkMesh(TerrainChunkMesh *target, const StreamChunk *chunk) {
+    const int groundVertices = TERRAIN_CHUNK_SIDE * TERRAIN_CHUNK_SIDE;
+    Mesh mesh = { 0 };
+    mesh.vertexCount = groundVertices + chunk->propCount * TERRAIN_PROP_VERTICES;
+    mesh.triangleCount = TERRAIN_CHUNK_CELLS * TERRAIN_CHUNK_CELLS * 2 + chunk->propCount * TERRAIN_PROP_INDICES / 3;
+    mesh.vertices = MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.normals = MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.texcoords = MemAlloc(mesh.vertexCount * 2 * sizeof(float));
+    mesh.colors = MemAlloc(mesh.vertexCount * 4 * sizeof(unsigned char));
+    mesh.indices = MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short));
+
+    float chunkMinX = (float)chunk->chunkX * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT;
+    float chunkMinZ = (float)chunk->chunkZ * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT;
+    for (int z = 0; z < TERRAIN_CHUNK_SIDE; z++) {
+        for (int x = 0; x < TERRAIN_CHUNK_SIDE; x++) {
+            float worldX = chunkMinX + (float)x * TERRAIN_CELL_SIZE, worldZ = chunkMinZ + (float)z * TERRAIN_CELL_SIZE;
+            float height = StreamChunkSample(chunk, x, z);
+            Vector3 normal = SampleTerrainNormal(worldX, worldZ);
+            float highland = Clamp(height / TERRAIN_HEIGHT_SCALE * 0.5f + 0.5f, 0.0f, 1.0f);
+            Color base = { (unsigned char)Lerp(96.0f, 150.0f, highland), (unsigned char)Lerp(128.0f, 140.0f, highland), (unsigned char)Lerp(80.0f, 120.0f, highland), 255 };
+            SetTerrainVertex(&mesh, z * TERRAIN_CHUNK_SIDE + x, (Vector3){ worldX, height, worldZ }, normal,
+                             (Vector2){ (float)x / TERRAIN_CHUNK_CELLS, (float)z / TERRAIN_CHUNK_CELLS }, ShadeTerrain(base, normal));
+        }
+    }
+
+    int index = 0;
+    for (int z = 0; z < TERRAIN_CHUNK_CELLS; z++) {
+        for (int x = 0; x < TERRAIN_CHUNK_CELLS; x++) {
+            unsigned short topLeft = (unsigned short)(z * TERRAIN_CHUNK_SIDE + x), bottomLeft = (unsigned short)((z + 1) * TERRAIN_CHUNK_SIDE + x);
+            mesh.indices[index++] = topLeft;
+            mesh.indices[index++] = bottomLeft;
+            mesh.indices[index++] = (unsigned short)(topLeft + 1);
+            mesh.indices[index++] = (unsigned short)(topLeft + 1);
+            mesh.indices[index++] = bottomLeft;
+            mesh.indices[index++] = (unsigned short)(bottomLeft + 1);
+        }
+    }
+
+    // Rocks: boxes with one quad per face, wound counter-clockwise seen from outside
+    static const Vector3 faceNormals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    for (int p = 0; p < chunk->propCount; p++) {
+        const StaticProp *prop = &chunk->props[p];
+        Vector3 half = Vector3Scale(prop->size, 0.5f);
+        for (int f = 0; f < 6; f++) {
+            Vector3 n = faceNormals[f];
+            Vector3 u = (fabsf(n.y) > 0.5f) ? (Vector3){ 1, 0, 0 } : (Vector3){ 0, 1, 0 };
+            Vector3 v = Vector3CrossProduct(n, u);
+            int first = groundVertices + p * TERRAIN_PROP_VERTICES + f * 4;
+            for (int corner = 0; corner < 4; corner++) {
+                float su = (corner == 1 || corner == 2) ? 1.0f : -1.0f, sv = (corner >= 2) ? 1.0f : -1.0f;
+                Vector3 offset = Vector3Add(n, Vector3Add(Vector3Scale(u, su), Vector3Scale(v, sv)));
+                Vector3 position = Vector3Add(prop->position, Vector3Multiply(offset, half));
+                SetTerrainVertex(&mesh, first + corner, position, n, (Vector2){ (su + 1.0f) * 0.5f, (sv + 1.0f) * 0.5f }, ShadeTerrain((Color){ 120, 116, 110, 255 }, n));
+            }
+            // u x v = n, so corners 0 -> 1 -> 2 turn counter-clockwise around n
+            mesh.indices[index++] = (unsigned short)first;
+            mesh.indices[index++] = (unsigned short)(first + 1);
+            mesh.indices[index++] = (unsigned short)(first + 2);
+            mesh.indices[index++] = (unsigned short)first;
+            mesh.indices[index++] = (unsigned short)(first + 2);
+            mesh.indices[index++] = (unsigned short)(first + 3);
+        }
+    }
+
+    if (target->loaded) UnloadModel(target->model);
+    UploadMesh(&mesh, false);
+    target->model = LoadModelFromMesh(mesh);
+    target->loaded = true;
+    target->chunkX = chunk->chunkX;
+    target->chunkZ = chunk->chunkZ;
+    target->generation = chunk->generation;
+    target->bounds.min = (Vector3){ chunkMinX, chunk->minHeight, chunkMinZ };
+    target->bounds.max = (Vector3){ chunkMinX + TERRAIN_CHUNK_SIZE, chunk->maxHeight, chunkMinZ + TERRAIN_CHUNK_SIZE };
+}
+
+void UnloadTerrainChunks(void) {
+    for (int z = 0; z < STREAM_WINDOW_CHUNKS; z++) {
+        for (int x = 0; x < STREAM_WINDOW_CHUNKS; x++) {
+            if (terrainMeshes[z][x].loaded) UnloadModel(terrainMeshes[z][x].model);
+            terrainMeshes[z][x].loaded = false;
+        }
+    }
+}
+
+// True when the box is at least partly on the inner side of all six planes
+static bool BoxInFrustum(const Vector4 planes[6], BoundingBox box) {
+    for (int p = 0; p < 6; p++) {
+        Vector3 farthest = { planes[p].x >= 0.0f ? box.max.x : box.min.x, planes[p].y >= 0.0f ? box.max.y : box.min.y,
+                             planes[p].z >= 0.0f ? box.max.z : box.min.z };
+        if (planes[p].x * farthest.x + planes[p].y * farthest.y + planes[p].z * farthest.z + planes[p].w < 0.0f) return false;
+    }
+    return true;
+}
+
+void DrawTerrain(Camera3D view) {
+    UpdateChunkStreaming(&terrainStream, view.position);
+
+    // Frustum planes straight from the rows of projection * view, with the far plane pulled in to
+    // the terrain draw distance
+    float aspect = (float)GetScreenWidth() / (float)(GetScreenHeight() > 0 ? GetScreenHeight() : 1);
+    Matrix clip = MatrixMultiply(GetCameraMatrix(view), MatrixPerspective(view.fovy * DEG2RAD, aspect, 0.01, TERRAIN_DRAW_DISTANCE));
+    Vector4 rowX = { clip.m0, clip.m4, clip.m8, clip.m12 }, rowY = { clip.m1, clip.m5, clip.m9, clip.m13 };
+    Vector4 rowZ = { clip.m2, clip.m6, clip.m10, clip.m14 }, rowW = { clip.m3, clip.m7, clip.m11, clip.m15 };
+    Vector4 planes[6] = {
+        { rowW.x + rowX.x, rowW.y + rowX.y, rowW.z + rowX.z, rowW.w + rowX.w }, // Left
+        { rowW.x - rowX.x, rowW.y - rowX.y, rowW.z - rowX.z, rowW.w - rowX.w }, // Right
+        { rowW.x + rowY.x, rowW.y + rowY.y, rowW.z + rowY.z, rowW.w + rowY.w }, // Bottom
+        { rowW.x - rowY.x, rowW.y - rowY.y, rowW.z - rowY.z, rowW.w - rowY.w }, // Top
+        { rowW.x + rowZ.x, rowW.y + rowZ.y, rowW.z + rowZ.z, rowW.w + rowZ.w }, // Near
+        { rowW.x - rowZ.x, rowW.y - rowZ.y, rowW.z - rowZ.z, rowW.w - rowZ.w }  // Far
+    };
+
+    int builds = 0;
+    for (int z = 0; z < STREAM_WINDOW_CHUNKS; z++) {
+        for (int x = 0; x < STREAM_WINDOW_CHUNKS; x++) {
+            const StreamChunk *chunk = &terrainStream.chunks[z][x];
+            if (atomic_load_explicit(&chunk->state, memory_order_acquire) != CHUNK_RESIDENT) continue;
+            TerrainChunkMesh *mesh = &terrainMeshes[z][x];
+            if (!mesh->loaded || mesh->chunkX != chunk->chunkX || mesh->chunkZ != chunk->chunkZ || mesh->generation != chunk->generation) {
+                if (builds == STREAM_MESH_BUILDS_PER_FRAME) continue; // Slot shows nothing until its mesh is built
+                BuildTerrainChunkMesh(mesh, chunk);
+                builds++;
+            }
+            if (BoxInFrustum(planes, mesh->bounds)) DrawModel(mesh->model, Vector3Zero(), 1.0f, WHITE);
+        }
+    }
+}
+
+// --- Lit Rendering ---
+// Everything DrawWorld used to draw one call at a time (entity and crate boxes, bullet and bomb
+// spheres, missiles, aircraft and tanks) goes through one lit shader as instanced draws. At load
+// each model is merged into one mesh per material, with the material colour baked into the vertex
+// colours; per frame each batch uploads its instance transforms and colours into its own vertex
+// buffers, and the draws are sorted by texture. That leaves one shader bind, a texture bind per
+// distinct texture and one vertex array bind and draw per merged mesh, whatever the pool sizes.
+// The instance buffers are attached to the merged meshes' vertex arrays once, at load. Without
+// OpenGL 3.3 (or with --classic-render) DrawWorld keeps the per-call path. render_draws_total and
+// render_state_changes_total count this path only: raylib batches and binds the per-call path's
+// draws internally, so compare the two paths with a GL tracer rather than these counters.
+typedef enum {
+    LIT_BATCH_BOXES,    // Combat entities and crates, a unit cube scaled per instance
+    LIT_BATCH_SPHERES,  // Bullets and falling bombs, a unit sphere scaled per instance
+    LIT_BATCH_MISSILES,
+    LIT_BATCH_AIRCRAFT,
+    LIT_BATCH_TANKS,
+    LIT_BATCH_COUNT
+} LitBatchKind;
+
+const int litBatchCapacity[LIT_BATCH_COUNT] = {
+    [LIT_BATCH_BOXES] = MAX_ENTITIES + MAX_CRATES,
+    [LIT_BATCH_SPHERES] = MAX_PLAYER_BULLETS + MAX_ENTITY_BULLETS + MAX_TANK_BULLETS + MAX_BOMBS + MAX_TANK_BOMBS,
+    [LIT_BATCH_MISSILES] = MAX_MISSILES,
+    [LIT_BATCH_AIRCRAFT] = MAX_AIRCRAFT,
+    [LIT_BATCH_TANKS] = MAX_TANKS,
+};
+
+typedef struct {
+    Mesh mesh;
+    unsigned int textureId; // Diffuse map of the material the group was merged from
+} LitGroup;
+
+typedef struct {
+    LitGroup groups[LIT_MAX_GROUPS];
+    int groupCount;
+    float16 *transforms;    // Column-major, as the instanceTransform attribute reads them
+    Color *colors;
+    int count;
+    unsigned int transformBuffer;
+    unsigned int colorBuffer;
+} LitBatch;
+
+typedef struct {
+    bool ready;
+    Shader shader;
+    int mvpLocation;
+    int sunLocation;
+    int transformLocation;  // First of the four instanceTransform attribute columns
+    int colorLocation;
+    LitBatch batches[LIT_BATCH_COUNT];
+} LitRenderer;
+
+LitRenderer litRenderer = { 0 };
+
+const char *litVertexShader =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in vec2 vertexTexCoord;\n"
+    "in vec3 vertexNormal;\n"
+    "in vec4 vertexColor;\n"
+    "in mat4 instanceTransform;\n"
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec2 fragTexCoord;\n"
+    "out vec4 fragColor;\n"
+    "out vec3 fragNormal;\n"
+    "void main() {\n"
+    "    fragTexCoord = vertexTexCoord;\n"
+    "    fragColor = vertexColor * instanceColor;\n"
+    "    fragNormal = mat3(instanceTransform) * vertexNormal;\n"
+    "    gl_Position = mvp * instanceTransform * vec4(vertexPosition, 1.0);\n"
+    "}\n";
+
+// The same lambert term ShadeTerrain bakes into the ground
+const char *litFragmentShader =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "in vec3 fragNormal;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform vec3 sunDirection;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    vec4 texel = texture(texture0, fragTexCoord) * fragColor;\n"
+    "    float light = 0.45 + 0.55 * max(dot(normalize(fragNormal), sunDirection), 0.0);\n"
+    "    finalColor = vec4(texel.rgb * light, texel.a);\n"
+    "}\n";
+
+// Appends one source mesh, moved by the model transform and tinted by its material colour
+static void AppendLitMesh(Mesh *target, const Mesh *source, Matrix transform, Color tint) {
+    int base = target->vertexCount;
+    for (int v = 0; v < source->vertexCount; v++) {
+        int t = base + v;
+        Vector3 position = Vector3Transform((Vector3){ source->vertices[v * 3], source->vertices[v * 3 + 1], source->vertices[v * 3 + 2] }, transform);
+        Vector3 normal = (source->normals != NULL) ? (Vector3){ source->normals[v * 3], source->normals[v * 3 + 1], source->normals[v * 3 + 2] } : (Vector3){ 0.0f, 1.0f, 0.0f };
+        normal = Vector3Normalize(Vector3Subtract(Vector3Transform(normal, transform), Vector3Transform(Vector3Zero(), transform)));
+        Color color = (source->colors != NULL) ? (Color){ source->colors[v * 4], source->colors[v * 4 + 1], source->colors[v * 4 + 2], source->colors[v * 4 + 3] } : WHITE;
+        target->vertices[t * 3 + 0] = position.x;
+        target->vertices[t * 3 + 1] = position.y;
+        target->vertices[t * 3 + 2] = position.z;
+        target->normals[t * 3 + 0] = normal.x;
+        target->normals[t * 3 + 1] = normal.y;
+        target->normals[t * 3 + 2] = normal.z;
+        target->texcoords[t * 2 + 0] = (source->texcoords != NULL) ? source->texcoords[v * 2] : 0.0f;
+        target->texcoords[t * 2 + 1] = (source->texcoords != NULL) ? source->texcoords[v * 2 + 1] : 0.0f;
+        target->colors[t * 4 + 0] = (unsigned char)(color.r * tint.r / 255);
+        target->colors[t * 4 + 1] = (unsigned char)(color.g * tint.g / 255);
+        target->colors[t * 4 + 2] = (unsigned char)(color.b * tint.b / 255);
+        target->colors[t * 4 + 3] = (unsigned char)(color.a * tint.a / 255);
+    }
+    int indexCount = (source->indices != NULL) ? source->triangleCount * 3 : source->vertexCount;
+    for (int i = 0; i < indexCount; i++) {
+        int index = (source->indices != NULL) ? source->indices[i] : i;
+        target->indices[target->triangleCount * 3 + i] = (unsigned short)(base + index);
+    }
+    target->vertexCount += source->vertexCount;
+    target->triangleCount += indexCount / 3;
+}
+
+// Merges the model's meshes into one group per material. A material whose meshes pass the 16-bit
+// index range spills into further groups; meshes past LIT_MAX_GROUPS are left out with a warning.
+bool MergeLitModel(LitBatch *batch, Model model) {
+    for (int m = 0; m < model.materialCount; m++) {
+        const MaterialMap *diffuse = &model.materials[m].maps[MATERIAL_MAP_DIFFUSE];
+        unsigned int textureId = (diffuse->texture.id != 0) ? diffuse->texture.id : rlGetTextureIdDefault();
+        int first = 0;
+        while (first < model.meshCount) {
+            // Gather this material's meshes from first on, up to the index range
+            int vertices = 0, indices = 0, last = first;
+            for (; last < model.meshCount; last++) {
+                if (model.meshMaterial[last] != m) continue;
+                const Mesh *mesh = &model.meshes[last];
+                if (mesh->vertexCount > 65535) {
+                    TraceLog(LOG_WARNING, "RENDER: mesh %d has %d vertices, too many for 16-bit indices", last, mesh->vertexCount);
+                    return false;
+                }
+                if (vertices + mesh->vertexCount > 65535) break;
+                vertices += mesh->vertexCount;
+                indices += (mesh->indices != NULL) ? mesh->triangleCount * 3 : mesh->vertexCount;
+            }
+            if (vertices == 0) break;
+            if (batch->groupCount == LIT_MAX_GROUPS) {
+                TraceLog(LOG_WARNING, "RENDER: model needs more than %d merged meshes", LIT_MAX_GROUPS);
+                return false;
+            }
+            LitGroup *group = &batch->groups[batch->groupCount++];
+            group->textureId = textureId;
+            group->mesh = (Mesh){ 0 };
+            group->mesh.vertices = MemAlloc(vertices * 3 * sizeof(float));
+            group->mesh.normals = MemAlloc(vertices * 3 * sizeof(float));
+            group->mesh.texcoords = MemAlloc(vertices * 2 * sizeof(float));
+            group->mesh.colors = MemAlloc(vertices * 4 * sizeof(unsigned char));
+            group->mesh.indices = MemAlloc(indices * sizeof(unsigned short));
+            for (int i = first; i < last; i++) {
+                if (model.meshMaterial[i] == m) AppendLitMesh(&group->mesh, &model.meshes[i], model.transform, diffuse->color);
+            }
+            UploadMesh(&group->mesh, false);
+            first = last;
+        }
+    }
+    return true;
+}
+
+// Points the merged meshes' instance attributes at the batch's buffers; the vertex arrays keep them
+static void AttachLitInstanceBuffers(LitBatch *batch) {
+    const LitRenderer *lit = &litRenderer;
+    for (int g = 0; g < batch->groupCount; g++) {
+        rlEnableVertexArray(batch->groups[g].mesh.vaoId);
+        rlEnableVertexBuffer(batch->transformBuffer);
+        for (int column = 0; column < 4; column++) {
+            rlEnableVertexAttribute(lit->transformLocation + column);
+            rlSetVertexAttribute(lit->transformLocation + column, 4, RL_FLOAT, false, sizeof(float16), column * sizeof(Vector4));
+            rlSetVertexAttributeDivisor(lit->transformLocation + column, 1);
+        }
+        rlEnableVertexBuffer(batch->colorBuffer);
+        rlEnableVertexAttribute(lit->colorLocation);
+        rlSetVertexAttribute(lit->colorLocation, 4, RL_UNSIGNED_BYTE, true, sizeof(Color), 0);
+        rlSetVertexAttributeDivisor(lit->colorLocation, 1);
+        rlDisableVertexBuffer();
+        rlDisableVertexArray();
+    }
+}
+
+void UnloadLitRenderer(void) {
+    LitRenderer *lit = &litRenderer;
+    for (int b = 0; b < LIT_BATCH_COUNT; b++) {
+        LitBatch *batch = &lit->batches[b];
+        for (int g = 0; g < batch->groupCount; g++) UnloadMesh(batch->groups[g].mesh);
+        if (batch->transformBuffer != 0) rlUnloadVertexBuffer(batch->transformBuffer);
+        if (batch->colorBuffer != 0) rlUnloadVertexBuffer(batch->colorBuffer);
+        free(batch->transforms);
+        free(batch->colors);
+    }
+    if (lit->shader.id != 0) UnloadShader(lit->shader);
+    *lit = (LitRenderer){ 0 };
+}
+
+// Call after the models are loaded. Leaves litRenderer.ready false, and DrawWorld on the per-call
+// path, when instancing is unavailable or anything fails to load.
+void InitLitRenderer(void) {
+    LitRenderer *lit = &litRenderer;
+    if (rlGetVersion() != RL_OPENGL_33 && rlGetVersion() != RL_OPENGL_43) {
+        TraceLog(LOG_INFO, "RENDER: instancing needs OpenGL 3.3, drawing one call per object");
+        return;
+    }
+    lit->shader = LoadShaderFromMemory(litVertexShader, litFragmentShader);
+    lit->mvpLocation = GetShaderLocation(lit->shader, "mvp");
+    lit->sunLocation = GetShaderLocation(lit->shader, "sunDirection");
+    lit->transformLocation = GetShaderLocationAttrib(lit->shader, "instanceTransform");
+    lit->colorLocation = GetShaderLocationAttrib(lit->shader, "instanceColor");
+    if (lit->shader.id == rlGetShaderIdDefault() || lit->transformLocation < 0 || lit->colorLocation < 0) {
+        TraceLog(LOG_WARNING, "RENDER: lit shader did not compile, drawing one call per object");
+        lit->shader = (Shader){ 0 }; // Never unload the default shader
+        UnloadLitRenderer();
+        return;
+    }
+
+    Model sphereModel = LoadModelFromMesh(GenMeshSphere(1.0f, LIT_SPHERE_DETAIL, LIT_SPHERE_DETAIL));
+    const Model sources[LIT_BATCH_COUNT] = {
+        [LIT_BATCH_BOXES] = crateModel,
+        [LIT_BATCH_SPHERES] = sphereModel,
+        [LIT_BATCH_MISSILES] = missileModel,
+        [LIT_BATCH_AIRCRAFT] = jetModel,
+        [LIT_BATCH_TANKS] = tankModel,
+    };
+    bool merged = true;
+    int groups = 0;
+    for (int b = 0; b < LIT_BATCH_COUNT && merged; b++) {
+        LitBatch *batch = &lit->batches[b];
+        merged = MergeLitModel(batch, sources[b]);
+        batch->transforms = malloc(sizeof(float16) * litBatchCapacity[b]);
+        batch->colors = malloc(sizeof(Color) * litBatchCapacity[b]);
+        batch->transformBuffer = rlLoadVertexBuffer(NULL, (int)sizeof(float16) * litBatchCapacity[b], true);
+        batch->colorBuffer = rlLoadVertexBuffer(NULL, (int)sizeof(Color) * litBatchCapacity[b], true);
+        merged = merged && batch->transforms != NULL && batch->colors != NULL && batch->transformBuffer != 0 && batch->colorBuffer != 0;
+        if (merged) AttachLitInstanceBuffers(batch);
+        groups += batch->groupCount;
+    }
+    UnloadModel(sphereModel);
+    if (!merged || groups > LIT_MAX_DRAWS) {
+        TraceLog(LOG_WARNING, "RENDER: could not prepare the instanced models, drawing one call per object");
+        UnloadLitRenderer();
+        return;
+    }
+    lit->ready = true;
+    TraceLog(LOG_INFO, "RENDER: lit instanced path, %d merged meshes", groups);
+}
+
+static inline void PushLitInstance(LitBatchKind kind, Matrix transform, Color color) {
+    LitBatch *batch = &litRenderer.batches[kind];
+    if (batch->count == litBatchCapacity[kind]) return;
+    batch->transforms[batch->count] = MatrixToFloatV(transform);
+    batch->colors[batch->count] = color;
+    batch->count++;
+}
+
+typedef struct {
+    unsigned int textureId;
+    int batch;
+    int group;
+} LitDraw;
+
+static int CompareLitDraws(const void *a, const void *b) {
+    const LitDraw *x = a, *y = b;
+    if (x->textureId != y->textureId) return (x->textureId < y->textureId) ? -1 : 1;
+    if (x->batch != y->batch) return x->batch - y->batch;
+    return x->group - y->group;
+}
+
+// Collects this frame's instances, uploads them and draws every batch sorted by texture. Call
+// inside BeginMode3D.
+void DrawLitScene(void) {
+    LitRenderer *lit = &litRenderer;
+    for (int b = 0; b < LIT_BATCH_COUNT; b++) lit->batches[b].count = 0;
+
+    for (int i = 0; i < combatEntityCount; i++) {
+        Color entityColor = (combatEntitiesCold[i].type == ENTITY_ENEMY) ? RED : GREEN;
+        PushLitInstance(LIT_BATCH_BOXES, MatrixMultiply(MatrixScale(1.0f, 2.0f, 1.0f), MatrixTranslate(combatEntities[i].position.x, combatEntities[i].position.y, combatEntities[i].position.z)), entityColor);
+    }
+    for (int i = 0; i < crateCount; i++) {
+        PushLitInstance(LIT_BATCH_BOXES, MatrixMultiply(QuaternionToMatrix(crates[i].rotation), MatrixTranslate(crates[i].position.x, crates[i].position.y, crates[i].position.z)), cratesCold[i].color);
+    }
+    for (int i = 0; i < playerBulletCount; i++) {
+        PushLitInstance(LIT_BATCH_SPHERES, MatrixMultiply(MatrixScale(0.1f, 0.1f, 0.1f), MatrixTranslate(playerBullets[i].position.x, playerBullets[i].position.y, playerBullets[i].position.z)), DARKBLUE);
+    }
+    for (int i = 0; i < entityBulletCount; i++) {
+        PushLitInstance(LIT_BATCH_SPHERES, MatrixMultiply(MatrixScale(0.1f, 0.1f, 0.1f), MatrixTranslate(entityBullets[i].position.x, entityBullets[i].position.y, entityBullets[i].position.z)), ORANGE);
+    }
+    for (int i = 0; i < tankBulletCount; i++) {
+        PushLitInstance(LIT_BATCH_SPHERES, MatrixMultiply(MatrixScale(TANK_BULLET_RADIUS, TANK_BULLET_RADIUS, TANK_BULLET_RADIUS), MatrixTranslate(tankBullets[i].position.x, tankBullets[i].position.y, tankBullets[i].position.z)), BROWN);
+    }
+    for (int i = 0; i < bombCount; i++) {
+        if (bombs[i].exploded) continue;
+        PushLitInstance(LIT_BATCH_SPHERES, MatrixMultiply(MatrixScale(bombs[i].radius, bombs[i].radius, bombs[i].radius), MatrixTranslate(bombs[i].position.x, bombs[i].position.y, bombs[i].position.z)), BLACK);
+    }
+    for (int i = 0; i < tankBombCount; i++) {
+        if (tankBombs[i].exploded) continue;
+        PushLitInstance(LIT_BATCH_SPHERES, MatrixMultiply(MatrixScale(tankBombs[i].radius, tankBombs[i].radius, tankBombs[i].radius), MatrixTranslate(tankBombs[i].position.x, tankBombs[i].position.y, tankBombs[i].position.z)), DARKGRAY);
+    }
+    // The cylinder runs along its local Y, so Y goes to the flight direction
+    for (int i = 0; i < missileCount; i++) {
+        Vector3 forward = Vector3Normalize((Vector3){ missiles.velocityX[i], missiles.velocityY[i], missiles.velocityZ[i] });
+        Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, (Vector3){ 0.0f, 1.0f, 0.0f }));
+        Vector3 up = Vector3CrossProduct(right, forward);
+        Matrix transform = {
+            right.x, forward.x, up.x, missiles.positionX[i],
+            right.y, forward.y, up.y, missiles.positionY[i],
+            right.z, forward.z, up.z, missiles.positionZ[i],
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+        PushLitInstance(LIT_BATCH_MISSILES, transform, RED);
+    }
+    for (int i = 0; i < aircraftCount; i++) {
+        Matrix transform = MatrixMultiply(MatrixMultiply(MatrixScale(0.1f, 0.1f, 0.1f), MatrixRotateY(aircraft[i].yawRotation)),
+                                          MatrixTranslate(aircraft[i].position.x, aircraft[i].position.y, aircraft[i].position.z));
+        PushLitInstance(LIT_BATCH_AIRCRAFT, transform, WHITE);
+    }
+    for (int i = 0; i < tankCount; i++) {
+        Matrix transform = MatrixMultiply(MatrixMultiply(MatrixScale(TANK_SCALE_FACTOR, TANK_SCALE_FACTOR, TANK_SCALE_FACTOR), MatrixRotateY(tanksCold[i].yawRotation + PI)),
+                                          MatrixTranslate(tanks[i].position.x, tanks[i].position.y, tanks[i].position.z));
+        PushLitInstance(LIT_BATCH_TANKS, transform, WHITE);
+    }
+
+    LitDraw draws[LIT_MAX_DRAWS];
+    int drawCount = 0;
+    for (int b = 0; b < LIT_BATCH_COUNT; b++) {
+        LitBatch *batch = &lit->batches[b];
+        if (batch->count == 0) continue;
+        rlUpdateVertexBuffer(batch->transformBuffer, batch->transforms, batch->count * (int)sizeof(float16), 0);
+        rlUpdateVertexBuffer(batch->colorBuffer, batch->colors, batch->count * (int)sizeof(Color), 0);
+        for (int g = 0; g < batch->groupCount; g++) draws[drawCount++] = (LitDraw){ batch->groups[g].textureId, b, g };
+    }
+    if (drawCount == 0) return;
+    qsort(draws, drawCount, sizeof(LitDraw), CompareLitDraws);
+
+    rlDrawRenderBatchActive(); // Keep the immediate-mode shapes drawn so far in front of these in submission order
+    Matrix viewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlEnableShader(lit->shader.id);
+    rlSetUniformMatrix(lit->mvpLocation, viewProjection);
+    rlSetUniform(lit->sunLocation, &sunDirection, RL_SHADER_UNIFORM_VEC3, 1);
+    rlActiveTextureSlot(0);
+    int stateChanges = 1;
+    unsigned int boundTexture = 0;
+    for (int d = 0; d < drawCount; d++) {
+        const LitBatch *batch = &lit->batches[draws[d].batch];
+        const LitGroup *group = &batch->groups[draws[d].group];
+        if (group->textureId != boundTexture) {
+            rlEnableTexture(group->textureId);
+            boundTexture = group->textureId;
+            stateChanges++;
+        }
+        rlEnableVertexArray(group->mesh.vaoId);
+        rlDrawVertexArrayElementsInstanced(0, group->mesh.triangleCount * 3, 0, batch->count);
+        stateChanges++;
+    }
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+    CountTelemetry(TELEMETRY_RENDER_DRAWS, (unsigned long long)drawCount);
+    CountTelemetry(TELEMETRY_RENDER_STATE_CHANGES, (unsigned long long)stateChanges);
+}
+
+// Draws the calling thread's world from the camera: the 3D scene plus HUD, or the game over
+// screen. Networked clients fill the world pools from snapshots and draw them the same way.
+void DrawWorld(void) {
+    double start = WallClockSeconds();
+    if (!gameOver) {
+        BeginMode3D(camera);
+
+        DrawTerrain(camera);
+
+        if (litRenderer.ready) {
+            DrawLitScene();
+        } else {
+            // Draw combat entities (enemies and friendly forces)
+            for (int i = 0; i < combatEntityCount; i++) {
+                Color entityColor = (combatEntitiesCold[i].type == ENTITY_ENEMY) ? RED : GREEN;
+                DrawCube(combatEntities[i].position, 1.0f, 2.0f, 1.0f, entityColor);
+            }
+
+            for (int i = 0; i < crateCount; i++) {
+                Vector3 rotationAxis;
+                float rotationAngle;
+                QuaternionToAxisAngle(crates[i].rotation, &rotationAxis, &rotationAngle);
+                DrawModelEx(crateModel, crates[i].position, rotationAxis, rotationAngle * RAD2DEG, (Vector3){1.0f, 1.0f, 1.0f}, cratesCold[i].color);
+            }
+
+            for (int i = 0; i < playerBulletCount; i++) {
+                DrawSphere(playerBullets[i].position, 0.1f, DARKBLUE);
+            }
+
+            for (int i = 0; i < entityBulletCount; i++) {
+                DrawSphere(entityBullets[i].position, 0.1f, ORANGE);
+            }
+
+            // Draw tank bullets
+            for (int i = 0; i < tankBulletCount; i++) {
+                DrawSphere(tankBullets[i].position, TANK_BULLET_RADIUS, BROWN); // Tank bullets are brown
+            }
+
+            // Draw regular bombs (from jet)
+            for (int i = 0; i < bombCount; i++) {
+                if (!bombs[i].exploded) DrawSphere(bombs[i].position, bombs[i].radius, BLACK);
+            }
+
+            // Draw tank bombs
+            for (int i = 0; i < tankBombCount; i++) {
+                if (!tankBombs[i].exploded) DrawSphere(tankBombs[i].position, tankBombs[i].radius, DARKGRAY); // Tank bombs are dark gray
+            }
+
+            // Draw missiles (upright; the instanced path turns them along their velocity)
+            for (int i = 0; i < missileCount; i++) {
+                Vector3 missilePosition = { missiles.positionX[i], missiles.positionY[i], missiles.positionZ[i] };
+                DrawModel(missileModel, missilePosition, 1.0f, RED); // Scale 1.0f, color RED
+            }
+
+
+            // Draw the aircraft where this tick's flight step left them
+            for (int i = 0; i < aircraftCount; i++) {
+                DrawModelEx(jetModel, aircraft[i].position, (Vector3){0.0f, 1.0f, 0.0f}, aircraft[i].yawRotation * RAD2DEG, (Vector3){0.1f, 0.1f, 0.1f}, WHITE);
+            }
+
+            // Draw the tanks
+            for (int i = 0; i < tankCount; i++) {
+                DrawModelEx(tankModel, tanks[i].position, (Vector3){0.0f, 1.0f, 0.0f}, tanksCold[i].yawRotation * RAD2DEG + 180.0f, (Vector3){TANK_SCALE_FACTOR, TANK_SCALE_FACTOR, TANK_SCALE_FACTOR}, WHITE);
+            }
+        }
+
+        // Explosions are translucent, so they go after every opaque draw
+        for (int i = 0; i < bombCount; i++) {
+            if (bombs[i].exploded && BombExplosionProgress(&bombs[i]) < 1.0f) {
+                DrawSphere(bombs[i].position, bombs[i].explosion_radius * BombExplosionProgress(&bombs[i]), (Color){255, 165, 0, 100});
+            }
+        }
+        for (int i = 0; i < tankBombCount; i++) {
+            if (tankBombs[i].exploded && BombExplosionProgress(&tankBombs[i]) < 1.0f) {
+                DrawSphere(tankBombs[i].position, tankBombs[i].explosion_radius * BombExplosionProgress(&tankBombs[i]), (Color){255, 100, 0, 150}); // Slightly different explosion color
+            }
+        }
+
+        DrawParticles(camera);
+
+        EndMode3D();
+
+        // --- Draw Combat Entity Health Bars (after EndMode3D to draw in 2D overlay) ---
+        for (int i = 0; i < combatEntityCount; i++) {
+            Vector3 entityHeadPos = {combatEntities[i].position.x, combatEntities[i].position.y + 1.2f, combatEntities[i].position.z};
+            Vector2 screenPos = GetWorldToScreen(entityHeadPos, camera);
+
+            int barWidth = 40;
+            int barHeight = 6;
+            int barPadding = 2;
+
+            float healthPercent = combatEntities[i].health / 100.0f;
+
+            int outerBarX = (int)screenPos.x - (barWidth / 2) - barPadding;
+            int outerBarY = (int)screenPos.y - (barHeight / 2) - barPadding;
+            int innerBarX = (int)screenPos.x - (barWidth / 2);
+            int innerBarY = (int)screenPos.y - (barHeight / 2);
+
+            DrawRectangle(outerBarX, outerBarY, barWidth + (barPadding * 2), barHeight + (barPadding * 2), (combatEntitiesCold[i].type == ENTITY_ENEMY) ? DARKBROWN : DARKGREEN); // Background for health bar
+            DrawRectangle(innerBarX, innerBarY, (int)(barWidth * healthPercent), barHeight, (combatEntitiesCold[i].type == ENTITY_ENEMY) ? RED : GREEN);
+        }
+        // Draw Tank Health Bars
+        for (int i = 0; i < tankCount; i++) {
+            Vector3 tankHeadPos = {tanks[i].position.x, tanks[i].position.y + (3.0f * TANK_SCALE_FACTOR), tanks[i].position.z}; // Adjusted height for larger tank
+            Vector2 screenPos = GetWorldToScreen(tankHeadPos, camera);
+
+            int barWidth = 60;
+            int barHeight = 8;
+            int barPadding = 3;
+
+            float healthPercent = tanks[i].health / 200.0f; // Max tank health is 200
+
+            int outerBarX = (int)screenPos.x - (barWidth / 2) - barPadding;
+            int outerBarY = (int)screenPos.y - (barHeight / 2) - barPadding;
+            int innerBarX = (int)screenPos.x - (barWidth / 2);
+            int innerBarY = (int)screenPos.y - (barHeight / 2);
+
+            DrawRectangle(outerBarX, outerBarY, barWidth + (barPadding * 2), barHeight + (barPadding * 2), DARKBROWN);
+            DrawRectangle(innerBarX, innerBarY, (int)(barWidth * healthPercent), barHeight, MAROON); // Tank health bar color
+        }
+        // --- End Draw Combat Entity Health Bars ---
+
+        DrawText(TextFormat("Health: %.0f", playerHealth), 10, 10, 20, BLACK);
+        DrawText(TextFormat("Enemies: %d", activeEnemiesCount), 10, 40, 20, RED);
+        DrawText(TextFormat("Friendlies: %d", activeFriendliesCount), 10, 70, 20, GREEN);
+        DrawText(TextFormat("Tanks: %d", tankCount), 10, 100, 20, MAROON); // Display active tanks count
+        int aircraftLocked = 0;
+        for (int i = 0; i < aircraftCount; i++) {
+            if (ResolveHandle(&tankHandles, aircraftCold[i].lockedTarget) != -1) aircraftLocked++;
+        }
+        if (aircraftCount > 1) {
+             DrawText(TextFormat("Aircraft: %d, %d locked on", aircraftCount, aircraftLocked), 10, 130, 20, (aircraftLocked > 0) ? BLUE : GRAY);
+        } else if (aircraftLocked > 0) {
+             DrawText(TextFormat("Jet Target: Tank %d", aircraftCold[0].lockedTarget.slot), 10, 130, 20, BLUE);
+        } else {
+             DrawText("Jet Target: None", 10, 130, 20, GRAY);
+        }
+#ifdef FRAME_ARENA_DEBUG
+        DrawText(TextFormat("Arena: %zu B/frame (peak %zu B)", frameArena.lastFrameBytes, frameArena.peakFrameBytes), 10, 160, 20, DARKGRAY);
+#endif
+
+
+    } else {
+        // Game Over Screen drawing
+        DrawText("GAME OVER", GetScreenWidth() / 2 - MeasureText("GAME OVER", 40) / 2, GetScreenHeight() / 2 - 20, 40, DARKGRAY);
+        DrawText("Press ENTER to Restart", GetScreenWidth() / 2 - MeasureText("Press ENTER to Restart", 20) / 2, GetScreenHeight() / 2 + 30, 20, DARKGRAY);
+        DrawText("Press N for a New Battle, R to Rewind", GetScreenWidth() / 2 - MeasureText("Press N for a New Battle, R to Rewind", 20) / 2, GetScreenHeight() / 2 + 60, 20, DARKGRAY);
+    }
+    RecordDrawFrame(WallClockSeconds() - start);
+}
+
+// Single-player game loop; the window, assets and audio are already initialised by main
+void RunLocalGame(void) {
+    SeedWorldRandom((unsigned int)time(NULL));
+
+    ResetGame();
+    CaptureWorldSnapshot(&matchStartSnapshot);
+
+    // Main game loop
+    while (!WindowShouldClose()) {
+
+        // Release last frame's scratch memory before any system allocates from it
+        ResetFrameArena(&frameArena);
+        AdoptWatchedConfig(&configWatcher, &config); // Tuning saved to the --config file since the last frame
+
+        // Snapshot controls (outside the simulation step, file IO allocates)
+        if (IsKeyPressed(KEY_R)) RewindWorld(REWIND_STEP_FRAMES);
+        if (IsKeyPressed(KEY_F5)) {
+            if (SaveWorldSnapshot(SNAPSHOT_QUICKSAVE_PATH)) TraceLog(LOG_INFO, "SNAPSHOT: Saved %s", SNAPSHOT_QUICKSAVE_PATH);
+        }
+        if (IsKeyPressed(KEY_F9)) {
+            if (LoadWorldSnapshot(SNAPSHOT_QUICKSAVE_PATH)) TraceLog(LOG_INFO, "SNAPSHOT: Loaded %s", SNAPSHOT_QUICKSAVE_PATH);
+        }
+
+        float deltaTime = GetFrameTime();
+
+        BEGIN_SIMULATION_STEP();
+        if (!gameOver) {
+            // Update camera rotation using Raylib's FPS mode
+            UpdateCamera(&camera, CAMERA_FIRST_PERSON);
+            PlayerInput input = ReadPlayerInput();
+            StepSimulation(deltaTime, &input);
+        } else {
+            // Game Over Logic:
+            if (IsKeyPressed(KEY_ENTER)) {
+                // Instant restart of the same battle from the snapshot taken at match start
+                RestoreWorldSnapshot(&matchStartSnapshot);
+                ClearRewindHistory();
+            } else if (IsKeyPressed(KEY_N)) {
+                ResetGame();
+                CaptureWorldSnapshot(&matchStartSnapshot);
+                ClearRewindHistory();
+            }
+        }
+        END_SIMULATION_STEP();
+
+        RecordRewindFrame();
+        UpdateParticles(deltaTime);
+
+        // Drawing
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+
+        DrawWorld();
+
+        EndDrawing();
+    }
+}
+
+// --- Threaded Pipeline ---
+// The default interactive loop. The simulation steps on its own thread at PIPELINE_SIM_RATE and
+// publishes every step as an immutable RenderFrame; the main thread (which owns the window and GL
+// context) draws the newest frame and feeds input back; an audio thread plays the sound events the
+// simulation emits. Each pair of threads talks through one SpscRing, so a slow draw never holds up
+// a step: frames the renderer has not taken yet are superseded, or dropped when the ring is full.
+// Run with --serial for the single-threaded loop above.
+typedef enum {
+    PIPELINE_COMMAND_NONE,
+    PIPELINE_COMMAND_RESTART,     // Game over: ENTER
+    PIPELINE_COMMAND_NEW_BATTLE,  // Game over: N
+    PIPELINE_COMMAND_REWIND,
+    PIPELINE_COMMAND_QUICKSAVE,
+    PIPELINE_COMMAND_QUICKLOAD
+} PipelineCommand;
+
+typedef struct {
+    PlayerInput input;
+    Vector3 look;             // The render thread owns the view direction
+    PipelineCommand command;
+} PipelineInput;
+
+// Simulation side counters, cumulative since start. They travel inside the frames so the render
+// thread reads them without sharing memory with the simulation.
+typedef struct {
+    unsigned int steps;
+    double stepSeconds;       // Wall time spent stepping
+    unsigned int framesDropped;
+    unsigned int soundsDropped;
+    unsigned int inputsReceived;
+} PipelineSimCounters;
+
+typedef struct {
+    WorldSnapshot world;
+    double publishTime;       // WallClockSeconds() when the step finished
+    PipelineSimCounters counters;
+} RenderFrame;
+
+typedef struct {
+    SpscRing frameRing;       // Simulation -> render
+    SpscRing inputRing;       // Render -> simulation
+    SpscRing soundRing;       // Simulation -> audio
+    SpscRing effectRing;      // Simulation -> render
+    GameConfig config;        // The main thread's tuning and camera, copied into the simulation thread
+    Camera3D camera;
+    unsigned int seed;
+    atomic_bool quit;
+    // Audio thread counters, read by the render thread for the overlay
+    atomic_uint soundsPlayed;
+    atomic_llong soundLatencyMicros;
+    atomic_uint soundMaxDepth;
+} Pipeline;
+
+// Render side statistics over the last reporting window
+typedef struct {
+    double windowStart;
+    int framesDrawn;
+    int framesApplied;
+    int framesSuperseded;     // Published but replaced by a newer one before this thread got to it
+    double depthSum;
+    double latencySum;        // Publish to apply
+    double latencyMax;
+    PipelineSimCounters counters; // At the start of the window
+    unsigned int soundsPlayed;
+    long long soundLatencyMicros;
+    char summary[256];        // Last completed window, for the overlay
+} PipelineRenderStats;
+
+void RunPipelineCommand(PipelineCommand command) {
+    switch (command) {
+        case PIPELINE_COMMAND_RESTART:
+            if (!gameOver) break;
+            RestoreWorldSnapshot(&matchStartSnapshot);
+            ClearRewindHistory();
+            break;
+        case PIPELINE_COMMAND_NEW_BATTLE:
+            if (!gameOver) break;
+            ResetGame();
+            CaptureWorldSnapshot(&matchStartSnapshot);
+            ClearRewindHistory();
+            break;
+        case PIPELINE_COMMAND_REWIND:
+            RewindWorld(REWIND_STEP_FRAMES);
+            break;
+        case PIPELINE_COMMAND_QUICKSAVE:
+            if (SaveWorldSnapshot(SNAPSHOT_QUICKSAVE_PATH)) TraceLog(LOG_INFO, "SNAPSHOT: Saved %s", SNAPSHOT_QUICKSAVE_PATH);
+            break;
+        case PIPELINE_COMMAND_QUICKLOAD:
+            if (LoadWorldSnapshot(SNAPSHOT_QUICKSAVE_PATH)) TraceLog(LOG_INFO, "SNAPSHOT: Loaded %s", SNAPSHOT_QUICKSAVE_PATH);
+            break;
+        default:
+            break;
+    }
+}
+
+void *PipelineSimulationThread(void *argument) {
+    Pipeline *pipeline = argument;
+    config = pipeline->config;
+    camera = pipeline->camera;
+    worldDrivesCursor = false;
+    soundEventRing = &pipeline->soundRing;
+    effectEventRing = &pipeline->effectRing;
+    SeedWorldRandom(pipeline->seed);
+    StartChunkLoader(&terrainStream);
+    ResetGame();
+    CaptureWorldSnapshot(&matchStartSnapshot);
+
+    const double stepSeconds = 1.0 / PIPELINE_SIM_RATE;
+    PipelineSimCounters counters = { 0 };
+    PipelineInput held = { 0 };
+    held.look = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    double nextStepTime = WallClockSeconds();
+    while (!atomic_load(&pipeline->quit)) {
+        ResetFrameArena(&frameArena);
+        AdoptWatchedConfig(&configWatcher, &config);
+
+        // Buttons and look come from the newest message; jump and commands are edges and are kept
+        // from every message in between
+        PipelineInput message;
+        bool jump = false;
+        while (SpscRingPop(&pipeline->inputRing, &message)) {
+            if (message.command != PIPELINE_COMMAND_NONE) RunPipelineCommand(message.command);
+            jump = jump || message.input.jump;
+            held = message;
+            counters.inputsReceived++;
+        }
+        held.input.jump = jump;
+
+        double stepStart = WallClockSeconds();
+        BEGIN_SIMULATION_STEP();
+        if (!gameOver) {
+            camera.target = Vector3Add(camera.position, held.look);
+            StepSimulation((float)stepSeconds, &held.input);
+        }
+        END_SIMULATION_STEP();
+        RecordRewindFrame();
+        counters.steps++;
+        counters.stepSeconds += WallClockSeconds() - stepStart;
+        counters.soundsDropped = (unsigned int)soundEventsDropped;
+
+        RenderFrame *frame = SpscRingBeginWrite(&pipeline->frameRing);
+        if (frame != NULL) {
+            CaptureWorldSnapshot(&frame->world);
+            frame->counters = counters;
+            frame->publishTime = WallClockSeconds();
+            SpscRingCommitWrite(&pipeline->frameRing);
+        } else {
+            counters.framesDropped++;
+        }
+
+        nextStepTime += stepSeconds;
+        double now = WallClockSeconds();
+        if (nextStepTime < now - stepSeconds) nextStepTime = now; // Fell behind: do not try to catch up
+        SleepSeconds(nextStepTime - now);
+    }
+    StopChunkLoader(&terrainStream);
+    FinishTelemetry();
+    return NULL;
+}
+
+void *PipelineAudioThread(void *argument) {
+    Pipeline *pipeline = argument;
+    while (!atomic_load(&pipeline->quit)) {
+        uint32_t depth = SpscRingDepth(&pipeline->soundRing);
+        if (depth > atomic_load(&pipeline->soundMaxDepth)) atomic_store(&pipeline->soundMaxDepth, depth);
+        SoundEvent event;
+        while (SpscRingPop(&pipeline->soundRing, &event)) {
+            PlaySoundEvent(&event);
+            atomic_fetch_add(&pipeline->soundsPlayed, 1);
+            atomic_fetch_add(&pipeline->soundLatencyMicros, (long long)((WallClockSeconds() - event.queuedTime) * 1.0e6));
+        }
+        FlushTelemetry(); // Sounds are rare next to steps, so this thread does not batch them
+        SleepSeconds(PIPELINE_AUDIO_POLL_SECONDS);
+    }
+    return NULL;
+}
+
+// Folds the last second of render side samples and the cumulative simulation and audio counters
+// into the overlay line
+void UpdatePipelineRenderStats(PipelineRenderStats *stats, Pipeline *pipeline, const PipelineSimCounters *counters, double now) {
+    double window = now - stats->windowStart;
+    if (window < 1.0) return;
+    unsigned int steps = counters->steps - stats->counters.steps;
+    unsigned int soundsPlayed = atomic_load(&pipeline->soundsPlayed);
+    long long soundLatency = atomic_load(&pipeline->soundLatencyMicros);
+    unsigned int sounds = soundsPlayed - stats->soundsPlayed;
+    int applied = (stats->framesApplied > 0) ? stats->framesApplied : 1;
+    snprintf(stats->summary, sizeof(stats->summary),
+             "sim %.0f Hz %.2f ms/step | draw %.0f FPS, frame queue %.2f, latency %.1f ms (max %.1f), %d superseded, %u dropped | audio %u ev/s, %.2f ms, max queue %u",
+             steps / window, (steps > 0) ? (counters->stepSeconds - stats->counters.stepSeconds) * 1.0e3 / steps : 0.0, stats->framesDrawn / window,
+             stats->depthSum / applied, stats->latencySum * 1.0e3 / applied, stats->latencyMax * 1.0e3, stats->framesSuperseded,
+             counters->framesDropped - stats->counters.framesDropped, sounds, (sounds > 0) ? (soundLatency - stats->soundLatencyMicros) / 1.0e3 / sounds : 0.0,
+             atomic_load(&pipeline->soundMaxDepth));
+    stats->windowStart = now;
+    stats->framesDrawn = 0;
+    stats->framesApplied = 0;
+    stats->framesSuperseded = 0;
+    stats->depthSum = 0.0;
+    stats->latencySum = 0.0;
+    stats->latencyMax = 0.0;
+    stats->counters = *counters;
+    stats->soundsPlayed = soundsPlayed;
+    stats->soundLatencyMicros = soundLatency;
+    atomic_store(&pipeline->soundMaxDepth, 0);
+}
+
+void RunPipelinedGame(void) {
+    Pipeline *pipeline = calloc(1, sizeof(Pipeline));
+    if (pipeline == NULL || !InitSpscRing(&pipeline->frameRing, sizeof(RenderFrame), PIPELINE_FRAME_SLOTS) ||
+        !InitSpscRing(&pipeline->inputRing, sizeof(PipelineInput), PIPELINE_INPUT_SLOTS) ||
+        !InitSpscRing(&pipeline->soundRing, sizeof(SoundEvent), PIPELINE_SOUND_SLOTS) ||
+        !InitSpscRing(&pipeline->effectRing, sizeof(EffectEvent), PIPELINE_EFFECT_SLOTS)) {
+        TraceLog(LOG_ERROR, "PIPELINE: could not allocate the rings, running the serial loop");
+        if (pipeline != NULL) {
+            FreeSpscRing(&pipeline->frameRing);
+            FreeSpscRing(&pipeline->inputRing);
+            FreeSpscRing(&pipeline->soundRing);
+            FreeSpscRing(&pipeline->effectRing);
+        }
+        free(pipeline);
+        RunLocalGame();
+        return;
+    }
+    pipeline->config = config;
+    pipeline->camera = camera;
+    pipeline->seed = (unsigned int)time(NULL);
+    atomic_init(&pipeline->quit, false);
+
+    pthread_t simulationThread, audioThread;
+    bool simulationStarted = pthread_create(&simulationThread, NULL, PipelineSimulationThread, pipeline) == 0;
+    bool audioStarted = simulationStarted && pthread_create(&audioThread, NULL, PipelineAudioThread, pipeline) == 0;
+
+    // This thread's world is only a copy of the newest frame, drawn by DrawWorld as usual
+    worldDrivesCursor = false;
+    DisableCursor();
+    bool cursorVisible = false;
+    bool hasFrame = false;
+    Vector3 look = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    PipelineSimCounters counters = { 0 };
+    PipelineRenderStats stats = { 0 };
+    stats.windowStart = WallClockSeconds();
+    snprintf(stats.summary, sizeof(stats.summary), "pipeline starting");
+    while (simulationStarted && audioStarted && !WindowShouldClose()) {
+        // Newest frame wins: anything older was superseded while this thread was drawing
+        uint32_t depth = SpscRingDepth(&pipeline->frameRing);
+        const RenderFrame *frame = SpscRingPeek(&pipeline->frameRing);
+        while (frame != NULL && SpscRingDepth(&pipeline->frameRing) > 1) {
+            SpscRingRelease(&pipeline->frameRing);
+            stats.framesSuperseded++;
+            frame = SpscRingPeek(&pipeline->frameRing);
+        }
+        if (frame != NULL) {
+            double latency = WallClockSeconds() - frame->publishTime;
+            RestoreWorldSnapshot(&frame->world);
+            counters = frame->counters;
+            SpscRingRelease(&pipeline->frameRing);
+            hasFrame = true;
+            stats.framesApplied++;
+            stats.depthSum += depth;
+            stats.latencySum += latency;
+            if (latency > stats.latencyMax) stats.latencyMax = latency;
+        }
+        if (hasFrame && gameOver != cursorVisible) {
+            cursorVisible = gameOver;
+            if (cursorVisible) EnableCursor();
+            else DisableCursor();
+        }
+
+        // Look locally on top of the simulated position, then hand input and look to the simulation
+        camera.target = Vector3Add(camera.position, look);
+        PipelineInput message = { 0 };
+        if (!gameOver) {
+            Vector2 mouseDelta = GetMouseDelta();
+            UpdateCameraPro(&camera, Vector3Zero(), (Vector3){ mouseDelta.x * 0.05f, mouseDelta.y * 0.05f, 0.0f }, 0.0f);
+            look = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+            message.input = ReadPlayerInput();
+        }
+        message.look = look;
+        if (IsKeyPressed(KEY_R)) message.command = PIPELINE_COMMAND_REWIND;
+        else if (IsKeyPressed(KEY_F5)) message.command = PIPELINE_COMMAND_QUICKSAVE;
+        else if (IsKeyPressed(KEY_F9)) message.command = PIPELINE_COMMAND_QUICKLOAD;
+        else if (gameOver && IsKeyPressed(KEY_ENTER)) message.command = PIPELINE_COMMAND_RESTART;
+        else if (gameOver && IsKeyPressed(KEY_N)) message.command = PIPELINE_COMMAND_NEW_BATTLE;
+        SpscRingPush(&pipeline->inputRing, &message);
+
+        // Effects spawn against this thread's camera, so their level of detail follows the view
+        EffectEvent effect;
+        while (SpscRingPop(&pipeline->effectRing, &effect)) SpawnEffect(&effect);
+        UpdateParticles(GetFrameTime());
+
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        if (hasFrame) DrawWorld();
+        DrawText(stats.summary, 10, GetScreenHeight() - 20, 10, DARKGRAY);
+        EndDrawing();
+        stats.framesDrawn++;
+        UpdatePipelineRenderStats(&stats, pipeline, &counters, WallClockSeconds());
+    }
+
+    atomic_store(&pipeline->quit, true);
+    if (simulationStarted) pthread_join(simulationThread, NULL);
+    if (audioStarted) pthread_join(audioThread, NULL);
+    if (!simulationStarted || !audioStarted) TraceLog(LOG_ERROR, "PIPELINE: could not start the simulation and audio threads");
+    TraceLog(LOG_INFO, "PIPELINE: %u steps, %u frames dropped, %u sounds dropped, %u inputs | %s", counters.steps, counters.framesDropped,
+             counters.soundsDropped, counters.inputsReceived, stats.summary);
+    FreeSpscRing(&pipeline->frameRing);
+    FreeSpscRing(&pipeline->inputRing);
+    FreeSpscRing(&pipeline->soundRing);
+    FreeSpscRing(&pipeline->effectRing);
+    free(pipeline);
+}
+
+// --- Networking ---
+// Authoritative dedicated server and its clients over UDP. The server steps the only copy of the
+// world at a fixed tick. Every NET_SNAPSHOT_INTERVAL ticks it quantises the world into a
+// NetWorldState and sends each client the XOR/zero-run delta (the rewind codec) against the
+// newest state that client has acknowledged. Clients keep the last few decoded states, render
+// NET_INTERP_TICKS behind the newest one and send their input every frame. The world has a single
+// player: the first client to connect pilots it, later clients spectate.
+// Interest management: each client gets its own filtered copy of the state. Elements are tiered by
+// distance from the client's view (and demoted a tier when behind it), far tiers refresh less
+// often and out-of-range elements are not sent at all, so bandwidth scales with what is near each
+// camera rather than with the whole world.
+#ifdef NET_SUPPORTED
+
+typedef enum {
+    NET_PACKET_INPUT,
+    NET_PACKET_SNAPSHOT,
+    NET_PACKET_DISCONNECT
+} NetPacketType;
+
+typedef enum {
+    NET_ROLE_PILOT,
+    NET_ROLE_SPECTATOR
+} NetRole;
+
+// Input button bits
+#define NET_BUTTON_FORWARD (1 << 0)
+#define NET_BUTTON_BACK (1 << 1)
+#define NET_BUTTON_LEFT (1 << 2)
+#define NET_BUTTON_RIGHT (1 << 3)
+#define NET_BUTTON_RUN (1 << 4)
+#define NET_BUTTON_JUMP (1 << 5)
+#define NET_BUTTON_FIRE (1 << 6)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t type;          // NetPacketType
+    uint8_t role;          // Snapshots: the receiving client's NetRole
+    uint16_t payloadSize;  // Bytes following the header
+    uint32_t tick;         // Snapshots: server tick. Input: newest snapshot tick received (the ack)
+    uint32_t baselineTick; // Snapshots: tick the delta is against, 0 for the all-zero state
+} NetPacketHeader;
+
+typedef struct {
+    uint32_t sequence;
+    uint8_t buttons;        // NET_BUTTON_* bits
+    uint8_t padding[3];
+    float look[3];          // Pilot view direction
+    float viewPosition[3];  // Where the client's camera is (spectators fly freely)
+} NetInputPayload;
+
+// Quantised replicated state. Positions are int16 offsets in 1/NET_POSITION_SCALE units, which only
+// reach +-512 units, so every offset is taken from a chunk corner near the element: projectiles and
+// crates never leave the simulation window and use the snapshot's origin (the window's centre);
+// units, bombs and aircraft roam the whole map and carry their own chunk. Heights are absolute.
+// Entities, crates and tanks are stored by handle slot rather than packed, so an element keeps its
+// bytes (and its delta stays small) when the pool swaps it to another index or when interest
+// management leaves its neighbours out. The tag tells clients whether a slot is occupied and by
+// which generation.
+typedef struct {
+    uint16_t chunk[2];  // Map chunk (x, z) whose corner the offset is from
+    int16_t offset[3];
+} NetMapPosition;
+
+typedef struct {
+    int16_t position[3]; // From the snapshot origin
+} NetPoint;
+
+typedef struct {
+    NetMapPosition position;
+    uint8_t tag;    // NetSlotTag of the handle, 0 when not replicated
+    uint8_t type;   // EntityType
+    uint8_t health;
+} NetCombatEntity;
+
+typedef struct {
+    int16_t position[3]; // From the snapshot origin
+    int8_t rotation[4]; // Quaternion * 127
+    uint8_t tag;
+    uint8_t color;      // Index into netCratePalette
+} NetCrate;
+
+typedef struct {
+    NetMapPosition position;
+    uint8_t tag;
+    uint8_t health;
+    uint8_t yaw;        // Fraction of a full turn * 256
+} NetTank;
+
+typedef struct {
+    NetMapPosition position;
+    uint8_t exploded;
+    uint8_t explosionProgress; // BombExplosionProgress() * 255
+    uint8_t explosionRadius;   // World units
+} NetBomb;
+
+typedef struct {
+    NetMapPosition position;
+    uint16_t yaw;       // Fraction of a full turn * 65536
+} NetAircraft;
+
+typedef struct {
+    uint16_t originChunk[2];    // Chunk at the centre of the server's simulation window
+    NetMapPosition playerPosition;
+    uint8_t playerHealth;
+    uint8_t gameOver;
+    uint8_t activeEnemies;
+    uint8_t activeFriendlies;
+    uint8_t playerBulletCount;
+    uint8_t entityBulletCount;
+    uint8_t tankBulletCount;
+    uint8_t bombCount;
+    uint8_t tankBombCount;
+    uint8_t missileCount;
+    uint8_t aircraftCount;
+    NetCombatEntity entities[MAX_ENTITIES];
+    NetCrate crates[MAX_CRATES];
+    NetTank tanks[MAX_TANKS];
+    NetPoint playerBullets[MAX_PLAYER_BULLETS];
+    NetPoint entityBullets[MAX_ENTITY_BULLETS];
+    NetPoint tankBullets[MAX_TANK_BULLETS];
+    NetBomb bombs[MAX_BOMBS];
+    NetBomb tankBombs[MAX_TANK_BOMBS];
+    NetPoint missiles[NET_MAX_MISSILES];
+    NetAircraft aircraft[NET_MAX_AIRCRAFT];
+} NetWorldState;
+
+#define NET_DELTA_CAPACITY (sizeof(NetWorldState) + sizeof(NetWorldState) / SNAPSHOT_MIN_ZERO_RUN + 16)
+_Static_assert(sizeof(NetPacketHeader) + NET_DELTA_CAPACITY <= NET_MAX_PACKET, "a full snapshot must fit in one packet");
+
+const Color netCratePalette[] = { GREEN, YELLOW, BLUE };
+const NetWorldState netZeroState = { 0 }; // Baseline for clients that have acknowledged nothing yet
+
+int OpenUdpSocket(unsigned short port) {
+    int socketHandle = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socketHandle < 0) return -1;
+    struct sockaddr_in address = { 0 };
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(socketHandle, (struct sockaddr *)&address, sizeof(address)) < 0 || fcntl(socketHandle, F_SETFL, O_NONBLOCK) < 0) {
+        close(socketHandle);
+        return -1;
+    }
+    return socketHandle;
+}
+
+bool ResolveServerAddress(const char *host, unsigned short port, struct sockaddr_in *address) {
+    memset(address, 0, sizeof(*address));
+    address->sin_family = AF_INET;
+    address->sin_port = htons(port);
+    if (strcmp(host, "localhost") == 0) host = "127.0.0.1";
+    return inet_pton(AF_INET, host, &address->sin_addr) == 1;
+}
+
+int16_t QuantiseCoordinate(float value) {
+    float scaled = roundf(value * NET_POSITION_SCALE);
+    if (scaled > 32767.0f || scaled < -32767.0f) {
+        CountTelemetry(TELEMETRY_NET_CLAMPED_COORDINATES, 1); // Only heights can get here
+        scaled = Clamp(scaled, -32767.0f, 32767.0f);
+    }
+    return (int16_t)scaled;
+}
+
+// World position of a chunk's corner, exact in float for every chunk on the map
+Vector3 NetChunkCorner(int chunkX, int chunkZ) {
+    return (Vector3){ (float)chunkX * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT, 0.0f, (float)chunkZ * TERRAIN_CHUNK_SIZE - TERRAIN_HALF_EXTENT };
+}
+
+void QuantisePosition(Vector3 position, Vector3 origin, int16_t out[3]) {
+    out[0] = QuantiseCoordinate(position.x - origin.x);
+    out[1] = QuantiseCoordinate(position.y);
+    out[2] = QuantiseCoordinate(position.z - origin.z);
+}
+
+Vector3 DequantisePosition(const int16_t in[3], Vector3 origin) {
+    return (Vector3){ origin.x + in[0] / NET_POSITION_SCALE, in[1] / NET_POSITION_SCALE, origin.z + in[2] / NET_POSITION_SCALE };
+}
+
+void QuantiseMapPosition(Vector3 position, NetMapPosition *out) {
+    int chunkX = TerrainChunkCoord(position.x), chunkZ = TerrainChunkCoord(position.z);
+    out->chunk[0] = (uint16_t)chunkX;
+    out->chunk[1] = (uint16_t)chunkZ;
+    QuantisePosition(position, NetChunkCorner(chunkX, chunkZ), out->offset);
+}
+
+Vector3 DequantiseMapPosition(const NetMapPosition *in) {
+    return DequantisePosition(in->offset, NetChunkCorner(in->chunk[0], in->chunk[1]));
+}
+
+Vector3 NetStateOrigin(const NetWorldState *state) {
+    return NetChunkCorner(state->originChunk[0], state->originChunk[1]);
+}
+
+uint8_t QuantiseUnit(float value, float maximum) {
+    return (uint8_t)Clamp(roundf(value / maximum * 255.0f), 0.0f, 255.0f);
+}
+
+uint8_t QuantiseByte(float value) {
+    return (uint8_t)Clamp(roundf(value), 0.0f, 255.0f);
+}
+
+// Fraction of a full turn, wrapped into [0, 1)
+float TurnFraction(float angle) {
+    float turns = angle / (2.0f * PI);
+    return turns - floorf(turns);
+}
+
+// Non-zero tag for an occupied slot; changes when the slot is reused by a new generation
+uint8_t NetSlotTag(Handle handle) {
+    return (uint8_t)(1 + handle.generation % 255);
+}
+
+void QuantiseBomb(const ProjectileBomb *bomb, NetBomb *out) {
+    QuantiseMapPosition(bomb->position, &out->position);
+    out->exploded = bomb->exploded ? 1 : 0;
+    out->explosionProgress = QuantiseUnit(BombExplosionProgress(bomb), 1.0f);
+    out->explosionRadius = QuantiseByte(bomb->explosion_radius);
+}
+
+// Quantises the calling thread's world
+void CaptureNetWorldState(NetWorldState *state) {
+    memset(state, 0, sizeof(NetWorldState));
+    state->originChunk[0] = (uint16_t)(simulationWindowX + STREAM_WINDOW_CHUNKS / 2);
+    state->originChunk[1] = (uint16_t)(simulationWindowZ + STREAM_WINDOW_CHUNKS / 2);
+    Vector3 origin = NetStateOrigin(state);
+    QuantiseMapPosition(camera.position, &state->playerPosition);
+    state->playerHealth = QuantiseByte(playerHealth);
+    state->gameOver = gameOver ? 1 : 0;
+    state->activeEnemies = (uint8_t)activeEnemiesCount;
+    state->activeFriendlies = (uint8_t)activeFriendliesCount;
+
+    for (int i = 0; i < combatEntityCount; i++) {
+        NetCombatEntity *entity = &state->entities[combatEntitiesCold[i].handle.slot];
+        QuantiseMapPosition(combatEntities[i].position, &entity->position);
+        entity->tag = NetSlotTag(combatEntitiesCold[i].handle);
+        entity->type = (uint8_t)combatEntitiesCold[i].type;
+        entity->health = QuantiseByte(combatEntities[i].health);
+    }
+    for (int i = 0; i < crateCount; i++) {
+        NetCrate *crate = &state->crates[cratesCold[i].handle.slot];
+        QuantisePosition(crates[i].position, origin, crate->position);
+        crate->rotation[0] = (int8_t)roundf(crates[i].rotation.x * 127.0f);
+        crate->rotation[1] = (int8_t)roundf(crates[i].rotation.y * 127.0f);
+        crate->rotation[2] = (int8_t)roundf(crates[i].rotation.z * 127.0f);
+        crate->rotation[3] = (int8_t)roundf(crates[i].rotation.w * 127.0f);
+        crate->tag = NetSlotTag(cratesCold[i].handle);
+        for (int c = 0; c < (int)(sizeof(netCratePalette) / sizeof(netCratePalette[0])); c++) {
+            if (memcmp(&cratesCold[i].color, &netCratePalette[c], sizeof(Color)) == 0) crate->color = (uint8_t)c;
+        }
+    }
+    for (int i = 0; i < tankCount; i++) {
+        NetTank *tank = &state->tanks[tanksCold[i].handle.slot];
+        QuantiseMapPosition(tanks[i].position, &tank->position);
+        tank->tag = NetSlotTag(tanksCold[i].handle);
+        tank->health = QuantiseByte(tanks[i].health);
+        tank->yaw = (uint8_t)(TurnFraction(tanksCold[i].yawRotation) * 255.0f);
+    }
+
+    state->playerBulletCount = (uint8_t)playerBulletCount;
+    for (int i = 0; i < playerBulletCount; i++) QuantisePosition(playerBullets[i].position, origin, state->playerBullets[i].position);
+    state->entityBulletCount = (uint8_t)entityBulletCount;
+    for (int i = 0; i < entityBulletCount; i++) QuantisePosition(entityBullets[i].position, origin, state->entityBullets[i].position);
+    state->tankBulletCount = (uint8_t)tankBulletCount;
+    for (int i = 0; i < tankBulletCount; i++) QuantisePosition(tankBullets[i].position, origin, state->tankBullets[i].position);
+    state->bombCount = (uint8_t)bombCount;
+    for (int i = 0; i < bombCount; i++) QuantiseBomb(&bombs[i], &state->bombs[i]);
+    state->tankBombCount = (uint8_t)tankBombCount;
+    for (int i = 0; i < tankBombCount; i++) QuantiseBomb(&tankBombs[i], &state->tankBombs[i]);
+    state->missileCount = (uint8_t)((missileCount < NET_MAX_MISSILES) ? missileCount : NET_MAX_MISSILES);
+    for (int i = 0; i < state->missileCount; i++) {
+        QuantisePosition((Vector3){ missiles.positionX[i], missiles.positionY[i], missiles.positionZ[i] }, origin, state->missiles[i].position);
+    }
+    state->aircraftCount = (uint8_t)((aircraftCount < NET_MAX_AIRCRAFT) ? aircraftCount : NET_MAX_AIRCRAFT);
+    for (int i = 0; i < state->aircraftCount; i++) {
+        QuantiseMapPosition(aircraft[i].position, &state->aircraft[i].position);
+        state->aircraft[i].yaw = (uint16_t)(TurnFraction(aircraft[i].yawRotation) * 65535.0f);
+    }
+}
+
+// Position between two snapshots. Elements that jumped (swap-removed into another index, respawned)
+// snap to the newer snapshot instead of sliding across the map.
+Vector3 InterpolateNetPosition(Vector3 start, Vector3 target, bool sameElement, float t) {
+    if (!sameElement) return target;
+    if (Vector3DistanceSqr(start, target) > NET_SNAP_DISTANCE * NET_SNAP_DISTANCE) return target;
+    return Vector3Lerp(start, target, t);
+}
+
+void ApplyNetPoints(Bullet *pool, int *count, const NetPoint *from, Vector3 fromOrigin, int fromCount, const NetPoint *to, Vector3 toOrigin, int toCount, float t) {
+    *count = toCount;
+    for (int i = 0; i < toCount; i++) {
+        pool[i].position = InterpolateNetPosition(DequantisePosition(from[i].position, fromOrigin), DequantisePosition(to[i].position, toOrigin), i < fromCount, t);
+        pool[i].velocity = Vector3Zero();
+        pool[i].mass = BULLET_MASS;
+    }
+}
+
+void ApplyNetBombs(ProjectileBomb *pool, int *count, float radius, const NetBomb *from, int fromCount, const NetBomb *to, int toCount, float t) {
+    *count = toCount;
+    for (int i = 0; i < toCount; i++) {
+        pool[i].position = InterpolateNetPosition(DequantiseMapPosition(&from[i].position), DequantiseMapPosition(&to[i].position), i < fromCount, t);
+        pool[i].velocity = Vector3Zero();
+        pool[i].exploded = to[i].exploded != 0;
+        pool[i].explosion_duration = 1.0f;
+        // Span the explosion over 255 ticks around this world's (idle) timer, progress ticks in
+        pool[i].explosionStartTick = timerWheel.now - to[i].explosionProgress;
+        pool[i].explosionEndTick = pool[i].explosionStartTick + 255u;
+        pool[i].radius = radius;
+        pool[i].explosion_radius = (float)to[i].explosionRadius;
+    }
+}
+
+// Writes the world between two decoded snapshots (t = 0 at from, 1 at to) into the calling
+// thread's pools, ready for DrawWorld. The camera position is left to the caller.
+void ApplyNetWorldState(const NetWorldState *from, const NetWorldState *to, float t) {
+    Vector3 fromOrigin = NetStateOrigin(from), toOrigin = NetStateOrigin(to);
+    playerHealth = to->playerHealth;
+    gameOver = to->gameOver != 0;
+    activeEnemiesCount = to->activeEnemies;
+    activeFriendliesCount = to->activeFriendlies;
+    aircraftCount = to->aircraftCount;
+    for (int i = 0; i < aircraftCount; i++) {
+        aircraft[i].position = InterpolateNetPosition(DequantiseMapPosition(&from->aircraft[i].position), DequantiseMapPosition(&to->aircraft[i].position),
+                                                      i < from->aircraftCount, t);
+        float toTurn = to->aircraft[i].yaw / 65535.0f;
+        float turnDelta = (i < from->aircraftCount) ? toTurn - from->aircraft[i].yaw / 65535.0f : 0.0f;
+        if (turnDelta > 0.5f) turnDelta -= 1.0f; // Turn the short way round when the heading wrapped
+        if (turnDelta < -0.5f) turnDelta += 1.0f;
+        aircraft[i].yawRotation = (toTurn - turnDelta * (1.0f - t)) * 2.0f * PI;
+        aircraftCold[i].lockedTarget = NULL_HANDLE;
+    }
+
+    // Slot order keeps the rebuilt pools stable from frame to frame
+    combatEntityCount = 0;
+    for (int slot = 0; slot < MAX_ENTITIES; slot++) {
+        const NetCombatEntity *entity = &to->entities[slot];
+        if (entity->tag == 0) continue;
+        int i = combatEntityCount++;
+        combatEntities[i].position = InterpolateNetPosition(DequantiseMapPosition(&from->entities[slot].position), DequantiseMapPosition(&entity->position),
+                                                            from->entities[slot].tag == entity->tag, t);
+        combatEntities[i].velocity = Vector3Zero();
+        combatEntities[i].health = entity->health;
+        combatEntitiesCold[i].type = (EntityType)entity->type;
+        combatEntitiesCold[i].mass = 1.0f;
+    }
+    crateCount = 0;
+    for (int slot = 0; slot < MAX_CRATES; slot++) {
+        const NetCrate *crate = &to->crates[slot];
+        if (crate->tag == 0) continue;
+        int i = crateCount++;
+        bool sameCrate = from->crates[slot].tag == crate->tag;
+        crates[i].position = InterpolateNetPosition(DequantisePosition(from->crates[slot].position, fromOrigin), DequantisePosition(crate->position, toOrigin), sameCrate, t);
+        Quaternion rotation = { crate->rotation[0] / 127.0f, crate->rotation[1] / 127.0f, crate->rotation[2] / 127.0f, crate->rotation[3] / 127.0f };
+        if (sameCrate) {
+            const int8_t *previousRotation = from->crates[slot].rotation;
+            Quaternion previous = { previousRotation[0] / 127.0f, previousRotation[1] / 127.0f, previousRotation[2] / 127.0f, previousRotation[3] / 127.0f };
+            rotation = QuaternionNlerp(previous, rotation, t);
+        }
+        crates[i].rotation = QuaternionNormalize(rotation);
+        crates[i].velocity = Vector3Zero();
+        crates[i].angularVelocity = Vector3Zero();
+        cratesCold[i].color = netCratePalette[crate->color % (sizeof(netCratePalette) / sizeof(netCratePalette[0]))];
+        cratesCold[i].mass = 2.0f;
+    }
+    tankCount = 0;
+    for (int slot = 0; slot < MAX_TANKS; slot++) {
+        const NetTank *tank = &to->tanks[slot];
+        if (tank->tag == 0) continue;
+        int i = tankCount++;
+        tanks[i].position = InterpolateNetPosition(DequantiseMapPosition(&from->tanks[slot].position), DequantiseMapPosition(&tank->position),
+                                                   from->tanks[slot].tag == tank->tag, t);
+        tanks[i].velocity = Vector3Zero();
+        tanks[i].health = tank->health;
+        tanksCold[i].yawRotation = tank->yaw / 255.0f * 2.0f * PI;
+    }
+
+    ApplyNetPoints(playerBullets, &playerBulletCount, from->playerBullets, fromOrigin, from->playerBulletCount, to->playerBullets, toOrigin, to->playerBulletCount, t);
+    ApplyNetPoints(entityBullets, &entityBulletCount, from->entityBullets, fromOrigin, from->entityBulletCount, to->entityBullets, toOrigin, to->entityBulletCount, t);
+    ApplyNetPoints(tankBullets, &tankBulletCount, from->tankBullets, fromOrigin, from->tankBulletCount, to->tankBullets, toOrigin, to->tankBulletCount, t);
+    ApplyNetBombs(bombs, &bombCount, BOMB_RADIUS, from->bombs, from->bombCount, to->bombs, to->bombCount, t);
+    ApplyNetBombs(tankBombs, &tankBombCount, TANK_BOMB_RADIUS, from->tankBombs, from->tankBombCount, to->tankBombs, to->tankBombCount, t);
+    missileCount = to->missileCount;
+    for (int i = 0; i < missileCount; i++) {
+        Vector3 start = DequantisePosition(from->missiles[i].position, fromOrigin);
+        Vector3 target = DequantisePosition(to->missiles[i].position, toOrigin);
+        Vector3 position = InterpolateNetPosition(start, target, i < from->missileCount, t);
+        Vector3 velocity = Vector3Subtract(target, start);
+        missiles.positionX[i] = position.x;
+        missiles.positionY[i] = position.y;
+        missiles.positionZ[i] = position.z;
+        missiles.velocityX[i] = velocity.x;
+        missiles.velocityY[i] = velocity.y;
+        missiles.velocityZ[i] = velocity.z;
+    }
+}
+
+// --- Interest Management ---
+typedef enum {
+    NET_TIER_NEAR,
+    NET_TIER_MID,
+    NET_TIER_FAR,
+    NET_TIER_NONE     // Not replicated to this client
+} NetRelevanceTier;
+
+typedef struct {
+    Vector3 position;
+    Vector3 look;
+} NetViewer;
+
+// A snapshot's bullets and missiles in one broadphase grid, built once and queried per client.
+// Indices run through playerBullets, entityBullets, tankBullets and missiles in that order.
+typedef struct {
+    int count;
+    float *x;
+    float *z;
+    SpatialGrid grid;
+    int *candidates;          // Query scratch, reused by every client
+    unsigned char *selected;
+} NetProjectileIndex;
+
+typedef struct {
+    int sent;     // Elements replicated with their current value
+    int stale;    // Relevant elements not due this snapshot: the client keeps the value it has
+    int culled;   // Elements left out entirely
+} NetRelevanceCounts;
+
+NetRelevanceTier ClassifyRelevance(const NetViewer *viewer, Vector3 position) {
+    float dx = position.x - viewer->position.x;
+    float dz = position.z - viewer->position.z;
+    float distanceSqr = dx * dx + dz * dz;
+    if (distanceSqr <= NET_RELEVANCE_NEAR * NET_RELEVANCE_NEAR) return NET_TIER_NEAR;
+    NetRelevanceTier tier = NET_TIER_NONE;
+    if (distanceSqr <= NET_RELEVANCE_MID * NET_RELEVANCE_MID) tier = NET_TIER_MID;
+    else if (distanceSqr <= NET_RELEVANCE_FAR * NET_RELEVANCE_FAR) tier = NET_TIER_FAR;
+
+    // Behind the camera the client has to turn around before it can see the element
+    float lookLength = sqrtf(viewer->look.x * viewer->look.x + viewer->look.z * viewer->look.z);
+    if (tier != NET_TIER_NONE && lookLength > 0.0f && dx * viewer->look.x + dz * viewer->look.z < NET_BEHIND_COSINE * sqrtf(distanceSqr) * lookLength) {
+        tier = (NetRelevanceTier)(tier + 1);
+    }
+    return tier;
+}
+
+// Whether a slot in this tier refreshes on this snapshot. Slots are staggered so a tier's updates
+// spread over its period instead of all landing on the same snapshot.
+bool NetTierDue(NetRelevanceTier tier, uint32_t snapshotNumber, int slot) {
+    uint32_t period = (tier == NET_TIER_NEAR) ? 1 : (tier == NET_TIER_MID) ? NET_MID_PERIOD : NET_FAR_PERIOD;
+    return (snapshotNumber + (uint32_t)slot) % period == 0;
+}
+
+void BuildNetProjectileIndex(const NetWorldState *state, NetProjectileIndex *index, FrameArena *arena) {
+    int capacity = MAX_PLAYER_BULLETS + MAX_ENTITY_BULLETS + MAX_TANK_BULLETS + NET_MAX_MISSILES;
+    index->x = ARENA_ALLOC_ARRAY(arena, float, capacity);
+    index->z = ARENA_ALLOC_ARRAY(arena, float, capacity);
+    index->candidates = ARENA_ALLOC_ARRAY(arena, int, capacity);
+    index->selected = ARENA_ALLOC_ARRAY(arena, unsigned char, capacity);
+    index->count = 0;
+    if (index->x == NULL || index->z == NULL || index->candidates == NULL || index->selected == NULL) return;
+
+    Vector3 origin = NetStateOrigin(state);
+    const NetPoint *pools[] = { state->playerBullets, state->entityBullets, state->tankBullets, state->missiles };
+    const int counts[] = { state->playerBulletCount, state->entityBulletCount, state->tankBulletCount, state->missileCount };
+    for (int p = 0; p < 4; p++) {
+        for (int i = 0; i < counts[p]; i++) {
+            Vector3 position = DequantisePosition(pools[p][i].position, origin);
+            index->x[index->count] = position.x;
+            index->z[index->count] = position.z;
+            index->count++;
+        }
+    }
+    BuildSpatialGrid(&index->grid, arena, index->x, index->z, index->count, BROADPHASE_CELL_SIZE, BROADPHASE_GRID_DIM);
+}
+
+// What a client receives for one slot: nothing when irrelevant, the current value when its tier is
+// due, otherwise the value the client was last sent (while that is still the same element)
+void FilterNetSlot(const void *current, const void *previous, bool samePrevious, NetRelevanceTier tier, bool due, void *out, size_t size, NetRelevanceCounts *counts) {
+    if (tier == NET_TIER_NONE) {
+        counts->culled++;
+    } else if (!due && samePrevious) {
+        memcpy(out, previous, size);
+        counts->stale++;
+    } else {
+        memcpy(out, current, size);
+        counts->sent++;
+    }
+}
+
+int PackRelevantPoints(const NetPoint *points, int count, const unsigned char *selected, NetPoint *out, NetRelevanceCounts *counts) {
+    int packed = 0;
+    for (int i = 0; i < count; i++) {
+        if (selected[i]) out[packed++] = points[i];
+    }
+    counts->sent += packed;
+    counts->culled += count - packed;
+    return packed;
+}
+
+int PackRelevantBombs(const NetBomb *bombs, int count, const NetViewer *viewer, NetBomb *out, NetRelevanceCounts *counts) {
+    int packed = 0;
+    for (int i = 0; i < count; i++) {
+        if (ClassifyRelevance(viewer, DequantiseMapPosition(&bombs[i].position)) != NET_TIER_NONE) out[packed++] = bombs[i];
+    }
+    counts->sent += packed;
+    counts->culled += count - packed;
+    return packed;
+}
+
+// Builds one client's view of the full state. previous is what the client was sent last time.
+void FilterNetWorldState(const NetWorldState *full, const NetWorldState *previous, NetProjectileIndex *projectiles, const NetViewer *viewer,
+                         uint32_t snapshotNumber, NetWorldState *out, NetRelevanceCounts *counts) {
+    memset(out, 0, sizeof(NetWorldState));
+    memcpy(out->originChunk, full->originChunk, sizeof(out->originChunk));
+    out->playerPosition = full->playerPosition;
+    out->playerHealth = full->playerHealth;
+    out->gameOver = full->gameOver;
+    out->activeEnemies = full->activeEnemies;
+    out->activeFriendlies = full->activeFriendlies;
+
+    for (int slot = 0; slot < MAX_ENTITIES; slot++) {
+        const NetCombatEntity *entity = &full->entities[slot];
+        if (entity->tag == 0) continue;
+        NetRelevanceTier tier = ClassifyRelevance(viewer, DequantiseMapPosition(&entity->position));
+        FilterNetSlot(entity, &previous->entities[slot], previous->entities[slot].tag == entity->tag, tier, NetTierDue(tier, snapshotNumber, slot),
+                      &out->entities[slot], sizeof(NetCombatEntity), counts);
+    }
+    // A stale crate's bytes are only valid against the origin they were quantised from
+    Vector3 origin = NetStateOrigin(full);
+    bool sameOrigin = memcmp(previous->originChunk, full->originChunk, sizeof(full->originChunk)) == 0;
+    for (int slot = 0; slot < MAX_CRATES; slot++) {
+        const NetCrate *crate = &full->crates[slot];
+        if (crate->tag == 0) continue;
+        NetRelevanceTier tier = ClassifyRelevance(viewer, DequantisePosition(crate->position, origin));
+        FilterNetSlot(crate, &previous->crates[slot], sameOrigin && previous->crates[slot].tag == crate->tag, tier, NetTierDue(tier, snapshotNumber, slot),
+                      &out->crates[slot], sizeof(NetCrate), counts);
+    }
+    for (int slot = 0; slot < MAX_TANKS; slot++) {
+        const NetTank *tank = &full->tanks[slot];
+        if (tank->tag == 0) continue;
+        NetRelevanceTier tier = ClassifyRelevance(viewer, DequantiseMapPosition(&tank->position));
+        if (tier == NET_TIER_NONE) tier = NET_TIER_FAR; // Tanks can shell the player from anywhere: always replicated
+        FilterNetSlot(tank, &previous->tanks[slot], previous->tanks[slot].tag == tank->tag, tier, NetTierDue(tier, snapshotNumber, slot),
+                      &out->tanks[slot], sizeof(NetTank), counts);
+    }
+
+    // Bullets and missiles are short-lived and only matter up close. They are packed, so they are
+    // always sent current; the grid narrows each client to the cells around its view.
+    memset(projectiles->selected, 0, (size_t)projectiles->count);
+    int found = QuerySpatialGrid(&projectiles->grid, viewer->position.x, viewer->position.z, NET_RELEVANCE_MID, projectiles->candidates, projectiles->count);
+    for (int k = 0; k < found; k++) {
+        int i = projectiles->candidates[k];
+        if (ClassifyRelevance(viewer, (Vector3){ projectiles->x[i], 0.0f, projectiles->z[i] }) <= NET_TIER_MID) projectiles->selected[i] = 1;
+    }
+    const unsigned char *selected = projectiles->selected;
+    out->playerBulletCount = (uint8_t)PackRelevantPoints(full->playerBullets, full->playerBulletCount, selected, out->playerBullets, counts);
+    selected += full->playerBulletCount;
+    out->entityBulletCount = (uint8_t)PackRelevantPoints(full->entityBullets, full->entityBulletCount, selected, out->entityBullets, counts);
+    selected += full->entityBulletCount;
+    out->tankBulletCount = (uint8_t)PackRelevantPoints(full->tankBullets, full->tankBulletCount, selected, out->tankBullets, counts);
+    selected += full->tankBulletCount;
+    out->missileCount = (uint8_t)PackRelevantPoints(full->missiles, full->missileCount, selected, out->missiles, counts);
+
+    // Explosions are visible from much further away
+    out->bombCount = (uint8_t)PackRelevantBombs(full->bombs, full->bombCount, viewer, out->bombs, counts);
+    out->tankBombCount = (uint8_t)PackRelevantBombs(full->tankBombs, full->tankBombCount, viewer, out->tankBombs, counts);
+
+    // Aircraft fly overhead where everyone can see them
+    out->aircraftCount = full->aircraftCount;
+    memcpy(out->aircraft, full->aircraft, sizeof(NetAircraft) * full->aircraftCount);
+}
+
+// --- Dedicated Server ---
+typedef struct {
+    bool connected;
+    struct sockaddr_in address;
+    double lastHeard;
+    uint32_t ackTick;      // Newest snapshot the client has decoded, used as its delta baseline
+    uint8_t buttons;
+    bool pendingJump;      // Jump is an edge: held until a server tick consumes it
+    Vector3 look;
+    Vector3 viewPosition;
+    uint32_t lastSentTick;
+    uint32_t sentTicks[NET_CLIENT_HISTORY]; // Ticks of the states in netClientStates for this client
+} NetServerClient;
+
+typedef struct {
+    unsigned short port;
+    int tickLimit;            // Stop after this many ticks, 0 runs until killed
+    unsigned int seed;
+    bool interestManagement;  // false sends every client the whole world
+    bool quiet;               // No per-second or per-match reports
+} NetServerOptions;
+
+typedef struct {
+    int ticks;
+    long long bytesSent;
+    int packetsSent;
+    int fullSnapshots;     // Snapshots sent against the zero state (no usable ack)
+    long long elementsSent;   // Interest management totals over all client snapshots
+    long long elementsStale;
+    long long elementsCulled;
+    double simSeconds;     // Wall time in StepSimulation
+    double netSeconds;     // Wall time receiving, quantising, filtering, encoding and sending
+    double maxTickSeconds;
+} NetServerStats;
+
+void AccumulateNetServerStats(NetServerStats *total, const NetServerStats *add) {
+    total->ticks += add->ticks;
+    total->bytesSent += add->bytesSent;
+    total->packetsSent += add->packetsSent;
+    total->fullSnapshots += add->fullSnapshots;
+    total->elementsSent += add->elementsSent;
+    total->elementsStale += add->elementsStale;
+    total->elementsCulled += add->elementsCulled;
+    total->simSeconds += add->simSeconds;
+    total->netSeconds += add->netSeconds;
+    if (add->maxTickSeconds > total->maxTickSeconds) total->maxTickSeconds = add->maxTickSeconds;
+}
+
+NetServerClient netClients[NET_MAX_CLIENTS];
+NetWorldState (*netClientStates)[NET_CLIENT_HISTORY]; // What each client was sent, by snapshot number % NET_CLIENT_HISTORY
+NetWorldState netFullState; // This snapshot's unfiltered world
+
+int FindNetClient(const struct sockaddr_in *address, bool create, double now) {
+    int freeSlot = -1;
+    for (int c = 0; c < NET_MAX_CLIENTS; c++) {
+        if (!netClients[c].connected) {
+            if (freeSlot == -1) freeSlot = c;
+            continue;
+        }
+        if (netClients[c].address.sin_addr.s_addr == address->sin_addr.s_addr && netClients[c].address.sin_port == address->sin_port) return c;
+    }
+    if (!create || freeSlot == -1) return -1;
+    memset(&netClients[freeSlot], 0, sizeof(NetServerClient));
+    netClients[freeSlot].connected = true;
+    netClients[freeSlot].address = *address;
+    netClients[freeSlot].lastHeard = now;
+    netClients[freeSlot].look = (Vector3){ 0.0f, 0.0f, 1.0f };
+    TraceLog(LOG_INFO, "SERVER: client %d connected from %s:%d", freeSlot, inet_ntoa(address->sin_addr), ntohs(address->sin_port));
+    return freeSlot;
+}
+
+void ReceiveNetInputs(int socketHandle, double now) {
+    unsigned char packet[NET_MAX_PACKET];
+    for (;;) {
+        struct sockaddr_in from;
+        socklen_t fromLength = sizeof(from);
+        ssize_t received = recvfrom(socketHandle, packet, sizeof(packet), 0, (struct sockaddr *)&from, &fromLength);
+        if (received < 0) break; // EWOULDBLOCK: drained
+        NetPacketHeader header;
+        if ((size_t)received < sizeof(header)) continue;
+        memcpy(&header, packet, sizeof(header));
+        if (header.magic != NET_PROTOCOL_MAGIC) continue;
+
+        int c = FindNetClient(&from, header.type == NET_PACKET_INPUT, now);
+        if (c == -1) continue;
+        if (header.type == NET_PACKET_DISCONNECT) {
+            netClients[c].connected = false;
+            TraceLog(LOG_INFO, "SERVER: client %d disconnected", c);
+            continue;
+        }
+        NetInputPayload input;
+        if (header.type != NET_PACKET_INPUT || (size_t)received < sizeof(header) + sizeof(input)) continue;
+        memcpy(&input, packet + sizeof(header), sizeof(input));
+
+        NetServerClient *client = &netClients[c];
+        client->lastHeard = now;
+        if (header.tick > client->ackTick) client->ackTick = header.tick;
+        client->buttons = input.buttons;
+        if (input.buttons & NET_BUTTON_JUMP) client->pendingJump = true;
+        Vector3 look = { input.look[0], input.look[1], input.look[2] };
+        if (Vector3LengthSqr(look) > 0.0f) client->look = Vector3Normalize(look);
+        client->viewPosition = (Vector3){ input.viewPosition[0], input.viewPosition[1], input.viewPosition[2] };
+    }
+}
+
+// Lowest connected slot drives the player
+int FindNetPilot(void) {
+    for (int c = 0; c < NET_MAX_CLIENTS; c++) {
+        if (netClients[c].connected) return c;
+    }
+    return -1;
+}
+
+// Quantises this tick's world, filters it for each client and sends the delta against the newest
+// state that client has acknowledged
+void SendNetSnapshots(int socketHandle, uint32_t tick, bool interestManagement, NetServerStats *stats) {
+    CaptureNetWorldState(&netFullState);
+    NetProjectileIndex projectiles = { 0 };
+    if (interestManagement) BuildNetProjectileIndex(&netFullState, &projectiles, &frameArena);
+    uint32_t snapshotNumber = tick / NET_SNAPSHOT_INTERVAL;
+
+    int pilot = FindNetPilot();
+    unsigned char packet[NET_MAX_PACKET];
+    for (int c = 0; c < NET_MAX_CLIENTS; c++) {
+        NetServerClient *client = &netClients[c];
+        if (!client->connected) continue;
+
+        NetWorldState *sentStates = netClientStates[c];
+        NetWorldState *current = &sentStates[snapshotNumber % NET_CLIENT_HISTORY];
+        if (interestManagement) {
+            uint32_t previousIndex = (client->lastSentTick / NET_SNAPSHOT_INTERVAL) % NET_CLIENT_HISTORY;
+            const NetWorldState *previous = &netZeroState;
+            if (client->lastSentTick != 0 && client->sentTicks[previousIndex] == client->lastSentTick) previous = &sentStates[previousIndex];
+            NetViewer viewer = { client->viewPosition, client->look };
+            if (c == pilot) viewer.position = camera.position;
+            NetRelevanceCounts counts = { 0 };
+            FilterNetWorldState(&netFullState, previous, &projectiles, &viewer, snapshotNumber, current, &counts);
+            stats->elementsSent += counts.sent;
+            stats->elementsStale += counts.stale;
+            stats->elementsCulled += counts.culled;
+        } else {
+            *current = netFullState;
+        }
+        client->sentTicks[snapshotNumber % NET_CLIENT_HISTORY] = tick;
+        client->lastSentTick = tick;
+
+        // Delta against the newest state the client decoded, if it is still in its history
+        uint32_t baselineTick = client->ackTick;
+        uint32_t baselineIndex = (baselineTick / NET_SNAPSHOT_INTERVAL) % NET_CLIENT_HISTORY;
+        const NetWorldState *baseline = &netZeroState;
+        if (baselineTick != 0 && baselineTick < tick && client->sentTicks[baselineIndex] == baselineTick) {
+            baseline = &sentStates[baselineIndex];
+        } else {
+            baselineTick = 0;
+            stats->fullSnapshots++;
+        }
+        int deltaSize = EncodeSnapshotDelta((const unsigned char *)baseline, (const unsigned char *)current, (int)sizeof(NetWorldState),
+                                            packet + sizeof(NetPacketHeader), (int)(sizeof(packet) - sizeof(NetPacketHeader)));
+        if (deltaSize < 0) continue;
+
+        NetPacketHeader header = { NET_PROTOCOL_MAGIC, NET_PACKET_SNAPSHOT, (uint8_t)((c == pilot) ? NET_ROLE_PILOT : NET_ROLE_SPECTATOR), (uint16_t)deltaSize, tick, baselineTick };
+        memcpy(packet, &header, sizeof(header));
+        int packetSize = (int)sizeof(header) + deltaSize;
+        if (sendto(socketHandle, packet, (size_t)packetSize, 0, (struct sockaddr *)&client->address, sizeof(client->address)) == packetSize) {
+            stats->bytesSent += packetSize;
+            stats->packetsSent++;
+        }
+    }
+}
+
+void PrintNetServerStats(const char *label, const NetServerStats *stats, int clients) {
+    int ticks = (stats->ticks > 0) ? stats->ticks : 1;
+    int packets = (stats->packetsSent > 0) ? stats->packetsSent : 1;
+    printf("[server] %s | ticks %d | clients %d | %.1f B/tick, %.1f B/packet, %d full | tick %.0f us (sim %.0f, net %.0f), max %.0f us\n",
+           label, stats->ticks, clients, (double)stats->bytesSent / ticks, (double)stats->bytesSent / packets, stats->fullSnapshots,
+           (stats->simSeconds + stats->netSeconds) * 1.0e6 / ticks, stats->simSeconds * 1.0e6 / ticks, stats->netSeconds * 1.0e6 / ticks,
+           stats->maxTickSeconds * 1.0e6);
+    if (stats->elementsSent + stats->elementsStale + stats->elementsCulled > 0) {
+        printf("[server]   relevance per client snapshot: %.1f sent, %.1f stale, %.1f culled\n", (double)stats->elementsSent / packets,
+               (double)stats->elementsStale / packets, (double)stats->elementsCulled / packets);
+    }
+    fflush(stdout);
+}
+
+// Runs the server until options->tickLimit (forever when 0); the whole run's stats go to totals
+int RunServerLoop(const NetServerOptions *options, NetServerStats *totals) {
+    int socketHandle = OpenUdpSocket(options->port);
+    if (socketHandle < 0) {
+        TraceLog(LOG_ERROR, "SERVER: could not bind UDP port %d", options->port);
+        return 1;
+    }
+    netClientStates = calloc(NET_MAX_CLIENTS, sizeof(*netClientStates));
+    if (netClientStates == NULL) {
+        TraceLog(LOG_ERROR, "SERVER: could not allocate client snapshot history");
+        close(socketHandle);
+        return 1;
+    }
+    TraceLog(LOG_INFO, "SERVER: listening on UDP port %d, %d Hz, snapshots every %d ticks, interest management %s", options->port, NET_TICK_RATE,
+             NET_SNAPSHOT_INTERVAL, options->interestManagement ? "on" : "off");
+
+    SeedWorldRandom(options->seed);
+    ResetGame();
+    memset(netClients, 0, sizeof(netClients));
+
+    const double tickSeconds = 1.0 / NET_TICK_RATE;
+    NetServerStats reportStats = { 0 }, matchStats = { 0 };
+    memset(totals, 0, sizeof(NetServerStats));
+    int matchNumber = 1;
+    uint32_t tick = 0;
+    double nextTickTime = WallClockSeconds();
+    while (options->tickLimit <= 0 || (int)tick < options->tickLimit) {
+        double tickStart = WallClockSeconds();
+        NetServerStats tickStats = { 0 };
+        tickStats.ticks = 1;
+        AdoptWatchedConfig(&configWatcher, &config);
+
+        ReceiveNetInputs(socketHandle, tickStart);
+        int clients = 0;
+        for (int c = 0; c < NET_MAX_CLIENTS; c++) {
+            if (!netClients[c].connected) continue;
+            if (tickStart - netClients[c].lastHeard > NET_CLIENT_TIMEOUT) {
+                netClients[c].connected = false;
+                TraceLog(LOG_INFO, "SERVER: client %d timed out", c);
+                continue;
+            }
+            clients++;
+        }
+
+        // The pilot's input drives the player; without one the player stands still
+        PlayerInput input = { 0 };
+        int pilot = FindNetPilot();
+        if (pilot != -1) {
+            NetServerClient *client = &netClients[pilot];
+            input.forward = (client->buttons & NET_BUTTON_FORWARD) != 0;
+            input.back = (client->buttons & NET_BUTTON_BACK) != 0;
+            input.left = (client->buttons & NET_BUTTON_LEFT) != 0;
+            input.right = (client->buttons & NET_BUTTON_RIGHT) != 0;
+            input.run = (client->buttons & NET_BUTTON_RUN) != 0;
+            input.fire = (client->buttons & NET_BUTTON_FIRE) != 0;
+            input.jump = client->pendingJump;
+            client->pendingJump = false;
+            camera.target = Vector3Add(camera.position, client->look);
+        }
+        double netTime = WallClockSeconds() - tickStart;
+
+        double simStart = WallClockSeconds();
+        ResetFrameArena(&frameArena);
+        BEGIN_SIMULATION_STEP();
+        StepSimulation((float)tickSeconds, &input);
+        END_SIMULATION_STEP();
+        tick++;
+        tickStats.simSeconds = WallClockSeconds() - simStart;
+
+        double sendStart = WallClockSeconds();
+        if (tick % NET_SNAPSHOT_INTERVAL == 0) SendNetSnapshots(socketHandle, tick, options->interestManagement, &tickStats);
+        tickStats.netSeconds = netTime + (WallClockSeconds() - sendStart);
+        tickStats.maxTickSeconds = WallClockSeconds() - tickStart;
+        AccumulateNetServerStats(&reportStats, &tickStats);
+        AccumulateNetServerStats(&matchStats, &tickStats);
+
+        if (tick % NET_TICK_RATE == 0 && !options->quiet) {
+            PrintNetServerStats(TextFormat("tick %u", tick), &reportStats, clients);
+            memset(&reportStats, 0, sizeof(reportStats));
+        }
+
+        // Matches restart on their own; the per-match totals are the bandwidth and CPU budget
+        bool victory = activeEnemiesCount == 0 && tankCount == 0;
+        if (gameOver || victory) {
+            if (!options->quiet) PrintNetServerStats(TextFormat("match %d %s", matchNumber, gameOver ? "lost" : "won"), &matchStats, clients);
+            AccumulateNetServerStats(totals, &matchStats);
+            memset(&matchStats, 0, sizeof(matchStats));
+            matchNumber++;
+            ResetGame();
+        }
+
+        nextTickTime += tickSeconds;
+        double now = WallClockSeconds();
+        if (nextTickTime < now - tickSeconds) nextTickTime = now; // Fell behind: do not try to catch up
+        SleepSeconds(nextTickTime - now);
+    }
+
+    AccumulateNetServerStats(totals, &matchStats);
+    FinishTelemetry();
+    free(netClientStates);
+    netClientStates = NULL;
+    close(socketHandle);
+    return 0;
+}
+
+// --server [--port P] [--ticks N] [--config file] [--no-interest] [--metrics-file path] [--metrics-port P] [--metrics-interval s]:
+// headless authoritative server. Prints bandwidth and tick time every second and per match; N > 0
+// stops after N ticks.
+int RunServer(int argc, char **argv) {
+    NetServerOptions options = { NET_DEFAULT_PORT, 0, (unsigned int)time(NULL), true, false };
+    TelemetryOptions telemetryOptions = DEFAULT_TELEMETRY_OPTIONS;
+    const char *configFile = NULL; // The last --config is watched and reloaded while the server runs
+    GameConfig configBase = config;
+    for (int a = 0; a < argc; a++) {
+        bool hasValue = (a + 1 < argc);
+        if (strcmp(argv[a], "--port") == 0 && hasValue) options.port = (unsigned short)atoi(argv[++a]);
+        else if (strcmp(argv[a], "--ticks") == 0 && hasValue) options.tickLimit = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--no-interest") == 0) options.interestManagement = false;
+        else if (strcmp(argv[a], "--config") == 0 && hasValue) {
+            configBase = config;
+            configFile = argv[++a];
+            if (!LoadGameConfig(configFile, &config)) return 1;
+        } else if (!ParseTelemetryOption(argc, argv, &a, &telemetryOptions)) {
+            TraceLog(LOG_ERROR, "SERVER: unknown option '%s'", argv[a]);
+            return 1;
+        }
+    }
+
+    TelemetryExporter exporter;
+    if (!StartTelemetryExporter(&exporter, &telemetryOptions)) return 1;
+    if (configFile != NULL) StartConfigWatcher(&configWatcher, configFile, &configBase, &config);
+    NetServerStats totals;
+    int result = RunServerLoop(&options, &totals);
+    StopConfigWatcher(&configWatcher);
+    StopTelemetryExporter(&exporter);
+    if (result != 0) return 1;
+    PrintNetServerStats("total", &totals, 0);
+    return 0;
+}
+
+// --- Network Client ---
+typedef struct {
+    int socketHandle;
+    struct sockaddr_in server;
+    NetWorldState states[NET_SNAPSHOT_HISTORY]; // Decoded snapshots, by tick % NET_SNAPSHOT_HISTORY
+    uint32_t stateTicks[NET_SNAPSHOT_HISTORY];
+    uint32_t latestTick;
+    double renderTick;    // Server time being displayed, in (fractional) ticks
+    NetRole role;
+    uint32_t sequence;
+    long long bytesReceived;
+    int snapshotsReceived;
+    int baselineMisses;   // Deltas whose baseline this client no longer had
+} NetClient;
+
+bool OpenNetClient(NetClient *client, const char *host, unsigned short port) {
+    memset(client, 0, sizeof(NetClient));
+    client->role = NET_ROLE_SPECTATOR;
+    if (!ResolveServerAddress(host, port, &client->server)) {
+        TraceLog(LOG_ERROR, "CLIENT: bad server address %s", host);
+        return false;
+    }
+    client->socketHandle = OpenUdpSocket(0);
+    if (client->socketHandle < 0) {
+        TraceLog(LOG_ERROR, "CLIENT: could not open a UDP socket");
+        return false;
+    }
+    return true;
+}
+
+void SendNetPacket(NetClient *client, NetPacketType type, const NetInputPayload *input) {
+    unsigned char packet[sizeof(NetPacketHeader) + sizeof(NetInputPayload)];
+    NetPacketHeader header = { NET_PROTOCOL_MAGIC, (uint8_t)type, 0, (uint16_t)((input != NULL) ? sizeof(NetInputPayload) : 0), client->latestTick, 0 };
+    memcpy(packet, &header, sizeof(header));
+    size_t size = sizeof(header);
+    if (input != NULL) {
+        memcpy(packet + size, input, sizeof(NetInputPayload));
+        size += sizeof(NetInputPayload);
+    }
+    sendto(client->socketHandle, packet, size, 0, (struct sockaddr *)&client->server, sizeof(client->server));
+}
+
+void SendNetInput(NetClient *client, const PlayerInput *input, Vector3 viewPosition, Vector3 look) {
+    NetInputPayload payload = { 0 };
+    payload.sequence = ++client->sequence;
+    payload.buttons = (uint8_t)((input->forward ? NET_BUTTON_FORWARD : 0) | (input->back ? NET_BUTTON_BACK : 0) |
+                                (input->left ? NET_BUTTON_LEFT : 0) | (input->right ? NET_BUTTON_RIGHT : 0) |
+                                (input->run ? NET_BUTTON_RUN : 0) | (input->jump ? NET_BUTTON_JUMP : 0) | (input->fire ? NET_BUTTON_FIRE : 0));
+    payload.look[0] = look.x;
+    payload.look[1] = look.y;
+    payload.look[2] = look.z;
+    payload.viewPosition[0] = viewPosition.x;
+    payload.viewPosition[1] = viewPosition.y;
+    payload.viewPosition[2] = viewPosition.z;
+    SendNetPacket(client, NET_PACKET_INPUT, &payload);
+}
+
+void ReceiveNetSnapshots(NetClient *client) {
+    unsigned char packet[NET_MAX_PACKET];
+    for (;;) {
+        ssize_t received = recv(client->socketHandle, packet, sizeof(packet), 0);
+        if (received < 0) break;
+        NetPacketHeader header;
+        if ((size_t)received < sizeof(header)) continue;
+        memcpy(&header, packet, sizeof(header));
+        if (header.magic != NET_PROTOCOL_MAGIC || header.type != NET_PACKET_SNAPSHOT || sizeof(header) + header.payloadSize != (size_t)received) continue;
+        if (header.tick <= client->latestTick && client->stateTicks[header.tick % NET_SNAPSHOT_HISTORY] == header.tick) continue; // Duplicate
+        client->bytesReceived += received;
+
+        // Rebuild the state from the baseline it was encoded against
+        NetWorldState decoded = netZeroState;
+        if (header.baselineTick != 0) {
+            if (client->stateTicks[header.baselineTick % NET_SNAPSHOT_HISTORY] != header.baselineTick) {
+                client->baselineMisses++;
+                continue;
+            }
+            decoded = client->states[header.baselineTick % NET_SNAPSHOT_HISTORY];
+        }
+        if (!ApplySnapshotDelta((unsigned char *)&decoded, (int)sizeof(NetWorldState), packet + sizeof(header), header.payloadSize)) continue;
+        client->states[header.tick % NET_SNAPSHOT_HISTORY] = decoded;
+        client->stateTicks[header.tick % NET_SNAPSHOT_HISTORY] = header.tick;
+        client->snapshotsReceived++;
+        if (header.tick > client->latestTick) {
+            client->latestTick = header.tick;
+            client->role = (NetRole)header.role;
+        }
+    }
+}
+
+// Advances the render clock by deltaTime and writes the interpolated world into the local pools.
+// Returns false until the first snapshot has arrived.
+bool UpdateNetClientWorld(NetClient *client, float deltaTime) {
+    if (client->latestTick == 0) return false;
+
+    // Render a fixed delay behind the newest snapshot; resync when the clock has drifted too far
+    double targetTick = (double)client->latestTick - NET_INTERP_TICKS;
+    client->renderTick += deltaTime * NET_TICK_RATE;
+    if (fabs(client->renderTick - targetTick) > NET_INTERP_TICKS) client->renderTick = targetTick;
+
+    // Newest state at or before the render tick, and the oldest one after it
+    int from = -1, to = -1;
+    for (int i = 0; i < NET_SNAPSHOT_HISTORY; i++) {
+        uint32_t stateTick = client->stateTicks[i];
+        if (stateTick == 0 || stateTick + NET_SNAPSHOT_HISTORY <= client->latestTick) continue;
+        if (stateTick <= client->renderTick) {
+            if (from == -1 || stateTick > client->stateTicks[from]) from = i;
+        } else if (to == -1 || stateTick < client->stateTicks[to]) {
+            to = i;
+        }
+    }
+    if (from == -1) from = to;
+    if (to == -1) to = from;
+    float t = 1.0f;
+    if (client->stateTicks[to] != client->stateTicks[from]) {
+        t = (float)((client->renderTick - client->stateTicks[from]) / (double)(client->stateTicks[to] - client->stateTicks[from]));
+    }
+    ApplyNetWorldState(&client->states[from], &client->states[to], Clamp(t, 0.0f, 1.0f));
+
+    // The pilot sees from the replicated player position; spectators keep their own camera
+    if (client->role == NET_ROLE_PILOT) {
+        Vector3 look = Vector3Subtract(camera.target, camera.position);
+        const NetWorldState *a = &client->states[from];
+        const NetWorldState *b = &client->states[to];
+        camera.position = InterpolateNetPosition(DequantiseMapPosition(&a->playerPosition), DequantiseMapPosition(&b->playerPosition), true, Clamp(t, 0.0f, 1.0f));
+        camera.target = Vector3Add(camera.position, look);
+    }
+    return true;
+}
+
+void CloseNetClient(NetClient *client) {
+    SendNetPacket(client, NET_PACKET_DISCONNECT, NULL);
+    close(client->socketHandle);
+}
+
+void InitNetClientCamera(void) {
+    float startY = SampleTerrainHeight(0.0f, -45.0f) + 1.0f;
+    camera.position = (Vector3){ 0.0f, startY, -45.0f };
+    camera.target = (Vector3){ 0.0f, startY, -44.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+}
+
+// --bot-client [--host H] [--port P] [--seconds S]: headless client driven by the batch runner's
+// bot. Reports the snapshot bandwidth it receives.
+int RunBotClient(int argc, char **argv) {
+    const char *host = "127.0.0.1";
+    unsigned short port = NET_DEFAULT_PORT;
+    double seconds = NET_BOT_DEFAULT_SECONDS;
+    for (int a = 0; a < argc; a++) {
+        bool hasValue = (a + 1 < argc);
+        if (strcmp(argv[a], "--host") == 0 && hasValue) host = argv[++a];
+        else if (strcmp(argv[a], "--port") == 0 && hasValue) port = (unsigned short)atoi(argv[++a]);
+        else if (strcmp(argv[a], "--seconds") == 0 && hasValue) seconds = atof(argv[++a]);
+        else {
+            TraceLog(LOG_ERROR, "CLIENT: unknown option '%s'", argv[a]);
+            return 1;
+        }
+    }
+
+    NetClient *client = malloc(sizeof(NetClient));
+    if (client == NULL || !OpenNetClient(client, host, port)) {
+        free(client);
+        return 1;
+    }
+    InitNetClientCamera();
+
+    const double tickSeconds = 1.0 / NET_TICK_RATE;
+    double start = WallClockSeconds();
+    double nextReport = start + 1.0;
+    long long reportBytes = 0;
+    uint32_t reportTick = 0;
+    while (WallClockSeconds() - start < seconds) {
+        double frameStart = WallClockSeconds();
+        ReceiveNetSnapshots(client);
+        PlayerInput input = { 0 };
+        if (UpdateNetClientWorld(client, (float)tickSeconds)) input = BotPlayerInput();
+        SendNetInput(client, &input, camera.position, Vector3Normalize(Vector3Subtract(camera.target, camera.position)));
+
+        if (frameStart >= nextReport && client->latestTick > reportTick) {
+            printf("[bot] tick %u | %s | %.1f B/tick received | %d snapshots, %d baseline misses\n", client->latestTick,
+                   (client->role == NET_ROLE_PILOT) ? "pilot" : "spectator", (double)(client->bytesReceived - reportBytes) / (client->latestTick - reportTick),
+                   client->snapshotsReceived, client->baselineMisses);
+            fflush(stdout);
+            reportBytes = client->bytesReceived;
+            reportTick = client->latestTick;
+            nextReport += 1.0;
+        }
+        SleepSeconds(frameStart + tickSeconds - WallClockSeconds());
+    }
+
+    printf("[bot] done: %d snapshots, %lld bytes, %d baseline misses\n", client->snapshotsReceived, client->bytesReceived, client->baselineMisses);
+    CloseNetClient(client);
+    free(client);
+    return 0;
+}
+
+// Windowed client loop for --connect; the window, assets and audio are already initialised by main
+void RunNetClientLoop(NetClient *client) {
+    InitNetClientCamera();
+    DisableCursor();
+    while (!WindowShouldClose()) {
+        float deltaTime = GetFrameTime();
+        ReceiveNetSnapshots(client);
+
+        // Look locally (the pilot's position comes from the server); spectators also fly
+        PlayerInput input = { 0 };
+        if (client->role == NET_ROLE_PILOT) {
+            Vector2 mouseDelta = GetMouseDelta();
+            UpdateCameraPro(&camera, Vector3Zero(), (Vector3){ mouseDelta.x * 0.05f, mouseDelta.y * 0.05f, 0.0f }, 0.0f);
+            input = ReadPlayerInput();
+        } else {
+            UpdateCamera(&camera, CAMERA_FREE);
+        }
+        SendNetInput(client, &input, camera.position, Vector3Normalize(Vector3Subtract(camera.target, camera.position)));
+        bool hasWorld = UpdateNetClientWorld(client, deltaTime);
+
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+        if (hasWorld) DrawWorld();
+        else DrawText("Waiting for server...", 10, 10, 20, DARKGRAY);
+        DrawText(TextFormat("%s | tick %u | %d snapshots", (client->role == NET_ROLE_PILOT) ? "Pilot" : "Spectator", client->latestTick, client->snapshotsReceived),
+                 10, GetScreenHeight() - 30, 20, DARKGRAY);
+        EndDrawing();
+    }
+}
+
+void RunNetClient(const char *host, unsigned short port) {
+    NetClient *client = malloc(sizeof(NetClient));
+    if (client != NULL && OpenNetClient(client, host, port)) {
+        RunNetClientLoop(client);
+        CloseNetClient(client);
+    }
+    free(client);
+}
+
+// --- Interest Management Benchmark ---
+// --bench-net [clients] [seconds]: runs a server thread and the given number of headless spectator
+// clients over loopback, first sending everyone the whole world, then with interest management.
+// The clients are scattered over the map and slowly circle their spot, so each sees a different
+// part of the world.
+typedef struct {
+    NetServerOptions options;
+    NetServerStats totals;
+    int result;
+    atomic_bool finished;
+} NetBenchServer;
+
+void *NetBenchServerThread(void *argument) {
+    NetBenchServer *server = argument;
+    server->result = RunServerLoop(&server->options, &server->totals);
+    atomic_store(&server->finished, true);
+    return NULL;
+}
+
+bool RunNetBenchmarkPass(int clientCount, double seconds, bool interestManagement, NetServerStats *stats) {
+    NetBenchServer server = {
+        .options = {
+            .port = (unsigned short)(NET_BENCH_PORT + (interestManagement ? 1 : 0)),
+            .tickLimit = (int)(seconds * NET_TICK_RATE),
+            .seed = 1234,
+            .interestManagement = interestManagement,
+            .quiet = true,
+        },
+    };
+    atomic_init(&server.finished, false);
+    NetClient *clients = calloc((size_t)clientCount, sizeof(NetClient));
+    Vector3 *centers = malloc(sizeof(Vector3) * (size_t)clientCount);
+    int opened = 0;
+    while (clients != NULL && centers != NULL && opened < clientCount && OpenNetClient(&clients[opened], "127.0.0.1", server.options.port)) opened++;
+
+    pthread_t thread;
+    bool started = (opened == clientCount) && pthread_create(&thread, NULL, NetBenchServerThread, &server) == 0;
+    if (started) {
+        SeedWorldRandom(99);
+        for (int c = 0; c < clientCount; c++) centers[c] = (Vector3){ (float)(WorldRand() % 100 - 50), 2.0f, (float)(WorldRand() % 100 - 50) };
+
+        const double tickSeconds = 1.0 / NET_TICK_RATE;
+        const PlayerInput idle = { 0 };
+        double start = WallClockSeconds();
+        while (!atomic_load(&server.finished)) {
+            double frameStart = WallClockSeconds();
+            float angle = (float)(frameStart - start) * 0.5f;
+            for (int c = 0; c < clientCount; c++) {
+                ReceiveNetSnapshots(&clients[c]);
+                float phase = angle + (float)c;
+                Vector3 view = Vector3Add(centers[c], (Vector3){ 5.0f * cosf(phase), 0.0f, 5.0f * sinf(phase) });
+                SendNetInput(&clients[c], &idle, view, (Vector3){ -sinf(phase), 0.0f, cosf(phase) });
+            }
+            SleepSeconds(frameStart + tickSeconds - WallClockSeconds());
+        }
+        pthread_join(thread, NULL);
+    }
+
+    int snapshots = 0, misses = 0, starved = 0;
+    for (int c = 0; c < opened; c++) {
+        snapshots += clients[c].snapshotsReceived;
+        misses += clients[c].baselineMisses;
+        if (clients[c].snapshotsReceived == 0) starved++;
+        CloseNetClient(&clients[c]);
+    }
+    free(clients);
+    free(centers);
+    if (!started || server.result != 0) {
+        TraceLog(LOG_ERROR, "BENCH: could not start the loopback server and %d clients", clientCount);
+        return false;
+    }
+
+    *stats = server.totals;
+    int ticks = (stats->ticks > 0) ? stats->ticks : 1;
+    int packets = (stats->packetsSent > 0) ? stats->packetsSent : 1;
+    printf("interest %-3s | %8.0f B/tick out, %6.1f B/snapshot per client | net %6.0f us/tick, sim %5.0f us/tick | %d snapshots decoded, %d baseline misses, %d clients starved\n",
+           interestManagement ? "on" : "off", (double)stats->bytesSent / ticks, (double)stats->bytesSent / packets, stats->netSeconds * 1.0e6 / ticks,
+           stats->simSeconds * 1.0e6 / ticks, snapshots, misses, starved);
+    if (interestManagement) {
+        printf("             | per client snapshot: %.1f elements sent, %.1f stale, %.1f culled\n", (double)stats->elementsSent / packets,
+               (double)stats->elementsStale / packets, (double)stats->elementsCulled / packets);
+    }
+    fflush(stdout);
+    return true;
+}
+
+int RunNetBenchmark(int clientCount, double seconds) {
+    if (clientCount < 1) clientCount = 1;
+    if (clientCount > NET_MAX_CLIENTS) clientCount = NET_MAX_CLIENTS;
+    if (seconds <= 0.0) seconds = NET_BENCH_SECONDS;
+    printf("Interest management benchmark: %d loopback clients, %.1f s per pass, %d Hz, snapshot every %d ticks\n", clientCount, seconds,
+           NET_TICK_RATE, NET_SNAPSHOT_INTERVAL);
+    fflush(stdout);
+
+    NetServerStats everything, filtered;
+    if (!RunNetBenchmarkPass(clientCount, seconds, false, &everything) || !RunNetBenchmarkPass(clientCount, seconds, true, &filtered)) return 1;
+    double bytesRatio = (filtered.bytesSent > 0) ? (double)everything.bytesSent / filtered.bytesSent : 0.0;
+    printf("interest management: %.2fx less bandwidth, server network time %.0f -> %.0f us/tick\n", bytesRatio,
+           everything.netSeconds * 1.0e6 / (everything.ticks > 0 ? everything.ticks : 1), filtered.netSeconds * 1.0e6 / (filtered.ticks > 0 ? filtered.ticks : 1));
+    return 0;
+}
+
+#endif // NET_SUPPORTED
+
+int main(int argc, char **argv) {
+    // Headless benchmark modes
+    if (argc > 1 && strcmp(argv[1], "--bench-flowfield") == 0) {
+        return RunFlowFieldBenchmark(argc > 2 ? atoi(argv[2]) : FLOWFIELD_BENCH_AGENTS);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-missiles") == 0) {
+        return RunMissileBenchmark(argc > 2 ? atoi(argv[2]) : MISSILE_BENCH_COUNT);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-hitscan") == 0) {
+        return RunHitScanBenchmark(argc > 2 ? atoi(argv[2]) : HITSCAN_BENCH_BOXES);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-particles") == 0) {
+        return RunParticleBenchmark(argc > 2 ? atoi(argv[2]) : MAX_PARTICLES);
+    }
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        return RunBatch(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-config") == 0) {
+        return RunConfigBenchmark(argc > 2 ? atoi(argv[2]) : CONFIG_BENCH_MATCHES);
+    }
+    if (argc > 1 && strcmp(argv[1], "--check-divergence") == 0) {
+        return RunDivergenceCheck(argc - 2, argv + 2);
+    }
+#ifdef NET_SUPPORTED
+    if (argc > 1 && strcmp(argv[1], "--server") == 0) {
+        return RunServer(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bot-client") == 0) {
+        return RunBotClient(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-net") == 0) {
+        return RunNetBenchmark(argc > 2 ? atoi(argv[2]) : NET_BENCH_CLIENTS, argc > 3 ? atof(argv[3]) : NET_BENCH_SECONDS);
+    }
+    if (argc > 1 && strcmp(argv[1], "--scrape-metrics") == 0) {
+        return RunTelemetryScrape(argc > 2 ? atoi(argv[2]) : TELEMETRY_DEFAULT_PORT);
+    }
+#endif
+
+    // --serial runs simulation, drawing and audio on the main thread, one after the other;
+    // --classic-render draws one call per object instead of the lit instanced batches
+    bool serialLoop = false;
+    bool classicRender = false;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--serial") == 0) serialLoop = true;
+        if (strcmp(argv[a], "--classic-render") == 0) classicRender = true;
+    }
+
+    // Tuning overrides for the interactive game, --connect host[:port] to join a server, and metrics export
+    TelemetryOptions telemetryOptions = DEFAULT_TELEMETRY_OPTIONS;
+    const char *configFile = NULL;
+    GameConfig configBase = config;
+#ifdef NET_SUPPORTED
+    const char *connectHost = NULL;
+    unsigned short connectPort = 0;
+#endif
+    for (int a = 1; a + 1 < argc; a++) {
+        if (strcmp(argv[a], "--connect") == 0) {
+#ifdef NET_SUPPORTED
+            static char hostBuffer[64];
+            snprintf(hostBuffer, sizeof(hostBuffer), "%s", argv[a + 1]);
+            char *colon = strchr(hostBuffer, ':');
+            connectPort = (colon != NULL) ? (unsigned short)atoi(colon + 1) : NET_DEFAULT_PORT;
+            if (colon != NULL) *colon = '\0';
+            connectHost = hostBuffer;
+#else
+            TraceLog(LOG_ERROR, "NET: networking is not supported on this platform");
+            return 1;
+#endif
+        }
+        if (ParseTelemetryOption(argc, argv, &a, &telemetryOptions)) continue;
+        if (strcmp(argv[a], "--config") != 0) continue;
+#ifdef BAKED_CONFIG
+        TraceLog(LOG_WARNING, "CONFIG: built with BAKED_CONFIG, ignoring %s", argv[a + 1]);
+#else
+        configBase = config;
+        configFile = argv[a + 1];
+        LoadGameConfig(configFile, &config);
+#endif
+    }
+    // The last --config file is watched, and saving it retunes the running game
+    if (configFile != NULL) StartConfigWatcher(&configWatcher, configFile, &configBase, &config);
+
+    // Initialization
+    InitWindow(800, 600, "Battle Force");
+    SetTargetFPS(60);
+
+    InitAudioDevice();
+
+    // Load sounds
+    bulletShotSound = LoadSound(SOUND_BULLET_PATH);
+    crateHitSound = LoadSound(SOUND_CRATE_HIT_PATH);
+    entityShotSound = LoadSound(SOUND_ENTITY_SHOT_PATH);
+    bombDropSound = LoadSound(SOUND_BOMB_DROP_PATH);
+    explosionSound = LoadSound(SOUND_EXPLOSION_PATH);
+    tankShotSound = LoadSound(SOUND_TANK_SHOT_PATH);
+    tankBombSound = LoadSound(SOUND_TANK_BOMB_PATH);
+    missileLaunchSound = LoadSound(SOUND_MISSILE_LAUNCH_PATH);
+    missileImpactSound = LoadSound(SOUND_MISSILE_IMPACT_PATH);
+
+    SetSoundVolume(bulletShotSound, 0.5f);
+    SetSoundVolume(entityShotSound, 0.3f);
+    SetSoundVolume(bombDropSound, 0.8f);
+    SetSoundVolume(explosionSound, 1.0f);
+    SetSoundVolume(tankShotSound, 0.6f);
+    SetSoundVolume(tankBombSound, 0.9f);
+    SetSoundVolume(missileLaunchSound, 0.7f);
+    SetSoundVolume(missileImpactSound, 1.0f);
+    audioEnabled = IsAudioDeviceReady();
+    effectsEnabled = true;
+
+    // Initialize camera properties
+    camera.fovy = 90.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    // Load models once at initialization
+    entityModel = LoadModelFromMesh(GenMeshCube(1.0f, 2.0f, 1.0f));
+    crateModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
+    jetModel = LoadModel("resources/models/Jet.glb");
+    bombModel = LoadModelFromMesh(GenMeshSphere(BOMB_RADIUS, 16, 16));
+    tankModel = LoadModel("resources/models/Tank.glb");
+    missileModel = LoadModelFromMesh(GenMeshCylinder(MISSILE_RADIUS, MISSILE_RADIUS * 3.0f, 16)); // Simple cylinder for missile
+    if (!classicRender) InitLitRenderer();
+    StartChunkLoader(&terrainStream); // Terrain around the camera streams in the background
+    TelemetryExporter exporter;
+    StartTelemetryExporter(&exporter, &telemetryOptions); // A failed export is logged; the game still runs
+
+
+#ifdef NET_SUPPORTED
+    if (connectHost != NULL) RunNetClient(connectHost, connectPort);
+    else if (serialLoop) RunLocalGame();
+    else RunPipelinedGame();
+#else
+    if (serialLoop) RunLocalGame();
+    else RunPipelinedGame();
+#endif
+    FinishTelemetry();
+    StopTelemetryExporter(&exporter);
+    StopConfigWatcher(&configWatcher);
 
     // De-Initialization
     UnloadSound(bulletShotSound);
@@ -1557,12 +8959,15 @@ int main(void) {
     UnloadSound(tankBombSound);
     UnloadSound(missileLaunchSound);
     UnloadSound(missileImpactSound);
+    UnloadLitRenderer();
     UnloadModel(entityModel);
     UnloadModel(crateModel);
     UnloadModel(jetModel);
     UnloadModel(bombModel);
     UnloadModel(tankModel);
     UnloadModel(missileModel); // Unload missile model
+    StopChunkLoader(&terrainStream);
+    UnloadTerrainChunks();
     CloseAudioDevice();
     CloseWindow();
 